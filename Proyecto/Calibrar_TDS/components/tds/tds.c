@@ -17,7 +17,6 @@ static const char *KEY_GAIN = "tds_gain";
 
 static float tds_offset = 0.0f;
 static float tds_gain = 1.0f;
-static float last_raw = 0.0f;
 
 void tds_init(void)
 {
@@ -34,8 +33,7 @@ float tds_read_raw(void)
 {
     // Use ADC driver to read raw and return as float
     int raw = adc_read_raw(20);
-    last_raw = (float)raw;
-    return last_raw;
+    return (float)raw;
 }
 
 float tds_read_ppm(void)
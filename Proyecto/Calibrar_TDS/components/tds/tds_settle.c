@@ -0,0 +1,94 @@
+#include "tds_settle.h"
+
+#include <math.h>
+#include <stddef.h>
+
+bool tds_settle_init(tds_settle_t *s, const tds_settle_cfg_t *cfg)
+{
+    if (s == NULL || cfg == NULL || cfg->window < 3 || cfg->window > TDS_SETTLE_MAX_WINDOW ||
+        cfg->hold == 0 || !(cfg->max_slope > 0.0f) || !(cfg->max_sigma > 0.0f)) {
+        return false;
+    }
+    s->cfg = *cfg;
+    tds_settle_reset(s);
+    return true;
+}
+
+void tds_settle_reset(tds_settle_t *s)
+{
+    s->head = 0;
+    s->count = 0;
+    s->settled_for = 0;
+}
+
+/** Least-squares fit over the window; deviations from the means keep floats accurate */
+static void fit(const tds_settle_t *s, tds_settle_stats_t *st)
+{
+    int n = s->count;
+    double t_mean = 0.0, x_mean = 0.0;
+    for (int i = 0; i < n; i++) {
+        t_mean += s->t[i];
+        x_mean += s->x[i];
+    }
+    t_mean /= n;
+    x_mean /= n;
+
+    double stt = 0.0, stx = 0.0;
+    for (int i = 0; i < n; i++) {
+        double dt = s->t[i] - t_mean;
+        stt += dt * dt;
+        stx += dt * (s->x[i] - x_mean);
+    }
+    double slope = stt > 0.0 ? stx / stt : 0.0;
+
+    double ss = 0.0;
+    for (int i = 0; i < n; i++) {
+        double r = (s->x[i] - x_mean) - slope * (s->t[i] - t_mean);
+        ss += r * r;
+    }
+    double sigma = n > 2 ? sqrt(ss / (n - 2)) : 0.0;
+
+    // Noise of the mean plus the drift left across half the window span
+    double span = n > 1 ? sqrt(12.0 * stt / n) : 0.0;
+    double drift = slope * span / 2.0;
+    st->count = (uint16_t)n;
+    st->mean = (float)x_mean;
+    st->sigma = (float)sigma;
+    st->slope = (float)slope;
+    st->uncertainty = (float)sqrt(sigma * sigma / n + drift * drift);
+}
+
+bool tds_settle_push(tds_settle_t *s, float t_s, float raw, tds_settle_stats_t *stats)
+{
+    const tds_settle_cfg_t *cfg = &s->cfg;
+    s->t[s->head] = t_s;
+    s->x[s->head] = raw;
+    s->head = (uint16_t)((s->head + 1) % cfg->window);
+    if (s->count < cfg->window) {
+        s->count++;
+    }
+
+    tds_settle_stats_t st;
+    fit(s, &st);
+    bool full = s->count == cfg->window;
+    st.settled = full && fabsf(st.slope) <= cfg->max_slope && st.sigma <= cfg->max_sigma;
+    s->settled_for = st.settled ? (uint16_t)(s->settled_for + 1) : 0;
+
+    // First half fills the window, second half is the hold count; an unsettled
+    // full window shows how far the worse criterion is from its limit
+    unsigned pct;
+    if (!full) {
+        pct = 50u * s->count / cfg->window;
+    } else if (st.settled) {
+        pct = 50u + 50u * s->settled_for / cfg->hold;
+    } else {
+        float excess = fmaxf(fabsf(st.slope) / cfg->max_slope, st.sigma / cfg->max_sigma);
+        pct = (unsigned)(50.0f / excess);
+    }
+    st.progress = (uint8_t)(pct > 100u ? 100u : pct);
+
+    if (stats != NULL) {
+        *stats = st;
+    }
+    return s->settled_for >= cfg->hold;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Probe settling detector for the calibration wizard.
+ *
+ * Readings stream into a rolling window. A least-squares line through the
+ * window gives the drift (slope) and the scatter around it (sigma), so a
+ * probe that is still moving is not mistaken for a noisy one. The point is
+ * captured once both stay under their limits for `hold` consecutive
+ * readings.
+ *
+ * Pure C (no ESP-IDF) so it can be tested on the host.
+ */
+
+#define TDS_SETTLE_MAX_WINDOW 64
+
+typedef struct {
+    uint16_t window;       // Readings in the rolling window (3..TDS_SETTLE_MAX_WINDOW)
+    uint16_t hold;         // Consecutive settled readings before capture (>= 1)
+    float max_slope;       // Drift limit, raw units per second
+    float max_sigma;       // Scatter limit around the fitted line, raw units
+} tds_settle_cfg_t;
+
+typedef struct {
+    uint16_t count;        // Readings in the window
+    float mean;            // Window mean: the captured value
+    float sigma;           // Residual standard deviation around the line
+    float slope;           // Raw units per second
+    float uncertainty;     // Standard uncertainty of `mean` (noise + residual drift)
+    bool settled;          // This window meets both limits
+    uint8_t progress;      // 0..100 for the console display
+} tds_settle_stats_t;
+
+typedef struct {
+    tds_settle_cfg_t cfg;
+    float t[TDS_SETTLE_MAX_WINDOW];
+    float x[TDS_SETTLE_MAX_WINDOW];
+    uint16_t head;
+    uint16_t count;
+    uint16_t settled_for;
+} tds_settle_t;
+
+/** @brief false (and nothing changed) if the configuration is out of range */
+bool tds_settle_init(tds_settle_t *s, const tds_settle_cfg_t *cfg);
+
+/** @brief Empty the window, keeping the configuration */
+void tds_settle_reset(tds_settle_t *s);
+
+/**
+ * @brief Add a reading taken at t_s seconds and refresh the statistics
+ * @return true when the probe has been settled for `hold` readings and
+ *         stats->mean can be captured
+ */
+bool tds_settle_push(tds_settle_t *s, float t_s, float raw, tds_settle_stats_t *stats);
@@ -1,22 +1,152 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "adc_driver.h"
 #include "tds.h"
+#include "tds_settle.h"
 #include "storage.h"
+#include "rawstream_uart.h"
 
 static const char *TAG = "main";
 
+// Calibration wizard: readings every 250 ms into a 5 s window; the point is
+// captured once drift and scatter stay under the limits for 1 s
+#define CAL_PERIOD_MS     250
+#define CAL_WINDOW        20
+#define CAL_HOLD          4
+#define CAL_MAX_SLOPE     0.5f     // raw units per second
+#define CAL_MAX_SIGMA     3.0f     // raw units
+#define CAL_TIMEOUT_S     120
+#define CAL_BAR_WIDTH     20
+
+// Raw streaming: back-to-back single conversions per tick (the ADC driver
+// only exposes the default channel, ADC_CHANNEL_0)
+#define STREAM_BLOCK      64
+#define STREAM_CHANNEL    0
+
+// Point requested from the console ('A', 'B'), 'X' to cancel, 0 when idle
+static atomic_int g_cal_request;
+
+static void cal_progress(char point, float elapsed_s, const tds_settle_stats_t *st)
+{
+    char bar[CAL_BAR_WIDTH + 1];
+    int filled = st->progress * CAL_BAR_WIDTH / 100;
+    for (int i = 0; i < CAL_BAR_WIDTH; i++) {
+        bar[i] = i < filled ? '#' : '.';
+    }
+    bar[CAL_BAR_WIDTH] = '\0';
+    printf("\rcal%c [%s] %3u%% %5.1fs raw=%8.2f sigma=%6.3f slope=%+7.3f/s %s   ",
+           point, bar, st->progress, elapsed_s, st->mean, st->sigma, st->slope,
+           st->settled ? "stable" : (st->count < CAL_WINDOW ? "filling" : "settling"));
+    fflush(stdout);
+}
+
+static void cal_apply(char point, float raw)
+{
+    if (point == 'A') {
+        tds_set_calibration_point_A(raw);
+    } else {
+        tds_set_calibration_point_B(raw);
+    }
+}
+
+/**
+ * Stream readings until the probe settles, then capture the window mean.
+ * Runs on tds_task; a new calA/calB restarts, cancel aborts.
+ */
+static void cal_wizard(char point)
+{
+    static const tds_settle_cfg_t cfg = {
+        .window = CAL_WINDOW,
+        .hold = CAL_HOLD,
+        .max_slope = CAL_MAX_SLOPE,
+        .max_sigma = CAL_MAX_SIGMA,
+    };
+    static tds_settle_t settle;
+    tds_settle_init(&settle, &cfg);
+
+    printf("cal%c: waiting for the probe to settle (|slope| <= %.2f/s, sigma <= %.2f, "
+           "type cancel to abort)\n", point, CAL_MAX_SLOPE, CAL_MAX_SIGMA);
+    int64_t t0 = esp_timer_get_time();
+    TickType_t wake = xTaskGetTickCount();
+    tds_settle_stats_t st;
+    while (1) {
+        int req = atomic_exchange(&g_cal_request, 0);
+        if (req == 'X') {
+            printf("\ncal%c: cancelled\n", point);
+            return;
+        }
+        if (req == 'A' || req == 'B') {
+            point = (char)req;
+            tds_settle_reset(&settle);
+            t0 = esp_timer_get_time();
+            printf("\ncal%c: restarted\n", point);
+        }
+
+        float t_s = (float)(esp_timer_get_time() - t0) / 1e6f;
+        bool done = tds_settle_push(&settle, t_s, tds_read_raw(), &st);
+        cal_progress(point, t_s, &st);
+        if (done) {
+            break;
+        }
+        if (t_s > CAL_TIMEOUT_S) {
+            printf("\ncal%c: timeout after %d s, last window raw=%.2f sigma=%.3f slope=%+.3f/s "
+                   "(%s too high). Nothing captured; retry or use cal%c now\n",
+                   point, CAL_TIMEOUT_S, st.mean, st.sigma, st.slope,
+                   st.sigma > CAL_MAX_SIGMA ? "noise" : "drift", point);
+            return;
+        }
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(CAL_PERIOD_MS));
+    }
+
+    cal_apply(point, st.mean);
+    printf("\ncal%c: captured raw=%.2f +/- %.2f (k=1, %u readings, sigma=%.3f, slope=%+.3f/s) "
+           "in %.1f s\n", point, st.mean, st.uncertainty, st.count, st.sigma, st.slope,
+           (float)(esp_timer_get_time() - t0) / 1e6f);
+}
+
+/** One block of raw conversions for rawstream, then yield the tick */
+static void stream_block(void)
+{
+    for (int i = 0; i < STREAM_BLOCK; i++) {
+        int raw = adc_read_raw(1);
+        rawstream_push(RAWSTREAM_CH_ADC(STREAM_CHANNEL), raw, esp_timer_get_time());
+    }
+    vTaskDelay(1);
+}
+
 static void tds_task(void *arg)
 {
+    TickType_t last_log = xTaskGetTickCount();
     while (1) {
-        float raw = tds_read_raw();
-        float ppm = tds_read_ppm();
-        ESP_LOGI(TAG, "TDS raw=%.2f ppm=%.2f", raw, ppm);
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        if (rawstream_active()) {
+            stream_block();
+            continue;
+        }
+        int req = atomic_load(&g_cal_request);
+        if (req == 'A' || req == 'B') {
+            atomic_store(&g_cal_request, 0);
+            cal_wizard((char)req);
+            last_log = xTaskGetTickCount();
+            continue;
+        }
+        if (req == 'X') {
+            atomic_store(&g_cal_request, 0);
+        }
+        if (xTaskGetTickCount() - last_log >= pdMS_TO_TICKS(1000)) {
+            float raw = tds_read_raw();
+            float ppm = tds_read_ppm();
+            ESP_LOGI(TAG, "TDS raw=%.2f ppm=%.2f", raw, ppm);
+            last_log = xTaskGetTickCount();
+        }
+        // Short poll so a calibration request starts without waiting a full log period
+        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
@@ -33,13 +163,28 @@ static void console_task(void *arg)
         char *nl = strchr(line, '\n'); if (nl) *nl = '\0';
 
         if (strcmp(line, "calA") == 0) {
+            atomic_store(&g_cal_request, 'A');
+        } else if (strcmp(line, "calB") == 0) {
+            atomic_store(&g_cal_request, 'B');
+        } else if (strcmp(line, "cancel") == 0) {
+            atomic_store(&g_cal_request, 'X');
+        } else if (strcmp(line, "calA now") == 0) {
+            // Single average without waiting for the probe to settle
             float raw = tds_read_raw();
             tds_set_calibration_point_A(raw);
             printf("Calibration A saved in RAM: %f\n", raw);
-        } else if (strcmp(line, "calB") == 0) {
+        } else if (strcmp(line, "calB now") == 0) {
             float raw = tds_read_raw();
             tds_set_calibration_point_B(raw);
             printf("Calibration B set in RAM: %f\n", raw);
+        } else if (strncmp(line, "stream on", 9) == 0) {
+            // Binary frames from here on; "stream off" (at the new baud) returns to text
+            long baud = strtol(line + 9, NULL, 10);
+            rawstream_start(baud > 0 ? (uint32_t)baud : 0);
+        } else if (strcmp(line, "stream off") == 0) {
+            rawstream_stop();
+        } else if (strcmp(line, "stream") == 0) {
+            rawstream_print_stats();
         } else if (strcmp(line, "save") == 0) {
             if (tds_save_calibration() == ESP_OK) printf("Calibration persisted\n");
             else printf("Failed to save calibration\n");
@@ -48,7 +193,8 @@ static void console_task(void *arg)
         } else if (strlen(line) == 0) {
             // ignore empty
         } else {
-            printf("Commands: calA, calB, save, show\n");
+            printf("Commands: calA, calB, cancel, calA now, calB now, save, show, "
+                   "stream [on [baud] | off]\n");
         }
     }
 }
@@ -0,0 +1,165 @@
+#include <string.h>
+
+#include "batch.h"
+#include "test_unit.h"
+
+static const batch_policy_t POLICY = { .publish_every = 10, .threshold_cm = 5.0f };
+
+static batch_state_t fresh(void)
+{
+    batch_state_t b;
+    memset(&b, 0xA5, sizeof(b));    // Memoria RTC sin inicializar
+    TEST_ASSERT(!batch_restore(&b));
+    return b;
+}
+
+// Deja un lote ya publicado con la referencia en level_cm
+static batch_state_t published_at(float level_cm)
+{
+    batch_state_t b = fresh();
+    batch_append(&b, level_cm);
+    batch_mark_published(&b);
+    return b;
+}
+
+static void test_restore_keeps_valid_state(void)
+{
+    batch_state_t b = fresh();
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(batch_restore(&b));
+    TEST_ASSERT_EQ(b.count, 1);
+    TEST_ASSERT_EQ(b.wake_count, 1);
+}
+
+static void test_first_batch_publishes(void)
+{
+    batch_state_t b = fresh();
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+    batch_mark_published(&b);
+    TEST_ASSERT(b.has_published);
+    TEST_ASSERT_EQ(b.count, 0);
+    TEST_ASSERT_EQ(b.published_wake, 1);
+}
+
+static void test_publish_every_rollover(void)
+{
+    batch_state_t b = published_at(50.0f);
+    for (int i = 1; i < POLICY.publish_every; i++) {
+        batch_append(&b, 50.0f);
+        TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+    }
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+    TEST_ASSERT_EQ(b.count, POLICY.publish_every);
+
+    // El contador de despertares puede dar la vuelta sin romper la resta
+    b = published_at(50.0f);
+    b.wake_count = UINT32_MAX - 2;
+    b.published_wake = UINT32_MAX - 2;
+    for (int i = 1; i < POLICY.publish_every; i++) {
+        batch_append(&b, 50.0f);
+        TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+    }
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(b.wake_count < b.published_wake);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+}
+
+static void test_threshold_triggers(void)
+{
+    batch_state_t b = published_at(50.0f);
+    batch_append(&b, 54.9f);
+    TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+    batch_append(&b, 45.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+
+    // Umbral <= 0 desactiva el disparo por cambio de nivel
+    const batch_policy_t no_threshold = { .publish_every = 10, .threshold_cm = 0.0f };
+    b = published_at(50.0f);
+    batch_append(&b, 120.0f);
+    TEST_ASSERT(!batch_should_publish(&b, &no_threshold));
+}
+
+static void test_overflow_drops_oldest(void)
+{
+    const batch_policy_t never = { .publish_every = UINT16_MAX, .threshold_cm = 0.0f };
+    batch_state_t b = published_at(0.0f);
+    for (int i = 0; i < BATCH_MAX_SAMPLES + 3; i++) {
+        batch_append(&b, (float)i);
+    }
+    TEST_ASSERT_EQ(b.count, BATCH_MAX_SAMPLES);
+    TEST_ASSERT_EQ(b.dropped, 3);
+    TEST_ASSERT(batch_should_publish(&b, &never));
+
+    // Quedan las más recientes, en orden: 3, 4, ..., 34
+    char json[512];
+    TEST_ASSERT(batch_to_json(&b, 60, json, sizeof(json)) > 0);
+    TEST_ASSERT(strstr(json, "\"dropped\":3") != NULL);
+    TEST_ASSERT(strstr(json, "\"levels_cm\":[3.0,4.0,") != NULL);
+    TEST_ASSERT(strstr(json, ",34.0]}") != NULL);
+    TEST_ASSERT_EQ(batch_to_json(&b, 60, json, 64), -1);
+}
+
+static void test_failed_reads_only(void)
+{
+    batch_state_t b = fresh();
+    batch_append(&b, -1.0f);
+    batch_append(&b, -1.0f);
+    TEST_ASSERT_EQ(b.count, 0);
+    TEST_ASSERT_EQ(b.failed, 2);
+    TEST_ASSERT_EQ(b.wake_count, 2);
+    TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+
+    // La primera lectura válida marca el inicio del lote
+    batch_append(&b, 50.0f);
+    TEST_ASSERT_EQ(b.first_wake, 3);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+}
+
+static void test_retry_backoff_after_failed_publish(void)
+{
+    TEST_ASSERT_EQ(batch_retry_wakes(0), 0);
+    TEST_ASSERT_EQ(batch_retry_wakes(1), 2);
+    TEST_ASSERT_EQ(batch_retry_wakes(3), 8);
+    TEST_ASSERT_EQ(batch_retry_wakes(20), BATCH_RETRY_MAX_WAKES);
+
+    batch_state_t b = fresh();
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+    batch_mark_failed(&b);                      // Sin red
+    TEST_ASSERT_EQ(b.count, 1);
+
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+    batch_append(&b, 50.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+    batch_mark_failed(&b);
+
+    // Segundo fallo: 4 despertares sin radio aunque el umbral se dispare
+    for (int i = 1; i < 4; i++) {
+        batch_append(&b, 100.0f);
+        TEST_ASSERT(!batch_should_publish(&b, &POLICY));
+    }
+    batch_append(&b, 100.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+    TEST_ASSERT_EQ(b.count, 7);
+
+    // Un éxito reinicia el backoff
+    batch_mark_published(&b);
+    TEST_ASSERT_EQ(b.fail_streak, 0);
+    batch_append(&b, 120.0f);
+    TEST_ASSERT(batch_should_publish(&b, &POLICY));
+}
+
+int main(void)
+{
+    TEST_RUN(test_restore_keeps_valid_state);
+    TEST_RUN(test_first_batch_publishes);
+    TEST_RUN(test_publish_every_rollover);
+    TEST_RUN(test_threshold_triggers);
+    TEST_RUN(test_overflow_drops_oldest);
+    TEST_RUN(test_failed_reads_only);
+    TEST_RUN(test_retry_backoff_after_failed_publish);
+    return TEST_EXIT();
+}
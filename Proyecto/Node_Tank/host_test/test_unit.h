@@ -0,0 +1,29 @@
+#pragma once
+#include <stdio.h>
+
+/* Mini arnés de pruebas: cada archivo define sus casos y llama a TEST_RUN() */
+
+static int s_test_failures = 0;
+
+#define TEST_ASSERT(cond) do { \
+        if (!(cond)) { \
+            printf("  ✗ %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQ(a, b) do { \
+        long long _a = (long long)(a), _b = (long long)(b); \
+        if (_a != _b) { \
+            printf("  ✗ %s:%d: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_RUN(fn) do { \
+        int _before = s_test_failures; \
+        fn(); \
+        printf("%s %s\n", (s_test_failures == _before) ? "✓" : "✗", #fn); \
+    } while (0)
+
+#define TEST_EXIT() (s_test_failures ? 1 : 0)
@@ -0,0 +1,158 @@
+// batch.c
+// Acumulación de lecturas en memoria RTC y política de publicación.
+
+#include <stdio.h>
+#include <string.h>
+#include "batch.h"
+
+#define BATCH_MAGIC 0x42544332u   // "BTC2" (cambia con el formato de batch_state_t)
+
+bool batch_restore(batch_state_t *b)
+{
+    if (b->magic == BATCH_MAGIC && b->count <= BATCH_MAX_SAMPLES && b->head < BATCH_MAX_SAMPLES) {
+        return true;
+    }
+    memset(b, 0, sizeof(*b));
+    b->magic = BATCH_MAGIC;
+    return false;
+}
+
+void batch_append(batch_state_t *b, float level_cm)
+{
+    b->wake_count++;
+
+    if (level_cm < 0.0f) {
+        b->failed++;
+        return;
+    }
+
+    if (b->count == 0) {
+        b->first_wake = b->wake_count;
+    }
+
+    if (b->count == BATCH_MAX_SAMPLES) {
+        // Lote lleno (p. ej. sin red): descartar la lectura más vieja
+        b->head = (b->head + 1) % BATCH_MAX_SAMPLES;
+        b->count--;
+        b->dropped++;
+    }
+    b->samples[(b->head + b->count) % BATCH_MAX_SAMPLES] = level_cm;
+    b->count++;
+}
+
+static float batch_last(const batch_state_t *b)
+{
+    return b->samples[(b->head + b->count - 1) % BATCH_MAX_SAMPLES];
+}
+
+bool batch_should_publish(const batch_state_t *b, const batch_policy_t *policy)
+{
+    if (b->count == 0) {
+        // Nada que publicar: solo lecturas fallidas
+        return false;
+    }
+    if (b->fail_streak > 0 &&
+        b->wake_count - b->last_attempt_wake < batch_retry_wakes(b->fail_streak)) {
+        // Último intento fallido: no levantar la radio hasta que pase el backoff
+        return false;
+    }
+    if (!b->has_published) {
+        // Primer lote tras el encendido: publicar para que el servidor vea el nodo
+        return true;
+    }
+    if (b->count >= BATCH_MAX_SAMPLES) {
+        return true;
+    }
+
+    uint16_t every = policy->publish_every ? policy->publish_every : 1;
+    if (b->wake_count - b->published_wake >= every) {
+        return true;
+    }
+
+    if (policy->threshold_cm > 0.0f) {
+        float delta = batch_last(b) - b->last_published_cm;
+        if (delta < 0.0f) {
+            delta = -delta;
+        }
+        if (delta >= policy->threshold_cm) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t batch_retry_wakes(uint16_t fail_streak)
+{
+    if (fail_streak == 0) {
+        return 0;
+    }
+    uint32_t wakes = 1;
+    for (uint16_t i = 0; i < fail_streak && wakes < BATCH_RETRY_MAX_WAKES; i++) {
+        wakes <<= 1;
+    }
+    return wakes < BATCH_RETRY_MAX_WAKES ? wakes : BATCH_RETRY_MAX_WAKES;
+}
+
+void batch_mark_failed(batch_state_t *b)
+{
+    b->last_attempt_wake = b->wake_count;
+    if (b->fail_streak < UINT16_MAX) {
+        b->fail_streak++;
+    }
+}
+
+void batch_mark_published(batch_state_t *b)
+{
+    if (b->count > 0) {
+        b->last_published_cm = batch_last(b);
+        b->has_published = true;
+    }
+    b->published_wake = b->wake_count;
+    b->head = 0;
+    b->count = 0;
+    b->dropped = 0;
+    b->failed = 0;
+    b->awake_cycles = 0;
+    b->awake_sum_us = 0;
+    b->awake_max_us = 0;
+    b->fail_streak = 0;
+}
+
+void batch_note_awake(batch_state_t *b, uint32_t awake_us)
+{
+    b->awake_cycles++;
+    b->awake_sum_us += awake_us;
+    if (awake_us > b->awake_max_us) {
+        b->awake_max_us = awake_us;
+    }
+}
+
+int batch_to_json(const batch_state_t *b, uint32_t period_s, char *buf, size_t len)
+{
+    uint32_t awake_avg_ms = b->awake_cycles ? (b->awake_sum_us / b->awake_cycles) / 1000 : 0;
+    int n = snprintf(buf, len,
+                     "{\"first_wake\":%lu,\"period_s\":%lu,\"dropped\":%u,\"failed\":%u,"
+                     "\"awake_avg_ms\":%lu,\"awake_max_ms\":%lu,\"levels_cm\":[",
+                     (unsigned long)b->first_wake, (unsigned long)period_s,
+                     (unsigned)b->dropped, (unsigned)b->failed,
+                     (unsigned long)awake_avg_ms, (unsigned long)(b->awake_max_us / 1000));
+    if (n < 0 || (size_t)n >= len) {
+        return -1;
+    }
+    size_t pos = n;
+
+    for (uint16_t i = 0; i < b->count; i++) {
+        n = snprintf(buf + pos, len - pos, "%s%.1f", i ? "," : "",
+                     b->samples[(b->head + i) % BATCH_MAX_SAMPLES]);
+        if (n < 0 || (size_t)n >= len - pos) {
+            return -1;
+        }
+        pos += n;
+    }
+
+    n = snprintf(buf + pos, len - pos, "]}");
+    if (n < 0 || (size_t)n >= len - pos) {
+        return -1;
+    }
+    return (int)(pos + n);
+}
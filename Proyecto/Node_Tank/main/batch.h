@@ -0,0 +1,79 @@
+// batch.h
+// Lote de lecturas para el modo de ciclo de trabajo (deep sleep).
+//
+// El estado vive en memoria RTC (RTC_DATA_ATTR en main.c) y sobrevive al deep
+// sleep. Este módulo no depende de ESP-IDF: la lógica de acumulación y la
+// decisión de publicar se pueden compilar y probar en el host.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lecturas máximas retenidas; si no se puede publicar se descartan las más viejas.
+#define BATCH_MAX_SAMPLES 32
+// Tras una publicación fallida se espera 2, 4, 8... despertares antes de
+// reintentar (sin red, cada intento cuesta el timeout completo de conexión).
+#define BATCH_RETRY_MAX_WAKES 32
+
+typedef struct {
+    uint32_t magic;            // Valida el contenido tras un encendido en frío
+    uint32_t wake_count;       // Despertares desde el encendido
+    uint32_t first_wake;       // Despertar de la lectura más vieja del lote
+    uint32_t published_wake;   // Despertar de la última publicación
+    uint16_t head;             // Índice de la lectura más vieja
+    uint16_t count;            // Lecturas en el lote
+    uint16_t dropped;          // Lecturas descartadas por lote lleno
+    uint16_t failed;           // Lecturas fallidas desde la última publicación
+    float samples[BATCH_MAX_SAMPLES];
+    bool has_published;
+    float last_published_cm;   // Referencia para el umbral
+    uint32_t awake_cycles;     // Ciclos medidos desde la última publicación
+    uint32_t awake_sum_us;
+    uint32_t awake_max_us;
+    uint32_t last_attempt_wake; // Despertar del último intento fallido
+    uint16_t fail_streak;       // Publicaciones fallidas seguidas
+} batch_state_t;
+
+typedef struct {
+    uint16_t publish_every;    // Publicar cada N despertares (>= 1)
+    float threshold_cm;        // Publicar de inmediato si el nivel cambia al menos esto (<= 0 desactiva)
+} batch_policy_t;
+
+// Inicializa el estado si la memoria RTC no es válida (encendido en frío).
+// Retorna true si el estado ya era válido (se despertó de deep sleep).
+bool batch_restore(batch_state_t *b);
+
+// Registra un despertar y agrega la lectura (level_cm < 0 = lectura fallida).
+void batch_append(batch_state_t *b, float level_cm);
+
+// Decide si en este despertar hay que conectarse y publicar el lote. Tras un
+// fallo no reintenta hasta que pase el backoff (batch_retry_wakes()).
+bool batch_should_publish(const batch_state_t *b, const batch_policy_t *policy);
+
+// Vacía el lote tras publicar con éxito y toma la última lectura como referencia.
+void batch_mark_published(batch_state_t *b);
+
+// Registra un intento de publicación fallido; el lote se conserva.
+void batch_mark_failed(batch_state_t *b);
+
+// Despertares a esperar tras fail_streak fallos seguidos (0 sin fallos).
+uint32_t batch_retry_wakes(uint16_t fail_streak);
+
+// Registra el tiempo despierto del ciclo actual (se reporta en el próximo lote).
+void batch_note_awake(batch_state_t *b, uint32_t awake_us);
+
+// Serializa el lote como JSON. Retorna la longitud escrita o -1 si no cabe.
+int batch_to_json(const batch_state_t *b, uint32_t period_s, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCH_H
@@ -1,19 +1,27 @@
 // main.c
 // Nodo de Sensor de Tanque (ESP32-C6)
-// Inicializa NVS, Wi‑Fi, MQTT y crea la tarea que lee el sensor y publica en MQTT cada 5s.
+// Modo continuo: inicializa NVS, Wi‑Fi, MQTT y crea la tarea que lee el sensor y publica cada 5s.
+// Modo ciclo de trabajo: despierta por timer, lee, acumula en memoria RTC y vuelve a
+// deep sleep; solo levanta Wi‑Fi/MQTT para publicar el lote.
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
 
 #include "wifi.h"
 #include "mqtt.h"
 #include "sensor.h"
 #include "tasks.h"
+#include "batch.h"
+#include "tank_geometry.h"
 
 static const char *TAG = "TANK_NODE";
 
@@ -21,8 +29,30 @@ static const char *TAG = "TANK_NODE";
 #define DEFAULT_WIFI_SSID "Casa de Tatan"//RPi-Hotspot" RPi-Hotspot
 #define DEFAULT_WIFI_PASS "123123123"
 #define DEFAULT_MQTT_BROKER_URI "mqtt://10.162.31.132:1883"  // 10.162.31.132        10.42.0.111
+// El nodo solo publica cada 5 s y no recibe comandos: tolera ~1 s de latencia
+// en bajada, así que la radio despierta cada 10 beacons (~1 s) en lugar de cada DTIM
+#define WIFI_PS_LISTEN_INTERVAL 10
 
-void app_main(void)
+// Modo ciclo de trabajo (1) o tarea continua cada 5 s (0)
+#define TANK_DUTY_CYCLE            1
+#define DUTY_PERIOD_S              60       // Período entre lecturas
+#define DUTY_PUBLISH_EVERY         10       // Publicar el lote cada N despertares
+#define DUTY_THRESHOLD_CM          5.0f     // ... o si el nivel cambia al menos esto
+#define DUTY_PUBLISH_TIMEOUT_MS    15000    // Máximo despierto esperando al broker
+
+// Geometría por defecto: tinaco cilíndrico vertical de ~1100 L. Se guarda en
+// NVS (namespace "tank_geom") y se puede reemplazar desde otro firmware/herramienta.
+#define TANK_SENSOR_HEIGHT_CM      150.0f   // Sensor → fondo
+#define TANK_MAX_LEVEL_CM          140.0f   // Rebose
+#define TANK_DIAMETER_CM           100.0f
+
+#define MQTT_TOPIC_LEVEL "tank_sensordata"
+#define MQTT_TOPIC_BATCH "tank_sensordata/batch"
+
+// Lote de lecturas: sobrevive al deep sleep
+static RTC_DATA_ATTR batch_state_t s_batch;
+
+static void nvs_init(void)
 {
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -30,9 +60,114 @@ void app_main(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+}
+
+// Carga la geometría del tanque (requiere NVS) para convertir distancia → litros
+static void geometry_init(void)
+{
+    const tank_geometry_cfg_t defaults = {
+        .shape = TANK_SHAPE_CYLINDER_V,
+        .sensor_height_cm = TANK_SENSOR_HEIGHT_CM,
+        .max_level_cm = TANK_MAX_LEVEL_CM,
+        .diameter_cm = TANK_DIAMETER_CM,
+    };
+    if (tank_geometry_load(0, &defaults) != ESP_OK) {
+        ESP_LOGW(TAG, "Geometría no disponible: se publica solo la distancia");
+    }
+}
+
+// Conecta, publica el lote y la última lectura. Retorna ESP_OK solo si el
+// broker confirmó el lote (si no, se conserva para el próximo intento).
+static esp_err_t duty_publish_batch(void)
+{
+    static char payload[512];
+
+    nvs_init();
+    geometry_init();
+    wifi_init_sta(DEFAULT_WIFI_SSID, DEFAULT_WIFI_PASS);
+    esp_err_t err = mqtt_init(DEFAULT_MQTT_BROKER_URI);
+
+    if (err == ESP_OK) {
+        if (batch_to_json(&s_batch, DUTY_PERIOD_S, payload, sizeof(payload)) < 0) {
+            ESP_LOGE(TAG, "Lote no cabe en el buffer");
+            err = ESP_ERR_NO_MEM;
+        } else {
+            err = mqtt_publish_wait(MQTT_TOPIC_BATCH, payload, DUTY_PUBLISH_TIMEOUT_MS);
+        }
+    }
+
+    if (err == ESP_OK) {
+        // Compatibilidad con los consumidores del modo continuo
+        float last = s_batch.samples[(s_batch.head + s_batch.count - 1) % BATCH_MAX_SAMPLES];
+        float height_cm, liters;
+        if (tank_geometry_convert(0, last, &height_cm, &liters)) {
+            snprintf(payload, sizeof(payload),
+                     "{\"level_cm\": %.2f, \"height_cm\": %.1f, \"liters\": %.1f}",
+                     last, height_cm, liters);
+        } else {
+            snprintf(payload, sizeof(payload), "{\"level_cm\": %.2f}", last);
+        }
+        mqtt_publish_wait(MQTT_TOPIC_LEVEL, payload, DUTY_PUBLISH_TIMEOUT_MS);
+    }
+
+    wifi_stop_sta();
+    return err;
+}
+
+// Un ciclo completo: lectura, decisión, publicación opcional y deep sleep.
+// No retorna.
+static void duty_cycle_run(void)
+{
+    const batch_policy_t policy = {
+        .publish_every = DUTY_PUBLISH_EVERY,
+        .threshold_cm = DUTY_THRESHOLD_CM,
+    };
+
+    if (!batch_restore(&s_batch)) {
+        ESP_LOGI(TAG, "Encendido en frío: lote RTC inicializado");
+    }
+
+    sensor_init();
+    float level = sensor_read_level_cm();
+    batch_append(&s_batch, level);
+
+    bool publish = batch_should_publish(&s_batch, &policy);
+    ESP_LOGI(TAG, "Despertar #%" PRIu32 ": nivel=%.1f cm, lote=%u, publicar=%s",
+             s_batch.wake_count, level, s_batch.count, publish ? "si" : "no");
+
+    if (publish) {
+        if (duty_publish_batch() == ESP_OK) {
+            batch_mark_published(&s_batch);
+        } else {
+            batch_mark_failed(&s_batch);
+            ESP_LOGW(TAG, "Lote no publicado (%u fallos seguidos): se reintenta en %" PRIu32 " despertares",
+                     s_batch.fail_streak, batch_retry_wakes(s_batch.fail_streak));
+        }
+    }
+
+    // Tiempo despierto desde el arranque de la app (no incluye ROM/bootloader)
+    int64_t awake_us = esp_timer_get_time();
+    batch_note_awake(&s_batch, (uint32_t)awake_us);
+    ESP_LOGI(TAG, "Despierto %" PRId64 " ms (%s)", awake_us / 1000, publish ? "con red" : "sin red");
+
+    // Descontar el tiempo despierto para mantener el período entre lecturas
+    uint64_t period_us = (uint64_t)DUTY_PERIOD_S * 1000000ULL;
+    uint64_t sleep_us = ((uint64_t)awake_us < period_us) ? period_us - (uint64_t)awake_us : period_us;
+    esp_sleep_enable_timer_wakeup(sleep_us);
+    esp_deep_sleep_start();
+}
+
+void app_main(void)
+{
+#if TANK_DUTY_CYCLE
+    duty_cycle_run();
+#else
+    nvs_init();
+    geometry_init();
 
     ESP_LOGI(TAG, "Inicializando Wi-Fi...");
     // Conectar a la red (reemplazar SSID/PASS o modificar la función para leer de config)
+    wifi_set_power_save(WIFI_PS_LISTEN_INTERVAL);
     wifi_init_sta(DEFAULT_WIFI_SSID, DEFAULT_WIFI_PASS);
 
     ESP_LOGI(TAG, "Inicializando MQTT (%s)...", DEFAULT_MQTT_BROKER_URI);
@@ -54,4 +189,5 @@ void app_main(void)
     tasks_start(xMutex);
 
     // app_main devuelve; tareas FreeRTOS continúan ejecutándose
+#endif
 }
@@ -6,10 +6,39 @@
 #include "mqtt.h"
 #include "esp_err.h"
 #include "mqtt_client.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 
 static const char *TAG = "MQTT_MODULE";
 static esp_mqtt_client_handle_t client = NULL;
 
+// Estado de conexión y confirmaciones para mqtt_publish_wait()
+static EventGroupHandle_t s_mqtt_events = NULL;
+#define MQTT_CONNECTED_BIT BIT0
+#define MQTT_PUBLISHED_BIT BIT1
+static volatile int s_last_acked_id = -1;
+
+static void on_mqtt_event(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    esp_mqtt_event_handle_t event = (esp_mqtt_event_handle_t)event_data;
+
+    switch (event_id) {
+    case MQTT_EVENT_CONNECTED:
+        xEventGroupSetBits(s_mqtt_events, MQTT_CONNECTED_BIT);
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        xEventGroupClearBits(s_mqtt_events, MQTT_CONNECTED_BIT);
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        s_last_acked_id = event->msg_id;
+        xEventGroupSetBits(s_mqtt_events, MQTT_PUBLISHED_BIT);
+        break;
+    default:
+        break;
+    }
+}
+
 esp_err_t mqtt_init(const char *broker_uri)
 {
     if (broker_uri == NULL) {
@@ -29,6 +58,12 @@ esp_err_t mqtt_init(const char *broker_uri)
         return ESP_FAIL;
     }
 
+    s_mqtt_events = xEventGroupCreate();
+    if (s_mqtt_events == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, on_mqtt_event, NULL);
+
     esp_err_t err = esp_mqtt_client_start(client);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "esp_mqtt_client_start failed: 0x%x", err);
@@ -58,3 +93,44 @@ esp_err_t mqtt_publish(const char *topic, const char *payload)
     ESP_LOGI(TAG, "Publicado id=%d topic=%s", msg_id, topic);
     return ESP_OK;
 }
+
+esp_err_t mqtt_publish_wait(const char *topic, const char *payload, uint32_t timeout_ms)
+{
+    if (client == NULL || s_mqtt_events == NULL) {
+        ESP_LOGW(TAG, "Cliente MQTT no inicializado");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (topic == NULL || payload == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    EventBits_t bits = xEventGroupWaitBits(s_mqtt_events, MQTT_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    if (!(bits & MQTT_CONNECTED_BIT)) {
+        ESP_LOGW(TAG, "Sin conexión al broker");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    xEventGroupClearBits(s_mqtt_events, MQTT_PUBLISHED_BIT);
+    int msg_id = esp_mqtt_client_publish(client, topic, payload, 0, 1, 0);
+    if (msg_id <= 0) {
+        ESP_LOGW(TAG, "Fallo publicando en %s", topic);
+        return ESP_FAIL;
+    }
+
+    // Esperar el PUBACK de este mensaje (puede llegar otro id antes)
+    while (s_last_acked_id != msg_id) {
+        int64_t remaining_us = deadline - esp_timer_get_time();
+        if (remaining_us <= 0) {
+            ESP_LOGW(TAG, "Sin PUBACK para id=%d en %s", msg_id, topic);
+            return ESP_ERR_TIMEOUT;
+        }
+        xEventGroupWaitBits(s_mqtt_events, MQTT_PUBLISHED_BIT, pdTRUE, pdTRUE,
+                            pdMS_TO_TICKS(remaining_us / 1000) + 1);
+    }
+
+    ESP_LOGI(TAG, "Confirmado id=%d topic=%s", msg_id, topic);
+    return ESP_OK;
+}
@@ -4,6 +4,7 @@
 #ifndef MQTT_H
 #define MQTT_H
 
+#include <stdint.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -17,6 +18,11 @@ esp_err_t mqtt_init(const char *broker_uri);
 // Retorna ESP_OK si la publicación fue enviada al cliente MQTT.
 esp_err_t mqtt_publish(const char *topic, const char *payload);
 
+// Publica con QoS=1 y espera el PUBACK del broker (espera también la conexión).
+// Pensado para el modo deep sleep: no se debe dormir con mensajes en vuelo.
+// Retorna ESP_ERR_TIMEOUT si no se confirmó dentro de `timeout_ms`.
+esp_err_t mqtt_publish_wait(const char *topic, const char *payload, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,12 +18,12 @@ void sensor_init(void)
 
 float sensor_read_level_cm(void)
 {
-    int d = medir_distancia();
-    if (d < 0) {
+    int32_t d_um = medir_distancia_um();
+    if (d_um < 0) {
         ESP_LOGW(TAG, "Error midiendo distancia (timeout)");
         return -1.0f;
     }
-    // Aquí se asume que el sensor devuelve la distancia desde el sensor al agua
-    // Si se requiere convertir a nivel de tanque (altura), aplicar la transformación adecuada.
-    return (float)d;
+    // Distancia desde el sensor al agua; la conversión a nivel/litros la hace
+    // tank_geometry_convert() al publicar
+    return (float)d_um / 10000.0f;
 }
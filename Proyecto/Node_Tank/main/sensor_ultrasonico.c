@@ -1,11 +1,11 @@
 // sensor_ultrasonico.c
-// Implementación del sensor HC-SR04 usando GPIO y esp_timer para medir pulsos
+// Sensor HC-SR04 del tanque sobre el driver compartido Proyecto/components/ultrasonic
 
 #include "sensor_ultrasonico.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include "esp_log.h"
-#include "driver/gpio.h"
-#include "esp_timer.h"
+#include "ultrasonic.h"
 
 // Para FreeRTOS
 #include "freertos/FreeRTOS.h"
@@ -13,73 +13,75 @@
 
 static const char *TAG = "HCSR04";
 
+// Driver compartido (Proyecto/components/ultrasonic): ISR de flancos,
+// timeouts de Kconfig y guarda entre pings, sin busy-wait
+static ultrasonic_handle_t s_us = NULL;
+
 void sensor_ultrasonico_init(void)
 {
-    // Configura TRIG como salida
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    io_conf.mode = GPIO_MODE_OUTPUT;
-    io_conf.pin_bit_mask = (1ULL << HCSR04_TRIG_GPIO);
-    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
-    gpio_config(&io_conf);
-
-    // Configura ECHO como entrada
-    io_conf = (gpio_config_t){};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << HCSR04_ECHO_GPIO);
-    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
-    gpio_config(&io_conf);
-
-    // Asegura TRIG en bajo
-    gpio_set_level(HCSR04_TRIG_GPIO, 0);
+    if (s_us != NULL) {
+        return;
+    }
+    ultrasonic_config_t cfg = ULTRASONIC_CONFIG_DEFAULT(HCSR04_TRIG_GPIO, HCSR04_ECHO_GPIO);
+    cfg.temp_dc = HCSR04_AIR_TEMP_DC;
+    esp_err_t ret = ultrasonic_create(&cfg, &s_us);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error inicializando sensor ultrasónico: %s", esp_err_to_name(ret));
+        return;
+    }
     ESP_LOGI(TAG, "Sensor ultrasónico inicializado (TRIG=%d, ECHO=%d)", HCSR04_TRIG_GPIO, HCSR04_ECHO_GPIO);
 }
 
-int medir_distancia(void)
+int32_t medir_distancia_um(void)
 {
-    const int timeout_us = 30000; // 30 ms timeout para evitar bloqueos
-
-    // Genera pulso de 10us en TRIG
-    gpio_set_level(HCSR04_TRIG_GPIO, 0);
-    esp_rom_delay_us(2);
-    gpio_set_level(HCSR04_TRIG_GPIO, 1);
-    esp_rom_delay_us(10);
-    gpio_set_level(HCSR04_TRIG_GPIO, 0);
-
-    // Espera a que ECHO suba
-    int64_t start_wait = esp_timer_get_time();
-    while (gpio_get_level(HCSR04_ECHO_GPIO) == 0) {
-        if ((esp_timer_get_time() - start_wait) > timeout_us) {
-            ESP_LOGW(TAG, "Timeout esperando ECHO alto");
-            return -1;
-        }
+    if (s_us == NULL) {
+        return -1;
     }
 
-    // Marca inicio del pulso
-    int64_t t_start = esp_timer_get_time();
-
-    // Espera a que ECHO baje
-    while (gpio_get_level(HCSR04_ECHO_GPIO) == 1) {
-        if ((esp_timer_get_time() - t_start) > timeout_us) {
-            ESP_LOGW(TAG, "Timeout esperando ECHO bajo");
-            return -1;
-        }
+    ultrasonic_reading_t r;
+    esp_err_t ret = ultrasonic_measure(s_us, &r);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Timeout esperando ECHO %s", r.rise_seen ? "bajo" : "alto");
+        return -1;
     }
 
-    int64_t t_end = esp_timer_get_time();
-    int64_t pulse_us = t_end - t_start;
+    // Distancia en µm con la velocidad del sonido a la temperatura actual
+    // (antes pulse_us / 58: velocidad fija y truncado a cm entero)
+    ESP_LOGD(TAG, "Pulse: %lu us, Distance: %lu um", (unsigned long)r.echo_us,
+             (unsigned long)r.distance_um);
+    return (int32_t)r.distance_um;
+}
 
-    // Conversión a distancia en cm (velocidad del sonido ~ 34300 cm/s)
-    // Fórmula aproximada: distance_cm = pulse_us / 58
-    int distance_cm = (int)((pulse_us) / 58);
+void sensor_ultrasonico_set_temp_dc(int16_t temp_dc)
+{
+    if (s_us != NULL && ultrasonic_set_temp_dc(s_us, temp_dc)) {
+        ESP_LOGI(TAG, "Temperatura del aire: %d.%d °C", temp_dc / 10, abs(temp_dc % 10));
+    }
+}
 
-    ESP_LOGD(TAG, "Pulse: %lld us, Distance: %d cm", pulse_us, distance_cm);
-    return distance_cm;
+void sensor_ultrasonico_print_stats(void)
+{
+    if (s_us == NULL) {
+        return;
+    }
+    ultrasonic_stats_t st;
+    ultrasonic_get_stats(s_us, &st);
+    ESP_LOGI(TAG, "pings=%lu ecos=%lu timeouts subida=%lu eco=%lu latencia prom=%lu us máx=%lu us",
+             (unsigned long)st.pings, (unsigned long)st.echoes, (unsigned long)st.rise_timeouts,
+             (unsigned long)st.echo_timeouts, (unsigned long)st.latency_avg_us,
+             (unsigned long)st.latency_max_us);
 }
 
+int medir_distancia(void)
+{
+    int32_t um = medir_distancia_um();
+    if (um < 0) {
+        return -1;
+    }
+    return (int)((um + 5000) / 10000);
+}
+
+
 // test helper (se incluyó en el original)
 void test_sensor_ultrasonico(void)
 {
@@ -102,5 +104,6 @@ void test_sensor_ultrasonico(void)
         vTaskDelay(pdMS_TO_TICKS(1000)); // espera 1 segundo entre mediciones
     }
 
+    sensor_ultrasonico_print_stats();
     ESP_LOGI(TAG, "Test del sensor ultrasónico finalizado.");
 }
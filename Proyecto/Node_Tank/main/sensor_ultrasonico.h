@@ -4,6 +4,8 @@
 #ifndef SENSOR_ULTRASONICO_H
 #define SENSOR_ULTRASONICO_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,8 +17,22 @@ extern "C" {
 // Inicializa los pines y recursos necesarios para el sensor ultrasónico
 void sensor_ultrasonico_init(void);
 
-// Mide la distancia y devuelve un entero con la distancia en centímetros.
-// Retorna -1 en caso de timeout/error.
+// Temperatura del aire por defecto para la velocidad del sonido (décimas de °C)
+#define HCSR04_AIR_TEMP_DC 200
+
+// Fija la temperatura del aire (décimas de °C); el factor de conversión solo
+// se recalcula si cambió.
+void sensor_ultrasonico_set_temp_dc(int16_t temp_dc);
+
+// Mide la distancia en micrómetros con la velocidad del sonido compensada
+// por temperatura (aritmética entera). Retorna -1 en caso de timeout/error.
+int32_t medir_distancia_um(void);
+
+// Muestra las estadísticas del driver (pings, timeouts, latencia media)
+void sensor_ultrasonico_print_stats(void);
+
+// Mide la distancia y devuelve un entero con la distancia en centímetros
+// (redondeada desde medir_distancia_um). Retorna -1 en caso de timeout/error.
 int medir_distancia(void);
 
 #ifdef __cplusplus
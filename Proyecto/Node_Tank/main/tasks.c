@@ -10,6 +10,7 @@
 #include "tasks.h"
 #include "sensor.h"
 #include "mqtt.h"
+#include "tank_geometry.h"
 
 static const char *TAG = "TASKS_MODULE";
 static const char *MQTT_TOPIC = "tank_sensordata";
@@ -24,8 +25,16 @@ static void sensor_task(void *arg)
         if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2000)) == pdTRUE) {
             float level = sensor_read_level_cm();
             if (level >= 0.0f) {
-                // Crear payload JSON simple
-                int len = snprintf(payload, sizeof(payload), "{\"level_cm\": %.2f}", level);
+                // Crear payload JSON simple (con litros si hay geometría cargada)
+                float height_cm, liters;
+                int len;
+                if (tank_geometry_convert(0, level, &height_cm, &liters)) {
+                    len = snprintf(payload, sizeof(payload),
+                                   "{\"level_cm\": %.2f, \"height_cm\": %.1f, \"liters\": %.1f}",
+                                   level, height_cm, liters);
+                } else {
+                    len = snprintf(payload, sizeof(payload), "{\"level_cm\": %.2f}", level);
+                }
                 if (len > 0 && len < (int)sizeof(payload)) {
                     esp_err_t res = mqtt_publish(MQTT_TOPIC, payload);
                     if (res != ESP_OK) {
@@ -18,6 +18,9 @@ static const char *TAG = "WIFI_MODULE";
 static EventGroupHandle_t s_wifi_event_group;
 const int WIFI_CONNECTED_BIT = BIT0;
 
+// Beacons entre despertares de la radio (0 = cada DTIM)
+static uint16_t s_listen_interval = 0;
+
 static void on_wifi_event(void* arg, esp_event_base_t event_base,
                           int32_t event_id, void* event_data)
 {
@@ -31,6 +34,11 @@ static void on_wifi_event(void* arg, esp_event_base_t event_base,
     }
 }
 
+void wifi_set_power_save(uint16_t listen_interval)
+{
+    s_listen_interval = listen_interval;
+}
+
 void wifi_init_sta(const char *ssid, const char *password)
 {
     esp_netif_init();
@@ -57,10 +65,14 @@ void wifi_init_sta(const char *ssid, const char *password)
     strncpy((char*)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid)-1);
     strncpy((char*)wifi_config.sta.password, password, sizeof(wifi_config.sta.password)-1);
     wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+    wifi_config.sta.listen_interval = s_listen_interval;
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_ERROR_CHECK(esp_wifi_set_ps(s_listen_interval ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM));
+    ESP_LOGI(TAG, "Ahorro de energía: %s (listen interval %u)",
+             s_listen_interval ? "max-modem" : "min-modem", s_listen_interval);
 
     ESP_LOGI(TAG, "Wi-Fi inicializado. Esperando conexión...");
 
@@ -68,3 +80,9 @@ void wifi_init_sta(const char *ssid, const char *password)
     xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT, pdFALSE, pdTRUE, pdMS_TO_TICKS(10000));
     ESP_LOGI(TAG, "wifi_init_sta: done");
 }
+
+void wifi_stop_sta(void)
+{
+    esp_wifi_disconnect();
+    esp_wifi_stop();
+}
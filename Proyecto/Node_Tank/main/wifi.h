@@ -4,6 +4,8 @@
 #ifndef WIFI_H
 #define WIFI_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -12,6 +14,14 @@ extern "C" {
 // Internamente inicializa esp-netif y el stack de Wi-Fi.
 void wifi_init_sta(const char *ssid, const char *password);
 
+// Ahorro de energía: con listen_interval > 0 se usa WIFI_PS_MAX_MODEM y la
+// radio despierta cada listen_interval beacons; con 0 se usa WIFI_PS_MIN_MODEM
+// (cada DTIM). Llamar antes de wifi_init_sta(): el intervalo se negocia al asociarse.
+void wifi_set_power_save(uint16_t listen_interval);
+
+// Desconecta y apaga la radio (antes de entrar en deep sleep).
+void wifi_stop_sta(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,89 @@
+#include <stddef.h>
+
+#include "adc_adaptive.h"
+#include "adc_decim.h"
+
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+bool adc_adaptive_cfg_valid(const adc_adaptive_cfg_t *cfg)
+{
+    return cfg != NULL && cfg->min_samples >= 2 && cfg->max_samples >= cfg->min_samples;
+}
+
+void adc_welford_reset(adc_welford_t *w)
+{
+    w->n = 0;
+    w->sum = 0;
+    w->mean_q16 = 0;
+    w->m2_q16 = 0;
+}
+
+void adc_welford_push(adc_welford_t *w, int32_t x)
+{
+    // Welford: no sum of squares, so no cancellation on a large mean
+    int64_t x_q16 = (int64_t)x << 16;
+    w->n++;
+    w->sum += x;
+    int64_t delta = x_q16 - w->mean_q16;
+    int64_t half = (int64_t)w->n / 2;
+    w->mean_q16 += (delta >= 0 ? delta + half : delta - half) / (int64_t)w->n;
+    w->m2_q16 += (delta * (x_q16 - w->mean_q16)) >> 16;
+}
+
+uint64_t adc_welford_var_mlsb2(const adc_welford_t *w)
+{
+    if (w->n < 2 || w->m2_q16 <= 0) {
+        return 0;
+    }
+    // LSB² · 2^16 → mLSB²: · 10^6 / 2^16 = · 15625 / 2^10
+    uint64_t var_q16 = (uint64_t)w->m2_q16 / (w->n - 1);
+    return (var_q16 * 15625) >> 10;
+}
+
+uint32_t adc_welford_sigma_mlsb(const adc_welford_t *w)
+{
+    return isqrt64(adc_welford_var_mlsb2(w));
+}
+
+uint32_t adc_welford_sem_mlsb(const adc_welford_t *w)
+{
+    return w->n > 0 ? isqrt64(adc_welford_var_mlsb2(w) / w->n) : 0;
+}
+
+bool adc_adaptive_done(const adc_adaptive_cfg_t *cfg, const adc_welford_t *w)
+{
+    if (w->n >= cfg->max_samples) {
+        return true;
+    }
+    if (w->n < cfg->min_samples) {
+        return false;
+    }
+    // σ²/n <= target², without the square root
+    uint64_t target2 = (uint64_t)cfg->target_sem_mlsb * cfg->target_sem_mlsb;
+    return adc_welford_var_mlsb2(w) <= target2 * w->n;
+}
+
+void adc_adaptive_result(const adc_welford_t *w, uint8_t extra_bits, adc_adaptive_result_t *out)
+{
+    out->value_q = adc_decim_block(w->sum, (int)w->n, extra_bits);
+    out->samples = (uint16_t)w->n;
+    out->sigma_mlsb = adc_welford_sigma_mlsb(w);
+    out->sem_mlsb = adc_welford_sem_mlsb(w);
+}
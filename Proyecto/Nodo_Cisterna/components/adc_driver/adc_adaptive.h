@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Noise-adaptive sample count.
+ *
+ * A burst keeps a running mean and variance (Welford, fixed point) and stops
+ * as soon as the standard error of the mean σ/√n reaches the target, within
+ * [min_samples, max_samples]. A quiet input stops at the minimum; a noisy
+ * probe gets more conversions instead of a fixed 20.
+ *
+ * Pure C (no ESP-IDF), tested on the host with the simulated backend.
+ */
+
+typedef struct {
+    uint16_t min_samples;        // Conversions before the noise is trusted (>= 2)
+    uint16_t max_samples;        // Hard limit even if the target is not met
+    uint16_t target_sem_mlsb;    // Standard error of the mean, thousandths of an LSB
+} adc_adaptive_cfg_t;
+
+typedef struct {
+    uint32_t n;
+    int64_t sum;                 // Exact, for the rounded fixed-point mean
+    int64_t mean_q16;            // Running mean, LSB · 2^16
+    int64_t m2_q16;              // Sum of squared deviations, LSB² · 2^16
+} adc_welford_t;
+
+/** Result of an adaptive burst */
+typedef struct {
+    int32_t value_q;             // Rounded mean, LSB · 2^extra_bits
+    uint16_t samples;            // Conversions actually used
+    uint32_t sigma_mlsb;         // Sample standard deviation
+    uint32_t sem_mlsb;           // Standard error of the returned mean
+} adc_adaptive_result_t;
+
+/** @brief false if min/max are inconsistent (min < 2, max < min) */
+bool adc_adaptive_cfg_valid(const adc_adaptive_cfg_t *cfg);
+
+void adc_welford_reset(adc_welford_t *w);
+
+/** @brief Add one conversion */
+void adc_welford_push(adc_welford_t *w, int32_t x);
+
+/** @brief Sample variance in mLSB² (0 with fewer than 2 samples) */
+uint64_t adc_welford_var_mlsb2(const adc_welford_t *w);
+
+/** @brief Sample standard deviation in mLSB */
+uint32_t adc_welford_sigma_mlsb(const adc_welford_t *w);
+
+/** @brief Standard error of the mean in mLSB */
+uint32_t adc_welford_sem_mlsb(const adc_welford_t *w);
+
+/** @brief true when the burst can stop (target reached or max_samples) */
+bool adc_adaptive_done(const adc_adaptive_cfg_t *cfg, const adc_welford_t *w);
+
+/** @brief Fill a result from the accumulator (mean rounded to extra_bits) */
+void adc_adaptive_result(const adc_welford_t *w, uint8_t extra_bits, adc_adaptive_result_t *out);
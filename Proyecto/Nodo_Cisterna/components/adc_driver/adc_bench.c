@@ -0,0 +1,36 @@
+#include "adc_driver.h"
+#include "bench.h"
+
+/* Reads go through the acquisition service: each one includes the queue
+ * round-trip to adc_acq and back, as every client pays it */
+
+static bool bench_adc_setup(void)
+{
+    return adc_default_channel() >= 0;
+}
+
+static void bench_adc_read(void)
+{
+    int32_t q;
+    adc_read_oversampled(adc_default_channel(), 1, 0, &q);
+    BENCH_KEEP(q);
+}
+BENCH_REGISTER_SETUP("adc_read", bench_adc_setup, bench_adc_read);
+
+static void bench_adc_read16(void)
+{
+    int32_t q;
+    adc_read_oversampled(adc_default_channel(), 16, 2, &q);
+    BENCH_KEEP(q);
+}
+BENCH_REGISTER_SETUP("adc_read16", bench_adc_setup, bench_adc_read16);
+
+static unsigned s_raw;
+
+/** Calibration lookup only (no conversion) */
+static void bench_adc_to_mv(void)
+{
+    s_raw = (s_raw + 97) & 4095;
+    BENCH_KEEP(adc_raw_to_mv(s_raw));
+}
+BENCH_REGISTER_SETUP("adc_to_mv", bench_adc_setup, bench_adc_to_mv);
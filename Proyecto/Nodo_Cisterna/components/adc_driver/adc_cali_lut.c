@@ -0,0 +1,49 @@
+#include <stddef.h>
+#include "adc_cali_lut.h"
+
+void adc_cali_lut_fill_linear(adc_cali_lut_t *lut, int full_scale_mv)
+{
+    for (int raw = 0; raw < ADC_CALI_LUT_SIZE; raw++) {
+        lut->mv[raw] = (uint16_t)(((int32_t)raw * full_scale_mv + (ADC_CALI_LUT_SIZE - 1) / 2) /
+                                  (ADC_CALI_LUT_SIZE - 1));
+    }
+    lut->calibrated = false;
+}
+
+bool adc_cali_lut_build(adc_cali_lut_t *lut, adc_cali_fn_t fn, void *ctx,
+                        int fallback_full_scale_mv)
+{
+    for (int raw = 0; fn != NULL && raw < ADC_CALI_LUT_SIZE; raw++) {
+        int mv = 0;
+        if (!fn(ctx, raw, &mv)) {
+            break;
+        }
+        if (mv < 0) mv = 0;
+        if (mv > UINT16_MAX) mv = UINT16_MAX;
+        lut->mv[raw] = (uint16_t)mv;
+        if (raw == ADC_CALI_LUT_SIZE - 1) {
+            lut->calibrated = true;
+            return true;
+        }
+    }
+    adc_cali_lut_fill_linear(lut, fallback_full_scale_mv);
+    return false;
+}
+
+int adc_cali_lut_raw_for_mv(const adc_cali_lut_t *lut, int mv)
+{
+    int lo = 0;
+    int hi = ADC_CALI_LUT_SIZE - 1;
+    if (lut->mv[hi] < mv) {
+        return hi;
+    }
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (lut->mv[mid] < mv) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
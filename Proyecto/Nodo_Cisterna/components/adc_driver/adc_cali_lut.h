@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Precomputed raw → mV table for one attenuation.
+ *
+ * The chip calibration (curve fitting on the eFuse coefficients) is
+ * evaluated once per code at init; every conversion afterwards is a single
+ * table load. 4096 x uint16_t = 8 KB. Pure C, tested on the host with the
+ * synthetic curve of the simulated backend (adc_sim.h).
+ */
+
+#define ADC_CALI_LUT_BITS 12
+#define ADC_CALI_LUT_SIZE (1 << ADC_CALI_LUT_BITS)
+
+typedef struct {
+    uint16_t mv[ADC_CALI_LUT_SIZE];
+    bool calibrated;             // false: nominal linear fallback (no eFuse data)
+} adc_cali_lut_t;
+
+/** Calibration source: millivolts for a raw code, false on error */
+typedef bool (*adc_cali_fn_t)(void *ctx, int raw, int *mv);
+
+/**
+ * @brief Fill the table from a calibration function
+ * @return false if the function failed; the table then holds the linear
+ *         fallback for `fallback_full_scale_mv`
+ */
+bool adc_cali_lut_build(adc_cali_lut_t *lut, adc_cali_fn_t fn, void *ctx,
+                        int fallback_full_scale_mv);
+
+/** @brief Nominal linear table: 0 → 0 mV, max code → full_scale_mv */
+void adc_cali_lut_fill_linear(adc_cali_lut_t *lut, int full_scale_mv);
+
+static inline int adc_cali_lut_mv(const adc_cali_lut_t *lut, int raw)
+{
+    if (raw < 0) raw = 0;
+    if (raw >= ADC_CALI_LUT_SIZE) raw = ADC_CALI_LUT_SIZE - 1;
+    return lut->mv[raw];
+}
+
+/**
+ * @brief Millivolts for a fixed-point raw value (raw · 2^extra_bits), linear
+ *        interpolation between the two neighbouring codes
+ */
+static inline float adc_cali_lut_mv_frac(const adc_cali_lut_t *lut, int32_t raw_q, uint8_t extra_bits)
+{
+    int32_t code = raw_q >> extra_bits;
+    if (code < 0) return lut->mv[0];
+    if (code >= ADC_CALI_LUT_SIZE - 1) return lut->mv[ADC_CALI_LUT_SIZE - 1];
+    float t = (float)(raw_q - (code << extra_bits)) / (float)(1 << extra_bits);
+    return lut->mv[code] + t * (float)(lut->mv[code + 1] - lut->mv[code]);
+}
+
+/** @brief Smallest raw code reading at least `mv` (inverse, binary search) */
+int adc_cali_lut_raw_for_mv(const adc_cali_lut_t *lut, int mv);
@@ -0,0 +1,109 @@
+#include <math.h>
+#include <string.h>
+
+#include "adc_decim.h"
+
+bool adc_decim_init(adc_decim_t *d, const adc_decim_cfg_t *cfg)
+{
+    if (d == NULL || cfg == NULL || cfg->extra_bits > ADC_DECIM_MAX_EXTRA_BITS ||
+        cfg->window == 0 || cfg->window > ADC_DECIM_MAX_WINDOW || cfg->stride > cfg->window) {
+        return false;
+    }
+    d->cfg = *cfg;
+    if (d->cfg.stride == 0) {
+        d->cfg.stride = d->cfg.window;
+    }
+    adc_decim_reset(d);
+    return true;
+}
+
+void adc_decim_reset(adc_decim_t *d)
+{
+    memset(d->ring, 0, sizeof(d->ring));
+    d->sum = 0;
+    d->head = 0;
+    d->filled = 0;
+    d->since_out = 0;
+}
+
+bool adc_decim_push(adc_decim_t *d, int raw, int32_t *out_q)
+{
+    if (raw < 0) raw = 0;
+    if (raw > UINT16_MAX) raw = UINT16_MAX;
+
+    // Moving sum: add the new sample, drop the one leaving the window
+    d->sum += raw - d->ring[d->head];
+    d->ring[d->head] = (uint16_t)raw;
+    d->head = (uint16_t)((d->head + 1) % d->cfg.window);
+    if (d->filled < d->cfg.window) {
+        d->filled++;
+    }
+    d->since_out++;
+
+    // First output once the window is full, then one every stride samples
+    if (d->filled < d->cfg.window || d->since_out < d->cfg.stride) {
+        return false;
+    }
+    d->since_out = 0;
+    if (out_q != NULL) {
+        *out_q = adc_decim_block(d->sum, d->cfg.window, d->cfg.extra_bits);
+    }
+    return true;
+}
+
+void adc_decim_cfg_for_noise(uint32_t sigma_mlsb, uint32_t floor_mlsb, adc_decim_cfg_t *cfg)
+{
+    uint32_t window = 1;
+    if (floor_mlsb > 0 && sigma_mlsb > floor_mlsb) {
+        uint64_t s2 = (uint64_t)sigma_mlsb * sigma_mlsb;
+        uint64_t f2 = (uint64_t)floor_mlsb * floor_mlsb;
+        uint64_t w = (s2 + f2 - 1) / f2;
+        window = w > ADC_DECIM_MAX_WINDOW ? ADC_DECIM_MAX_WINDOW : (uint32_t)w;
+    } else if (floor_mlsb == 0) {
+        window = ADC_DECIM_MAX_WINDOW;
+    }
+    uint8_t bits = 0;
+    while (bits < ADC_DECIM_MAX_EXTRA_BITS && (1u << (2 * (bits + 1))) <= window) {
+        bits++;
+    }
+    cfg->extra_bits = bits;
+    cfg->window = (uint16_t)window;
+    cfg->stride = (uint16_t)window;
+}
+
+void adc_noise_measure(const int32_t *v, int n, uint8_t extra_bits, adc_noise_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (v == NULL || n <= 0) {
+        return;
+    }
+    int64_t sum = 0;
+    int32_t lo = v[0];
+    int32_t hi = v[0];
+    for (int i = 0; i < n; i++) {
+        sum += v[i];
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    double mean = (double)sum / n;
+    double ss = 0.0;
+    for (int i = 0; i < n; i++) {
+        double dv = v[i] - mean;
+        ss += dv * dv;
+    }
+    double sigma_lsb = (n > 1 ? sqrt(ss / (n - 1)) : 0.0) / (double)(1 << extra_bits);
+
+    // ENOB = N − log2(σ·√12): an ideal N-bit quantizer has σ = 1/√12 LSB.
+    // A noiseless block is limited by the output resolution.
+    double enob = ADC_DECIM_INPUT_BITS + extra_bits;
+    if (sigma_lsb > 0.0) {
+        double e = ADC_DECIM_INPUT_BITS - log2(sigma_lsb * sqrt(12.0));
+        if (e < enob) {
+            enob = e;
+        }
+    }
+    out->mean_q = (int32_t)lround(mean);
+    out->p2p_q = hi - lo;
+    out->sigma_mlsb = (uint32_t)lround(sigma_lsb * 1000.0);
+    out->enob_x100 = enob > 0.0 ? (uint16_t)lround(enob * 100.0) : 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Oversampling and decimation for the 12-bit oneshot stream.
+ *
+ * A first-order CIC (moving sum) over `window` conversions, one output every
+ * `stride` new conversions. Summing 4^k samples and keeping k of the extra
+ * bits gives k more effective bits as long as the input carries at least
+ * ~0.5 LSB of noise (which the ESP32-C6 ADC always does). Outputs are fixed
+ * point: raw LSB scaled by 2^extra_bits, rounded, never truncated.
+ *
+ * Pure C (no ESP-IDF), tested on the host with the simulated backend.
+ */
+
+#define ADC_DECIM_INPUT_BITS     12
+#define ADC_DECIM_MAX_EXTRA_BITS 4
+#define ADC_DECIM_MAX_WINDOW     256
+
+typedef struct {
+    uint8_t extra_bits;          // Fractional bits of the output (0..ADC_DECIM_MAX_EXTRA_BITS)
+    uint16_t window;             // Conversions summed per output (1..ADC_DECIM_MAX_WINDOW)
+    uint16_t stride;             // Conversions between outputs (== window: integrate-and-dump)
+} adc_decim_cfg_t;
+
+typedef struct {
+    adc_decim_cfg_t cfg;
+    uint16_t ring[ADC_DECIM_MAX_WINDOW];
+    int32_t sum;
+    uint16_t head;
+    uint16_t filled;
+    uint16_t since_out;
+} adc_decim_t;
+
+/** Noise of a block of fixed-point outputs */
+typedef struct {
+    int32_t mean_q;              // Mean, same scale as the outputs
+    int32_t p2p_q;               // Peak to peak
+    uint32_t sigma_mlsb;         // Standard deviation in thousandths of an input LSB
+    uint16_t enob_x100;          // Effective bits from the measured noise
+} adc_noise_t;
+
+/**
+ * @brief Check and load a configuration (stride 0 = window)
+ * @return false if the configuration is out of range
+ */
+bool adc_decim_init(adc_decim_t *d, const adc_decim_cfg_t *cfg);
+
+/** @brief Drop the accumulated history (e.g. after switching channel) */
+void adc_decim_reset(adc_decim_t *d);
+
+/**
+ * @brief Feed one conversion
+ * @return true when an output is ready in `out_q` (raw · 2^extra_bits)
+ */
+bool adc_decim_push(adc_decim_t *d, int raw, int32_t *out_q);
+
+/** @brief Rounded mean of a burst in raw · 2^extra_bits (integrate-and-dump) */
+static inline int32_t adc_decim_block(int64_t sum, int n, uint8_t extra_bits)
+{
+    // Round half up: a plain integer average loses up to 1 LSB downwards
+    return n > 0 ? (int32_t)(((sum << extra_bits) + n / 2) / n) : 0;
+}
+
+/**
+ * @brief Smallest configuration that brings an input noise down to a floor
+ *
+ * Averaging n samples divides the noise by √n, so the window is
+ * ⌈(σ/floor)²⌉ (clamped to ADC_DECIM_MAX_WINDOW) and the extra bits are
+ * log4 of the window: the bits the averaging actually resolves.
+ */
+void adc_decim_cfg_for_noise(uint32_t sigma_mlsb, uint32_t floor_mlsb, adc_decim_cfg_t *cfg);
+
+/** @brief Measure mean, σ and ENOB of `n` outputs with `extra_bits` fraction */
+void adc_noise_measure(const int32_t *v, int n, uint8_t extra_bits, adc_noise_t *out);
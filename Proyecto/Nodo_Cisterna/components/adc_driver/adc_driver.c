@@ -2,9 +2,28 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+
+#include <inttypes.h>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "boot_prof.h"
+#include "adc_scan.h"
+#include "adc_cali_lut.h"
+#include "adc_decim.h"
+#include "adc_adaptive.h"
+#include "rawstream_uart.h"
+#if CONFIG_ADC_DRIVER_SIMULATED
+#include "adc_sim.h"
+#endif
 
 static const char *TAG = "adc_driver";
 
@@ -12,62 +31,753 @@ static const char *TAG = "adc_driver";
 #define ADC_UNIT_ID ADC_UNIT_1
 #define ADC_CHANNEL ADC_CHANNEL_0 // change as needed
 #define ADC_ATTEN ADC_ATTEN_DB_11
-#define DEFAULT_VREF 1100
+#define ADC_MAX_CHANNELS 8
+// Nominal full scale at 11/12 dB, only used when the chip has no eFuse
+// calibration (the old 1100 mV "VREF" was the 0 dB range)
+#define ADC_NOMINAL_FULL_SCALE_MV 3100
+// Code used to measure each extra channel's offset against the table
+#define ADC_CALI_REF_RAW 2048
+// Noise report: outputs per decimation setting (σ estimate from 32 points)
+#define ADC_NOISE_OUTPUTS 32
 
-static int g_adc_channel = -1;
+static int g_adc_channel = -1;      // Default channel (first configured)
+#if !CONFIG_ADC_DRIVER_SIMULATED
 static adc_oneshot_unit_handle_t adc_handle = NULL;
+#endif
+static bool g_channel_ready[ADC_MAX_CHANNELS];
+// raw -> mV for ADC_ATTEN, built once from the first channel's calibration;
+// other channels only differ by a per-channel offset
+static adc_cali_lut_t g_cali_lut;
+static bool g_cali_ready = false;
+static int16_t g_chan_offset_mv[ADC_MAX_CHANNELS];
 
-esp_err_t adc_init(int channel)
+// Acquisition service: the only task that touches the oneshot unit. Scan
+// slots and client requests (direct reads, calibration, diagnostics) are
+// served in turn, so conversions never contend and need no lock.
+#define ADC_ACQ_TASK_STACK  4096    // The noise report runs here (float logging)
+#define ADC_ACQ_TASK_PRIO   2
+#define ADC_ACQ_QUEUE_LEN   4
+#define ADC_ACQ_MAX_SUBSCRIBERS 4
+// Capture: conversions per tick while a channel is streamed continuously
+// (back to back, then the tick is yielded to lower-priority tasks)
+#define ADC_CAPTURE_BLOCK   64
+
+typedef enum {
+    ADC_REQ_BURST = 0,          // Windowed (fixed or adaptive) average of one channel
+    ADC_REQ_JOB,                // Run a function with exclusive access to the unit
+} adc_req_kind_t;
+
+// Lives on the caller's stack: the caller blocks until `done` is given
+typedef struct {
+    adc_req_kind_t kind;
+    int channel;
+    adc_adaptive_cfg_t stop;    // target_sem_mlsb = 0: exactly max_samples
+    uint8_t extra_bits;
+    adc_adaptive_result_t *res;
+    void (*job)(void *ctx);
+    void *ctx;
+    esp_err_t ret;
+    SemaphoreHandle_t done;
+} adc_request_t;
+
+static TaskHandle_t g_acq_task = NULL;
+static QueueHandle_t g_acq_queue = NULL;
+static QueueHandle_t g_acq_subs[ADC_ACQ_MAX_SUBSCRIBERS];
+static atomic_int g_capture_channel = -1;
+static struct {
+    uint32_t requests;
+    uint32_t conversions;
+    uint32_t slots_skipped;     // Slot already refreshed by a request this round
+    uint32_t events_dropped;    // Subscriber queue full
+    uint32_t captured;          // Conversions made for adc_capture_start()
+} g_acq_stats;
+
+// Scan schedule (see adc_scan.h), run by the acquisition service
+static adc_scan_t g_scan;
+static bool g_scan_ready = false;
+static uint32_t g_scan_round_ms = 0;
+static uint32_t g_scan_cost_us[ADC_SCAN_MAX_CHANNELS];   // Last burst duration per slot
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static esp_err_t port_read(int channel, int *raw)
+{
+#if CONFIG_ADC_DRIVER_SIMULATED
+    esp_err_t ret = adc_sim_read(channel, raw);
+#else
+    esp_err_t ret = adc_oneshot_read(adc_handle, (adc_channel_t)channel, raw);
+#endif
+    // Every conversion (scan, requests, noise report, capture) goes to the raw stream
+    if (ret == ESP_OK && rawstream_active()) {
+        rawstream_push(RAWSTREAM_CH_ADC(channel), *raw, esp_timer_get_time());
+    }
+    return ret;
+}
+
+#if !CONFIG_ADC_DRIVER_SIMULATED && ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+static bool hw_cali_mv(void *ctx, int raw, int *mv)
 {
-    esp_err_t ret = ESP_OK;
-    g_adc_channel = channel;
+    return adc_cali_raw_to_voltage((adc_cali_handle_t)ctx, raw, mv) == ESP_OK;
+}
 
-    adc_oneshot_unit_init_cfg_t init_cfg = {
+static adc_cali_handle_t hw_cali_create(int channel)
+{
+    adc_cali_curve_fitting_config_t cfg = {
         .unit_id = ADC_UNIT_ID,
-        .ulp_mode = ADC_ULP_MODE_DISABLE,
+        .chan = (adc_channel_t)channel,
+        .atten = ADC_ATTEN,
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
     };
-    ret = adc_oneshot_new_unit(&init_cfg, &adc_handle);
+    adc_cali_handle_t h = NULL;
+    esp_err_t ret = adc_cali_create_scheme_curve_fitting(&cfg, &h);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "adc_oneshot_new_unit failed: %s", esp_err_to_name(ret));
-        return ret;
+        ESP_LOGW(TAG, "curve fitting calibration unavailable on channel %d: %s",
+                 channel, esp_err_to_name(ret));
+        return NULL;
+    }
+    return h;
+}
+#endif
+
+/**
+ * Build the raw -> mV table on the first channel, then only measure the
+ * offset of each additional channel at ADC_CALI_REF_RAW.
+ */
+static void cali_init_channel(int channel)
+{
+    if (!g_cali_ready) {
+        int64_t t0 = esp_timer_get_time();
+#if CONFIG_ADC_DRIVER_SIMULATED
+        (void)channel;
+        adc_cali_lut_build(&g_cali_lut, adc_sim_curve_mv, NULL, ADC_NOMINAL_FULL_SCALE_MV);
+#elif ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+        adc_cali_handle_t h = hw_cali_create(channel);
+        adc_cali_lut_build(&g_cali_lut, h ? hw_cali_mv : NULL, h, ADC_NOMINAL_FULL_SCALE_MV);
+        if (h) {
+            adc_cali_delete_scheme_curve_fitting(h);
+        }
+#else
+        adc_cali_lut_fill_linear(&g_cali_lut, ADC_NOMINAL_FULL_SCALE_MV);
+#endif
+        g_cali_ready = true;
+        ESP_LOGI(TAG, "raw->mV table %s (%d..%d mV) built in %" PRId64 " us",
+                 g_cali_lut.calibrated ? "calibrated" : "NOMINAL (no eFuse calibration)",
+                 g_cali_lut.mv[0], g_cali_lut.mv[ADC_CALI_LUT_SIZE - 1],
+                 esp_timer_get_time() - t0);
+        return;
+    }
+#if !CONFIG_ADC_DRIVER_SIMULATED && ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    if (g_cali_lut.calibrated) {
+        adc_cali_handle_t h = hw_cali_create(channel);
+        int mv = 0;
+        if (h && hw_cali_mv(h, ADC_CALI_REF_RAW, &mv)) {
+            g_chan_offset_mv[channel] = (int16_t)(mv - g_cali_lut.mv[ADC_CALI_REF_RAW]);
+        }
+        if (h) {
+            adc_cali_delete_scheme_curve_fitting(h);
+        }
     }
+#endif
+}
+
+static bool channel_ready(int channel)
+{
+    return channel >= 0 && channel < ADC_MAX_CHANNELS && g_channel_ready[channel];
+}
+
+static void acq_task(void *arg);
+
+/**
+ * Run a request on the acquisition service and wait for it. Inside the
+ * service itself (a job reading the ADC) or before it exists, run inline.
+ */
+static esp_err_t acq_submit(adc_request_t *req);
 
+typedef struct {
+    int channel;
+    esp_err_t ret;
+} chan_init_ctx_t;
+
+static void chan_init_job(void *arg)
+{
+    chan_init_ctx_t *ctx = (chan_init_ctx_t *)arg;
+    ctx->ret = ESP_OK;
+#if !CONFIG_ADC_DRIVER_SIMULATED
     adc_oneshot_chan_cfg_t chan_cfg = {
         .bitwidth = ADC_BITWIDTH_DEFAULT,
         .atten = ADC_ATTEN,
     };
-    ret = adc_oneshot_config_channel(adc_handle, (adc_channel_t)g_adc_channel, &chan_cfg);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "adc_oneshot_config_channel failed: %s", esp_err_to_name(ret));
-        return ret;
+    ctx->ret = adc_oneshot_config_channel(adc_handle, (adc_channel_t)ctx->channel, &chan_cfg);
+    if (ctx->ret != ESP_OK) {
+        ESP_LOGE(TAG, "adc_oneshot_config_channel failed: %s", esp_err_to_name(ctx->ret));
+        return;
+    }
+#endif
+    cali_init_channel(ctx->channel);
+}
+
+/** Oneshot unit, channel and acquisition service setup for adc_init() */
+static esp_err_t adc_init_channel(int channel)
+{
+#if !CONFIG_ADC_DRIVER_SIMULATED
+    // One oneshot unit shared by every channel (ADC1 can only be claimed once)
+    if (adc_handle == NULL) {
+        adc_oneshot_unit_init_cfg_t init_cfg = {
+            .unit_id = ADC_UNIT_ID,
+            .ulp_mode = ADC_ULP_MODE_DISABLE,
+        };
+        esp_err_t ret = adc_oneshot_new_unit(&init_cfg, &adc_handle);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "adc_oneshot_new_unit failed: %s", esp_err_to_name(ret));
+            return ret;
+        }
     }
+#endif
 
-    // Note: esp_adc_cal not used here. Use simple linear conversion from raw to mV below.
-    ESP_LOGI(TAG, "ADC initialized (oneshot)");
+    // Channel setup also goes through the service once it runs
+    chan_init_ctx_t ctx = { .channel = channel };
+    adc_request_t req = { .kind = ADC_REQ_JOB, .job = chan_init_job, .ctx = &ctx };
+    acq_submit(&req);
+    if (ctx.ret != ESP_OK) {
+        return ctx.ret;
+    }
+
+    if (g_acq_task == NULL) {
+        if (!g_scan_ready) {
+            adc_scan_init(&g_scan);
+            g_scan_ready = true;
+        }
+        g_acq_queue = xQueueCreate(ADC_ACQ_QUEUE_LEN, sizeof(adc_request_t *));
+        if (g_acq_queue == NULL ||
+            xTaskCreate(acq_task, "adc_acq", ADC_ACQ_TASK_STACK, NULL,
+                        ADC_ACQ_TASK_PRIO, &g_acq_task) != pdPASS) {
+            ESP_LOGE(TAG, "acquisition service: out of memory");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    g_channel_ready[channel] = true;
+    if (g_adc_channel < 0) {
+        g_adc_channel = channel;
+    }
+    ESP_LOGI(TAG, "ADC channel %d initialized (oneshot)", channel);
     return ESP_OK;
 }
 
+esp_err_t adc_init(int channel)
+{
+    if (channel < 0 || channel >= ADC_MAX_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_channel_ready[channel]) {
+        return ESP_OK;
+    }
+    // The profile entry is closed on every path, failures included
+    int prof = boot_prof_begin("adc");
+    esp_err_t ret = adc_init_channel(channel);
+    boot_prof_end(prof);
+    return ret;
+}
+
+int adc_default_channel(void)
+{
+    return g_adc_channel;
+}
+
 int adc_read_raw(int samples)
 {
-    if (samples <= 0) samples = 10;
-    long sum = 0;
-    for (int i = 0; i < samples; ++i) {
+    return adc_read_raw_channel(g_adc_channel, samples);
+}
+
+/**
+ * Convert until `stop` is met. Failed conversions count against
+ * max_samples so a dead channel cannot spin. Service task only.
+ */
+static int acquire(int channel, const adc_adaptive_cfg_t *stop, adc_welford_t *w, int32_t *buf)
+{
+    adc_welford_reset(w);
+    int failed = 0;
+    esp_err_t last_err = ESP_OK;
+    while (w->n + failed < stop->max_samples) {
         int raw = 0;
-        esp_err_t r = adc_oneshot_read(adc_handle, (adc_channel_t)g_adc_channel, &raw);
+        esp_err_t r = port_read(channel, &raw);
         if (r != ESP_OK) {
-            ESP_LOGW(TAG, "adc_oneshot_read failed: %s", esp_err_to_name(r));
+            failed++;
+            last_err = r;
+            continue;
+        }
+        if (buf != NULL) {
+            buf[w->n] = raw;
+        }
+        adc_welford_push(w, raw);
+        g_acq_stats.conversions++;
+        // Noise target: stop once the mean is good enough
+        if (stop->target_sem_mlsb > 0 && adc_adaptive_done(stop, w)) {
+            break;
+        }
+    }
+    if (failed > 0) {
+        ESP_LOGW(TAG, "adc_oneshot_read failed %d times on channel %d: %s", failed, channel,
+                 esp_err_to_name(last_err));
+    }
+    return (int)w->n;
+}
+
+/** Hand a published value to the subscribers (never blocks the service) */
+static void acq_notify(int slot)
+{
+    adc_scan_event_t ev = { .channel = g_scan.cfg[slot].channel };
+    if (!adc_scan_latest(&g_scan, slot, &ev.v)) {
+        return;
+    }
+    for (int i = 0; i < ADC_ACQ_MAX_SUBSCRIBERS; i++) {
+        if (g_acq_subs[i] != NULL && xQueueSend(g_acq_subs[i], &ev, 0) != pdTRUE) {
+            g_acq_stats.events_dropped++;
+        }
+    }
+}
+
+static void acq_serve(adc_request_t *req)
+{
+    if (req->kind == ADC_REQ_JOB) {
+        req->job(req->ctx);
+        req->ret = ESP_OK;
+        return;
+    }
+    g_acq_stats.requests++;
+    adc_welford_t w;
+    if (acquire(req->channel, &req->stop, &w, NULL) == 0) {
+        req->ret = ESP_FAIL;
+        return;
+    }
+    adc_adaptive_result(&w, req->extra_bits, req->res);
+    req->ret = ESP_OK;
+
+    // A scanned channel gets the fresh burst too: the next slot is skipped
+    // instead of converting the same input again
+    int slot = g_scan_ready ? adc_scan_find(&g_scan, req->channel) : -1;
+    if (slot >= 0 && g_scan.cfg[slot].reduce == ADC_SCAN_REDUCE_MEAN &&
+        g_scan.cfg[slot].extra_bits == req->extra_bits) {
+        uint8_t n = req->res->samples > UINT8_MAX ? UINT8_MAX : (uint8_t)req->res->samples;
+        adc_scan_publish(&g_scan, slot, req->res->value_q, n, now_ms());
+        acq_notify(slot);
+    }
+}
+
+static esp_err_t acq_submit(adc_request_t *req)
+{
+    if (g_acq_task == NULL || xTaskGetCurrentTaskHandle() == g_acq_task) {
+        acq_serve(req);
+        return req->ret;
+    }
+    StaticSemaphore_t done_buf;
+    req->done = xSemaphoreCreateBinaryStatic(&done_buf);
+    adc_request_t *p = req;
+    xQueueSend(g_acq_queue, &p, portMAX_DELAY);
+    // Every request is answered after a bounded burst: no timeout, so the
+    // service never writes into a stack frame that has gone away
+    xSemaphoreTake(req->done, portMAX_DELAY);
+    vSemaphoreDelete(req->done);
+    return req->ret;
+}
+
+/** Burst request on behalf of a client task */
+static esp_err_t acq_read(int channel, const adc_adaptive_cfg_t *stop, uint8_t extra_bits,
+                          adc_adaptive_result_t *out)
+{
+    if (channel < 0) {
+        channel = g_adc_channel;
+    }
+    if (!channel_ready(channel)) {
+        ESP_LOGW(TAG, "ADC channel %d not initialized", channel);
+        return ESP_ERR_INVALID_STATE;
+    }
+    adc_request_t req = {
+        .kind = ADC_REQ_BURST,
+        .channel = channel,
+        .stop = *stop,
+        .extra_bits = extra_bits,
+        .res = out,
+    };
+    esp_err_t ret = acq_submit(&req);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "read: no valid conversions on channel %d", channel);
+    }
+    return ret;
+}
+
+int adc_read_raw_channel(int channel, int samples)
+{
+    int32_t raw = 0;
+    adc_read_oversampled(channel, samples > 0 ? samples : 10, 0, &raw);
+    return (int)raw;
+}
+
+esp_err_t adc_read_oversampled(int channel, int samples, uint8_t extra_bits, int32_t *out_q)
+{
+    if (samples <= 0 || samples > UINT16_MAX || extra_bits > ADC_DECIM_MAX_EXTRA_BITS ||
+        out_q == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const adc_adaptive_cfg_t stop = { .min_samples = samples, .max_samples = samples };
+    adc_adaptive_result_t res = {0};
+    esp_err_t ret = acq_read(channel, &stop, extra_bits, &res);
+    *out_q = res.value_q;
+    return ret;
+}
+
+esp_err_t adc_read_adaptive(int channel, const adc_adaptive_cfg_t *cfg, uint8_t extra_bits,
+                            adc_adaptive_result_t *out)
+{
+    if (!adc_adaptive_cfg_valid(cfg) || extra_bits > ADC_DECIM_MAX_EXTRA_BITS || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return acq_read(channel, cfg, extra_bits, out);
+}
+
+/** One scan slot: skipped if a client request already refreshed it this round */
+static void scan_step(void)
+{
+    int32_t buf[ADC_SCAN_MAX_SAMPLES];
+    int slot = adc_scan_next(&g_scan);
+    if (slot < 0) {
+        return;
+    }
+    const adc_scan_channel_cfg_t *cfg = &g_scan.cfg[slot];
+    adc_scan_value_t last;
+    if (adc_scan_latest(&g_scan, slot, &last) && now_ms() - last.t_ms < g_scan_round_ms / 2) {
+        g_acq_stats.slots_skipped++;
+        return;
+    }
+    const adc_adaptive_cfg_t stop = {
+        .min_samples = cfg->min_samples,
+        .max_samples = cfg->samples,
+        .target_sem_mlsb = cfg->target_sem_mlsb,
+    };
+    adc_welford_t w;
+    int64_t t0 = esp_timer_get_time();
+    int n = acquire(cfg->channel, &stop, &w, buf);
+    g_scan_cost_us[slot] = (uint32_t)(esp_timer_get_time() - t0);
+    if (n > 0) {
+        adc_scan_publish(&g_scan, slot, adc_scan_reduce(cfg, buf, n), (uint8_t)n, now_ms());
+        acq_notify(slot);
+    } else {
+        ESP_LOGW(TAG, "scan: no valid conversions on channel %d", cfg->channel);
+    }
+}
+
+/** Continuous capture: one block per idle tick, each conversion tapped by port_read() */
+static void capture_block(int channel)
+{
+    for (int i = 0; i < ADC_CAPTURE_BLOCK; i++) {
+        int raw = 0;
+        if (port_read(channel, &raw) != ESP_OK) {
+            return;
+        }
+        g_acq_stats.conversions++;
+        g_acq_stats.captured++;
+    }
+}
+
+/**
+ * Acquisition service: waits on the request queue until the next scan
+ * slot is due. Slots are spread evenly over the round so conversions never
+ * bunch up; requests are served as they arrive, between slots. Only this
+ * task converts and writes the latest-value table.
+ */
+static void acq_task(void *arg)
+{
+    (void)arg;
+    int64_t next_slot_us = esp_timer_get_time();
+    while (1) {
+        int count = atomic_load(&g_scan.count);
+        bool scanning = g_scan_round_ms > 0 && count > 0;
+        TickType_t wait = portMAX_DELAY;
+        if (scanning) {
+            int64_t left_us = next_slot_us - esp_timer_get_time();
+            if (left_us <= 0) {
+                // A due slot goes first: a stream of requests cannot starve the scan
+                scan_step();
+                next_slot_us = esp_timer_get_time() + (int64_t)g_scan_round_ms * 1000 / count;
+                continue;
+            }
+            // Round up: a wait of 0 ticks would spin on the queue until the slot
+            const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+            wait = (TickType_t)((left_us + tick_us - 1) / tick_us);
+        }
+        int capture = atomic_load(&g_capture_channel);
+        if (capture >= 0 && wait > 1) {
+            wait = 1;
+        }
+        adc_request_t *req = NULL;
+        if (xQueueReceive(g_acq_queue, &req, wait) == pdTRUE) {
+            acq_serve(req);
+            xSemaphoreGive(req->done);
+        } else if (capture >= 0) {
+            capture_block(capture);
+        }
+    }
+}
+
+esp_err_t adc_scan_add_channel(const adc_scan_channel_cfg_t *cfg)
+{
+    if (cfg == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!g_scan_ready) {
+        adc_scan_init(&g_scan);
+        g_scan_ready = true;
+    }
+    if (adc_scan_find(&g_scan, cfg->channel) >= 0) {
+        return ESP_OK;
+    }
+    esp_err_t ret = adc_init(cfg->channel);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (adc_scan_add(&g_scan, cfg) < 0) {
+        ESP_LOGE(TAG, "scan: cannot add channel %d (%s)", cfg->channel,
+                 cfg->name ? cfg->name : "?");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cfg->target_sem_mlsb > 0) {
+        ESP_LOGI(TAG, "scan: channel %d '%s' (%u..%u samples to SEM %u mLSB, %s +%u bits, ema 1/%d)",
+                 cfg->channel, cfg->name ? cfg->name : "?", cfg->min_samples, cfg->samples,
+                 cfg->target_sem_mlsb, cfg->reduce == ADC_SCAN_REDUCE_MEDIAN ? "median" : "mean",
+                 cfg->extra_bits, 1 << cfg->ema_shift);
+    } else {
+        ESP_LOGI(TAG, "scan: channel %d '%s' (%u samples, %s +%u bits, ema 1/%d)", cfg->channel,
+                 cfg->name ? cfg->name : "?", cfg->samples,
+                 cfg->reduce == ADC_SCAN_REDUCE_MEDIAN ? "median" : "mean", cfg->extra_bits,
+                 1 << cfg->ema_shift);
+    }
+    return ESP_OK;
+}
+
+static void scan_round_job(void *arg)
+{
+    g_scan_round_ms = *(const uint32_t *)arg;
+}
+
+esp_err_t adc_scan_start(uint32_t round_ms)
+{
+    if (round_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_acq_task == NULL) {
+        return ESP_ERR_INVALID_STATE;   // No channel configured yet
+    }
+    bool started = g_scan_round_ms == 0;
+    // Set from the service so an idle one wakes up and schedules the first slot
+    adc_request_t req = { .kind = ADC_REQ_JOB, .job = scan_round_job, .ctx = &round_ms };
+    acq_submit(&req);
+    if (started) {
+        ESP_LOGI(TAG, "scan: started, round %" PRIu32 " ms", round_ms);
+    }
+    return ESP_OK;
+}
+
+esp_err_t adc_scan_subscribe(QueueHandle_t queue)
+{
+    if (queue == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < ADC_ACQ_MAX_SUBSCRIBERS; i++) {
+        if (g_acq_subs[i] == queue) {
+            return ESP_OK;
+        }
+    }
+    for (int i = 0; i < ADC_ACQ_MAX_SUBSCRIBERS; i++) {
+        if (g_acq_subs[i] == NULL) {
+            g_acq_subs[i] = queue;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t adc_scan_unsubscribe(QueueHandle_t queue)
+{
+    for (int i = 0; i < ADC_ACQ_MAX_SUBSCRIBERS; i++) {
+        if (g_acq_subs[i] == queue) {
+            g_acq_subs[i] = NULL;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t adc_capture_start(int channel)
+{
+    if (!channel_ready(channel)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    atomic_store(&g_capture_channel, channel);
+    ESP_LOGI(TAG, "capture: channel %d, %d conversions per tick", channel, ADC_CAPTURE_BLOCK);
+    return ESP_OK;
+}
+
+void adc_capture_stop(void)
+{
+    atomic_store(&g_capture_channel, -1);
+}
+
+bool adc_read_latest(int channel, uint32_t max_age_ms, adc_scan_value_t *out)
+{
+    if (!g_scan_ready || g_scan_round_ms == 0 || out == NULL) {
+        return false;
+    }
+    if (!adc_scan_latest(&g_scan, adc_scan_find(&g_scan, channel), out)) {
+        return false;
+    }
+    return max_age_ms == 0 || (now_ms() - out->t_ms) <= max_age_ms;
+}
+
+void adc_scan_print(void)
+{
+    ESP_LOGI(TAG, "acquisition: %" PRIu32 " requests, %" PRIu32 " conversions (%" PRIu32
+             " captured), %" PRIu32 " slots skipped (fresh), %" PRIu32 " events dropped",
+             g_acq_stats.requests, g_acq_stats.conversions, g_acq_stats.captured,
+             g_acq_stats.slots_skipped, g_acq_stats.events_dropped);
+    if (!g_scan_ready) {
+        ESP_LOGI(TAG, "scan: no channels");
+        return;
+    }
+    uint32_t t = now_ms();
+    int count = atomic_load(&g_scan.count);
+    ESP_LOGI(TAG, "=== ADC SCAN (%d channels, round %" PRIu32 " ms, %" PRIu32 " rounds) ===",
+             count, g_scan_round_ms, g_scan.rounds);
+    for (int i = 0; i < count; i++) {
+        const adc_scan_channel_cfg_t *cfg = &g_scan.cfg[i];
+        adc_scan_value_t v;
+        if (!adc_scan_latest(&g_scan, i, &v)) {
+            ESP_LOGI(TAG, "ch%d %-8s (no data yet)", cfg->channel, cfg->name ? cfg->name : "?");
             continue;
         }
-        sum += raw;
+        float scale = (float)(1 << cfg->extra_bits);
+        ESP_LOGI(TAG, "ch%d %-8s raw=%.2f value=%.2f age=%" PRIu32
+                 " ms | %u/%u samples %s +%u bits, %" PRIu32 " us | %" PRIu32 " updates",
+                 cfg->channel, cfg->name ? cfg->name : "?", v.raw / scale, v.value / scale,
+                 t - v.t_ms, v.samples, cfg->samples,
+                 cfg->reduce == ADC_SCAN_REDUCE_MEDIAN ? "median" : "mean", cfg->extra_bits,
+                 g_scan_cost_us[i], v.updates);
     }
-    int avg = (int)(sum / samples);
-    return avg;
+}
+
+int adc_raw_to_mv(int raw)
+{
+    return adc_raw_to_mv_channel(g_adc_channel, raw);
+}
+
+int adc_raw_to_mv_channel(int channel, int raw)
+{
+    int offset = (channel >= 0 && channel < ADC_MAX_CHANNELS) ? g_chan_offset_mv[channel] : 0;
+    int mv = adc_cali_lut_mv(&g_cali_lut, raw) + offset;
+    return mv > 0 ? mv : 0;
+}
+
+bool adc_is_calibrated(void)
+{
+    return g_cali_ready && g_cali_lut.calibrated;
+}
+
+float adc_raw_q_to_mv_channel(int channel, int32_t raw_q, uint8_t extra_bits)
+{
+    int offset = (channel >= 0 && channel < ADC_MAX_CHANNELS) ? g_chan_offset_mv[channel] : 0;
+    float mv = adc_cali_lut_mv_frac(&g_cali_lut, raw_q, extra_bits) + (float)offset;
+    return mv > 0.0f ? mv : 0.0f;
 }
 
 float adc_read_voltage(int samples)
 {
     if (samples <= 0) samples = 10;
-    int raw = adc_read_raw(samples);
-    uint32_t voltage = (uint32_t)((raw / 4095.0f) * DEFAULT_VREF);
-    return (float)voltage; // millivolts
+    // Keep the bits the average resolves: log4(samples)
+    uint8_t bits = 0;
+    while (bits < ADC_DECIM_MAX_EXTRA_BITS && (1 << (2 * (bits + 1))) <= samples) {
+        bits++;
+    }
+    int32_t raw_q = 0;
+    if (adc_read_oversampled(g_adc_channel, samples, bits, &raw_q) != ESP_OK) {
+        return 0.0f;
+    }
+    return adc_raw_q_to_mv_channel(g_adc_channel, raw_q, bits); // millivolts
+}
+
+typedef struct {
+    int channel;
+    uint32_t floor_mlsb;
+} noise_ctx_t;
+
+/** Noise report body: runs on the acquisition service (the scan waits) */
+static void noise_job(void *arg)
+{
+    static const uint16_t windows[] = { 1, 4, 16, 64, 256 };
+    static adc_decim_t decim;              // 0.5 KB of history: keep it off the stack
+    const noise_ctx_t *ctx = (const noise_ctx_t *)arg;
+    int32_t out[ADC_NOISE_OUTPUTS];
+
+    ESP_LOGI(TAG, "=== ADC NOISE ch%d (%d outputs per row, floor %" PRIu32 " mLSB) ===",
+             ctx->channel, ADC_NOISE_OUTPUTS, ctx->floor_mlsb);
+
+    uint32_t sigma1_mlsb = 0;
+    for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        adc_decim_cfg_t cfg = { .window = windows[w], .stride = windows[w] };
+        while (cfg.extra_bits < ADC_DECIM_MAX_EXTRA_BITS &&
+               (1u << (2 * (cfg.extra_bits + 1))) <= cfg.window) {
+            cfg.extra_bits++;
+        }
+        adc_decim_init(&decim, &cfg);
+
+        int n = 0;
+        uint32_t conversions = 0;
+        int64_t t0 = esp_timer_get_time();
+        while (n < ADC_NOISE_OUTPUTS) {
+            int raw = 0;
+            if (port_read(ctx->channel, &raw) != ESP_OK) {
+                ESP_LOGW(TAG, "noise: conversion failed on channel %d", ctx->channel);
+                return;
+            }
+            conversions++;
+            if (adc_decim_push(&decim, raw, &out[n])) {
+                n++;
+            }
+        }
+        int64_t conv_us = esp_timer_get_time() - t0;
+        g_acq_stats.conversions += conversions;
+
+        adc_noise_t noise;
+        adc_noise_measure(out, n, cfg.extra_bits, &noise);
+        if (cfg.window == 1) {
+            sigma1_mlsb = noise.sigma_mlsb;
+        }
+        uint32_t out_hz = conv_us > 0 ?
+            (uint32_t)((int64_t)conversions * 1000000 / conv_us / cfg.stride) : 0;
+        ESP_LOGI(TAG, "window %3u +%u bits | mean=%.3f LSB sigma=%" PRIu32 " mLSB p2p=%.2f LSB"
+                 " | ENOB %u.%02u | %" PRIu32 " Hz",
+                 cfg.window, cfg.extra_bits, (double)noise.mean_q / (1 << cfg.extra_bits),
+                 noise.sigma_mlsb, (double)noise.p2p_q / (1 << cfg.extra_bits),
+                 noise.enob_x100 / 100, noise.enob_x100 % 100, out_hz);
+    }
+
+    adc_decim_cfg_t rec;
+    adc_decim_cfg_for_noise(sigma1_mlsb, ctx->floor_mlsb, &rec);
+    ESP_LOGI(TAG, "floor %" PRIu32 " mLSB -> window %u, +%u bits", ctx->floor_mlsb, rec.window,
+             rec.extra_bits);
+}
+
+void adc_noise_report(int channel, uint32_t floor_mlsb)
+{
+    if (channel < 0) {
+        channel = g_adc_channel;
+    }
+    if (!channel_ready(channel)) {
+        ESP_LOGW(TAG, "noise: ADC channel %d not initialized", channel);
+        return;
+    }
+    noise_ctx_t ctx = { .channel = channel, .floor_mlsb = floor_mlsb };
+    adc_request_t req = { .kind = ADC_REQ_JOB, .job = noise_job, .ctx = &ctx };
+    acq_submit(&req);
 }
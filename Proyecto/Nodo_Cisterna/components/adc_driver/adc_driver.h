@@ -2,13 +2,132 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "adc_scan.h"
+#include "adc_adaptive.h"
 
+/**
+ * ADC acquisition service.
+ *
+ * One task owns the oneshot unit: it runs the background scan and serves
+ * every other read (adc_read_*, calibration, noise report) from a request
+ * queue, between scan slots. Callers block until their burst is done, so
+ * the API is unchanged, but two tasks can no longer interleave conversions
+ * or write the same result. A request on a scanned channel also refreshes
+ * its slot, and the scan skips that slot for the rest of the round.
+ */
+
+/** Scan result pushed to subscribers (adc_scan_subscribe) */
+typedef struct {
+    int channel;
+    adc_scan_value_t v;
+} adc_scan_event_t;
+
+/**
+ * Configure an ADC1 channel. The oneshot unit and the acquisition service
+ * are created on the first call; later calls only add channels (calling
+ * twice with the same channel is a no-op). The first channel configured is
+ * the default for adc_read_raw().
+ */
 esp_err_t adc_init(int channel);
+
+/** Default channel for adc_read_raw(), -1 before adc_init() */
+int adc_default_channel(void);
+
 /**
  * Read averaged raw ADC value (0..4095 or hardware-dependent).
  * samples: number of samples to average
  */
 int adc_read_raw(int samples);
 
-/** Read measured voltage in millivolts (averaged). samples: number of samples */
+/** Same as adc_read_raw() on a specific channel (must be configured with adc_init) */
+int adc_read_raw_channel(int channel, int samples);
+
+/**
+ * Oversampled read: the rounded mean of `samples` conversions in
+ * raw · 2^extra_bits. Averaging 4^k samples resolves k extra bits, so
+ * e.g. 16 samples with extra_bits = 2 give a 14-bit result.
+ * channel < 0: default channel (as adc_read_raw()).
+ */
+esp_err_t adc_read_oversampled(int channel, int samples, uint8_t extra_bits, int32_t *out_q);
+
+/**
+ * Read measured voltage in millivolts (averaged). samples: number of samples;
+ * the extra bits of the average are kept through the calibration table.
+ */
 float adc_read_voltage(int samples);
+
+/**
+ * Convert a raw reading to millivolts on the default channel: one load from
+ * the table built at init with the chip's curve-fitting calibration.
+ */
+int adc_raw_to_mv(int raw);
+
+/** Same as adc_raw_to_mv() with the channel's calibration offset */
+int adc_raw_to_mv_channel(int channel, int raw);
+
+/**
+ * Noise-adaptive read: convert until the standard error of the mean reaches
+ * cfg->target_sem_mlsb (at least min_samples, at most max_samples). The
+ * result carries the mean in raw · 2^extra_bits and the count used.
+ * channel < 0: default channel.
+ */
+esp_err_t adc_read_adaptive(int channel, const adc_adaptive_cfg_t *cfg, uint8_t extra_bits,
+                            adc_adaptive_result_t *out);
+
+/** Millivolts for a fixed-point raw value, interpolating the table */
+float adc_raw_q_to_mv_channel(int channel, int32_t raw_q, uint8_t extra_bits);
+
+/** true if the table comes from eFuse calibration (false: nominal linear) */
+bool adc_is_calibrated(void);
+
+/**
+ * Add a channel to the background scan (configures it with adc_init()).
+ * Adding an already scanned channel is a no-op; channels can be added
+ * before or after adc_scan_start().
+ */
+esp_err_t adc_scan_add_channel(const adc_scan_channel_cfg_t *cfg);
+
+/**
+ * Start (or retime) the scan. Every channel is sampled once per round,
+ * slots evenly spaced; results land in a lock-free latest-value table.
+ * ESP_ERR_INVALID_STATE if no channel was configured yet.
+ */
+esp_err_t adc_scan_start(uint32_t round_ms);
+
+/**
+ * Receive every published scan value as an adc_scan_event_t. The service
+ * never blocks on the queue: when it is full the event is dropped and
+ * counted (see adc_scan_print). Up to 4 queues.
+ */
+esp_err_t adc_scan_subscribe(QueueHandle_t queue);
+esp_err_t adc_scan_unsubscribe(QueueHandle_t queue);
+
+/**
+ * Latest scanned value of a channel without touching the ADC.
+ * Returns false if the channel is not scanned, has no data yet or the value
+ * is older than max_age_ms (0 = any age); callers then fall back to
+ * adc_read_raw_channel().
+ */
+bool adc_read_latest(int channel, uint32_t max_age_ms, adc_scan_value_t *out);
+
+/**
+ * Convert `channel` continuously whenever the service is idle (blocks of
+ * back-to-back conversions, one per tick) so the raw stream (rawstream)
+ * carries it at kHz. Scan slots and requests keep priority.
+ */
+esp_err_t adc_capture_start(int channel);
+void adc_capture_stop(void);
+
+/** Print the service counters and the scan table (value, age, burst cost per channel) */
+void adc_scan_print(void);
+
+/**
+ * Measure the noise of a channel through the decimator at windows
+ * 1/4/16/64/256: mean, σ, ENOB and output rate per window, then the window
+ * that reaches `floor_mlsb` (thousandths of an LSB). channel < 0: default.
+ * Runs on the acquisition service: the caller and the scan wait for the
+ * conversions (~10k at the widest window).
+ */
+void adc_noise_report(int channel, uint32_t floor_mlsb);
@@ -0,0 +1,131 @@
+#include <string.h>
+
+#include "adc_scan.h"
+
+void adc_scan_init(adc_scan_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    atomic_init(&s->count, 0);
+    for (int i = 0; i < ADC_SCAN_MAX_CHANNELS; i++) {
+        atomic_init(&s->slot[i].seq, 0);
+    }
+}
+
+int adc_scan_find(const adc_scan_t *s, int channel)
+{
+    int n = atomic_load_explicit(&((adc_scan_t *)s)->count, memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        if (s->cfg[i].channel == channel) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int adc_scan_add(adc_scan_t *s, const adc_scan_channel_cfg_t *cfg)
+{
+    if (cfg == NULL || cfg->channel < 0 || cfg->samples == 0 ||
+        cfg->samples > ADC_SCAN_MAX_SAMPLES || cfg->ema_shift > 8 ||
+        cfg->extra_bits > ADC_DECIM_MAX_EXTRA_BITS) {
+        return -1;
+    }
+    if (cfg->target_sem_mlsb > 0 && (cfg->min_samples < 2 || cfg->min_samples > cfg->samples)) {
+        return -1;
+    }
+    int n = atomic_load_explicit(&s->count, memory_order_relaxed);
+    if (n >= ADC_SCAN_MAX_CHANNELS || adc_scan_find(s, cfg->channel) >= 0) {
+        return -1;
+    }
+    s->cfg[n] = *cfg;
+    memset(&s->slot[n].v, 0, sizeof(s->slot[n].v));
+    s->slot[n].ema_q8 = 0;
+    // The scan task only sees the slot once its config is complete
+    atomic_store_explicit(&s->count, n + 1, memory_order_release);
+    return n;
+}
+
+int adc_scan_next(adc_scan_t *s)
+{
+    int n = atomic_load_explicit(&s->count, memory_order_acquire);
+    if (n == 0) {
+        return -1;
+    }
+    if (s->next >= n) {
+        s->next = 0;
+    }
+    int slot = s->next++;
+    if (s->next >= n) {
+        s->next = 0;
+        s->rounds++;
+    }
+    return slot;
+}
+
+int32_t adc_scan_reduce(const adc_scan_channel_cfg_t *cfg, int32_t *samples, int n)
+{
+    if (n <= 0) {
+        return 0;
+    }
+    if (cfg->reduce == ADC_SCAN_REDUCE_MEDIAN) {
+        // Insertion sort: n <= ADC_SCAN_MAX_SAMPLES
+        for (int i = 1; i < n; i++) {
+            int32_t v = samples[i];
+            int j = i - 1;
+            while (j >= 0 && samples[j] > v) {
+                samples[j + 1] = samples[j];
+                j--;
+            }
+            samples[j + 1] = v;
+        }
+        int64_t mid = (n & 1) ? (int64_t)samples[n / 2] * 2 : (int64_t)samples[n / 2 - 1] + samples[n / 2];
+        return adc_decim_block(mid, 2, cfg->extra_bits);
+    }
+    int64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    return adc_decim_block(sum, n, cfg->extra_bits);
+}
+
+void adc_scan_publish(adc_scan_t *s, int slot, int32_t raw, uint8_t samples, uint32_t t_ms)
+{
+    adc_scan_slot_t *sl = &s->slot[slot];
+    uint8_t shift = s->cfg[slot].ema_shift;
+
+    // EMA in Q8: the first scan seeds the filter
+    int32_t value = raw;
+    if (shift > 0) {
+        if (sl->v.updates == 0) {
+            sl->ema_q8 = raw * 256;
+        } else {
+            sl->ema_q8 += (raw * 256 - sl->ema_q8) >> shift;
+        }
+        value = (sl->ema_q8 + 128) / 256;
+    }
+
+    unsigned seq = atomic_load_explicit(&sl->seq, memory_order_relaxed);
+    atomic_store_explicit(&sl->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    sl->v.raw = raw;
+    sl->v.value = value;
+    sl->v.t_ms = t_ms;
+    sl->v.updates++;
+    sl->v.samples = samples;
+    atomic_store_explicit(&sl->seq, seq + 2, memory_order_release);
+}
+
+bool adc_scan_latest(adc_scan_t *s, int slot, adc_scan_value_t *out)
+{
+    if (slot < 0 || slot >= atomic_load_explicit(&s->count, memory_order_acquire)) {
+        return false;
+    }
+    adc_scan_slot_t *sl = &s->slot[slot];
+    unsigned before, after;
+    do {
+        before = atomic_load_explicit(&sl->seq, memory_order_acquire);
+        *out = sl->v;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&sl->seq, memory_order_relaxed);
+    } while ((before & 1u) || before != after);
+    return out->updates > 0;
+}
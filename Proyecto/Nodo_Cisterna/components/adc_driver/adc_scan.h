@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "adc_decim.h"
+
+/**
+ * Round-robin ADC scan schedule and lock-free latest-value table.
+ *
+ * Pure C (no ESP-IDF): adc_driver.c owns the hardware and the scan task,
+ * this file decides which channel comes next, reduces the samples and
+ * publishes the result. Each slot is a seqlock: the scan task is the only
+ * writer, readers retry if they raced with an update and never block it.
+ */
+
+#define ADC_SCAN_MAX_CHANNELS 8
+#define ADC_SCAN_MAX_SAMPLES  32
+
+typedef enum {
+    ADC_SCAN_REDUCE_MEAN = 0,    // Average of the burst
+    ADC_SCAN_REDUCE_MEDIAN,      // Median of the burst (rejects spikes)
+} adc_scan_reduce_t;
+
+typedef struct {
+    const char *name;
+    int channel;
+    uint8_t samples;             // Conversions per scan slot (1..ADC_SCAN_MAX_SAMPLES);
+                                 // with a noise target, the maximum
+    adc_scan_reduce_t reduce;
+    uint8_t ema_shift;           // Smoothing alpha = 1/2^shift across scans (0 = none)
+    uint8_t extra_bits;          // Fixed-point fraction of the result (0..ADC_DECIM_MAX_EXTRA_BITS)
+    uint16_t target_sem_mlsb;    // Stop the burst at this standard error (0 = fixed count),
+    uint8_t min_samples;         // but not before min_samples (see adc_adaptive.h)
+} adc_scan_channel_cfg_t;
+
+typedef struct {
+    int32_t raw;                 // Reduced value of the last burst (LSB · 2^extra_bits)
+    int32_t value;               // After the EMA (== raw without smoothing), same scale
+    uint32_t t_ms;               // When it was published
+    uint32_t updates;            // Scans published so far
+    uint8_t samples;             // Conversions in the last burst
+} adc_scan_value_t;
+
+typedef struct {
+    atomic_uint seq;             // Odd while the writer is updating the slot
+    adc_scan_value_t v;
+    int32_t ema_q8;
+} adc_scan_slot_t;
+
+typedef struct {
+    adc_scan_channel_cfg_t cfg[ADC_SCAN_MAX_CHANNELS];
+    adc_scan_slot_t slot[ADC_SCAN_MAX_CHANNELS];
+    atomic_int count;            // Published after the slot config is written
+    int next;
+    uint32_t rounds;
+} adc_scan_t;
+
+void adc_scan_init(adc_scan_t *s);
+
+/**
+ * @brief Add a channel to the schedule
+ * @return slot index, or -1 if the table is full, the config is invalid or
+ *         the channel is already scheduled
+ */
+int adc_scan_add(adc_scan_t *s, const adc_scan_channel_cfg_t *cfg);
+
+/** @brief Slot of a channel, -1 if it is not scheduled */
+int adc_scan_find(const adc_scan_t *s, int channel);
+
+/** @brief Slot to sample next (round-robin), -1 if the schedule is empty */
+int adc_scan_next(adc_scan_t *s);
+
+/**
+ * @brief Reduce a burst of conversions with the slot's method
+ *
+ * MEAN keeps `extra_bits` of the sum (rounded); MEDIAN sorts `samples` in
+ * place and is only scaled, a median does not gain resolution.
+ */
+int32_t adc_scan_reduce(const adc_scan_channel_cfg_t *cfg, int32_t *samples, int n);
+
+/** @brief Apply the slot's EMA and publish a burst of `samples` (single writer) */
+void adc_scan_publish(adc_scan_t *s, int slot, int32_t raw, uint8_t samples, uint32_t t_ms);
+
+/**
+ * @brief Copy a slot's latest value without blocking the writer
+ * @return false if the slot does not exist or was never published
+ */
+bool adc_scan_latest(adc_scan_t *s, int slot, adc_scan_value_t *out);
@@ -0,0 +1,105 @@
+#include <stddef.h>
+#include "adc_sim.h"
+
+typedef struct {
+    int32_t raw_q8;
+    uint16_t sigma_x16;
+} sim_channel_t;
+
+static sim_channel_t s_ch[ADC_SIM_MAX_CHANNELS];
+static uint32_t s_rng = 1;
+
+// mV = 10 + 0.78·raw − 1.5e-5·raw²: 10 mV at 0, ~2953 mV at 4095, monotonic
+static int curve_mv(int raw)
+{
+    int64_t r = raw;
+    return (int)((10000000 + r * 780000 - r * r * 15) / 1000000);
+}
+
+bool adc_sim_curve_mv(void *ctx, int raw, int *mv)
+{
+    (void)ctx;
+    if (raw < 0 || raw > ADC_SIM_RAW_MAX || mv == NULL) {
+        return false;
+    }
+    *mv = curve_mv(raw);
+    return true;
+}
+
+void adc_sim_set_raw_q8(int channel, int32_t raw_q8)
+{
+    if (channel >= 0 && channel < ADC_SIM_MAX_CHANNELS) {
+        s_ch[channel].raw_q8 = raw_q8;
+    }
+}
+
+void adc_sim_set_mv(int channel, int mv)
+{
+    // Inverse of the curve with linear interpolation between codes
+    int lo = 0;
+    int hi = ADC_SIM_RAW_MAX;
+    if (mv <= curve_mv(lo)) {
+        adc_sim_set_raw_q8(channel, 0);
+        return;
+    }
+    if (mv >= curve_mv(hi)) {
+        adc_sim_set_raw_q8(channel, (int32_t)hi << 8);
+        return;
+    }
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (curve_mv(mid) <= mv) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    int span = curve_mv(hi) - curve_mv(lo);
+    int32_t frac = span > 0 ? ((mv - curve_mv(lo)) * 256) / span : 0;
+    adc_sim_set_raw_q8(channel, ((int32_t)lo << 8) + frac);
+}
+
+void adc_sim_set_noise(int channel, uint16_t sigma_lsb_x16)
+{
+    if (channel >= 0 && channel < ADC_SIM_MAX_CHANNELS) {
+        s_ch[channel].sigma_x16 = sigma_lsb_x16;
+    }
+}
+
+void adc_sim_seed(uint32_t seed)
+{
+    s_rng = seed ? seed : 1;
+}
+
+static uint32_t rng_next(void)
+{
+    // xorshift32
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+esp_err_t adc_sim_read(int channel, int *raw)
+{
+    if (channel < 0 || channel >= ADC_SIM_MAX_CHANNELS || raw == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const sim_channel_t *ch = &s_ch[channel];
+    int64_t v_q8 = ch->raw_q8;
+    if (ch->sigma_x16 > 0) {
+        // Sum of 12 uniforms in [0,1): mean 6, variance 1
+        int64_t acc = 0;
+        for (int i = 0; i < 12; i++) {
+            acc += rng_next() >> 16;            // 0..65535
+        }
+        int64_t n_q16 = acc - 6 * 65536;        // N(0,1) in Q16
+        v_q8 += (n_q16 * ch->sigma_x16) >> 12;  // · σ/16 · 256 / 65536
+    }
+    // Quantize to the nearest code
+    int64_t code = (v_q8 + 128) >> 8;
+    if (code < 0) code = 0;
+    if (code > ADC_SIM_RAW_MAX) code = ADC_SIM_RAW_MAX;
+    *raw = (int)code;
+    return ESP_OK;
+}
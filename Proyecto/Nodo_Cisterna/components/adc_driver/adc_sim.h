@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * Simulated ADC backend (CONFIG_ADC_DRIVER_SIMULATED and host tests).
+ *
+ * Each channel holds a true input level with sub-LSB resolution plus
+ * optional Gaussian-like noise, and is quantized on every read like the
+ * real converter. The raw → mV characteristic is a fixed synthetic curve
+ * (slightly compressive near full scale, as on the 12 dB range), so the
+ * calibration table has a real shape to reproduce.
+ */
+
+#define ADC_SIM_MAX_CHANNELS 8
+#define ADC_SIM_RAW_MAX      4095
+
+/** @brief Synthetic calibration curve (adc_cali_fn_t signature) */
+bool adc_sim_curve_mv(void *ctx, int raw, int *mv);
+
+/** @brief Set a channel's input in millivolts (mapped through the curve) */
+void adc_sim_set_mv(int channel, int mv);
+
+/** @brief Set a channel's input directly in raw codes, Q8 (sub-LSB) */
+void adc_sim_set_raw_q8(int channel, int32_t raw_q8);
+
+/** @brief Noise standard deviation in LSB/16 (0 = noiseless) */
+void adc_sim_set_noise(int channel, uint16_t sigma_lsb_x16);
+
+/** @brief Deterministic noise sequence */
+void adc_sim_seed(uint32_t seed);
+
+/** @brief One conversion */
+esp_err_t adc_sim_read(int channel, int *raw);
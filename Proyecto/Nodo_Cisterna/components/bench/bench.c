@@ -0,0 +1,300 @@
+#include "bench.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM) && !CONFIG_IDF_TARGET_LINUX
+#define BENCH_ON_CHIP 1
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#include "rawstream_uart.h"
+#endif
+#else
+#define BENCH_ON_CHIP 0
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HOST_TSC 1
+#endif
+#endif
+
+volatile uint32_t bench_sink;
+volatile float bench_sink_f;
+
+static bench_t *s_head = NULL;
+
+// ========== RELOJ ==========
+
+#if BENCH_ON_CHIP
+
+static inline uint32_t read_cycles(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+static float ticks_per_us(void)
+{
+    return (float)esp_rom_get_cpu_ticks_per_us();
+}
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_pm_lock = NULL;
+#endif
+
+/** Con gestión de energía, la CPU a frecuencia máxima y sin light sleep mientras se mide */
+static void clock_hold(bool hold)
+{
+#if CONFIG_PM_ENABLE
+    if (s_pm_lock == NULL &&
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "bench", &s_pm_lock) != ESP_OK) {
+        return;
+    }
+    if (hold) {
+        esp_pm_lock_acquire(s_pm_lock);
+    } else {
+        esp_pm_lock_release(s_pm_lock);
+    }
+#else
+    (void)hold;
+#endif
+}
+
+#else // Host y target linux
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#if BENCH_HOST_TSC
+static inline uint32_t read_cycles(void)
+{
+    return (uint32_t)__rdtsc();
+}
+
+/** Frecuencia del TSC contra el reloj monótono (una vez, ~10 ms) */
+static float ticks_per_us(void)
+{
+    static float s_tpu = 0.0f;
+    if (s_tpu == 0.0f) {
+        uint64_t n0 = mono_ns();
+        uint64_t c0 = __rdtsc();
+        while (mono_ns() - n0 < 10000000u) {
+        }
+        uint64_t c1 = __rdtsc();
+        uint64_t n1 = mono_ns();
+        s_tpu = (float)((double)(c1 - c0) * 1000.0 / (double)(n1 - n0));
+    }
+    return s_tpu;
+}
+#else
+// Sin contador de ciclos accesible: los "ciclos" son ns
+static inline uint32_t read_cycles(void)
+{
+    return (uint32_t)mono_ns();
+}
+
+static float ticks_per_us(void)
+{
+    return 1000.0f;
+}
+#endif
+
+static void clock_hold(bool hold)
+{
+    (void)hold;
+}
+
+#endif
+
+static void empty_iteration(void)
+{
+}
+
+// Puntero volátil: la medición del costo fijo incluye la llamada indirecta
+static void (*volatile s_empty_fn)(void) = empty_iteration;
+
+/** Ciclos que cuesta medir una iteración vacía (mínimo de varias) */
+static uint32_t measure_overhead(void)
+{
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < 64; i++) {
+        uint32_t t0 = read_cycles();
+        s_empty_fn();
+        uint32_t dt = read_cycles() - t0;
+        if (dt < best) {
+            best = dt;
+        }
+    }
+    return best;
+}
+
+// ========== REGISTRO ==========
+
+void bench_register(bench_t *b)
+{
+    bench_t **pp = &s_head;
+    while (*pp != NULL && strcmp((*pp)->name, b->name) < 0) {
+        pp = &(*pp)->next;
+    }
+    if (*pp == b) {
+        return;
+    }
+    b->next = *pp;
+    *pp = b;
+}
+
+int bench_count(void)
+{
+    int n = 0;
+    for (const bench_t *b = s_head; b != NULL; b = b->next) {
+        n++;
+    }
+    return n;
+}
+
+const bench_t *bench_get(int i)
+{
+    const bench_t *b = s_head;
+    while (b != NULL && i-- > 0) {
+        b = b->next;
+    }
+    return b;
+}
+
+bool bench_matches(const bench_t *b, const char *filter)
+{
+    if (filter == NULL || filter[0] == '\0' || strcmp(filter, "all") == 0) {
+        return true;
+    }
+    return strncmp(b->name, filter, strlen(filter)) == 0;
+}
+
+// ========== MEDICIÓN ==========
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_summarize(uint32_t *cycles, uint32_t n, float ticks_per_us, bench_result_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (n == 0) {
+        return;
+    }
+    qsort(cycles, n, sizeof(cycles[0]), cmp_u32);
+    out->iters = n;
+    out->min_cycles = cycles[0];
+    out->median_cycles = (n % 2) ? cycles[n / 2]
+                                 : (uint32_t)(((uint64_t)cycles[n / 2 - 1] + cycles[n / 2]) / 2);
+    // Rango más cercano: el menor valor con al menos el 99 % de las muestras debajo
+    uint32_t rank = (uint32_t)(((uint64_t)n * 99 + 99) / 100);
+    out->p99_cycles = cycles[rank - 1];
+    out->min_us = out->min_cycles / ticks_per_us;
+    out->median_us = out->median_cycles / ticks_per_us;
+    out->p99_us = out->p99_cycles / ticks_per_us;
+}
+
+static bool run_with_overhead(const bench_t *b, uint32_t iters, uint32_t overhead,
+                              bench_result_t *out)
+{
+    if (b->setup != NULL && !b->setup()) {
+        return false;
+    }
+    if (iters == 0) {
+        iters = 1;
+    } else if (iters > BENCH_MAX_ITERS) {
+        iters = BENCH_MAX_ITERS;
+    }
+    uint32_t *cycles = malloc(iters * sizeof(uint32_t));
+    if (cycles == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < BENCH_WARMUP_ITERS; i++) {
+        b->fn();                 // Caché de la flash y estado inicial de la función
+    }
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t t0 = read_cycles();
+        b->fn();
+        uint32_t dt = read_cycles() - t0;
+        cycles[i] = dt > overhead ? dt - overhead : 0;
+    }
+    bench_summarize(cycles, iters, ticks_per_us(), out);
+    free(cycles);
+    return true;
+}
+
+bool bench_run(const bench_t *b, uint32_t iters, bench_result_t *out)
+{
+    clock_hold(true);
+    bool ok = run_with_overhead(b, iters, measure_overhead(), out);
+    clock_hold(false);
+    return ok;
+}
+
+int bench_run_matching(const char *filter, uint32_t iters)
+{
+    clock_hold(true);
+    uint32_t overhead = measure_overhead();
+    printf("bench: %" PRIu32 " iteraciones, %.1f ciclos/us, %" PRIu32 " ciclos de medición restados\n",
+           iters, ticks_per_us(), overhead);
+    printf("  %-20s %9s %9s %9s %10s %10s %10s\n",
+           "nombre", "min", "mediana", "p99", "min us", "med us", "p99 us");
+
+    int ran = 0;
+    for (const bench_t *b = s_head; b != NULL; b = b->next) {
+        if (!bench_matches(b, filter)) {
+            continue;
+        }
+        bench_result_t r;
+        if (!run_with_overhead(b, iters, overhead, &r)) {
+            printf("  %-20s omitido\n", b->name);
+            continue;
+        }
+        printf("  %-20s %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %10.2f %10.2f %10.2f\n",
+               b->name, r.min_cycles, r.median_cycles, r.p99_cycles,
+               r.min_us, r.median_us, r.p99_us);
+        ran++;
+    }
+    clock_hold(false);
+    if (ran == 0) {
+        printf("bench: ninguno coincide con \"%s\"\n", filter);
+    }
+    return ran;
+}
+
+void bench_print_list(void)
+{
+    printf("bench: %d registrados (bench <prefijo|all> [N], N <= %d)\n",
+           bench_count(), BENCH_MAX_ITERS);
+    for (const bench_t *b = s_head; b != NULL; b = b->next) {
+        printf("  %s\n", b->name);
+    }
+}
+
+void bench_command(const char *args)
+{
+    char filter[32] = "";
+    unsigned long iters = BENCH_DEFAULT_ITERS;
+#if BENCH_ON_CHIP
+    // Las tablas salen por printf y romperían la trama binaria del UART
+    if (rawstream_active()) {
+        return;
+    }
+#endif
+    int n = sscanf(args, "%31s %lu", filter, &iters);
+    if (n < 1) {
+        bench_print_list();
+        return;
+    }
+    bench_run_matching(filter, (uint32_t)iters);
+}
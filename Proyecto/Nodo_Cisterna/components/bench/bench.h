@@ -0,0 +1,107 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+/**
+ * Microbenchmarks de los caminos calientes (comando `bench`).
+ *
+ * Cada componente registra sus funciones con una línea:
+ *
+ *   static void bench_ping_filter(void) { ... una iteración ... }
+ *   BENCH_REGISTER("ping_filter", bench_ping_filter);
+ *
+ * El registro corre como constructor antes de app_main. Si los benchmarks
+ * están en un archivo que nada más referencia, el componente debe pedir
+ * WHOLE_ARCHIVE para que el enlazador no lo descarte.
+ *
+ * Cada iteración se mide por separado con el contador de ciclos de la CPU
+ * (en el host, el TSC o el reloj monótono) y se informan mínimo, mediana y
+ * p99 en ciclos y µs, con el costo de la propia medición ya restado. El
+ * mínimo es el costo con caché caliente; el p99 incluye fallos de caché de
+ * la flash e interrupciones. Las iteraciones no se aíslan del planificador:
+ * algunos benchmarks (ADC, MQTT) esperan a otras tareas.
+ *
+ * Se compila igual para el chip, el target linux de ESP-IDF y las pruebas
+ * de host (host_test/bench_host).
+ */
+
+#define BENCH_DEFAULT_ITERS 200
+#define BENCH_WARMUP_ITERS  3
+#ifdef CONFIG_BENCH_MAX_ITERS
+#define BENCH_MAX_ITERS     CONFIG_BENCH_MAX_ITERS
+#else
+#define BENCH_MAX_ITERS     5000
+#endif
+
+typedef struct bench {
+    const char *name;            // Literal: se filtra por prefijo
+    bool (*setup)(void);         // Opcional, antes de cada corrida; false = se omite
+    void (*fn)(void);            // Una iteración
+    struct bench *next;
+} bench_t;
+
+typedef struct {
+    uint32_t iters;
+    uint32_t min_cycles;
+    uint32_t median_cycles;
+    uint32_t p99_cycles;
+    float min_us;
+    float median_us;
+    float p99_us;
+} bench_result_t;
+
+/** Igual que BENCH_REGISTER, con una función que prepara la corrida o la omite */
+#define BENCH_REGISTER_SETUP(name_, setup_, fn_) \
+    static bench_t s_bench_##fn_; \
+    __attribute__((constructor)) static void bench_ctor_##fn_(void) \
+    { \
+        bench_register(&s_bench_##fn_); \
+    } \
+    static bench_t s_bench_##fn_ = { (name_), (setup_), (fn_), 0 }
+
+#define BENCH_REGISTER(name_, fn_) BENCH_REGISTER_SETUP(name_, 0, fn_)
+
+/**
+ * Sumideros para que el compilador no elimine el cálculo medido:
+ * BENCH_KEEP(ping.distance_cm) al final de la iteración.
+ */
+extern volatile uint32_t bench_sink;
+extern volatile float bench_sink_f;
+#define BENCH_KEEP(x)   (bench_sink = (uint32_t)(x))
+#define BENCH_KEEP_F(x) (bench_sink_f = (float)(x))
+
+/** @brief Agrega un benchmark (orden alfabético); normalmente vía BENCH_REGISTER */
+void bench_register(bench_t *b);
+
+int bench_count(void);
+const bench_t *bench_get(int i);
+
+/** @brief "" o "all" corresponde a todos; si no, prefijo del nombre */
+bool bench_matches(const bench_t *b, const char *filter);
+
+/**
+ * @brief Ordena los ciclos de cada iteración y calcula mínimo, mediana y p99
+ * (rango más cercano); los µs usan ticks_per_us
+ */
+void bench_summarize(uint32_t *cycles, uint32_t n, float ticks_per_us, bench_result_t *out);
+
+/**
+ * @brief Corre iters iteraciones (1..BENCH_MAX_ITERS) tras BENCH_WARMUP_ITERS
+ * @return false si setup la omitió o no hubo memoria para las muestras
+ */
+bool bench_run(const bench_t *b, uint32_t iters, bench_result_t *out);
+
+/** @brief Corre los que coinciden con filter e imprime la tabla; retorna cuántos corrió */
+int bench_run_matching(const char *filter, uint32_t iters);
+
+/** @brief Lista los benchmarks registrados */
+void bench_print_list(void);
+
+/**
+ * @brief Comando de consola: "bench" lista, "bench <filtro|all> [N]" corre
+ * (firma de cmdline_fn_t)
+ */
+void bench_command(const char *args);
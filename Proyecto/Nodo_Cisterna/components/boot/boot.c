@@ -0,0 +1,190 @@
+#include "boot.h"
+#include "boot_prof.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "boot";
+
+// Un bit de evento por etapa: se activa al terminar (bien, mal u omitida).
+// Los event groups de FreeRTOS ofrecen 24 bits con ticks de 32 bits.
+#if BOOT_MAX_STAGES > 24
+#error "BOOT_MAX_STAGES excede los bits disponibles en un event group"
+#endif
+
+typedef struct {
+    int64_t ready_us;         // Dependencias satisfechas
+    int64_t start_us;
+    int64_t end_us;
+    esp_err_t result;
+    boot_stage_state_t state;
+} boot_stage_record_t;
+
+static const boot_stage_t *s_stages = NULL;
+static size_t s_count = 0;
+static boot_stage_record_t s_records[BOOT_MAX_STAGES];
+static EventGroupHandle_t s_done_group = NULL;
+static int64_t s_boot_start_us = 0;
+
+static const char *state_str(boot_stage_state_t st)
+{
+    switch (st) {
+        case BOOT_STAGE_PENDING: return "PEND";
+        case BOOT_STAGE_RUNNING: return "RUN";
+        case BOOT_STAGE_DONE:    return "OK";
+        case BOOT_STAGE_FAILED:  return "FAIL";
+        case BOOT_STAGE_SKIPPED: return "SKIP";
+    }
+    return "?";
+}
+
+static void boot_stage_task(void *arg)
+{
+    size_t idx = (size_t)arg;
+    const boot_stage_t *stage = &s_stages[idx];
+    boot_stage_record_t *rec = &s_records[idx];
+
+    // Esperar a todas las dependencias
+    if (stage->deps != 0) {
+        xEventGroupWaitBits(s_done_group, stage->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    rec->ready_us = esp_timer_get_time();
+
+    bool deps_ok = true;
+    for (size_t i = 0; i < idx; i++) {
+        if ((stage->deps & BOOT_DEP(i)) && s_records[i].state != BOOT_STAGE_DONE) {
+            deps_ok = false;
+            break;
+        }
+    }
+
+    if (!deps_ok) {
+        rec->start_us = rec->end_us = rec->ready_us;
+        rec->state = BOOT_STAGE_SKIPPED;
+        ESP_LOGW(TAG, "⚠ Etapa '%s' omitida (falló una dependencia)", stage->name);
+    } else {
+        rec->state = BOOT_STAGE_RUNNING;
+        int prof = boot_prof_begin(stage->name);
+        rec->start_us = esp_timer_get_time();
+        rec->result = stage->fn ? stage->fn(stage->arg) : ESP_OK;
+        rec->end_us = esp_timer_get_time();
+        boot_prof_end(prof);
+        rec->state = (rec->result == ESP_OK) ? BOOT_STAGE_DONE : BOOT_STAGE_FAILED;
+        if (rec->result != ESP_OK) {
+            ESP_LOGE(TAG, "✗ Etapa '%s' falló: %s", stage->name, esp_err_to_name(rec->result));
+        } else {
+            ESP_LOGI(TAG, "✓ Etapa '%s' lista (%" PRId64 " ms)", stage->name,
+                     (rec->end_us - rec->start_us) / 1000);
+        }
+    }
+
+    xEventGroupSetBits(s_done_group, BOOT_DEP(idx));
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_run(const boot_stage_t *stages, size_t count)
+{
+    if (stages == NULL || count == 0 || count > BOOT_MAX_STAGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_done_group != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Validar el grafo: solo dependencias hacia etapas anteriores
+    for (size_t i = 0; i < count; i++) {
+        if (stages[i].deps & ~(BOOT_DEP(i) - 1)) {
+            ESP_LOGE(TAG, "✗ Etapa '%s' depende de una etapa posterior o de sí misma",
+                     stages[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    s_done_group = xEventGroupCreate();
+    if (s_done_group == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_stages = stages;
+    s_count = count;
+    memset(s_records, 0, sizeof(s_records));
+    s_boot_start_us = esp_timer_get_time();
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t stack = stages[i].stack_size ? stages[i].stack_size : 4096;
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "boot_%s", stages[i].name);
+        if (xTaskCreate(boot_stage_task, name, stack, (void *)i, 4, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "✗ No se pudo crear la tarea de la etapa '%s'", stages[i].name);
+            s_records[i].state = BOOT_STAGE_FAILED;
+            s_records[i].result = ESP_ERR_NO_MEM;
+            xEventGroupSetBits(s_done_group, BOOT_DEP(i));
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t boot_wait(uint32_t timeout_ms)
+{
+    if (s_done_group == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    EventBits_t all = (EventBits_t)(BOOT_DEP(s_count) - 1);
+    EventBits_t bits = xEventGroupWaitBits(s_done_group, all, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    if ((bits & all) != all) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_records[i].state != BOOT_STAGE_DONE) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+boot_stage_state_t boot_stage_state(size_t idx)
+{
+    if (idx >= s_count) {
+        return BOOT_STAGE_PENDING;
+    }
+    return s_records[idx].state;
+}
+
+void boot_print_report(void)
+{
+    if (s_stages == NULL) {
+        return;
+    }
+
+    int64_t last_end = s_boot_start_us;
+    ESP_LOGI(TAG, "=== LÍNEA DE TIEMPO DE ARRANQUE (ms desde boot_run) ===");
+    ESP_LOGI(TAG, "%-10s %-5s %8s %8s %8s", "etapa", "est", "listo", "inicio", "duracion");
+    for (size_t i = 0; i < s_count; i++) {
+        const boot_stage_record_t *rec = &s_records[i];
+        if (rec->state == BOOT_STAGE_PENDING || rec->state == BOOT_STAGE_RUNNING) {
+            ESP_LOGI(TAG, "%-10s %-5s", s_stages[i].name, state_str(rec->state));
+            continue;
+        }
+        ESP_LOGI(TAG, "%-10s %-5s %8" PRId64 " %8" PRId64 " %8" PRId64,
+                 s_stages[i].name, state_str(rec->state),
+                 (rec->ready_us - s_boot_start_us) / 1000,
+                 (rec->start_us - s_boot_start_us) / 1000,
+                 (rec->end_us - rec->start_us) / 1000);
+        if (rec->end_us > last_end) {
+            last_end = rec->end_us;
+        }
+    }
+    ESP_LOGI(TAG, "Total: %" PRId64 " ms (arranque del sistema a las %" PRId64 " ms)",
+             (last_end - s_boot_start_us) / 1000, s_boot_start_us / 1000);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/**
+ * Orquestador de arranque: cada etapa declara de qué etapas depende y se
+ * ejecuta en su propia tarea en cuanto sus dependencias terminan. Las etapas
+ * independientes (ej. sensores y Wi-Fi) avanzan en paralelo.
+ *
+ * Las dependencias solo pueden apuntar a etapas declaradas antes en la tabla,
+ * lo que garantiza un grafo acíclico.
+ */
+
+#define BOOT_MAX_STAGES 16
+
+/** Máscara de dependencia para la etapa con índice idx */
+#define BOOT_DEP(idx) (1u << (idx))
+
+typedef esp_err_t (*boot_stage_fn_t)(void *arg);
+
+typedef struct {
+    const char *name;         // Nombre corto para el reporte
+    boot_stage_fn_t fn;       // Función de inicialización
+    void *arg;                // Argumento para fn
+    uint32_t deps;            // OR de BOOT_DEP() de las etapas previas requeridas
+    uint32_t stack_size;      // Stack de la tarea de la etapa (0 = 4096)
+} boot_stage_t;
+
+typedef enum {
+    BOOT_STAGE_PENDING = 0,
+    BOOT_STAGE_RUNNING,
+    BOOT_STAGE_DONE,
+    BOOT_STAGE_FAILED,
+    BOOT_STAGE_SKIPPED,       // Alguna dependencia falló
+} boot_stage_state_t;
+
+/**
+ * Lanza todas las etapas. Retorna de inmediato; usar boot_wait() para
+ * esperar a que terminen. La tabla debe permanecer válida (static).
+ */
+esp_err_t boot_run(const boot_stage_t *stages, size_t count);
+
+/**
+ * Espera a que todas las etapas terminen (bien, mal u omitidas).
+ * Retorna ESP_OK si todas terminaron bien, ESP_FAIL si alguna falló u
+ * se omitió, ESP_ERR_TIMEOUT si no terminaron en timeout_ms.
+ */
+esp_err_t boot_wait(uint32_t timeout_ms);
+
+/** Estado actual de una etapa */
+boot_stage_state_t boot_stage_state(size_t idx);
+
+/** Imprime la línea de tiempo del arranque (inicio/duración por etapa) */
+void boot_print_report(void);
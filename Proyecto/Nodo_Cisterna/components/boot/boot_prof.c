@@ -0,0 +1,110 @@
+#include "boot_prof.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_app_desc.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "boot_prof";
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+    int64_t end_us;           // -1 mientras el intervalo está abierto
+} boot_prof_entry_t;
+
+static boot_prof_entry_t s_entries[BOOT_PROF_MAX_ENTRIES];
+static int s_count = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+int boot_prof_begin(const char *name)
+{
+    int64_t now = esp_timer_get_time();
+    int slot = -1;
+
+    taskENTER_CRITICAL(&s_lock);
+    if (s_count < BOOT_PROF_MAX_ENTRIES) {
+        slot = s_count++;
+        s_entries[slot].name = name;
+        s_entries[slot].start_us = now;
+        s_entries[slot].end_us = -1;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    return slot;
+}
+
+void boot_prof_end(int slot)
+{
+    if (slot < 0 || slot >= BOOT_PROF_MAX_ENTRIES) {
+        return;
+    }
+    s_entries[slot].end_us = esp_timer_get_time();
+}
+
+void boot_prof_event_once(const char *name)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_lock);
+    bool seen = false;
+    for (int i = 0; i < s_count; i++) {
+        if (strcmp(s_entries[i].name, name) == 0) {
+            seen = true;
+            break;
+        }
+    }
+    if (!seen && s_count < BOOT_PROF_MAX_ENTRIES) {
+        s_entries[s_count].name = name;
+        s_entries[s_count].start_us = now;
+        s_entries[s_count].end_us = now;
+        s_count++;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+void boot_prof_print(void)
+{
+    const esp_app_desc_t *app = esp_app_get_description();
+    ESP_LOGI(TAG, "BOOTPROF_BEGIN ver=%s built=%s_%s", app->version, app->date, app->time);
+    for (int i = 0; i < s_count; i++) {
+        const boot_prof_entry_t *e = &s_entries[i];
+        int64_t dur = (e->end_us < 0) ? -1 : (e->end_us - e->start_us);
+        ESP_LOGI(TAG, "BOOTPROF %s %" PRId64 " %" PRId64, e->name, e->start_us, dur);
+    }
+    ESP_LOGI(TAG, "BOOTPROF_END");
+}
+
+int boot_prof_to_json(char *buf, size_t len)
+{
+    const esp_app_desc_t *app = esp_app_get_description();
+    size_t pos = 0;
+    int n = snprintf(buf, len, "{\"ver\":\"%s\",\"built\":\"%s_%s\",\"entries\":[",
+                     app->version, app->date, app->time);
+    if (n < 0 || (size_t)n >= len) {
+        return -1;
+    }
+    pos = n;
+
+    for (int i = 0; i < s_count; i++) {
+        const boot_prof_entry_t *e = &s_entries[i];
+        int64_t dur = (e->end_us < 0) ? -1 : (e->end_us - e->start_us);
+        n = snprintf(buf + pos, len - pos, "%s{\"n\":\"%s\",\"t\":%" PRId64 ",\"d\":%" PRId64 "}",
+                     i ? "," : "", e->name, e->start_us, dur);
+        if (n < 0 || (size_t)n >= len - pos) {
+            return -1;
+        }
+        pos += n;
+    }
+
+    n = snprintf(buf + pos, len - pos, "]}");
+    if (n < 0 || (size_t)n >= len - pos) {
+        return -1;
+    }
+    return (int)(pos + n);
+}
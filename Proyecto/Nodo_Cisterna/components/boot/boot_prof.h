@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Perfilador de arranque: registra con esp_timer el inicio y fin de cada
+ * paso de inicialización (NVS, Wi-Fi, ADC, calibración...) y eventos
+ * puntuales (primera muestra, primera publicación) en un buffer estático.
+ *
+ * Los nombres deben ser literales: solo se guarda el puntero.
+ * Formato de consola (una línea por entrada, para tools/boot_timeline.py):
+ *   BOOTPROF <nombre> <inicio_us> <duracion_us>
+ */
+
+#define BOOT_PROF_MAX_ENTRIES 24
+
+/** Abre un intervalo; retorna el índice para boot_prof_end() o -1 si no hay espacio */
+int boot_prof_begin(const char *name);
+
+/** Cierra un intervalo abierto con boot_prof_begin() */
+void boot_prof_end(int slot);
+
+/** Registra un evento puntual; llamadas repetidas con el mismo nombre se ignoran */
+void boot_prof_event_once(const char *name);
+
+/** Imprime la línea de tiempo en consola */
+void boot_prof_print(void);
+
+/**
+ * Serializa la línea de tiempo como JSON:
+ * {"ver":"...","built":"...","entries":[{"n":"nvs","t":1234,"d":56},...]}
+ * Retorna la longitud escrita o -1 si el buffer es insuficiente.
+ */
+int boot_prof_to_json(char *buf, size_t len);
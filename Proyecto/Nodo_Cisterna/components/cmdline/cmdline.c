@@ -0,0 +1,136 @@
+#include "cmdline.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+static const cmdline_cmd_t *s_table = NULL;
+static size_t s_count = 0;
+static int64_t (*s_now_us)(void) = NULL;
+static cmdline_stats_t s_stats[CMDLINE_MAX_COMMANDS];
+static uint32_t s_unknown = 0;
+
+esp_err_t cmdline_init(const cmdline_cmd_t *table, size_t count, int64_t (*now_us)(void))
+{
+    if (table == NULL || count > CMDLINE_MAX_COMMANDS || now_us == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].name == NULL || table[i].name[0] == '\0' || table[i].fn == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    s_table = table;
+    s_count = count;
+    s_now_us = now_us;
+    memset(s_stats, 0, sizeof(s_stats));
+    s_unknown = 0;
+    return ESP_OK;
+}
+
+size_t cmdline_count(void)
+{
+    return s_count;
+}
+
+const cmdline_cmd_t *cmdline_get(size_t i, cmdline_stats_t *stats)
+{
+    if (i >= s_count) {
+        return NULL;
+    }
+    if (stats != NULL) {
+        *stats = s_stats[i];
+    }
+    return &s_table[i];
+}
+
+const cmdline_cmd_t *cmdline_find(const char *line, const char **args)
+{
+    while (*line == ' ') {
+        line++;
+    }
+    for (size_t i = 0; i < s_count; i++) {
+        size_t n = strlen(s_table[i].name);
+        // Palabra completa: "ps" no toma "psx", sí "ps max 3"
+        if (strncasecmp(line, s_table[i].name, n) == 0 && (line[n] == '\0' || line[n] == ' ')) {
+            if (args != NULL) {
+                const char *a = line + n;
+                while (*a == ' ') {
+                    a++;
+                }
+                *args = a;
+            }
+            return &s_table[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t cmdline_dispatch(const char *line)
+{
+    const char *args = NULL;
+    const cmdline_cmd_t *cmd = cmdline_find(line, &args);
+    if (cmd == NULL) {
+        s_unknown++;
+        return ESP_ERR_NOT_FOUND;
+    }
+    int64_t t0 = s_now_us();
+    cmd->fn(args);
+    uint32_t dt = (uint32_t)(s_now_us() - t0);
+
+    cmdline_stats_t *st = &s_stats[cmd - s_table];
+    st->calls++;
+    st->total_us += dt;
+    if (dt > st->max_us) {
+        st->max_us = dt;
+    }
+    return ESP_OK;
+}
+
+uint32_t cmdline_unknown_count(void)
+{
+    return s_unknown;
+}
+
+void cmdline_reader_init(cmdline_reader_t *r)
+{
+    memset(r, 0, sizeof(*r));
+}
+
+const char *cmdline_reader_feed(cmdline_reader_t *r, const uint8_t *data, size_t len,
+                                size_t *used)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+        if (c == '\r' || c == '\n') {
+            bool complete = r->len > 0 && !r->overflow;
+            r->line[r->len] = '\0';
+            r->len = 0;
+            r->overflow = false;
+            // "\r\n" llega como una línea y una vacía: la vacía se ignora
+            if (complete) {
+                *used = i + 1;
+                return r->line;
+            }
+            continue;
+        }
+        if (c == '\b' || c == 0x7F) {
+            // Terminal serie interactiva: borrar el último carácter
+            if (r->len > 0) {
+                r->len--;
+            }
+            continue;
+        }
+        if (!isprint(c)) {
+            continue;
+        }
+        if (r->len < sizeof(r->line) - 1) {
+            r->line[r->len++] = (char)c;
+        } else if (!r->overflow) {
+            r->overflow = true;
+            r->overflows++;
+        }
+    }
+    *used = len;
+    return NULL;
+}
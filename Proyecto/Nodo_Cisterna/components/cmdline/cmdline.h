@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/**
+ * Tabla única de comandos de texto.
+ *
+ * Cada comando es un nombre y una función que recibe el resto de la línea;
+ * el lector UART (cmdline_uart.c) despacha por esta tabla. Antes había dos
+ * copias (cmd_calA() para esp_console, sensor_do_calA() y un if/else para
+ * la UART).
+ *
+ * El despacho y el armado de líneas son C puro (probados en el host); el
+ * reloj se inyecta para medir cuánto tarda cada comando.
+ */
+
+#define CMDLINE_MAX_COMMANDS 32
+#define CMDLINE_LINE_MAX     128
+
+/** @brief Manejador: args es el resto de la línea sin espacios iniciales ("" si no hay) */
+typedef void (*cmdline_fn_t)(const char *args);
+
+typedef struct {
+    const char *name;            // Una palabra; se compara sin distinguir mayúsculas
+    const char *help;            // Uso en una línea, para "help"
+    cmdline_fn_t fn;
+} cmdline_cmd_t;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t max_us;             // Duración del manejador
+    uint64_t total_us;
+} cmdline_stats_t;
+
+/** Armado de líneas a partir de bytes sueltos (\r, \n o \r\n terminan la línea) */
+typedef struct {
+    char line[CMDLINE_LINE_MAX];
+    uint16_t len;
+    bool overflow;               // La línea en curso no entró: se descarta entera
+    uint32_t overflows;
+} cmdline_reader_t;
+
+/**
+ * @brief Fija la tabla (debe vivir mientras se use) y el reloj en µs
+ * @return ESP_ERR_INVALID_ARG si hay más de CMDLINE_MAX_COMMANDS o falta algo
+ */
+esp_err_t cmdline_init(const cmdline_cmd_t *table, size_t count, int64_t (*now_us)(void));
+
+size_t cmdline_count(void);
+
+/** @brief Comando i de la tabla y sus estadísticas (stats puede ser NULL) */
+const cmdline_cmd_t *cmdline_get(size_t i, cmdline_stats_t *stats);
+
+/** @brief Busca el comando de la línea; *args apunta a sus argumentos */
+const cmdline_cmd_t *cmdline_find(const char *line, const char **args);
+
+/** @brief Ejecuta la línea; ESP_ERR_NOT_FOUND si el comando no existe */
+esp_err_t cmdline_dispatch(const char *line);
+
+/** @brief Líneas que no correspondían a ningún comando */
+uint32_t cmdline_unknown_count(void);
+
+void cmdline_reader_init(cmdline_reader_t *r);
+
+/**
+ * @brief Consume bytes hasta completar una línea no vacía
+ * @param used Bytes consumidos (el resto se entrega en la próxima llamada)
+ * @return La línea terminada en NUL (válida hasta la próxima llamada) o NULL
+ */
+const char *cmdline_reader_feed(cmdline_reader_t *r, const uint8_t *data, size_t len,
+                                size_t *used);
@@ -0,0 +1,167 @@
+#include "cmdline_uart.h"
+
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+static const char *TAG = "cmdline";
+
+#define CMDLINE_UART_TASK_STACK 4096    // Los manejadores corren en esta tarea
+#define CMDLINE_UART_TASK_PRIO  2
+#define CMDLINE_UART_RX_BUF     256
+#define CMDLINE_UART_EVENTS     8
+
+static uart_port_t s_uart;
+static QueueHandle_t s_events = NULL;
+static int64_t s_start_us = 0;
+static cmdline_reader_t s_reader;
+
+static struct {
+    uint32_t wakeups;            // Eventos recibidos (debe seguir al tráfico, no al reloj)
+    uint32_t lines;
+    uint32_t overruns;           // FIFO o buffer de RX desbordados
+    uint32_t latency_max_us;
+    uint64_t latency_sum_us;
+    uint64_t active_us;          // Tarea despierta, incluidos los manejadores
+    uint64_t handler_us;
+} s_st;
+
+static void run_line(const char *line, int64_t t_wake)
+{
+    int64_t t0 = esp_timer_get_time();
+    uint32_t latency = (uint32_t)(t0 - t_wake);
+    s_st.lines++;
+    s_st.latency_sum_us += latency;
+    if (latency > s_st.latency_max_us) {
+        s_st.latency_max_us = latency;
+    }
+    ESP_LOGI(TAG, "UART CMD received: %s", line);
+    if (cmdline_dispatch(line) == ESP_ERR_NOT_FOUND) {
+        ESP_LOGI(TAG, "Unknown command: %s (help: lista de comandos)", line);
+    }
+    s_st.handler_us += (uint64_t)(esp_timer_get_time() - t0);
+}
+
+static void uart_reader_task(void *arg)
+{
+    (void)arg;
+    uint8_t buf[64];
+    cmdline_reader_init(&s_reader);
+    while (1) {
+        uart_event_t ev;
+        if (xQueueReceive(s_events, &ev, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        int64_t t_wake = esp_timer_get_time();
+        s_st.wakeups++;
+        switch (ev.type) {
+        case UART_DATA: {
+            size_t pending = ev.size;
+            while (pending > 0) {
+                int n = uart_read_bytes(s_uart, buf, pending < sizeof(buf) ? pending : sizeof(buf), 0);
+                if (n <= 0) {
+                    break;
+                }
+                pending -= (size_t)n;
+                size_t off = 0;
+                while (off < (size_t)n) {
+                    size_t used = 0;
+                    const char *line = cmdline_reader_feed(&s_reader, &buf[off], (size_t)n - off,
+                                                           &used);
+                    off += used;
+                    if (line != NULL) {
+                        run_line(line, t_wake);
+                    }
+                }
+            }
+            break;
+        }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            // Lo recibido ya no forma líneas confiables: empezar de cero
+            s_st.overruns++;
+            uart_flush_input(s_uart);
+            xQueueReset(s_events);
+            s_reader.len = 0;
+            s_reader.overflow = false;
+            break;
+        default:
+            break;
+        }
+        s_st.active_us += (uint64_t)(esp_timer_get_time() - t_wake);
+    }
+}
+
+esp_err_t cmdline_uart_start(int uart_num, uint32_t baud)
+{
+    if (s_events != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_uart = (uart_port_t)uart_num;
+    uart_config_t uart_config = {
+        .baud_rate = (int)baud,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+    };
+    esp_err_t ret = uart_param_config(s_uart, &uart_config);
+    if (ret == ESP_OK) {
+        // Sin buffer de TX: los logs siguen yendo por la consola de IDF
+        ret = uart_driver_install(s_uart, CMDLINE_UART_RX_BUF, 0, CMDLINE_UART_EVENTS,
+                                  &s_events, 0);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ UART %d: %s", uart_num, esp_err_to_name(ret));
+        return ret;
+    }
+    uart_set_rx_timeout(s_uart, CMDLINE_UART_RX_TOUT);
+
+    s_start_us = esp_timer_get_time();
+    if (xTaskCreate(uart_reader_task, "uart_cmd", CMDLINE_UART_TASK_STACK, NULL,
+                    CMDLINE_UART_TASK_PRIO, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "✓ Comandos por UART %d (eventos, %u comandos)", uart_num,
+             (unsigned)cmdline_count());
+    return ESP_OK;
+}
+
+void cmdline_print_help(void)
+{
+    for (size_t i = 0; i < cmdline_count(); i++) {
+        const cmdline_cmd_t *cmd = cmdline_get(i, NULL);
+        ESP_LOGI(TAG, "  %-8s %s", cmd->name, cmd->help ? cmd->help : "");
+    }
+}
+
+void cmdline_print_stats(void)
+{
+    uint64_t up_us = (uint64_t)(esp_timer_get_time() - s_start_us);
+    uint64_t reader_us = s_st.active_us - s_st.handler_us;
+    ESP_LOGI(TAG, "=== COMANDOS (UART) ===");
+    ESP_LOGI(TAG, "%" PRIu32 " despertares, %" PRIu32 " líneas, %" PRIu32 " desconocidas, %" PRIu32
+             " desbordes, %" PRIu32 " líneas largas descartadas",
+             s_st.wakeups, s_st.lines, cmdline_unknown_count(), s_st.overruns, s_reader.overflows);
+    ESP_LOGI(TAG, "Latencia evento→manejador: media %" PRIu64 " us, máx %" PRIu32
+             " us (+ timeout de RX de %d símbolos)",
+             s_st.lines ? s_st.latency_sum_us / s_st.lines : 0, s_st.latency_max_us,
+             CMDLINE_UART_RX_TOUT);
+    ESP_LOGI(TAG, "CPU del lector: %" PRIu64 " us (%" PRIu64 " ppm del tiempo encendido), "
+             "manejadores: %" PRIu64 " us",
+             reader_us, up_us ? reader_us * 1000000 / up_us : 0, s_st.handler_us);
+    for (size_t i = 0; i < cmdline_count(); i++) {
+        cmdline_stats_t st;
+        const cmdline_cmd_t *cmd = cmdline_get(i, &st);
+        if (st.calls == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-8s %4" PRIu32 " veces, media %" PRIu64 " us, máx %" PRIu32 " us",
+                 cmd->name, st.calls, st.total_us / st.calls, st.max_us);
+    }
+}
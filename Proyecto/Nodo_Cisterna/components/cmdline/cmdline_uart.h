@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+#include "cmdline.h"
+
+/**
+ * Lector de comandos por UART guiado por eventos.
+ *
+ * El driver entrega un evento por ráfaga recibida (timeout de RX tras
+ * CMDLINE_UART_RX_TOUT símbolos sin datos); la tarea duerme en esa cola y
+ * solo corre cuando llegó algo, sin lecturas byte a byte ni sondeo.
+ * Las líneas se despachan con cmdline_dispatch() (cmdline_init() antes).
+ */
+
+#define CMDLINE_UART_RX_TOUT 3       // Símbolos (~0.26 ms a 115200 baud)
+
+/** @brief Instala el driver con cola de eventos y arranca la tarea lectora */
+esp_err_t cmdline_uart_start(int uart_num, uint32_t baud);
+
+/** @brief Lista de comandos de la tabla */
+void cmdline_print_help(void);
+
+/**
+ * @brief Latencia (evento → inicio del manejador), tiempo de CPU del lector
+ * (sin los manejadores) y duración por comando
+ */
+void cmdline_print_stats(void);
@@ -0,0 +1,85 @@
+#include "lp_decision.h"
+
+void lp_decision_reset(lp_decision_state_t *st)
+{
+    st->level_zone = LP_ZONE_UNKNOWN;
+    st->tds_high = 0;
+    st->fail_streak = 0;
+}
+
+static uint32_t level_zone_classify(const lp_decision_cfg_t *cfg, uint32_t echo_us)
+{
+    if (echo_us < cfg->level_low_us) {
+        return LP_ZONE_LOW;
+    }
+    if (echo_us > cfg->level_high_us) {
+        return LP_ZONE_HIGH;
+    }
+    return LP_ZONE_NORMAL;
+}
+
+/**
+ * Zona con histéresis: para salir de una zona extrema hay que superar el
+ * umbral por al menos deadband, así el ruido en el borde no despierta al HP.
+ */
+static uint32_t level_zone_update(const lp_decision_cfg_t *cfg, uint32_t zone, uint32_t echo_us)
+{
+    switch (zone) {
+        case LP_ZONE_LOW:
+            if (echo_us < cfg->level_low_us + cfg->level_deadband_us) {
+                return LP_ZONE_LOW;
+            }
+            break;
+        case LP_ZONE_HIGH:
+            if (echo_us + cfg->level_deadband_us > cfg->level_high_us) {
+                return LP_ZONE_HIGH;
+            }
+            break;
+        default:
+            break;
+    }
+    return level_zone_classify(cfg, echo_us);
+}
+
+uint32_t lp_decision_step(lp_decision_state_t *st, const lp_decision_cfg_t *cfg,
+                          const lp_sample_t *sample, uint32_t batch_count)
+{
+    uint32_t wake = LP_WAKE_NONE;
+
+    if (batch_count >= cfg->batch_size || batch_count >= LP_BATCH_MAX) {
+        wake |= LP_WAKE_BATCH_FULL;
+    }
+
+    if (sample->echo_us == 0) {
+        st->fail_streak++;
+        if (st->fail_streak == LP_FAIL_WAKE_COUNT) {
+            wake |= LP_WAKE_SENSOR_FAIL;
+        }
+    } else {
+        st->fail_streak = 0;
+        uint32_t zone = (st->level_zone == LP_ZONE_UNKNOWN)
+                            ? level_zone_classify(cfg, sample->echo_us)
+                            : level_zone_update(cfg, st->level_zone, sample->echo_us);
+        if (st->level_zone != LP_ZONE_UNKNOWN && zone != st->level_zone) {
+            if (zone == LP_ZONE_LOW) {
+                wake |= LP_WAKE_LEVEL_LOW;
+            } else if (zone == LP_ZONE_HIGH) {
+                wake |= LP_WAKE_LEVEL_HIGH;
+            } else {
+                wake |= LP_WAKE_LEVEL_OK;
+            }
+        }
+        st->level_zone = zone;
+    }
+
+    if (sample->tds_raw != LP_TDS_NONE) {
+        if (!st->tds_high && sample->tds_raw > cfg->tds_high_raw) {
+            st->tds_high = 1;
+            wake |= LP_WAKE_TDS_HIGH;
+        } else if (st->tds_high && sample->tds_raw + cfg->tds_deadband_raw < cfg->tds_high_raw) {
+            st->tds_high = 0;
+        }
+    }
+
+    return wake;
+}
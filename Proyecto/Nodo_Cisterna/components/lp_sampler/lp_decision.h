@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Lógica de decisión del muestreo en el núcleo LP.
+ *
+ * Se compila tal cual en el programa del núcleo LP, en el componente del HP
+ * y en las pruebas de host: C puro, sin float ni dependencias de ESP-IDF.
+ * Las magnitudes están en unidades crudas del sensor (µs de eco, cuentas de
+ * ADC); el HP convierte los umbrales de cm/ppm antes de cargarlos.
+ */
+
+#define LP_BATCH_MAX        64          // Muestras retenidas en memoria RTC
+#define LP_TDS_NONE         0xFFFFu     // El núcleo LP no muestreó TDS
+#define LP_FAIL_WAKE_COUNT  3           // Fallos consecutivos del sensor que despiertan al HP
+
+/** Razones de despertar del HP (máscara de bits) */
+typedef enum {
+    LP_WAKE_NONE        = 0,
+    LP_WAKE_BATCH_FULL  = 1 << 0,
+    LP_WAKE_LEVEL_LOW   = 1 << 1,       // Entró en la zona baja
+    LP_WAKE_LEVEL_HIGH  = 1 << 2,       // Entró en la zona alta
+    LP_WAKE_LEVEL_OK    = 1 << 3,       // Volvió a la zona normal
+    LP_WAKE_TDS_HIGH    = 1 << 4,
+    LP_WAKE_SENSOR_FAIL = 1 << 5,
+} lp_wake_reason_t;
+
+/** Zonas con histéresis */
+enum {
+    LP_ZONE_UNKNOWN = 0,
+    LP_ZONE_LOW,
+    LP_ZONE_NORMAL,
+    LP_ZONE_HIGH,
+};
+
+typedef struct {
+    uint32_t level_low_us;      // Eco por debajo de esto → zona baja
+    uint32_t level_high_us;     // Eco por encima de esto → zona alta
+    uint32_t level_deadband_us; // Histéresis para volver a la zona normal
+    uint32_t tds_high_raw;      // Cuentas de ADC que marcan agua sucia
+    uint32_t tds_deadband_raw;
+    uint32_t batch_size;        // Despertar al acumular este número de muestras (<= LP_BATCH_MAX)
+} lp_decision_cfg_t;
+
+typedef struct {
+    uint32_t echo_us;           // 0 = sin eco (timeout)
+    uint32_t tds_raw;           // LP_TDS_NONE si no se muestreó
+} lp_sample_t;
+
+typedef struct {
+    uint32_t level_zone;
+    uint32_t tds_high;          // 1 mientras el TDS está sobre el umbral
+    uint32_t fail_streak;
+} lp_decision_state_t;
+
+/** Estado inicial: las zonas se fijan con la primera muestra válida, sin despertar */
+void lp_decision_reset(lp_decision_state_t *st);
+
+/**
+ * Evalúa una muestra ya agregada al lote.
+ * @param batch_count Muestras en el lote incluyendo esta
+ * @return Máscara de lp_wake_reason_t; LP_WAKE_NONE si no hay que despertar
+ */
+uint32_t lp_decision_step(lp_decision_state_t *st, const lp_decision_cfg_t *cfg,
+                          const lp_sample_t *sample, uint32_t batch_count);
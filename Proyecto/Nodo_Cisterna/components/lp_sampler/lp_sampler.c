@@ -0,0 +1,218 @@
+#include "lp_sampler.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include "lp_shared.h"
+
+static const char *TAG = "LP_SAMPLER";
+
+// Misma constante que sensor_read_ultrasonic(): 0.0343 cm/µs, ida y vuelta
+#define LP_SOUND_CM_PER_US 0.0343f
+
+uint32_t lp_sampler_cm_to_echo_us(float cm)
+{
+    if (cm <= 0.0f) {
+        return 0;
+    }
+    return (uint32_t)(cm * 2.0f / LP_SOUND_CM_PER_US);
+}
+
+#if CONFIG_ULP_COPROC_TYPE_LP_CORE
+
+#include "ulp_lp_core.h"
+#include "driver/rtc_io.h"
+#include "esp_sleep.h"
+#include "ulp_lp_sampler.h"
+
+extern const uint8_t lp_bin_start[] asm("_binary_ulp_lp_sampler_bin_start");
+extern const uint8_t lp_bin_end[]   asm("_binary_ulp_lp_sampler_bin_end");
+
+// El programa LP exporta `lp_shared`; el generador solo declara un uint32_t
+#define LP_SHARED ((volatile lp_shared_t *)&ulp_lp_shared)
+
+static bool s_running = false;
+static bool s_pins_lp = false;
+
+static esp_err_t lp_sampler_setup_pins(const lp_sampler_config_t *config)
+{
+    if (!rtc_gpio_is_valid_gpio(config->trig_pin) || !rtc_gpio_is_valid_gpio(config->echo_pin)) {
+        ESP_LOGE(TAG, "✗ TRIG=%d/ECHO=%d no son LP IO (GPIO0-7)", config->trig_pin, config->echo_pin);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rtc_gpio_init(config->trig_pin);
+    rtc_gpio_set_direction(config->trig_pin, RTC_GPIO_MODE_OUTPUT_ONLY);
+    rtc_gpio_set_level(config->trig_pin, 0);
+
+    rtc_gpio_init(config->echo_pin);
+    rtc_gpio_set_direction(config->echo_pin, RTC_GPIO_MODE_INPUT_ONLY);
+    rtc_gpio_pulldown_dis(config->echo_pin);
+    rtc_gpio_pullup_dis(config->echo_pin);
+    s_pins_lp = true;
+    return ESP_OK;
+}
+
+static void lp_sampler_load_cfg(const lp_sampler_config_t *config)
+{
+    volatile lp_shared_t *sh = LP_SHARED;
+    sh->cfg.level_low_us = lp_sampler_cm_to_echo_us(config->level_low_cm);
+    sh->cfg.level_high_us = lp_sampler_cm_to_echo_us(config->level_high_cm);
+    sh->cfg.level_deadband_us = lp_sampler_cm_to_echo_us(config->level_deadband_cm);
+    sh->cfg.tds_high_raw = LP_TDS_NONE;
+    sh->cfg.tds_deadband_raw = 0;
+    sh->cfg.batch_size = (config->batch_size && config->batch_size <= LP_BATCH_MAX)
+                             ? config->batch_size : LP_BATCH_MAX;
+    sh->trig_io = config->trig_pin;
+    sh->echo_io = config->echo_pin;
+}
+
+esp_err_t lp_sampler_start(const lp_sampler_config_t *config)
+{
+    if (config == NULL || config->period_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_running) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = lp_sampler_setup_pins(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Tras un despertar por LP el binario y el lote siguen en memoria RTC
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_ULP) {
+        ret = ulp_lp_core_load_binary(lp_bin_start, lp_bin_end - lp_bin_start);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "✗ Error cargando el programa LP: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        volatile lp_shared_t *sh = LP_SHARED;
+        lp_decision_reset((lp_decision_state_t *)&sh->state);
+        sh->count = 0;
+        sh->dropped = 0;
+        sh->wake_reason = 0;
+        sh->wake_pending = 0;
+    }
+    lp_sampler_load_cfg(config);
+
+    ulp_lp_core_cfg_t cfg = {
+        .wakeup_source = ULP_LP_CORE_WAKEUP_SOURCE_LP_TIMER,
+        .lp_timer_sleep_duration_us = config->period_ms * 1000,
+    };
+    ret = ulp_lp_core_run(&cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error arrancando el núcleo LP: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_running = true;
+    ESP_LOGI(TAG, "✓ Núcleo LP muestreando cada %" PRIu32 " ms (lote %" PRIu32 ")",
+             config->period_ms, LP_SHARED->cfg.batch_size);
+    return ESP_OK;
+}
+
+esp_err_t lp_sampler_stop(void)
+{
+    ulp_lp_core_stop();
+    s_running = false;
+
+    // Devolver los pines al HP (sensor_read_ultrasonic); tras un despertar
+    // por LP siguen asignados al dominio LP desde antes de dormir
+    volatile lp_shared_t *sh = LP_SHARED;
+    if (s_pins_lp || esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_ULP) {
+        rtc_gpio_deinit(sh->trig_io);
+        rtc_gpio_deinit(sh->echo_io);
+        s_pins_lp = false;
+    }
+    return ESP_OK;
+}
+
+bool lp_sampler_woke_main(void)
+{
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_ULP;
+}
+
+uint32_t lp_sampler_wake_reason(void)
+{
+    return LP_SHARED->wake_reason;
+}
+
+size_t lp_sampler_drain(float *levels_cm, size_t max, uint32_t *dropped)
+{
+    volatile lp_shared_t *sh = LP_SHARED;
+    size_t n = sh->count;
+    if (n > max) {
+        n = max;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t echo = sh->samples[i].echo_us;
+        levels_cm[i] = echo ? (echo * LP_SOUND_CM_PER_US) / 2.0f : -1.0f;
+    }
+
+    if (dropped != NULL) {
+        *dropped = sh->dropped;
+    }
+    sh->count = 0;
+    sh->dropped = 0;
+    sh->wake_reason = 0;
+    sh->wake_pending = 0;
+    return n;
+}
+
+esp_err_t lp_sampler_sleep(const lp_sampler_config_t *config)
+{
+    esp_err_t ret = lp_sampler_start(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = esp_sleep_enable_ulp_wakeup();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_LOGI(TAG, "→ HP a deep sleep; el núcleo LP sigue muestreando");
+    esp_deep_sleep_start();
+    return ESP_OK;
+}
+
+#else  // !CONFIG_ULP_COPROC_TYPE_LP_CORE
+
+esp_err_t lp_sampler_start(const lp_sampler_config_t *config)
+{
+    ESP_LOGW(TAG, "⚠ Núcleo LP no habilitado (CONFIG_ULP_COPROC_TYPE_LP_CORE)");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t lp_sampler_stop(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool lp_sampler_woke_main(void)
+{
+    return false;
+}
+
+uint32_t lp_sampler_wake_reason(void)
+{
+    return LP_WAKE_NONE;
+}
+
+size_t lp_sampler_drain(float *levels_cm, size_t max, uint32_t *dropped)
+{
+    if (dropped != NULL) {
+        *dropped = 0;
+    }
+    return 0;
+}
+
+esp_err_t lp_sampler_sleep(const lp_sampler_config_t *config)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif  // CONFIG_ULP_COPROC_TYPE_LP_CORE
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lp_decision.h"
+
+/**
+ * Muestreo periódico del nivel en el núcleo LP del ESP32-C6.
+ *
+ * Mientras el HP duerme en deep sleep, el núcleo LP mide el ultrasónico en
+ * cada período, acumula las muestras en memoria RTC y despierta al HP solo
+ * cuando el lote se llena, el nivel cruza un umbral (con histéresis) o el
+ * sensor falla repetidamente.
+ *
+ * Requiere CONFIG_ULP_COPROC_TYPE_LP_CORE; sin él las funciones retornan
+ * ESP_ERR_NOT_SUPPORTED. TRIG y ECHO deben estar en pines LP IO (GPIO0-7).
+ */
+
+typedef struct {
+    int trig_pin;                // LP IO (GPIO0-7)
+    int echo_pin;                // LP IO (GPIO0-7)
+    uint32_t period_ms;          // Período de muestreo del núcleo LP
+    float level_low_cm;          // Umbral de zona baja (misma lectura que sensor_data_t.water_level)
+    float level_high_cm;         // Umbral de zona alta
+    float level_deadband_cm;     // Histéresis
+    uint32_t batch_size;         // Muestras por lote (<= LP_BATCH_MAX)
+} lp_sampler_config_t;
+
+/**
+ * @brief Configura y arranca el programa LP
+ *
+ * En un arranque en frío carga el binario y reinicia el lote; tras un
+ * despertar por el núcleo LP conserva el estado de decisión.
+ */
+esp_err_t lp_sampler_start(const lp_sampler_config_t *config);
+
+/**
+ * @brief Detiene el núcleo LP y devuelve TRIG/ECHO al HP
+ */
+esp_err_t lp_sampler_stop(void);
+
+/**
+ * @brief true si este arranque lo causó el núcleo LP
+ */
+bool lp_sampler_woke_main(void);
+
+/**
+ * @brief Razones acumuladas del despertar (máscara de lp_wake_reason_t)
+ */
+uint32_t lp_sampler_wake_reason(void);
+
+/**
+ * @brief Copia el lote convertido a cm y lo vacía
+ *
+ * Las muestras sin eco se entregan como -1. Retorna el número de muestras.
+ */
+size_t lp_sampler_drain(float *levels_cm, size_t max, uint32_t *dropped);
+
+/**
+ * @brief Arranca el núcleo LP y entra en deep sleep con despertar por LP
+ *
+ * No retorna si tiene éxito.
+ */
+esp_err_t lp_sampler_sleep(const lp_sampler_config_t *config);
+
+/**
+ * @brief Convierte nivel en cm a duración de eco en µs (ida y vuelta a 343 m/s)
+ */
+uint32_t lp_sampler_cm_to_echo_us(float cm);
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+#include "lp_decision.h"
+
+/**
+ * Bloque compartido entre el HP y el núcleo LP, ubicado en memoria RTC.
+ * El programa LP define `lp_shared`; el HP lo ve como `ulp_lp_shared`.
+ * Solo campos de 32 bits para que los accesos de ambos núcleos sean atómicos.
+ */
+typedef struct {
+    lp_decision_cfg_t cfg;      // HP → LP
+    uint32_t trig_io;           // LP IO del TRIG
+    uint32_t echo_io;           // LP IO del ECHO
+    lp_decision_state_t state;  // LP (el HP lo reinicia en frío)
+    uint32_t runs;              // Ejecuciones del programa LP
+    uint32_t wake_pending;      // 1 tras despertar al HP, hasta que éste vacía el lote
+    uint32_t wake_reason;       // Máscara acumulada de lp_wake_reason_t
+    uint32_t count;             // Muestras en el lote
+    uint32_t dropped;           // Muestras perdidas con el lote lleno
+    lp_sample_t samples[LP_BATCH_MAX];
+} lp_shared_t;
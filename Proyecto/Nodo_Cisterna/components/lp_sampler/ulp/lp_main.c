@@ -0,0 +1,77 @@
+/*
+ * Programa del núcleo LP: una ejecución por período del temporizador LP.
+ * Dispara el HC-SR04, mide el eco contando ciclos, agrega la muestra al lote
+ * y despierta al HP solo si lp_decision_step() lo indica.
+ *
+ * El ESP32-C6 no tiene ADC accesible desde el núcleo LP: el TDS lo muestrea
+ * el HP en cada despertar (tds_raw = LP_TDS_NONE aquí).
+ */
+#include <stdint.h>
+#include "ulp_lp_core_utils.h"
+#include "ulp_lp_core_gpio.h"
+#include "riscv/csr.h"
+
+#include "lp_shared.h"
+
+// Reloj del núcleo LP (RC_FAST, nominal para ulp_lp_core_delay_us)
+#define LP_CPU_FREQ_HZ      16000000
+#define LP_CYCLES_PER_US    (LP_CPU_FREQ_HZ / 1000000)
+#define LP_ECHO_TIMEOUT_US  30000
+
+volatile lp_shared_t lp_shared;
+
+static uint32_t measure_echo_us(lp_io_num_t trig, lp_io_num_t echo)
+{
+    ulp_lp_core_gpio_set_level(trig, 1);
+    ulp_lp_core_delay_us(10);
+    ulp_lp_core_gpio_set_level(trig, 0);
+
+    const uint32_t timeout = LP_ECHO_TIMEOUT_US * LP_CYCLES_PER_US;
+    uint32_t start = RV_READ_CSR(mcycle);
+    while (ulp_lp_core_gpio_get_level(echo) == 0) {
+        if (RV_READ_CSR(mcycle) - start > timeout) {
+            return 0;
+        }
+    }
+
+    start = RV_READ_CSR(mcycle);
+    while (ulp_lp_core_gpio_get_level(echo) != 0) {
+        if (RV_READ_CSR(mcycle) - start > timeout) {
+            return 0;
+        }
+    }
+    uint32_t us = (RV_READ_CSR(mcycle) - start) / LP_CYCLES_PER_US;
+    return us ? us : 1;
+}
+
+int main(void)
+{
+    lp_shared.runs++;
+
+    lp_sample_t sample = {
+        .echo_us = measure_echo_us((lp_io_num_t)lp_shared.trig_io, (lp_io_num_t)lp_shared.echo_io),
+        .tds_raw = LP_TDS_NONE,
+    };
+
+    uint32_t count = lp_shared.count;
+    if (count < LP_BATCH_MAX) {
+        lp_shared.samples[count] = sample;
+        lp_shared.count = ++count;
+    } else {
+        lp_shared.dropped++;
+    }
+
+    uint32_t wake = lp_decision_step((lp_decision_state_t *)&lp_shared.state,
+                                     (const lp_decision_cfg_t *)&lp_shared.cfg,
+                                     &sample, count);
+    if (wake != LP_WAKE_NONE) {
+        lp_shared.wake_reason |= wake;
+        if (!lp_shared.wake_pending) {
+            lp_shared.wake_pending = 1;
+            ulp_lp_core_wakeup_main_processor();
+        }
+    }
+
+    // Al retornar, el núcleo LP se detiene hasta el próximo período del temporizador
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "power.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_pm.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "POWER";
+
+#define POWER_MAX_FREQ_MHZ CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define POWER_MIN_FREQ_MHZ 40           // XTAL: la frecuencia más baja con el APB estable
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_stats_t s_stats;
+static uint64_t s_pump_latency_sum_us = 0;
+
+// Contabilidad del ciclo en curso
+static int64_t s_cycle_start_us = 0;
+static uint32_t s_idle_mark = 0;
+static volatile uint64_t s_sleep_acc_us = 0;    // Actualizado desde el callback de light sleep
+static uint64_t s_sleep_mark = 0;
+static int64_t s_sensor_lock_start_us = 0;
+static uint32_t s_sensor_lock_us = 0;
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_cpu_lock = NULL;
+static esp_pm_lock_handle_t s_nosleep_lock = NULL;
+#endif
+
+/**
+ * @brief Tiempo acumulado de la tarea idle (incluye el tiempo en light sleep)
+ *
+ * Contador de 32 bits en µs (esp_timer): da la vuelta cada ~71 min, por eso
+ * solo se usan diferencias entre ciclos.
+ */
+static uint32_t power_idle_time_us(void)
+{
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    return (uint32_t)ulTaskGetIdleRunTimeCounter();
+#else
+    return 0;
+#endif
+}
+
+#if CONFIG_PM_ENABLE && CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+static esp_err_t IRAM_ATTR power_light_sleep_exit_cb(int64_t sleep_time_us, void *arg)
+{
+    // Mismo spinlock que el resto de estadísticas; _SAFE porque el callback
+    // corre en el camino de sleep del idle con interrupciones deshabilitadas
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_sleep_acc_us += (uint64_t)sleep_time_us;
+    s_stats.light_sleeps++;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+    return ESP_OK;
+}
+#endif
+
+static esp_err_t power_configure(bool light_sleep)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = POWER_MAX_FREQ_MHZ,
+        .min_freq_mhz = POWER_MIN_FREQ_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = light_sleep,
+#else
+        .light_sleep_enable = false,
+#endif
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error configurando esp_pm: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    s_stats.light_sleep = pm_config.light_sleep_enable;
+    ESP_LOGI(TAG, "✓ DFS %d-%d MHz, light sleep %s", POWER_MIN_FREQ_MHZ, POWER_MAX_FREQ_MHZ,
+             s_stats.light_sleep ? "automático" : "deshabilitado");
+    return ESP_OK;
+#else
+    (void)light_sleep;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t power_init(bool light_sleep)
+{
+    power_reset_stats();
+
+#if CONFIG_PM_ENABLE
+    esp_err_t ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "sensor_cpu", &s_cpu_lock);
+    if (ret == ESP_OK) {
+        ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "sensor_nosleep", &s_nosleep_lock);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error creando locks de energía: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = {
+        .exit_cb = power_light_sleep_exit_cb,
+        .exit_cb_user_arg = NULL,
+        .exit_cb_prior = 0,
+    };
+    esp_pm_light_sleep_register_cbs(&cbs);
+#endif
+
+    return power_configure(light_sleep);
+#else
+    (void)light_sleep;
+    ESP_LOGW(TAG, "⚠ CONFIG_PM_ENABLE deshabilitado: solo contabilidad");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t power_set_light_sleep(bool enable)
+{
+    esp_err_t ret = power_configure(enable);
+    if (ret == ESP_OK) {
+        power_reset_stats();
+    }
+    return ret;
+}
+
+void power_sensor_begin(void)
+{
+#if CONFIG_PM_ENABLE
+    if (s_cpu_lock != NULL) {
+        esp_pm_lock_acquire(s_cpu_lock);
+        esp_pm_lock_acquire(s_nosleep_lock);
+    }
+#endif
+    s_sensor_lock_start_us = esp_timer_get_time();
+}
+
+void power_sensor_end(void)
+{
+    s_sensor_lock_us += (uint32_t)(esp_timer_get_time() - s_sensor_lock_start_us);
+#if CONFIG_PM_ENABLE
+    if (s_cpu_lock != NULL) {
+        esp_pm_lock_release(s_nosleep_lock);
+        esp_pm_lock_release(s_cpu_lock);
+    }
+#endif
+}
+
+void power_cycle_mark(void)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t idle = power_idle_time_us();
+    taskENTER_CRITICAL(&s_lock);
+    uint64_t sleep = s_sleep_acc_us;            // 64 bits: no es atómico sin el lock
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (s_cycle_start_us != 0) {
+        uint32_t wall = (uint32_t)(now - s_cycle_start_us);
+        uint32_t idle_total = idle - s_idle_mark;
+        uint32_t slept = (uint32_t)(sleep - s_sleep_mark);
+        if (idle_total > wall) {
+            idle_total = wall;
+        }
+        if (slept > idle_total) {
+            slept = idle_total;
+        }
+
+        taskENTER_CRITICAL(&s_lock);
+        s_stats.cycles++;
+        s_stats.last_wall_us = wall;
+        s_stats.last_active_us = wall - idle_total;
+        s_stats.last_idle_us = idle_total - slept;
+        s_stats.last_sleep_us = slept;
+        s_stats.last_sensor_lock_us = s_sensor_lock_us;
+        s_stats.total_wall_us += wall;
+        s_stats.total_active_us += s_stats.last_active_us;
+        s_stats.total_idle_us += s_stats.last_idle_us;
+        s_stats.total_sleep_us += slept;
+        taskEXIT_CRITICAL(&s_lock);
+    }
+
+    s_cycle_start_us = now;
+    s_idle_mark = idle;
+    s_sleep_mark = sleep;
+    s_sensor_lock_us = 0;
+}
+
+void power_note_pump_latency_us(int64_t latency_us)
+{
+    if (latency_us < 0) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_lock);
+    s_stats.pump_samples++;
+    s_pump_latency_sum_us += (uint64_t)latency_us;
+    s_stats.pump_latency_last_us = (uint32_t)latency_us;
+    s_stats.pump_latency_avg_us = (uint32_t)(s_pump_latency_sum_us / s_stats.pump_samples);
+    if ((uint32_t)latency_us > s_stats.pump_latency_max_us) {
+        s_stats.pump_latency_max_us = (uint32_t)latency_us;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+void power_get_stats(power_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+void power_reset_stats(void)
+{
+    taskENTER_CRITICAL(&s_lock);
+    bool light_sleep = s_stats.light_sleep;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.light_sleep = light_sleep;
+    s_pump_latency_sum_us = 0;
+    s_cycle_start_us = 0;
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+static uint32_t permille(uint64_t part, uint64_t whole)
+{
+    return whole ? (uint32_t)((part * 1000) / whole) : 0;
+}
+
+void power_print_stats(void)
+{
+    power_stats_t st;
+    power_get_stats(&st);
+
+    ESP_LOGI(TAG, "=== ENERGÍA (light sleep %s, %" PRIu32 " ciclos) ===",
+             st.light_sleep ? "ON" : "OFF", st.cycles);
+    ESP_LOGI(TAG, "Último ciclo: activo=%" PRIu32 " us | ocioso=%" PRIu32 " us | dormido=%" PRIu32
+             " us | locks de muestreo=%" PRIu32 " us",
+             st.last_active_us, st.last_idle_us, st.last_sleep_us, st.last_sensor_lock_us);
+    uint32_t a = permille(st.total_active_us, st.total_wall_us);
+    uint32_t i = permille(st.total_idle_us, st.total_wall_us);
+    uint32_t s = permille(st.total_sleep_us, st.total_wall_us);
+    ESP_LOGI(TAG, "Acumulado: activo=%" PRIu32 ".%" PRIu32 "%% | ocioso=%" PRIu32 ".%" PRIu32
+             "%% | dormido=%" PRIu32 ".%" PRIu32 "%% (%" PRIu32 " entradas a light sleep)",
+             a / 10, a % 10, i / 10, i % 10, s / 10, s % 10, st.light_sleeps);
+    ESP_LOGI(TAG, "Latencia lectura→relé: n=%" PRIu32 " ultima=%" PRIu32 " prom=%" PRIu32
+             " max=%" PRIu32 " ms",
+             st.pump_samples, st.pump_latency_last_us / 1000, st.pump_latency_avg_us / 1000,
+             st.pump_latency_max_us / 1000);
+#if !CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    ESP_LOGW(TAG, "⚠ Sin CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS el tiempo ocioso no se mide");
+#endif
+}
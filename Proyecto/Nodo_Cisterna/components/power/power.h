@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * Gestión de energía del nodo: escalado dinámico de frecuencia (esp_pm) y
+ * light sleep automático en los tiempos muertos entre muestras.
+ *
+ * Los locks de esp_pm se toman solo durante el muestreo (ADC + captura del
+ * eco); la radio la gestiona el propio driver de Wi-Fi en modo ahorro.
+ * Cada ciclo de muestreo se contabiliza como tiempo activo, ocioso
+ * (despierto sin trabajo) y dormido, junto con la latencia de la regla de
+ * bomba para verificar que el ahorro no la degrada.
+ */
+
+typedef struct {
+    bool light_sleep;            // Light sleep automático habilitado
+    uint32_t cycles;             // Ciclos contabilizados desde el último reinicio de stats
+    // Último ciclo
+    uint32_t last_wall_us;
+    uint32_t last_active_us;
+    uint32_t last_idle_us;
+    uint32_t last_sleep_us;
+    uint32_t last_sensor_lock_us;   // Tiempo con los locks de muestreo tomados
+    // Acumulados
+    uint64_t total_wall_us;
+    uint64_t total_active_us;
+    uint64_t total_idle_us;
+    uint64_t total_sleep_us;
+    uint32_t light_sleeps;          // Entradas a light sleep
+    // Latencia lectura → relé de la regla automática de bomba
+    uint32_t pump_samples;
+    uint32_t pump_latency_last_us;
+    uint32_t pump_latency_avg_us;
+    uint32_t pump_latency_max_us;
+} power_stats_t;
+
+/**
+ * @brief Configura esp_pm (frecuencia máxima/mínima y light sleep) y crea los locks
+ *
+ * Sin CONFIG_PM_ENABLE retorna ESP_ERR_NOT_SUPPORTED; los locks y la
+ * contabilidad siguen siendo llamables (no hacen nada / solo miden).
+ */
+esp_err_t power_init(bool light_sleep);
+
+/**
+ * @brief Habilita o deshabilita el light sleep automático en caliente (comparación A/B)
+ */
+esp_err_t power_set_light_sleep(bool enable);
+
+/**
+ * @brief Toma los locks de muestreo (CPU a frecuencia máxima, sin light sleep)
+ */
+void power_sensor_begin(void);
+
+/**
+ * @brief Libera los locks de muestreo
+ */
+void power_sensor_end(void);
+
+/**
+ * @brief Cierra un ciclo de contabilidad (llamar una vez por ciclo de muestreo)
+ */
+void power_cycle_mark(void);
+
+/**
+ * @brief Registra la latencia entre una lectura y el cambio de relé que provocó
+ */
+void power_note_pump_latency_us(int64_t latency_us);
+
+void power_get_stats(power_stats_t *stats);
+
+/**
+ * @brief Reinicia los acumulados y la latencia de bomba
+ */
+void power_reset_stats(void);
+
+void power_print_stats(void);
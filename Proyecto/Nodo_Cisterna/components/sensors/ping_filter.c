@@ -0,0 +1,110 @@
+#include <string.h>
+
+#include "ping_filter.h"
+
+// Factor de consistencia de la MAD frente a una normal
+#define PING_MAD_SCALE 1.4826f
+
+void ping_filter_default_cfg(ping_filter_cfg_t *cfg)
+{
+    cfg->min_echo_us = 116;       // ~2 cm
+    cfg->max_echo_us = 23324;     // ~400 cm
+    cfg->hampel_k = 3.0f;
+    cfg->mad_floor_us = 30;       // ~0.5 cm
+    cfg->min_valid = 3;
+    cfg->spread_ref_cm = 2.0f;
+}
+
+/**
+ * @brief Ordenamiento por inserción: K es pequeño y el tiempo queda acotado
+ */
+static void sort_u32(uint32_t *v, int n)
+{
+    for (int i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+/**
+ * @brief Mediana de un arreglo ya ordenado (n > 0)
+ */
+static uint32_t median_sorted(const uint32_t *v, int n)
+{
+    if (n & 1) {
+        return v[n / 2];
+    }
+    return (uint32_t)(((uint64_t)v[n / 2 - 1] + v[n / 2]) / 2);
+}
+
+bool ping_filter_run(const ping_filter_cfg_t *cfg, const uint32_t *echo_us, int count,
+                     ping_result_t *out)
+{
+    uint32_t kept[PING_BURST_MAX];
+    uint32_t dev[PING_BURST_MAX];
+
+    memset(out, 0, sizeof(*out));
+    out->distance_cm = -1.0f;
+    if (count > PING_BURST_MAX) {
+        count = PING_BURST_MAX;
+    }
+    if (count <= 0) {
+        return false;
+    }
+    out->pings = (uint8_t)count;
+
+    // 1. Rango físico: descarta timeouts y ecos fuera del alcance
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (echo_us[i] >= cfg->min_echo_us && echo_us[i] <= cfg->max_echo_us) {
+            kept[n++] = echo_us[i];
+        }
+    }
+    out->in_range = (uint8_t)n;
+    if (n == 0) {
+        return false;
+    }
+
+    // 2. Mediana y MAD
+    sort_u32(kept, n);
+    uint32_t med = median_sorted(kept, n);
+    for (int i = 0; i < n; i++) {
+        dev[i] = kept[i] > med ? kept[i] - med : med - kept[i];
+    }
+    sort_u32(dev, n);
+    uint32_t mad = median_sorted(dev, n);
+    float sigma = PING_MAD_SCALE * (float)(mad > cfg->mad_floor_us ? mad : cfg->mad_floor_us);
+    float limit = cfg->hampel_k * sigma;
+
+    // 3. Hampel: promedio de los ecos cercanos a la mediana
+    uint64_t sum = 0;
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t d = kept[i] > med ? kept[i] - med : med - kept[i];
+        if ((float)d <= limit) {
+            sum += kept[i];
+            valid++;
+        }
+    }
+    out->valid = (uint8_t)valid;
+    out->spread_cm = PING_MAD_SCALE * (float)mad * PING_CM_PER_US;
+
+    // Confianza: fracción de pings aceptados, reducida a la mitad cuando la
+    // dispersión alcanza spread_ref_cm
+    float ratio = (float)valid / (float)count;
+    float ref = cfg->spread_ref_cm > 0.0f ? cfg->spread_ref_cm : 1.0f;
+    float conf = 100.0f * ratio * ref / (ref + out->spread_cm);
+    out->confidence = (uint8_t)(conf + 0.5f);
+
+    if (valid < cfg->min_valid) {
+        return false;
+    }
+    out->echo_us = (uint32_t)((sum + (uint64_t)valid / 2) / (uint64_t)valid);
+    out->distance_cm = ((float)sum / (float)valid) * PING_CM_PER_US;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef PING_FILTER_H
+#define PING_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Filtro robusto para una ráfaga de pings ultrasónicos.
+ *
+ * Recibe las duraciones de eco de K pings (0 = timeout / sin eco), descarta
+ * las que quedan fuera del rango físico del sensor y aplica un filtro de
+ * Hampel: se rechaza todo eco cuya distancia a la mediana supere
+ * k · 1.4826 · MAD. La distancia final es el promedio de los aceptados.
+ * echo_us permite convertirla con la velocidad del sonido compensada
+ * (sound_speed.h); distance_cm usa la velocidad nominal a 20 °C.
+ *
+ * C puro y sin heap: trabaja sobre copias en la pila de tamaño
+ * PING_BURST_MAX, así que se puede reproducir en el host con duraciones
+ * grabadas del sensor real.
+ */
+
+#define PING_BURST_MAX 9
+
+// Velocidad del sonido (343 m/s) ida y vuelta: cm por µs de eco
+#define PING_CM_PER_US 0.01715f
+
+typedef struct {
+    uint32_t min_echo_us;        // Eco más corto aceptado (zona muerta del sensor)
+    uint32_t max_echo_us;        // Eco más largo aceptado (alcance máximo)
+    float hampel_k;              // Umbral en desviaciones robustas (típico 3)
+    uint32_t mad_floor_us;       // MAD mínima: evita rechazar todo con ecos idénticos
+    uint8_t min_valid;           // Pings aceptados necesarios para una lectura válida
+    float spread_ref_cm;         // Dispersión a la que la confianza cae a la mitad
+} ping_filter_cfg_t;
+
+typedef struct {
+    float distance_cm;           // Promedio de los ecos aceptados a 20 °C (-1 si no es válida)
+    uint32_t echo_us;            // Eco promedio aceptado: para compensar por temperatura
+    float spread_cm;             // Dispersión robusta (1.4826 · MAD) de los aceptados
+    uint8_t pings;               // Pings disparados
+    uint8_t in_range;            // Ecos dentro del rango físico
+    uint8_t valid;               // Ecos aceptados por el filtro de Hampel
+    uint8_t confidence;          // 0-100: fracción aceptada penalizada por la dispersión
+} ping_result_t;
+
+/**
+ * @brief Configuración por defecto para el HC-SR04 (2 cm - 4 m)
+ */
+void ping_filter_default_cfg(ping_filter_cfg_t *cfg);
+
+/**
+ * @brief Filtra una ráfaga de duraciones de eco
+ *
+ * @param cfg Configuración del filtro
+ * @param echo_us Duraciones de eco en µs (0 = timeout)
+ * @param count Cantidad de pings (se recorta a PING_BURST_MAX)
+ * @param out Resultado
+ * @return true si hubo al menos cfg->min_valid ecos aceptados
+ */
+bool ping_filter_run(const ping_filter_cfg_t *cfg, const uint32_t *echo_us, int count,
+                     ping_result_t *out);
+
+#endif // PING_FILTER_H
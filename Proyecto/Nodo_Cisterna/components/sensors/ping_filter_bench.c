@@ -0,0 +1,26 @@
+#include "ping_filter.h"
+#include "bench.h"
+
+// Ráfagas de 9 ecos alrededor de 1 m (~5830 µs) con un eco espurio y un timeout
+static const uint32_t s_bursts[][PING_BURST_MAX] = {
+    { 5830, 5825, 5841, 5836, 0, 5829, 5833, 3120, 5838 },
+    { 5812, 5850, 5846, 5822, 5831, 9410, 5827, 5835, 5840 },
+    { 5833, 5833, 5834, 5832, 5833, 5831, 5835, 5833, 5834 },
+};
+static ping_filter_cfg_t s_cfg;
+static unsigned s_next;
+
+static bool bench_ping_filter_setup(void)
+{
+    ping_filter_default_cfg(&s_cfg);
+    return true;
+}
+
+static void bench_ping_filter(void)
+{
+    ping_result_t r;
+    s_next = (s_next + 1) % (sizeof(s_bursts) / sizeof(s_bursts[0]));
+    ping_filter_run(&s_cfg, s_bursts[s_next], PING_BURST_MAX, &r);
+    BENCH_KEEP_F(r.distance_cm);
+}
+BENCH_REGISTER_SETUP("ping_filter", bench_ping_filter_setup, bench_ping_filter);
@@ -1,340 +1,648 @@
-#include <string.h>
-#include <stdio.h>
-#include "esp_log.h"
-#include "esp_adc/adc_oneshot.h"
-#include "driver/gpio.h"
-#include "driver/uart.h"
-#include "esp_timer.h"
-#include "tds.h"
-#include "adc_driver.h"
-#include "storage.h"
-#include "esp_console.h"
-
-#include "sensor.h"
-
-static const char *TAG = "SENSOR";
-
-// Variables para el sensor ultrasónico
-static int g_trig_pin = -1;
-static int g_echo_pin = -1;
-// static adc_oneshot_unit_handle_t adc_handle = NULL;
-
-// Canal ADC para TDS
-static int g_tds_adc_channel = -1;
-
-// Constantes para sensor ultrasónico
-#define ULTRASONIC_PULSE_DURATION_US 10
-
-// --- Consola: comandos para calibración TDS ---
-static int cmd_calA(int argc, char **argv);
-static int cmd_calB(int argc, char **argv);
-static int cmd_save(int argc, char **argv);
-static int cmd_show(int argc, char **argv);
-
-
-/**
- * @brief Inicializa los sensores (ultrasónico y TDS)
- */
-esp_err_t sensor_init(int ultrasonic_trig_pin, int ultrasonic_echo_pin, 
-                      int tds_adc_pin)
-{
-    ESP_LOGI(TAG, "→ Inicializando sensores...");
-
-        // Almacenar pines
-        g_trig_pin = ultrasonic_trig_pin;
-        g_echo_pin = ultrasonic_echo_pin;
-        g_tds_adc_channel = tds_adc_pin;
-
-    // ========== Configurar sensor ultrasónico ==========
-    // Configurar TRIG como salida
-    gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << g_trig_pin),
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-    };
-    
-    esp_err_t ret = gpio_config(&io_conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error configurando TRIG: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // Configurar ECHO como entrada
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << g_echo_pin);
-    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
-    io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
-    
-    ret = gpio_config(&io_conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error configurando ECHO: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // ========== Configurar sensor TDS (ADC) ==========
-    adc_init(g_tds_adc_channel);
-
-    tds_init();
-    tds_load_calibration();
-
-    // Registrar comandos de consola para calibración TDS:
-    // calA  -> tomar lectura actual y guardarla como punto A (offset)
-    // calB  -> tomar lectura actual y usarla como punto B (gain)
-    // save  -> guardar calibración en NVS
-    // show  -> mostrar offset/gain actuales
-    {
-        static const esp_console_cmd_t calA_cmd_struct = {
-            .command = "calA",
-            .help = "Calibrar punto A (offset) con lectura actual",
-            .hint = NULL,
-            .func = &cmd_calA,
-        };
-        esp_console_cmd_register(&calA_cmd_struct);
-
-        static const esp_console_cmd_t calB_cmd_struct = {
-            .command = "calB",
-            .help = "Calibrar punto B (gain) con lectura actual",
-            .hint = NULL,
-            .func = &cmd_calB,
-        };
-        esp_console_cmd_register(&calB_cmd_struct);
-
-        static const esp_console_cmd_t save_cmd_struct = {
-            .command = "save",
-            .help = "Guardar calibración TDS en memoria NVS",
-            .hint = NULL,
-            .func = &cmd_save,
-        };
-        esp_console_cmd_register(&save_cmd_struct);
-
-        static const esp_console_cmd_t show_cmd_struct = {
-            .command = "show",
-            .help = "Mostrar offset y gain actuales de TDS",
-            .hint = NULL,
-            .func = &cmd_show,
-        };
-        esp_console_cmd_register(&show_cmd_struct);
-    }
-
-    ESP_LOGI(TAG, "✓ Calibración TDS cargada: offset=%.3f gain=%.3f",
-             tds_get_offset(), tds_get_gain());
-
-    ESP_LOGI(TAG, "✓ Sensores inicializados correctamente");
-    return ESP_OK;
-}
-
-/**
- * @brief Lee el nivel de agua mediante sensor ultrasónico
- * 
- * Calcula la distancia basada en:
- * - Envía pulso de 10µs al pin TRIG
- * - Mide tiempo del pulso ECHO
- * - Distancia = (tiempo_echo * velocidad_sonido) / 2
- */
-esp_err_t sensor_read_ultrasonic(float *distance)
-{
-    if (distance == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    if (g_trig_pin < 0 || g_echo_pin < 0) {
-        ESP_LOGE(TAG, "✗ Sensor ultrasónico no inicializado");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    // Enviar pulso de 10µs
-    gpio_set_level(g_trig_pin, 0);
-    esp_rom_delay_us(2);
-    gpio_set_level(g_trig_pin, 1);
-    esp_rom_delay_us(ULTRASONIC_PULSE_DURATION_US);
-    gpio_set_level(g_trig_pin, 0);
-
-    // Esperar a que ECHO se ponga en alto
-    // Aumentamos el timeout inicial a 30000 µs (30 ms) para evitar falsos timeouts
-    uint32_t timeout = 30000;  // 30ms timeout
-    uint32_t start_time = esp_timer_get_time();
-    while (gpio_get_level(g_echo_pin) == 0) {
-        if ((esp_timer_get_time() - start_time) > timeout) {
-            ESP_LOGW(TAG, "✗ Timeout esperando ECHO alto");
-            *distance = 0.0f;
-            return ESP_ERR_TIMEOUT;
-        }
-    }
-
-    // Medir duración del pulso ECHO
-    uint32_t echo_start = esp_timer_get_time();
-    timeout = 100000;  // 100ms timeout (máximo ~17 metros)
-    while (gpio_get_level(g_echo_pin) == 1) {
-        if ((esp_timer_get_time() - echo_start) > timeout) {
-            ESP_LOGW(TAG, "✗ Timeout esperando ECHO bajo");
-            *distance = 0.0f;
-            return ESP_ERR_TIMEOUT;
-        }
-    }
-    uint32_t echo_duration = esp_timer_get_time() - echo_start;
-
-    // Calcular distancia: distancia = (tiempo * velocidad_sonido) / 2
-    // Velocidad del sonido = 343 m/s = 0.0343 cm/µs
-    // Dividimos por 2 porque el sonido viaja ida y vuelta
-    *distance = (echo_duration * 0.0343f) / 2.0f;
-
-    return ESP_OK;
-}
-
-// --- Implementación de comandos de consola para calibración TDS ---
-static int cmd_calA(int argc, char **argv)
-{
-    (void)argc; (void)argv;
-    float raw = tds_read_raw();
-    tds_set_calibration_point_A(raw);
-    ESP_LOGI(TAG, "calA: raw=%.3f -> offset set", raw);
-    ESP_LOGI(TAG, "Calibration A saved in RAM: raw=%.3f | offset=%.6f", raw, tds_get_offset());
-    return 0;
-}
-
-static int cmd_calB(int argc, char **argv)
-{
-    (void)argc; (void)argv;
-    float raw = tds_read_raw();
-    tds_set_calibration_point_B(raw);
-    ESP_LOGI(TAG, "calB: raw=%.3f -> gain set", raw);
-    ESP_LOGI(TAG, "Calibration B saved in RAM: raw=%.3f | gain=%.9f", raw, tds_get_gain());
-    return 0;
-}
-
-static int cmd_save(int argc, char **argv)
-{
-    (void)argc; (void)argv;
-    esp_err_t r = tds_save_calibration();
-    if (r == ESP_OK) ESP_LOGI(TAG, "save: calibración guardada");
-    else ESP_LOGE(TAG, "save: error guardando calibración (%s)", esp_err_to_name(r));
-    if (r == ESP_OK) {
-        ESP_LOGI(TAG, "Calibration saved to NVS: offset=%.6f gain=%.9f", tds_get_offset(), tds_get_gain());
-    } else {
-        ESP_LOGW(TAG, "Calibration not saved to NVS");
-    }
-    return 0;
-}
-
-static int cmd_show(int argc, char **argv)
-{
-    (void)argc; (void)argv;
-    float off = tds_get_offset();
-    float gain = tds_get_gain();
-    ESP_LOGI(TAG, "show: offset=%.6f gain=%.6f", off, gain);
-    ESP_LOGI(TAG, "Calibration values: offset=%.6f | gain=%.9f", off, gain);
-    return 0;
-}
-
-/* Public wrappers for minimal UART command handler */
-void sensor_do_calA(void)
-{
-    float raw = tds_read_raw();
-    tds_set_calibration_point_A(raw);
-    ESP_LOGI(TAG, "(cmd) calA: raw=%.3f -> offset set | offset=%.6f", raw, tds_get_offset());
-}
-
-void sensor_do_calB(void)
-{
-    float raw = tds_read_raw();
-    tds_set_calibration_point_B(raw);
-    ESP_LOGI(TAG, "(cmd) calB: raw=%.3f -> gain set | gain=%.9f", raw, tds_get_gain());
-}
-
-void sensor_do_save(void)
-{
-    esp_err_t r = tds_save_calibration();
-    if (r == ESP_OK) {
-        ESP_LOGI(TAG, "(cmd) save: Calibration saved to NVS: offset=%.6f gain=%.9f", tds_get_offset(), tds_get_gain());
-    } else {
-        ESP_LOGE(TAG, "(cmd) save: Error saving calibration: %s", esp_err_to_name(r));
-    }
-}
-
-void sensor_do_show(void)
-{
-    float off = tds_get_offset();
-    float gain = tds_get_gain();
-    ESP_LOGI(TAG, "(cmd) show: offset=%.6f gain=%.9f", off, gain);
-}
-
-/**
- * @brief Lee el valor TDS mediante sensor analógico
- * 
- * Convierte el valor ADC a ppm:
- * - Rango ADC: 0-4095
- * - Voltaje máximo: 3.3V
- * - Voltaje = (valor_ADC / 4095) * 3.3
- * - TDS (ppm) = (Voltaje - 0.05) / 0.065
- */
-esp_err_t sensor_read_tds(float *tds_value)
-{
-    if (!tds_value) return ESP_ERR_INVALID_ARG;
-
-    float ppm = tds_read_ppm();  // <-- USA TU ALGORITMO REAL
-
-    if (ppm < 0) ppm = 0;
-
-    *tds_value = ppm;
-    return ESP_OK;
-}
-
-/**
- * @brief Clasifica la calidad del agua según el valor de TDS
- * 
- * Clasificación:
- * - < 300 ppm: agua limpia (WATER_STATE_CLEAN)
- * - 300-600 ppm: agua en estado medio (WATER_STATE_MEDIUM)
- * - > 600 ppm: agua sucia (WATER_STATE_DIRTY)
- */
-water_state_t sensor_classify_water_quality(float tds_value)
-{
-    if (tds_value < 300.0f) {
-        return WATER_STATE_CLEAN;
-    } else if (tds_value <= 600.0f) {
-        return WATER_STATE_MEDIUM;
-    } else {
-        return WATER_STATE_DIRTY;
-    }
-}
-
-/**
- * @brief Lee ambos sensores y devuelve estructura completa de datos
- */
-esp_err_t sensor_read_all(sensor_data_t *data)
-{
-    if (data == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    // Limpiar estructura
-    memset(data, 0, sizeof(sensor_data_t));
-
-    // Obtener timestamp
-    data->timestamp = (uint32_t)(esp_timer_get_time() / 1000000);
-
-        // Leer sensor ultrasónico (use heap buffer)
-        esp_err_t ret = sensor_read_ultrasonic(&data->water_level);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "✗ Error leyendo sensor ultrasónico");
-            data->water_level = -1.0f;
-        }
-
-        // Leer sensor TDS
-        ret = sensor_read_tds(&data->tds_value);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "✗ Error leyendo sensor TDS");
-            data->tds_value = -1.0f;
-        }
-    
-    // Clasificar calidad del agua
-    if (data->tds_value >= 0.0f) {
-        data->water_state = sensor_classify_water_quality(data->tds_value);
-    } else {
-        data->water_state = WATER_STATE_CLEAN;
-    }
-
-    return ESP_OK;
-}
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_adc/adc_oneshot.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "tds.h"
+#include "adc_driver.h"
+#include "storage.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sensor.h"
+#include "ping_filter.h"
+#include "ultrasonic.h"
+#include "rawstream_uart.h"
+
+static const char *TAG = "SENSOR";
+
+// Un tanque = un ultrasónico (driver compartido en Proyecto/components/ultrasonic)
+// y opcionalmente una sonda TDS en su propio canal ADC
+typedef struct {
+    char name[SENSOR_TANK_NAME_LEN];
+    ultrasonic_handle_t us;
+    int tds_channel;             // -1 sin sonda TDS
+} sensor_tank_t;
+
+static sensor_tank_t s_tanks[SENSOR_MAX_TANKS];
+static int s_tank_count = 0;
+// static adc_oneshot_unit_handle_t adc_handle = NULL;
+
+// Silencio entre pings de sensores distintos: la reverberación de un ping
+// en la sala de bombas no debe llegar al sensor del tanque vecino. Nunca hay
+// dos pings en vuelo a la vez.
+#define SENSOR_XTALK_GAP_MS 10
+
+static int64_t s_last_ping_end_us = 0;
+
+// Ronda del escaneo ADC de fondo: cada sonda TDS se convierte una vez por
+// ronda y el recorrido de sensores toma el último valor sin bloquear
+#define SENSOR_ADC_SCAN_ROUND_MS 2000
+
+static ping_filter_cfg_t s_ping_cfg;
+
+// Temperatura del aire para la velocidad del sonido. Sin sensor de
+// temperatura se usa la constante; con SENSOR_AIR_TEMP_SIMULATED se simula
+// un ciclo diario (pruebas de la compensación). Un sensor real debe llamar
+// a sensor_set_air_temp_c().
+#define SENSOR_AIR_TEMP_DEFAULT_DC   200      // 20.0 °C
+#define SENSOR_AIR_TEMP_SIMULATED    0
+#define SENSOR_AIR_TEMP_SIM_SWING_DC 80       // ±8 °C alrededor del valor por defecto
+
+// Desglose del ciclo de adquisición solapada (sensor_read_tanks)
+static portMUX_TYPE s_cycle_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_cycle_count = 0;
+static uint32_t s_cycle_last_total_us = 0;
+static uint32_t s_cycle_last_echo_us = 0;
+static uint32_t s_cycle_last_adc_us = 0;
+static uint32_t s_cycle_last_wait_us = 0;
+static uint32_t s_cycle_last_burst_us = 0;
+static uint32_t s_cycle_last_tanks = 0;
+static uint32_t s_cycle_last_seq_est_us = 0;
+static uint32_t s_cycle_max_total_us = 0;
+static uint64_t s_cycle_sum_total_us = 0;
+static uint64_t s_cycle_sum_serial_us = 0;
+
+static esp_err_t sensor_init_common(void);
+static void sensor_scan(uint32_t level_mask, uint32_t tds_mask, int pings,
+                        sensor_data_t *data, sensor_level_quality_t *quality);
+
+/**
+ * @brief Inicializa los sensores de todos los tanques de la tabla
+ */
+esp_err_t sensor_init_tanks(const sensor_tank_cfg_t *tanks, int count)
+{
+    if (tanks == NULL || count <= 0 || count > SENSOR_MAX_TANKS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGI(TAG, "→ Inicializando sensores de %d tanque(s)...", count);
+
+    // ========== Configurar sensores ultrasónicos ==========
+    // TRIG/ECHO, ISR de flancos y timeouts los maneja el driver compartido
+    for (int i = 0; i < s_tank_count; i++) {
+        ultrasonic_delete(s_tanks[i].us);
+    }
+    s_tank_count = 0;
+
+    for (int i = 0; i < count; i++) {
+        sensor_tank_t *tank = &s_tanks[i];
+        memset(tank, 0, sizeof(*tank));
+        snprintf(tank->name, sizeof(tank->name), "%s", tanks[i].name ? tanks[i].name : "tanque");
+        tank->tds_channel = tanks[i].tds_adc_channel;
+
+        ultrasonic_config_t us_cfg = ULTRASONIC_CONFIG_DEFAULT(tanks[i].trig_pin, tanks[i].echo_pin);
+        us_cfg.temp_dc = SENSOR_AIR_TEMP_DEFAULT_DC;
+        esp_err_t ret = ultrasonic_create(&us_cfg, &tank->us);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "✗ Error inicializando ultrasónico de '%s': %s", tank->name, esp_err_to_name(ret));
+            return ret;
+        }
+
+        // ========== Configurar sensor TDS (ADC) ==========
+        if (tank->tds_channel >= 0) {
+            const adc_scan_channel_cfg_t scan_cfg = {
+                .name = tank->name,
+                .channel = tank->tds_channel,
+                .samples = TDS_ADC_SAMPLES,
+                .reduce = ADC_SCAN_REDUCE_MEAN,   // Igual que calA/calB
+                .ema_shift = 0,                   // El scheduler ya mira la tendencia
+                .extra_bits = TDS_ADC_EXTRA_BITS, // Promedio en punto fijo, sin truncar
+                .target_sem_mlsb = TDS_ADC_TARGET_SEM_MLSB,
+                .min_samples = TDS_ADC_MIN_SAMPLES,  // Agua quieta: pocas conversiones
+            };
+            ret = adc_scan_add_channel(&scan_cfg);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "✗ Error inicializando ADC de '%s': %s", tank->name, esp_err_to_name(ret));
+                return ret;
+            }
+        }
+        s_tank_count = i + 1;
+        ESP_LOGI(TAG, "  ✓ Tanque %d '%s': TRIG=%d ECHO=%d TDS=%d", i, tank->name,
+                 tanks[i].trig_pin, tanks[i].echo_pin, tank->tds_channel);
+    }
+
+    return sensor_init_common();
+}
+
+/**
+ * @brief Inicializa los sensores (ultrasónico y TDS) de un único tanque
+ */
+esp_err_t sensor_init(int ultrasonic_trig_pin, int ultrasonic_echo_pin, 
+                      int tds_adc_pin)
+{
+    const sensor_tank_cfg_t tank = {
+        .name = "cisterna",
+        .trig_pin = ultrasonic_trig_pin,
+        .echo_pin = ultrasonic_echo_pin,
+        .tds_adc_channel = tds_adc_pin,
+    };
+    return sensor_init_tanks(&tank, 1);
+}
+
+/**
+ * @brief Filtro de ráfagas y calibración TDS
+ */
+static esp_err_t sensor_init_common(void)
+{
+    ping_filter_default_cfg(&s_ping_cfg);
+
+    // tds_init() ya carga la calibración desde NVS
+    tds_init();
+
+    for (int i = 0; i < s_tank_count; i++) {
+        if (s_tanks[i].tds_channel >= 0) {
+            esp_err_t ret = adc_scan_start(SENSOR_ADC_SCAN_ROUND_MS);
+            if (ret != ESP_OK) {
+                // Sin escaneo las lecturas TDS siguen siendo directas
+                ESP_LOGW(TAG, "⚠ Escaneo ADC no iniciado: %s", esp_err_to_name(ret));
+            }
+            break;
+        }
+    }
+
+    ESP_LOGI(TAG, "✓ Calibración TDS cargada: offset=%.3f gain=%.3f",
+             tds_get_offset(), tds_get_gain());
+
+    ESP_LOGI(TAG, "✓ Sensores inicializados correctamente");
+    return ESP_OK;
+}
+
+/**
+ * @brief Actualiza la temperatura simulada (si está habilitada)
+ */
+static void air_temp_refresh(void)
+{
+#if SENSOR_AIR_TEMP_SIMULATED
+    // Onda triangular de 24 h: mínimo a medianoche del arranque, máximo a mediodía
+    const int64_t day_us = 24LL * 3600 * 1000000;
+    int64_t t = esp_timer_get_time() % day_us;
+    int64_t half = day_us / 2;
+    int64_t tri = (t < half) ? t : day_us - t;          // 0 … half
+    int32_t offset = (int32_t)((tri * 2 * SENSOR_AIR_TEMP_SIM_SWING_DC) / half) - SENSOR_AIR_TEMP_SIM_SWING_DC;
+    for (int i = 0; i < s_tank_count; i++) {
+        ultrasonic_set_temp_dc(s_tanks[i].us, (int16_t)(SENSOR_AIR_TEMP_DEFAULT_DC + offset));
+    }
+#endif
+}
+
+/**
+ * @brief Fija la temperatura del aire (sensor real o comando UART)
+ */
+void sensor_set_air_temp_c(float temp_c)
+{
+    if (s_tank_count == 0) {
+        return;
+    }
+    // Todos los sensores comparten el aire de la sala
+    int16_t dc = (int16_t)(temp_c * 10.0f + (temp_c >= 0.0f ? 0.5f : -0.5f));
+    bool changed = false;
+    for (int i = 0; i < s_tank_count; i++) {
+        changed |= ultrasonic_set_temp_dc(s_tanks[i].us, dc);
+    }
+    if (changed) {
+        // 2 ms de eco = 1 ms de ida: en µm equivale a c en mm/s
+        uint32_t c_mm_s = ultrasonic_echo_to_um(s_tanks[0].us, 2000);
+        ESP_LOGI(TAG, "→ Temperatura del aire %.1f °C: c = %" PRIu32 ".%03" PRIu32 " m/s",
+                 temp_c, c_mm_s / 1000, c_mm_s % 1000);
+    }
+}
+
+float sensor_get_air_temp_c(void)
+{
+    int16_t dc = s_tank_count ? ultrasonic_get_temp_dc(s_tanks[0].us) : SENSOR_AIR_TEMP_DEFAULT_DC;
+    return (float)dc / 10.0f;
+}
+
+int sensor_tank_count(void)
+{
+    return s_tank_count;
+}
+
+const char *sensor_tank_name(int tank)
+{
+    return (tank >= 0 && tank < s_tank_count) ? s_tanks[tank].name : NULL;
+}
+
+bool sensor_tank_has_tds(int tank)
+{
+    return tank >= 0 && tank < s_tank_count && s_tanks[tank].tds_channel >= 0;
+}
+
+/**
+ * @brief Dispara un ping del tanque y retorna de inmediato
+ *
+ * Antes espera el silencio entre sensores (SENSOR_XTALK_GAP_MS desde el fin
+ * del último ping de cualquier tanque) y la guarda propia del sensor.
+ */
+static esp_err_t tank_ping_start(int tank)
+{
+    if (tank < 0 || tank >= s_tank_count) {
+        ESP_LOGE(TAG, "✗ Sensor ultrasónico no inicializado");
+        return ESP_ERR_INVALID_STATE;
+    }
+    int64_t quiet_us = s_last_ping_end_us + SENSOR_XTALK_GAP_MS * 1000LL - esp_timer_get_time();
+    uint32_t guard_us = ultrasonic_guard_remaining_us(s_tanks[tank].us);
+    int64_t wait_us = (quiet_us > (int64_t)guard_us) ? quiet_us : (int64_t)guard_us;
+    if (wait_us > 0) {
+        vTaskDelay(pdMS_TO_TICKS((wait_us + 999) / 1000));
+    }
+    return ultrasonic_trigger(s_tanks[tank].us);
+}
+
+/**
+ * @brief Espera el final del ping en vuelo del tanque
+ */
+static esp_err_t tank_ping_finish(int tank, ultrasonic_reading_t *r)
+{
+    esp_err_t ret = ultrasonic_wait(s_tanks[tank].us, r);
+    s_last_ping_end_us = r->end_us;
+    // Eco crudo de cada ping (antes del filtro de la ráfaga) para ajustar filtros
+    rawstream_push(RAWSTREAM_CH_ECHO(tank), ret == ESP_OK ? (int32_t)r->echo_us : -1, r->end_us);
+    return ret;
+}
+
+/**
+ * @brief Aplica el filtro de la ráfaga y registra el resultado
+ */
+static esp_err_t tank_burst_result(int tank, const uint32_t *echo_us, int pings,
+                                   float *distance, sensor_level_quality_t *quality)
+{
+    ping_result_t res;
+    bool ok = ping_filter_run(&s_ping_cfg, echo_us, pings, &res);
+    if (quality) {
+        quality->pings = res.pings;
+        quality->valid = res.valid;
+        quality->confidence = res.confidence;
+        quality->spread_cm = res.spread_cm;
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "✗ Ráfaga ultrasónica de '%s' sin lectura válida (%u/%u ecos aceptados)",
+                 s_tanks[tank].name, res.valid, res.pings);
+        *distance = -1.0f;
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    *distance = (float)ultrasonic_echo_to_um(s_tanks[tank].us, res.echo_us) / 10000.0f;
+    return ESP_OK;
+}
+
+/**
+ * @brief Lee el nivel de agua mediante sensor ultrasónico
+ * 
+ * Calcula la distancia basada en:
+ * - Envía pulso de 10µs al pin TRIG
+ * - Mide tiempo del pulso ECHO (flancos capturados por interrupción)
+ * - Distancia = (tiempo_echo * velocidad_sonido(T)) / 2
+ */
+esp_err_t sensor_read_ultrasonic(float *distance)
+{
+    if (distance == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    air_temp_refresh();
+    esp_err_t ret = tank_ping_start(0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ultrasonic_reading_t r;
+    ret = tank_ping_finish(0, &r);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "✗ Timeout esperando ECHO %s", r.rise_seen ? "bajo" : "alto");
+        *distance = 0.0f;
+        return ret;
+    }
+
+    // Distancia con la velocidad del sonido compensada por temperatura
+    // (aritmética entera en µm, ver sound_speed.h)
+    *distance = (float)r.distance_um / 10000.0f;
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Lee el nivel con una ráfaga de pings filtrada (mediana/Hampel)
+ */
+esp_err_t sensor_read_ultrasonic_burst(int pings, float *distance, sensor_level_quality_t *quality)
+{
+    if (distance == NULL || pings <= 0 || pings > PING_BURST_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_tank_count == 0) {
+        ESP_LOGE(TAG, "✗ Sensor ultrasónico no inicializado");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    sensor_data_t data[SENSOR_MAX_TANKS];
+    sensor_level_quality_t q[SENSOR_MAX_TANKS] = {0};
+    sensor_scan(0x1, 0x0, pings, data, q);
+    *distance = data[0].water_level;
+    if (quality) {
+        *quality = q[0];
+    }
+    return (data[0].water_level < 0.0f) ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
+
+/* Comandos calA/calB/save/show (tabla de cmdline en main.c) */
+void sensor_do_calA(void)
+{
+    float raw = tds_read_raw();
+    tds_set_calibration_point_A(raw);
+    ESP_LOGI(TAG, "(cmd) calA: raw=%.3f -> offset set | offset=%.6f", raw, tds_get_offset());
+}
+
+void sensor_do_calB(void)
+{
+    float raw = tds_read_raw();
+    tds_set_calibration_point_B(raw);
+    ESP_LOGI(TAG, "(cmd) calB: raw=%.3f -> gain set | gain=%.9f", raw, tds_get_gain());
+}
+
+void sensor_do_save(void)
+{
+    esp_err_t r = tds_save_calibration();
+    if (r == ESP_OK) {
+        ESP_LOGI(TAG, "(cmd) save: Calibration saved to NVS: offset=%.6f gain=%.9f", tds_get_offset(), tds_get_gain());
+    } else {
+        ESP_LOGE(TAG, "(cmd) save: Error saving calibration: %s", esp_err_to_name(r));
+    }
+}
+
+void sensor_do_show(void)
+{
+    float off = tds_get_offset();
+    float gain = tds_get_gain();
+    ESP_LOGI(TAG, "(cmd) show: offset=%.6f gain=%.9f", off, gain);
+}
+
+/**
+ * @brief TDS de un tanque y conversiones usadas por la ráfaga adaptativa
+ */
+static esp_err_t tank_read_tds(int tank, float *tds_value, uint8_t *samples)
+{
+    if (!tds_value) return ESP_ERR_INVALID_ARG;
+    if (!sensor_tank_has_tds(tank)) return ESP_ERR_NOT_SUPPORTED;
+
+    tds_reading_t rd;
+    esp_err_t ret = tds_read_channel(s_tanks[tank].tds_channel, &rd);  // <-- USA TU ALGORITMO REAL
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    float ppm = rd.ppm;
+
+    if (ppm < 0) ppm = 0;
+
+    *tds_value = ppm;
+    if (samples) {
+        *samples = rd.samples > UINT8_MAX ? UINT8_MAX : (uint8_t)rd.samples;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Lee el valor TDS mediante sensor analógico
+ * 
+ * Convierte el valor ADC a ppm:
+ * - Rango ADC: 0-4095
+ * - Voltaje máximo: 3.3V
+ * - Voltaje = (valor_ADC / 4095) * 3.3
+ * - TDS (ppm) = (Voltaje - 0.05) / 0.065
+ */
+esp_err_t sensor_read_tds(float *tds_value)
+{
+    return sensor_read_tds_tank(0, tds_value);
+}
+
+/**
+ * @brief Lee el TDS de un tanque (todas las sondas comparten la calibración)
+ */
+esp_err_t sensor_read_tds_tank(int tank, float *tds_value)
+{
+    return tank_read_tds(tank, tds_value, NULL);
+}
+
+/**
+ * @brief Recorrido de adquisición sobre los tanques indicados
+ *
+ * Pipeline solapado: se dispara el primer ping, se toman los TDS pedidos
+ * mientras el eco está en vuelo y recién entonces se espera el flanco de
+ * bajada. Con el escaneo ADC activo cada TDS es una copia de la tabla de
+ * últimos valores (adc_driver); solo si el valor está viejo se promedian
+ * las muestras aquí. El ciclo dura ~max(eco, ADC) en lugar de eco + ADC.
+ *
+ * Los pings de la ráfaga se intercalan por rondas (A1 B1 C1 A2 B2 C2 …):
+ * nunca hay dos en vuelo y entre sensores distintos se deja
+ * SENSOR_XTALK_GAP_MS, así que no hay diafonía acústica; la guarda de 60 ms
+ * de cada sensor transcurre mientras suenan los demás en lugar de quedar
+ * como espera muerta. Con un solo tanque se reduce a la ráfaga de siempre.
+ */
+static void sensor_scan(uint32_t level_mask, uint32_t tds_mask, int pings,
+                        sensor_data_t *data, sensor_level_quality_t *quality)
+{
+    int levels[SENSOR_MAX_TANKS];
+    int nl = 0;
+    uint32_t echo_us[SENSOR_MAX_TANKS][PING_BURST_MAX] = {{0}};
+
+    int64_t t_start = esp_timer_get_time();
+    for (int t = 0; t < s_tank_count; t++) {
+        uint32_t bit = 1u << t;
+        if (!((level_mask | tds_mask) & bit)) {
+            continue;
+        }
+        memset(&data[t], 0, sizeof(data[t]));
+        data[t].sample_us = t_start;
+        data[t].timestamp = (uint32_t)(t_start / 1000000);
+        data[t].water_level = -1.0f;
+        data[t].tds_value = -1.0f;
+        data[t].water_state = WATER_STATE_CLEAN;
+        if (level_mask & bit) {
+            levels[nl++] = t;
+        }
+    }
+    air_temp_refresh();
+
+    // Disparar el primer ping; el eco se captura por interrupción
+    ultrasonic_reading_t first = {0};
+    esp_err_t ping_ret = ESP_ERR_INVALID_STATE;
+    if (nl > 0) {
+        ping_ret = tank_ping_start(levels[0]);
+    }
+
+    // Leer los TDS mientras el eco está en vuelo
+    int64_t t_adc = esp_timer_get_time();
+    for (int t = 0; t < s_tank_count; t++) {
+        if (!(tds_mask & (1u << t))) {
+            continue;
+        }
+        if (tank_read_tds(t, &data[t].tds_value, &data[t].tds_samples) != ESP_OK) {
+            ESP_LOGW(TAG, "✗ Error leyendo sensor TDS de '%s'", s_tanks[t].name);
+            data[t].tds_value = -1.0f;
+        } else {
+            data[t].water_state = sensor_classify_water_quality(data[t].tds_value);
+        }
+    }
+    int64_t t_adc_end = esp_timer_get_time();
+
+    // Esperar el final del primer eco
+    uint64_t ping_sum_us = 0;
+    if (ping_ret == ESP_OK) {
+        ping_ret = tank_ping_finish(levels[0], &first);
+        echo_us[levels[0]][0] = first.echo_us;
+        ping_sum_us += (uint64_t)(first.end_us - first.trigger_us);
+    }
+    int64_t t_end = esp_timer_get_time();
+    // Sin eco válido se cuenta el tiempo hasta el timeout
+    int64_t first_echo_end = (ping_ret == ESP_OK) ? first.end_us : t_end;
+
+    // Rondas intercaladas con el resto de la ráfaga
+    for (int p = 0; p < pings; p++) {
+        for (int k = 0; k < nl; k++) {
+            if (p == 0 && k == 0) {
+                continue;
+            }
+            int t = levels[k];
+            ultrasonic_reading_t r;
+            if (tank_ping_start(t) != ESP_OK) {
+                continue;
+            }
+            tank_ping_finish(t, &r);
+            echo_us[t][p] = r.echo_us;
+            ping_sum_us += (uint64_t)(r.end_us - r.trigger_us);
+        }
+    }
+    int64_t t_burst_end = esp_timer_get_time();
+
+    for (int k = 0; k < nl; k++) {
+        int t = levels[k];
+        sensor_level_quality_t q = {0};
+        if (tank_burst_result(t, echo_us[t], pings, &data[t].water_level, &q) != ESP_OK) {
+            data[t].water_level = -1.0f;
+        }
+        data[t].level_pings = q.pings;
+        data[t].level_valid = q.valid;
+        data[t].level_confidence = q.confidence;
+        if (quality) {
+            quality[t] = q;
+        }
+    }
+
+    // Desglose del ciclo solapado (primer ping + ADC)
+    uint32_t total_us = (uint32_t)(t_end - t_start);
+    uint32_t first_echo_us = (uint32_t)(first_echo_end - t_start);
+    uint32_t adc_us = (uint32_t)(t_adc_end - t_adc);
+    uint32_t wait_us = (uint32_t)(t_end - t_adc_end);
+    // Lo que costaría leer tanque por tanque: ráfagas seguidas con la guarda
+    // completa entre pings del mismo sensor y el ADC aparte
+    uint64_t seq_us = ping_sum_us + adc_us +
+                      (uint64_t)nl * (pings - 1) * ULTRASONIC_GUARD_US;
+
+    taskENTER_CRITICAL(&s_cycle_lock);
+    s_cycle_count++;
+    s_cycle_last_total_us = total_us;
+    s_cycle_last_echo_us = first_echo_us;
+    s_cycle_last_adc_us = adc_us;
+    s_cycle_last_wait_us = wait_us;
+    s_cycle_last_burst_us = (uint32_t)(t_burst_end - t_end);
+    s_cycle_last_tanks = (uint32_t)nl;
+    s_cycle_last_seq_est_us = seq_us > UINT32_MAX ? UINT32_MAX : (uint32_t)seq_us;
+    if (total_us > s_cycle_max_total_us) {
+        s_cycle_max_total_us = total_us;
+    }
+    s_cycle_sum_total_us += total_us;
+    s_cycle_sum_serial_us += (uint64_t)first_echo_us + adc_us;
+    taskEXIT_CRITICAL(&s_cycle_lock);
+}
+
+/**
+ * @brief Lee nivel y/o TDS de varios tanques en un solo recorrido
+ */
+esp_err_t sensor_read_tanks(uint32_t level_mask, uint32_t tds_mask, sensor_data_t *data)
+{
+    if (data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_tank_count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t valid = (1u << s_tank_count) - 1;
+    if ((level_mask | tds_mask) & ~valid) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int t = 0; t < s_tank_count; t++) {
+        if (!sensor_tank_has_tds(t)) {
+            tds_mask &= ~(1u << t);
+        }
+    }
+    sensor_scan(level_mask, tds_mask, SENSOR_PING_BURST, data, NULL);
+    return ESP_OK;
+}
+
+/**
+ * @brief Lee ambos sensores del primer tanque y devuelve estructura completa de datos
+ */
+esp_err_t sensor_read_all(sensor_data_t *data)
+{
+    if (data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Limpiar estructura
+    memset(data, 0, sizeof(sensor_data_t));
+    if (s_tank_count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    sensor_scan(0x1, sensor_tank_has_tds(0) ? 0x1 : 0x0, SENSOR_PING_BURST, data, NULL);
+    return ESP_OK;
+}
+
+/**
+ * @brief Desglose de tiempos del último ciclo solapado y acumulados
+ */
+void sensor_get_cycle_stats(sensor_cycle_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_cycle_lock);
+    stats->cycles = s_cycle_count;
+    stats->last_total_us = s_cycle_last_total_us;
+    stats->last_echo_us = s_cycle_last_echo_us;
+    stats->last_adc_us = s_cycle_last_adc_us;
+    stats->last_wait_us = s_cycle_last_wait_us;
+    stats->last_burst_us = s_cycle_last_burst_us;
+    stats->last_tanks = s_cycle_last_tanks;
+    stats->last_seq_est_us = s_cycle_last_seq_est_us;
+    stats->max_total_us = s_cycle_max_total_us;
+    stats->avg_total_us = s_cycle_count ? (uint32_t)(s_cycle_sum_total_us / s_cycle_count) : 0;
+    stats->avg_serial_us = s_cycle_count ? (uint32_t)(s_cycle_sum_serial_us / s_cycle_count) : 0;
+    taskEXIT_CRITICAL(&s_cycle_lock);
+}
+
+void sensor_print_cycle_stats(void)
+{
+    sensor_cycle_stats_t st;
+    sensor_get_cycle_stats(&st);
+    ESP_LOGI(TAG, "=== CICLO DE ADQUISICIÓN (%" PRIu32 " ciclos solapados) ===", st.cycles);
+    ESP_LOGI(TAG, "Último: total=%" PRIu32 " us | eco=%" PRIu32 " us | ADC=%" PRIu32
+             " us | espera eco=%" PRIu32 " us",
+             st.last_total_us, st.last_echo_us, st.last_adc_us, st.last_wait_us);
+    ESP_LOGI(TAG, "Resto de la ráfaga (%" PRIu32 " tanque(s) x %d pings, intercalada): %" PRIu32
+             " us | tanque por tanque ≈ %" PRIu32 " us",
+             st.last_tanks, SENSOR_PING_BURST, st.last_burst_us, st.last_seq_est_us);
+    ESP_LOGI(TAG, "Promedio: total=%" PRIu32 " us (máx %" PRIu32 ") vs secuencial=%" PRIu32
+             " us | ahorro=%" PRIu32 " us/ciclo",
+             st.avg_total_us, st.max_total_us, st.avg_serial_us,
+             st.avg_serial_us > st.avg_total_us ? st.avg_serial_us - st.avg_total_us : 0);
+
+    for (int t = 0; t < s_tank_count; t++) {
+        ultrasonic_stats_t us;
+        ultrasonic_get_stats(s_tanks[t].us, &us);
+        ESP_LOGI(TAG, "Ultrasónico '%s': %" PRIu32 " pings | %" PRIu32 " ecos | timeouts subida=%"
+                 PRIu32 " eco=%" PRIu32 " | latencia prom=%" PRIu32 " us (máx %" PRIu32 ")",
+                 s_tanks[t].name, us.pings, us.echoes, us.rise_timeouts, us.echo_timeouts,
+                 us.latency_avg_us, us.latency_max_us);
+    }
+}
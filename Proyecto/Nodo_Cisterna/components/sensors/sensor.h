@@ -1,83 +1,250 @@
-#ifndef SENSOR_H
-#define SENSOR_H
-
-#include "esp_err.h"
-
-/**
- * @brief Estados de clasificación de calidad del agua según TDS
- */
-typedef enum {
-    WATER_STATE_CLEAN = 0,      // < 300 ppm
-    WATER_STATE_MEDIUM = 1,     // 300-600 ppm
-    WATER_STATE_DIRTY = 2       // > 600 ppm
-} water_state_t;
-
-/**
- * @brief Estructura para almacenar datos de sensores
- */
-typedef struct {
-    float water_level;           // Nivel de agua en cm
-    float tds_value;             // Valor de TDS en ppm
-    water_state_t water_state;   // Estado del agua (limpia, media, sucia)
-    uint32_t timestamp;          // Timestamp de la lectura
-} sensor_data_t;
-
-/**
- * @brief Inicializa los sensores (ultrasónico y TDS)
- * 
- * Configura los pines GPIO necesarios para:
- * - Sensor ultrasónico (TRIG y ECHO)
- * - Sensor TDS (ADC)
- * 
- * @param ultrasonic_trig_pin Pin GPIO para TRIG del sensor ultrasónico
- * @param ultrasonic_echo_pin Pin GPIO para ECHO del sensor ultrasónico
- * @param tds_adc_pin Pin ADC para el sensor TDS
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t sensor_init(int ultrasonic_trig_pin, int ultrasonic_echo_pin, int tds_adc_pin);
-
-/**
- * @brief Lee el nivel de agua mediante sensor ultrasónico
- * 
- * @param distance Puntero para almacenar la distancia en cm
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t sensor_read_ultrasonic(float *distance);
-
-/**
- * @brief Lee el valor TDS mediante sensor analógico
- * 
- * @param tds_value Puntero para almacenar el valor TDS en ppm
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t sensor_read_tds(float *tds_value);
-
-/**
- * @brief Clasifica la calidad del agua según el valor de TDS
- * 
- * Clasificación:
- * - < 300 ppm: agua limpia
- * - 300-600 ppm: agua en estado medio
- * - > 600 ppm: agua sucia
- * 
- * @param tds_value Valor de TDS en ppm
- * @return water_state_t Estado clasificado del agua
- */
-water_state_t sensor_classify_water_quality(float tds_value);
-
-/**
- * @brief Lee ambos sensores y devuelve estructura completa de datos
- * 
- * @param data Puntero a estructura para almacenar los datos leídos
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t sensor_read_all(sensor_data_t *data);
-
-/* Simple programmatic command API so external tasks (UART handler) can invoke
-    calibration without using esp_console/argtable which has caused instability. */
-void sensor_do_calA(void);
-void sensor_do_calB(void);
-void sensor_do_save(void);
-void sensor_do_show(void);
-
-#endif // SENSOR_H
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief Estados de clasificación de calidad del agua según TDS
+ */
+typedef enum {
+    WATER_STATE_CLEAN = 0,      // < 300 ppm
+    WATER_STATE_MEDIUM = 1,     // 300-600 ppm
+    WATER_STATE_DIRTY = 2       // > 600 ppm
+} water_state_t;
+
+/**
+ * @brief Estructura para almacenar datos de sensores
+ */
+typedef struct {
+    float water_level;           // Nivel de agua en cm
+    float tds_value;             // Valor de TDS en ppm
+    uint8_t tds_samples;         // Conversiones ADC de la lectura TDS (ráfaga adaptativa)
+    water_state_t water_state;   // Estado del agua (limpia, media, sucia)
+    uint32_t timestamp;          // Timestamp de la lectura
+    int64_t sample_us;           // Instante de la lectura (esp_timer, µs)
+    uint8_t level_pings;         // Pings disparados en la ráfaga de nivel
+    uint8_t level_valid;         // Ecos aceptados por el filtro (0 = nivel inválido)
+    uint8_t level_confidence;    // Confianza del nivel, 0-100
+    float level_filtered;        // Nivel filtrado (Kalman) en cm, -1 sin estimación
+    float level_rate;            // Tasa estimada en cm/s (incluye la bomba)
+    float level_var;             // Varianza del nivel filtrado en cm², -1 sin estimación
+} sensor_data_t;
+
+/**
+ * @brief Lectura vacía: nivel, TDS y estimación en -1 (sin dato)
+ *
+ * Estado inicial de cada tanque antes de la primera lectura; la regla de
+ * la bomba lo trata como "sin estimación" y no conmuta el relé.
+ */
+static inline void sensor_data_init_empty(sensor_data_t *d)
+{
+    *d = (sensor_data_t){
+        .water_level = -1.0f,
+        .tds_value = -1.0f,
+        .level_filtered = -1.0f,
+        .level_var = -1.0f,
+    };
+}
+
+/**
+ * @brief Pings por lectura de nivel (ver ping_filter.h, máximo PING_BURST_MAX)
+ */
+#define SENSOR_PING_BURST 5
+
+/**
+ * @brief Calidad de una lectura de nivel por ráfaga
+ */
+typedef struct {
+    uint8_t pings;
+    uint8_t valid;
+    uint8_t confidence;          // 0-100
+    float spread_cm;             // Dispersión robusta de los ecos
+} sensor_level_quality_t;
+
+/**
+ * @brief Tanques por nodo (cada uno con su ultrasónico y TDS opcional)
+ */
+#define SENSOR_MAX_TANKS 4
+#define SENSOR_TANK_NAME_LEN 16
+
+/**
+ * @brief Entrada de la tabla de tanques del nodo
+ */
+typedef struct {
+    const char *name;            // Usado en logs y en el tópico MQTT
+    int trig_pin;
+    int echo_pin;
+    int tds_adc_channel;         // -1 si el tanque no tiene sonda TDS
+} sensor_tank_cfg_t;
+
+/**
+ * @brief Inicializa los sensores de todos los tanques de la tabla
+ *
+ * El índice en la tabla es el índice de tanque del resto de la API. Las
+ * sondas TDS comparten la calibración de dos puntos (calA/calB).
+ *
+ * @param tanks Tabla de tanques
+ * @param count Cantidad de tanques (1..SENSOR_MAX_TANKS)
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_init_tanks(const sensor_tank_cfg_t *tanks, int count);
+
+/**
+ * @brief Tanques configurados
+ */
+int sensor_tank_count(void);
+
+/**
+ * @brief Nombre de un tanque (NULL si el índice no existe)
+ */
+const char *sensor_tank_name(int tank);
+
+/**
+ * @brief true si el tanque tiene sonda TDS
+ */
+bool sensor_tank_has_tds(int tank);
+
+/**
+ * @brief Inicializa los sensores (ultrasónico y TDS) de un único tanque
+ * 
+ * Configura los pines GPIO necesarios para:
+ * - Sensor ultrasónico (TRIG y ECHO)
+ * - Sensor TDS (ADC)
+ * 
+ * @param ultrasonic_trig_pin Pin GPIO para TRIG del sensor ultrasónico
+ * @param ultrasonic_echo_pin Pin GPIO para ECHO del sensor ultrasónico
+ * @param tds_adc_pin Pin ADC para el sensor TDS
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_init(int ultrasonic_trig_pin, int ultrasonic_echo_pin, int tds_adc_pin);
+
+/**
+ * @brief Lee el nivel de agua mediante sensor ultrasónico
+ * 
+ * @param distance Puntero para almacenar la distancia en cm
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_read_ultrasonic(float *distance);
+
+/**
+ * @brief Lee el nivel con una ráfaga de pings y rechazo de outliers
+ *
+ * Dispara `pings` pings separados por un tiempo de guarda y filtra las
+ * duraciones con mediana/Hampel (ping_filter.c).
+ *
+ * @param pings Cantidad de pings (1..PING_BURST_MAX)
+ * @param distance Distancia filtrada en cm (-1 si no hay lectura válida)
+ * @param quality Pings válidos y confianza (puede ser NULL)
+ * @return esp_err_t ESP_OK si hubo suficientes ecos aceptados
+ */
+esp_err_t sensor_read_ultrasonic_burst(int pings, float *distance, sensor_level_quality_t *quality);
+
+/**
+ * @brief Fija la temperatura del aire usada para la velocidad del sonido
+ *
+ * El factor solo se recalcula si la temperatura cambió (décimas de °C).
+ *
+ * @param temp_c Temperatura en °C (se satura a -20 … 60 °C)
+ */
+void sensor_set_air_temp_c(float temp_c);
+
+/**
+ * @brief Temperatura del aire aplicada actualmente (°C)
+ */
+float sensor_get_air_temp_c(void);
+
+/**
+ * @brief Lee el valor TDS mediante sensor analógico
+ * 
+ * @param tds_value Puntero para almacenar el valor TDS en ppm
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_read_tds(float *tds_value);
+
+/**
+ * @brief Lee el valor TDS de un tanque
+ *
+ * @return esp_err_t ESP_ERR_NOT_SUPPORTED si el tanque no tiene sonda
+ */
+esp_err_t sensor_read_tds_tank(int tank, float *tds_value);
+
+/**
+ * @brief Clasifica la calidad del agua según el valor de TDS
+ * 
+ * Clasificación:
+ * - < 300 ppm: agua limpia
+ * - 300-600 ppm: agua en estado medio
+ * - > 600 ppm: agua sucia
+ * 
+ * @param tds_value Valor de TDS en ppm
+ * @return water_state_t Estado clasificado del agua
+ */
+water_state_t sensor_classify_water_quality(float tds_value);
+
+/**
+ * @brief Lee nivel y/o TDS de varios tanques en un solo recorrido
+ *
+ * Los TDS se muestrean mientras el primer eco está en vuelo y los pings de
+ * las ráfagas se intercalan entre tanques, uno en vuelo a la vez.
+ * Solo se escriben las entradas de los tanques pedidos.
+ *
+ * @param level_mask Bit t = medir nivel del tanque t
+ * @param tds_mask Bit t = medir TDS del tanque t (se ignora sin sonda)
+ * @param data Arreglo indexado por tanque (SENSOR_MAX_TANKS entradas)
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_read_tanks(uint32_t level_mask, uint32_t tds_mask, sensor_data_t *data);
+
+/**
+ * @brief Lee ambos sensores del primer tanque y devuelve estructura completa de datos
+ *
+ * El nivel se obtiene con una ráfaga de SENSOR_PING_BURST pings; el TDS se
+ * muestrea mientras el primer eco está en vuelo.
+ * 
+ * @param data Puntero a estructura para almacenar los datos leídos
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t sensor_read_all(sensor_data_t *data);
+
+/**
+ * @brief Desglose de tiempos del ciclo solapado de sensor_read_tanks()
+ *
+ * "eco" va del disparo al flanco de bajada; "ADC" es el promedio del TDS
+ * hecho mientras el eco está en vuelo; "espera eco" es lo que la tarea
+ * quedó bloqueada tras terminar el ADC. avg_serial_us = eco + ADC, lo que
+ * costaría el mismo ciclo leyendo un sensor después del otro.
+ */
+typedef struct {
+    uint32_t cycles;
+    uint32_t last_total_us;
+    uint32_t last_echo_us;
+    uint32_t last_adc_us;
+    uint32_t last_wait_us;
+    uint32_t last_burst_us;      // Resto de las ráfagas de nivel tras el ciclo solapado
+    uint32_t last_tanks;         // Tanques con nivel en el último recorrido
+    uint32_t last_seq_est_us;    // Estimación del mismo recorrido tanque por tanque
+    uint32_t avg_total_us;
+    uint32_t max_total_us;
+    uint32_t avg_serial_us;
+} sensor_cycle_stats_t;
+
+/**
+ * @brief Obtiene el desglose de tiempos de los ciclos solapados
+ */
+void sensor_get_cycle_stats(sensor_cycle_stats_t *stats);
+
+/**
+ * @brief Imprime el desglose de tiempos por consola
+ */
+void sensor_print_cycle_stats(void);
+
+/* Calibración TDS: manejadores de calA/calB/save/show, registrados en la tabla
+   única de comandos (cmdline) que usan la UART y esp_console. */
+void sensor_do_calA(void);
+void sensor_do_calB(void);
+void sensor_do_save(void);
+void sensor_do_show(void);
+
+#endif // SENSOR_H
@@ -0,0 +1,22 @@
+#include "sensor.h"
+
+// C puro (fuera de sensor.c) para probarlo en el host
+
+/**
+ * @brief Clasifica la calidad del agua según el valor de TDS
+ * 
+ * Clasificación:
+ * - < 300 ppm: agua limpia (WATER_STATE_CLEAN)
+ * - 300-600 ppm: agua en estado medio (WATER_STATE_MEDIUM)
+ * - > 600 ppm: agua sucia (WATER_STATE_DIRTY), también un valor no numérico
+ */
+water_state_t sensor_classify_water_quality(float tds_value)
+{
+    if (tds_value < 300.0f) {
+        return WATER_STATE_CLEAN;
+    } else if (tds_value <= 600.0f) {
+        return WATER_STATE_MEDIUM;
+    } else {
+        return WATER_STATE_DIRTY;
+    }
+}
@@ -0,0 +1,12 @@
+#include "sensor.h"
+#include "bench.h"
+
+static const float s_tds[] = { 120.0f, 299.9f, 300.0f, 455.5f, 600.0f, 600.1f, 980.0f, -1.0f };
+static unsigned s_next;
+
+static void bench_classify(void)
+{
+    s_next = (s_next + 1) & 7;
+    BENCH_KEEP(sensor_classify_water_quality(s_tds[s_next]));
+}
+BENCH_REGISTER("classify", bench_classify);
@@ -0,0 +1,111 @@
+#include <string.h>
+
+#include "level_kf.h"
+
+// Varianza inicial de la tasa: sin información, ±3 cm/s
+#define LEVEL_KF_RATE_VAR0 9.0f
+
+void level_kf_init(level_kf_t *kf, const level_kf_cfg_t *cfg)
+{
+    memset(kf, 0, sizeof(*kf));
+    kf->cfg = *cfg;
+}
+
+static void level_kf_reset(level_kf_t *kf, uint32_t now_ms, bool pump_on, float level_cm, float r)
+{
+    kf->initialized = true;
+    kf->level = level_cm;
+    kf->rate = 0.0f;
+    kf->p00 = r;
+    kf->p01 = 0.0f;
+    kf->p11 = LEVEL_KF_RATE_VAR0;
+    kf->last_ms = now_ms;
+    kf->last_pump = pump_on;
+    kf->consecutive_rejects = 0;
+}
+
+bool level_kf_step(level_kf_t *kf, uint32_t now_ms, bool pump_on, float level_cm,
+                   uint8_t confidence)
+{
+    bool has_meas = confidence > 0;
+    // R crece al bajar la confianza: 100 → meas_var, 25 → 4·meas_var
+    float r = has_meas ? kf->cfg.meas_var_cm2 * 100.0f / (float)confidence : 0.0f;
+
+    if (!kf->initialized) {
+        if (!has_meas) {
+            return false;
+        }
+        level_kf_reset(kf, now_ms, pump_on, level_cm, r);
+        kf->updates++;
+        return true;
+    }
+
+    float dt = (float)(uint32_t)(now_ms - kf->last_ms) / 1000.0f;
+    if (dt > kf->cfg.max_dt_s) {
+        if (has_meas) {
+            level_kf_reset(kf, now_ms, pump_on, level_cm, r);
+            kf->updates++;
+            return true;
+        }
+        dt = kf->cfg.max_dt_s;
+    }
+    kf->last_ms = now_ms;
+
+    // ===== Predicción con la bomba como entrada conocida =====
+    float u = kf->last_pump ? kf->cfg.pump_rate_cm_s : 0.0f;
+    kf->level += (kf->rate + u) * dt;
+
+    // P = F·P·Fᵀ + Q, con F = [[1, dt], [0, 1]] y Q de aceleración blanca
+    float q = kf->cfg.accel_noise;
+    float dt2 = dt * dt;
+    float p00 = kf->p00 + dt * (2.0f * kf->p01 + dt * kf->p11) + q * dt2 * dt / 3.0f;
+    float p01 = kf->p01 + dt * kf->p11 + q * dt2 / 2.0f;
+    float p11 = kf->p11 + q * dt;
+
+    // Al conmutar la bomba, la tasa real cambia de golpe
+    if (pump_on != kf->last_pump) {
+        p11 += kf->cfg.pump_switch_var;
+        kf->last_pump = pump_on;
+    }
+    kf->p00 = p00;
+    kf->p01 = p01;
+    kf->p11 = p11;
+
+    if (!has_meas) {
+        return false;
+    }
+
+    // ===== Corrección =====
+    float y = level_cm - kf->level;
+    float s = kf->p00 + r;
+    float gate = kf->cfg.gate_sigma;
+    if (y * y > gate * gate * s) {
+        kf->rejected++;
+        if (++kf->consecutive_rejects >= LEVEL_KF_MAX_REJECTS) {
+            level_kf_reset(kf, now_ms, pump_on, level_cm, r);
+            kf->updates++;
+            return true;
+        }
+        return false;
+    }
+    kf->consecutive_rejects = 0;
+    float k0 = kf->p00 / s;
+    float k1 = kf->p01 / s;
+    kf->level += k0 * y;
+    kf->rate += k1 * y;
+
+    // P = (I - K·H)·P con H = [1, 0]
+    float n00 = (1.0f - k0) * kf->p00;
+    float n01 = (1.0f - k0) * kf->p01;
+    float n11 = kf->p11 - k1 * kf->p01;
+    kf->p00 = n00;
+    kf->p01 = n01;
+    kf->p11 = n11;
+    kf->updates++;
+    return true;
+}
+
+float level_kf_total_rate(const level_kf_t *kf)
+{
+    return kf->rate + (kf->last_pump ? kf->cfg.pump_rate_cm_s : 0.0f);
+}
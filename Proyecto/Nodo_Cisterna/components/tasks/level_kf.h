@@ -0,0 +1,74 @@
+#ifndef LEVEL_KF_H
+#define LEVEL_KF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Filtro de Kalman 1-D para el nivel de la cisterna.
+ *
+ * Estado: x = [nivel (cm), tasa no modelada (cm/s)]. El estado del relé es
+ * una entrada conocida: con la bomba encendida el nivel avanza además
+ * pump_rate_cm_s. La tasa del estado absorbe consumos, fugas y el error de
+ * pump_rate_cm_s; al conmutar la bomba se infla su varianza para que se
+ * reajuste rápido.
+ *
+ *   predicción:  h += (v + u·q)·dt        P = F·P·Fᵀ + Q(dt)
+ *   corrección:  z = nivel medido, R = varianza según la confianza
+ *
+ * Las innovaciones mayores a gate_sigma desviaciones se descartan; tras
+ * LEVEL_KF_MAX_REJECTS rechazos seguidos el filtro se reinicia sobre la
+ * medición (cambio real de nivel que el modelo no siguió).
+ * C puro, sin heap y de tiempo constante; se prueba en el host.
+ */
+
+#define LEVEL_KF_MAX_REJECTS 5
+
+typedef struct {
+    float pump_rate_cm_s;        // Avance del nivel con la bomba encendida (entrada conocida)
+    float accel_noise;           // Ruido de proceso sobre la tasa (cm²/s³)
+    float meas_var_cm2;          // Varianza de una medición con confianza 100
+    float pump_switch_var;       // Varianza sumada a la tasa al conmutar la bomba (cm²/s²)
+    float gate_sigma;            // Umbral de rechazo de innovaciones
+    float max_dt_s;              // dt mayor a esto (pausa larga) reinicia la covarianza
+} level_kf_cfg_t;
+
+typedef struct {
+    level_kf_cfg_t cfg;
+    bool initialized;
+    float level;                 // cm
+    float rate;                  // cm/s no modelada (sin la bomba)
+    float p00, p01, p11;         // Covarianza (simétrica)
+    uint32_t last_ms;
+    bool last_pump;
+    uint32_t updates;
+    uint32_t rejected;
+    uint8_t consecutive_rejects;
+} level_kf_t;
+
+/**
+ * @brief Inicializa el filtro; la primera medición válida fija el nivel
+ */
+void level_kf_init(level_kf_t *kf, const level_kf_cfg_t *cfg);
+
+/**
+ * @brief Avanza el filtro hasta now_ms y, si hay medición, la incorpora
+ *
+ * El intervalo transcurrido se predice con el estado del relé de la llamada
+ * anterior; pump_on rige desde now_ms hasta la próxima llamada.
+ *
+ * @param now_ms Instante monótono en ms
+ * @param pump_on Estado actual del relé (a partir de now_ms)
+ * @param level_cm Nivel medido
+ * @param confidence Confianza de la medición 0-100 (0 = sin medición, solo predice)
+ * @return true si la medición fue aceptada
+ */
+bool level_kf_step(level_kf_t *kf, uint32_t now_ms, bool pump_on, float level_cm,
+                   uint8_t confidence);
+
+/**
+ * @brief Tasa total estimada (cm/s), incluida la contribución de la bomba
+ */
+float level_kf_total_rate(const level_kf_t *kf);
+
+#endif // LEVEL_KF_H
@@ -0,0 +1,31 @@
+#include "level_kf.h"
+#include "bench.h"
+
+// Mismos parámetros que tasks.c; cada iteración es un paso de 1 s con medición
+static const level_kf_cfg_t s_cfg = {
+    .pump_rate_cm_s = 0.3f,
+    .accel_noise = 1e-5f,
+    .meas_var_cm2 = 4.0f,
+    .pump_switch_var = 0.05f,
+    .gate_sigma = 4.0f,
+    .max_dt_s = 120.0f,
+};
+static const float s_noise_cm[] = { 0.8f, -1.3f, 0.1f, 2.2f, -0.6f, -1.9f, 1.1f, 0.4f };
+static level_kf_t s_kf;
+static uint32_t s_now_ms;
+
+static bool bench_level_kf_setup(void)
+{
+    level_kf_init(&s_kf, &s_cfg);
+    s_now_ms = 0;
+    return true;
+}
+
+static void bench_level_kf(void)
+{
+    s_now_ms += 1000;
+    float z = 120.0f + s_noise_cm[(s_now_ms / 1000) % 8];
+    level_kf_step(&s_kf, s_now_ms, false, z, 90);
+    BENCH_KEEP_F(s_kf.level);
+}
+BENCH_REGISTER_SETUP("level_kf", bench_level_kf_setup, bench_level_kf);
@@ -0,0 +1,17 @@
+#include "pump_rule.h"
+
+pump_rule_action_t pump_rule_decide(const pump_rule_cfg_t *cfg, const sensor_data_t *data)
+{
+    bool level_ok = (data->level_var >= 0.0f);
+    bool level_low = level_ok && (data->level_filtered < cfg->level_low_cm);
+    bool level_high = level_ok && (data->level_filtered > cfg->level_high_cm);
+    bool water_acceptable = (data->water_state != WATER_STATE_DIRTY);
+
+    if (level_low && water_acceptable) {
+        return PUMP_RULE_ON;
+    }
+    if (level_high || !water_acceptable) {
+        return PUMP_RULE_OFF;
+    }
+    return PUMP_RULE_KEEP;
+}
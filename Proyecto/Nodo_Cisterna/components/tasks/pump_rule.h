@@ -0,0 +1,34 @@
+#ifndef PUMP_RULE_H
+#define PUMP_RULE_H
+
+#include "../sensors/sensor.h"
+
+/**
+ * Regla automática de la bomba (pump_control_task en main.c).
+ *
+ * Los umbrales se comparan contra el nivel filtrado (Kalman), así el
+ * jitter crudo de varios cm no hace conmutar el relé:
+ * - Nivel bajo y agua aceptable (≤600 ppm) → encender
+ * - Nivel alto o agua sucia (>600 ppm) → apagar
+ * - Si no, se mantiene el estado
+ * Sin estimación de nivel (level_var < 0) solo el agua sucia actúa.
+ * C puro; se prueba en el host.
+ */
+
+typedef enum {
+    PUMP_RULE_KEEP = 0,
+    PUMP_RULE_ON,
+    PUMP_RULE_OFF,
+} pump_rule_action_t;
+
+typedef struct {
+    float level_low_cm;          // Por debajo se enciende
+    float level_high_cm;         // Por encima se apaga
+} pump_rule_cfg_t;
+
+/**
+ * @brief Decide la acción sobre el relé para una lectura
+ */
+pump_rule_action_t pump_rule_decide(const pump_rule_cfg_t *cfg, const sensor_data_t *data);
+
+#endif // PUMP_RULE_H
@@ -0,0 +1,28 @@
+#include "pump_rule.h"
+#include "bench.h"
+
+static const pump_rule_cfg_t s_cfg = { .level_low_cm = 20.0f, .level_high_cm = 180.0f };
+static sensor_data_t s_data[4];
+static unsigned s_next;
+
+static bool bench_pump_rule_setup(void)
+{
+    // Bajo y limpia, alto, intermedio sucia, sin estimación
+    const float level[4] = { 15.0f, 185.0f, 90.0f, 90.0f };
+    const float var[4] = { 0.8f, 0.8f, 0.8f, -1.0f };
+    const water_state_t state[4] = { WATER_STATE_CLEAN, WATER_STATE_MEDIUM, WATER_STATE_DIRTY,
+                                     WATER_STATE_CLEAN };
+    for (int i = 0; i < 4; i++) {
+        s_data[i].level_filtered = level[i];
+        s_data[i].level_var = var[i];
+        s_data[i].water_state = state[i];
+    }
+    return true;
+}
+
+static void bench_pump_rule(void)
+{
+    s_next = (s_next + 1) & 3;
+    BENCH_KEEP(pump_rule_decide(&s_cfg, &s_data[s_next]));
+}
+BENCH_REGISTER_SETUP("pump_rule", bench_pump_rule_setup, bench_pump_rule);
@@ -0,0 +1,134 @@
+#include <string.h>
+
+#include "sched.h"
+
+// Comparación de tiempos tolerante al desborde de 32 bits (~49 días en ms)
+static inline bool time_reached(uint32_t now_ms, uint32_t due_ms)
+{
+    return (int32_t)(now_ms - due_ms) >= 0;
+}
+
+void sched_init(sched_t *s, uint32_t baseline_period_ms, uint32_t now_ms)
+{
+    (void)now_ms;
+    memset(s, 0, sizeof(*s));
+    s->baseline_period_ms = baseline_period_ms ? baseline_period_ms : 1000;
+}
+
+int sched_add(sched_t *s, const sched_sensor_cfg_t *cfg, uint32_t now_ms)
+{
+    if (s->count >= SCHED_MAX_SENSORS || cfg->min_period_ms == 0 ||
+        cfg->max_period_ms < cfg->min_period_ms) {
+        return -1;
+    }
+
+    int id = s->count++;
+    sched_sensor_t *e = &s->sensors[id];
+    memset(e, 0, sizeof(*e));
+    e->cfg = *cfg;
+    e->period_ms = cfg->min_period_ms;
+    e->next_due_ms = now_ms;            // Primera lectura inmediata
+    e->first_sample_ms = now_ms;
+    return id;
+}
+
+uint32_t sched_due(const sched_t *s, uint32_t now_ms)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < s->count; i++) {
+        if (time_reached(now_ms, s->sensors[i].next_due_ms)) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+uint32_t sched_wait_ms(const sched_t *s, uint32_t now_ms)
+{
+    uint32_t wait = UINT32_MAX;
+    for (int i = 0; i < s->count; i++) {
+        const sched_sensor_t *e = &s->sensors[i];
+        if (time_reached(now_ms, e->next_due_ms)) {
+            return 0;
+        }
+        uint32_t left = e->next_due_ms - now_ms;
+        if (left < wait) {
+            wait = left;
+        }
+    }
+    return (wait == UINT32_MAX) ? 0 : wait;
+}
+
+static uint32_t clamp_period(const sched_sensor_cfg_t *cfg, uint32_t period_ms)
+{
+    if (period_ms < cfg->min_period_ms) {
+        return cfg->min_period_ms;
+    }
+    if (period_ms > cfg->max_period_ms) {
+        return cfg->max_period_ms;
+    }
+    return period_ms;
+}
+
+void sched_report(sched_t *s, int id, float value, bool valid, bool boost,
+                  uint32_t now_ms, uint32_t cost_us)
+{
+    if (id < 0 || id >= s->count) {
+        return;
+    }
+    sched_sensor_t *e = &s->sensors[id];
+    const sched_sensor_cfg_t *cfg = &e->cfg;
+
+    e->samples++;
+    e->cost_sum_us += cost_us;
+
+    uint32_t period = e->period_ms;
+    if (!valid) {
+        // Lectura fallida: reintentar pronto sin tocar la referencia
+        period = cfg->min_period_ms;
+    } else {
+        if (boost || !e->has_last) {
+            period = cfg->min_period_ms;
+        } else {
+            uint32_t dt_ms = now_ms - e->last_sample_ms;
+            float delta = value - e->last_value;
+            if (delta < 0.0f) {
+                delta = -delta;
+            }
+            float rate = dt_ms ? (delta * 1000.0f) / (float)dt_ms : 0.0f;
+
+            if (rate >= cfg->fast_rate) {
+                period = cfg->min_period_ms;
+            } else if (rate <= cfg->stable_rate) {
+                period = period + period / 4;
+            } else {
+                period = period / 2;
+            }
+        }
+        e->last_value = value;
+        e->last_sample_ms = now_ms;
+        e->has_last = true;
+    }
+
+    e->period_ms = clamp_period(cfg, period);
+    e->next_due_ms = now_ms + e->period_ms;
+}
+
+void sched_get_stats(const sched_t *s, int id, uint32_t now_ms, sched_sensor_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (id < 0 || id >= s->count) {
+        return;
+    }
+    const sched_sensor_t *e = &s->sensors[id];
+    uint32_t elapsed_ms = now_ms - e->first_sample_ms;
+
+    out->period_ms = e->period_ms;
+    out->samples = e->samples;
+    out->rate_mhz = elapsed_ms ? (uint32_t)(((uint64_t)e->samples * 1000000u) / elapsed_ms) : 0;
+    out->avg_cost_us = e->samples ? (uint32_t)(e->cost_sum_us / e->samples) : 0;
+    out->baseline_samples = elapsed_ms / s->baseline_period_ms + 1;
+    if (out->baseline_samples > e->samples) {
+        out->saved_cpu_us = (uint64_t)(out->baseline_samples - e->samples) * out->avg_cost_us;
+    }
+}
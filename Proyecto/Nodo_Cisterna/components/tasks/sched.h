@@ -0,0 +1,79 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Planificador de muestreo multi-tasa: cada sensor tiene su propio período
+ * que se adapta a la actividad, siempre dentro de [min, max].
+ *
+ * - Con la bomba encendida o un ritmo de cambio alto → período mínimo.
+ * - Con la señal estable → el período crece un 25% por muestra hasta el máximo.
+ * - Entre ambos umbrales → el período se reduce a la mitad.
+ *
+ * C puro (sin FreeRTOS ni ESP-IDF): los tiempos son ms monótonos que
+ * entrega quien llama, y se prueba en el host.
+ */
+
+#define SCHED_MAX_SENSORS 8     // Nivel + TDS para hasta 4 tanques
+
+typedef struct {
+    const char *name;
+    uint32_t min_period_ms;
+    uint32_t max_period_ms;
+    float fast_rate;             // |Δvalor|/s por encima del cual se muestrea al mínimo
+    float stable_rate;           // |Δvalor|/s por debajo del cual el período crece
+} sched_sensor_cfg_t;
+
+typedef struct {
+    sched_sensor_cfg_t cfg;
+    uint32_t period_ms;          // Período actual
+    uint32_t next_due_ms;
+    uint32_t last_sample_ms;
+    float last_value;
+    bool has_last;
+    // Estadísticas
+    uint32_t samples;
+    uint32_t first_sample_ms;
+    uint64_t cost_sum_us;        // Tiempo de CPU medido en las lecturas
+} sched_sensor_t;
+
+typedef struct {
+    sched_sensor_t sensors[SCHED_MAX_SENSORS];
+    int count;
+    uint32_t baseline_period_ms; // Período fijo de referencia para calcular el ahorro
+} sched_t;
+
+typedef struct {
+    uint32_t period_ms;
+    uint32_t samples;
+    uint32_t rate_mhz;           // Tasa efectiva en milihertz (muestras por 1000 s)
+    uint32_t avg_cost_us;        // Costo medio de una lectura
+    uint32_t baseline_samples;   // Lecturas que habría hecho el período fijo
+    uint64_t saved_cpu_us;       // (baseline - reales) × costo medio
+} sched_sensor_stats_t;
+
+void sched_init(sched_t *s, uint32_t baseline_period_ms, uint32_t now_ms);
+
+/** Agrega un sensor; retorna su id o -1 si no hay espacio / config inválida */
+int sched_add(sched_t *s, const sched_sensor_cfg_t *cfg, uint32_t now_ms);
+
+/** Máscara de sensores vencidos (bit = id) */
+uint32_t sched_due(const sched_t *s, uint32_t now_ms);
+
+/** ms hasta el próximo sensor vencido (0 si ya hay alguno) */
+uint32_t sched_wait_ms(const sched_t *s, uint32_t now_ms);
+
+/**
+ * Registra una lectura y recalcula el período del sensor.
+ * @param valid  false si la lectura falló (se reintenta con el período mínimo)
+ * @param boost  true mientras la bomba está encendida
+ * @param cost_us Tiempo de CPU de la lectura, para el cálculo de ahorro
+ */
+void sched_report(sched_t *s, int id, float value, bool valid, bool boost,
+                  uint32_t now_ms, uint32_t cost_us);
+
+void sched_get_stats(const sched_t *s, int id, uint32_t now_ms, sched_sensor_stats_t *out);
+
+#endif // SCHED_H
@@ -0,0 +1,73 @@
+#include <string.h>
+
+#include "tank_history.h"
+
+void tank_history_init(tank_history_t *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void tank_history_push(tank_history_t *h, int tank, uint32_t t_ms,
+                       float level_cm, float tds_ppm, uint8_t confidence)
+{
+    if (tank < 0 || tank >= TANK_HIST_MAX_TANKS) {
+        return;
+    }
+    uint16_t i = h->head[tank];
+    h->t_ms[tank][i] = t_ms;
+    h->level_cm[tank][i] = level_cm;
+    h->tds_ppm[tank][i] = tds_ppm;
+    h->confidence[tank][i] = confidence;
+    h->head[tank] = (uint16_t)((i + 1) % TANK_HIST_LEN);
+    if (h->count[tank] < TANK_HIST_LEN) {
+        h->count[tank]++;
+    }
+}
+
+bool tank_history_summary(const tank_history_t *h, int tank, int window,
+                          tank_history_summary_t *out)
+{
+    if (tank < 0 || tank >= TANK_HIST_MAX_TANKS || h->count[tank] == 0) {
+        return false;
+    }
+    int n = h->count[tank];
+    if (window > 0 && window < n) {
+        n = window;
+    }
+    int newest = (h->head[tank] + TANK_HIST_LEN - 1) % TANK_HIST_LEN;
+    int oldest = (h->head[tank] + TANK_HIST_LEN - n) % TANK_HIST_LEN;
+
+    // Cada pasada recorre un solo campo del tanque
+    const float *level = h->level_cm[tank];
+    float lmin = 0.0f, lmax = 0.0f, lsum = 0.0f;
+    int lcount = 0;
+    for (int k = 0, i = oldest; k < n; k++, i = (i + 1) % TANK_HIST_LEN) {
+        float v = level[i];
+        if (v < 0.0f) {
+            continue;
+        }
+        if (lcount == 0 || v < lmin) lmin = v;
+        if (lcount == 0 || v > lmax) lmax = v;
+        lsum += v;
+        lcount++;
+    }
+
+    const float *tds = h->tds_ppm[tank];
+    float tsum = 0.0f;
+    int tcount = 0;
+    for (int k = 0, i = oldest; k < n; k++, i = (i + 1) % TANK_HIST_LEN) {
+        if (tds[i] >= 0.0f) {
+            tsum += tds[i];
+            tcount++;
+        }
+    }
+
+    out->samples = (uint16_t)n;
+    out->level_samples = (uint16_t)lcount;
+    out->level_min_cm = lcount ? lmin : -1.0f;
+    out->level_max_cm = lcount ? lmax : -1.0f;
+    out->level_mean_cm = lcount ? lsum / lcount : -1.0f;
+    out->tds_mean_ppm = tcount ? tsum / tcount : -1.0f;
+    out->span_ms = h->t_ms[tank][newest] - h->t_ms[tank][oldest];
+    return true;
+}
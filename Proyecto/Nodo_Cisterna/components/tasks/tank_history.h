@@ -0,0 +1,54 @@
+#ifndef TANK_HISTORY_H
+#define TANK_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Historial reciente de lecturas por tanque en formato struct-of-arrays.
+ *
+ * Cada campo es un arreglo contiguo [tanque][muestra] en lugar de un
+ * arreglo de structs: los resúmenes que arma la telemetría (mín/máx/media
+ * del nivel, media del TDS) recorren un solo campo y tocan solo sus líneas
+ * de caché, y agregar tanques no cambia el costo por tanque.
+ * C puro, sin heap; se prueba en el host.
+ */
+
+// tasks.c verifica con _Static_assert que alcance para SENSOR_MAX_TANKS
+#define TANK_HIST_MAX_TANKS 4
+// Muestras por tanque: 30 s de nivel al período mínimo del planificador
+// (SCHED_LEVEL_MIN_MS = 500 ms en tasks.c), 5 min al máximo de 5 s
+#define TANK_HIST_LEN       60
+
+typedef struct {
+    uint32_t t_ms[TANK_HIST_MAX_TANKS][TANK_HIST_LEN];
+    float level_cm[TANK_HIST_MAX_TANKS][TANK_HIST_LEN];     // -1 = lectura inválida
+    float tds_ppm[TANK_HIST_MAX_TANKS][TANK_HIST_LEN];      // -1 = sin sonda o inválido
+    uint8_t confidence[TANK_HIST_MAX_TANKS][TANK_HIST_LEN];
+    uint16_t head[TANK_HIST_MAX_TANKS];                     // Próxima posición a escribir
+    uint16_t count[TANK_HIST_MAX_TANKS];
+} tank_history_t;
+
+typedef struct {
+    uint16_t samples;            // Muestras en la ventana
+    uint16_t level_samples;      // De ellas, con nivel válido
+    float level_min_cm;
+    float level_max_cm;
+    float level_mean_cm;
+    float tds_mean_ppm;          // -1 si no hubo TDS válido
+    uint32_t span_ms;            // Más vieja → más nueva
+} tank_history_summary_t;
+
+void tank_history_init(tank_history_t *h);
+
+void tank_history_push(tank_history_t *h, int tank, uint32_t t_ms,
+                       float level_cm, float tds_ppm, uint8_t confidence);
+
+/**
+ * @brief Resume las últimas `window` muestras de un tanque (0 = todas)
+ * @return false si el tanque no tiene muestras
+ */
+bool tank_history_summary(const tank_history_t *h, int tank, int window,
+                          tank_history_summary_t *out);
+
+#endif // TANK_HISTORY_H
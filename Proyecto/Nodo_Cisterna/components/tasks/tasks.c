@@ -1,188 +1,454 @@
-#include <string.h>
-#include <inttypes.h>
-#include "esp_log.h"
-#include "driver/gpio.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "freertos/semphr.h"
-
-#include "tasks.h"
-#include "../sensors/sensor.h"
-
-static const char *TAG = "TASKS";
-
-// Declaración forward de función estática
-static void task_sensor_read_loop(void *pvParameters);
-
-// Variables globales
-static shared_sensor_data_t g_sensor_data = {
-    .sensor_data = {0},
-    .mutex = NULL
-};
-
-static int g_pump_relay_pin = -1;
-static bool g_pump_relay_state = false;
-
-/**
- * @brief Inicializa el sistema de tareas FreeRTOS
- */
-esp_err_t tasks_init(const task_config_t *config)
-{
-    if (config == NULL) {
-        ESP_LOGE(TAG, "✗ Configuración de tareas es NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    ESP_LOGI(TAG, "→ Inicializando sistema de tareas...");
-
-    // ========== Crear semáforo mutex ==========
-    g_sensor_data.mutex = xSemaphoreCreateMutex();
-    if (g_sensor_data.mutex == NULL) {
-        ESP_LOGE(TAG, "✗ Error creando mutex");
-        return ESP_FAIL;
-    }
-    ESP_LOGD(TAG, "  ✓ Mutex creado");
-
-    // ========== Inicializar sensores ==========
-    esp_err_t ret = sensor_init(config->ultrasonic_trig_pin,
-                                config->ultrasonic_echo_pin,
-                                config->tds_adc_pin);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error inicializando sensores: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // ========== Configurar pin del relé ==========
-    g_pump_relay_pin = config->pump_relay_pin;
-    
-    gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << g_pump_relay_pin),
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-    };
-
-    ret = gpio_config(&io_conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error configurando pin del relé: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // Apagar bomba inicialmente
-    gpio_set_level(g_pump_relay_pin, 0);
-    g_pump_relay_state = false;
-    ESP_LOGD(TAG, "  ✓ Pin del relé configurado (pin %d)", g_pump_relay_pin);
-
-    // ========== Crear tarea de lectura de sensores ==========
-    xTaskCreate(task_sensor_read_loop,
-                "sensor_read_task",
-                4096,                           // Stack size
-                (void *)config,                  // Parámetros
-                2,                              // Prioridad
-                NULL);                          // Handle
-
-    ESP_LOGI(TAG, "✓ Sistema de tareas inicializado");
-    return ESP_OK;
-}
-
-/**
- * @brief Tarea FreeRTOS para lectura periódica de sensores
- * 
- * Esta tarea realiza lecturas cada 1 segundo y actualiza la estructura
- * compartida de forma sincronizada usando un semáforo mutex
- */
-static void task_sensor_read_loop(void *pvParameters)
-{
-    const task_config_t *config = (const task_config_t *)pvParameters;
-    
-    ESP_LOGI(TAG, "→ Tarea de lectura de sensores iniciada");
-    ESP_LOGI(TAG, "  Intervalo: %" PRIu32 " ms", config->sampling_interval_ms);
-
-    sensor_data_t local_data;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-
-    while (1) {
-        // Leer sensores
-        esp_err_t err = sensor_read_all(&local_data);
-
-        if (err == ESP_OK) {
-            // Actualizar estructura compartida de forma segura
-            if (xSemaphoreTake(g_sensor_data.mutex, pdMS_TO_TICKS(100))) {
-                memcpy(&g_sensor_data.sensor_data, &local_data, 
-                       sizeof(sensor_data_t));
-                xSemaphoreGive(g_sensor_data.mutex);
-            } else {
-                ESP_LOGW(TAG, "⚠ Timeout adquiriendo mutex");
-            }
-        } else {
-            ESP_LOGW(TAG, "⚠ Error leyendo sensores");
-        }
-
-        // Esperar al siguiente ciclo
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(config->sampling_interval_ms));
-    }
-}
-
-/**
- * @brief Obtiene la estructura compartida de datos de sensores
- */
-shared_sensor_data_t* tasks_get_shared_sensor_data(void)
-{
-    return &g_sensor_data;
-}
-
-/**
- * @brief Lee datos de sensores de forma segura (con semáforo)
- */
-esp_err_t tasks_read_sensor_data(sensor_data_t *data, uint32_t timeout_ms)
-{
-    if (data == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    if (g_sensor_data.mutex == NULL) {
-        ESP_LOGE(TAG, "✗ Mutex no inicializado");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    // Intentar adquirir el mutex
-    if (xSemaphoreTake(g_sensor_data.mutex, pdMS_TO_TICKS(timeout_ms))) {
-        // Copiar datos
-        memcpy(data, &g_sensor_data.sensor_data, sizeof(sensor_data_t));
-        xSemaphoreGive(g_sensor_data.mutex);
-        return ESP_OK;
-    } else {
-        ESP_LOGW(TAG, "⚠ Timeout adquiriendo mutex (timeout=%" PRIu32 " ms)", timeout_ms);
-        return ESP_ERR_TIMEOUT;
-    }
-}
-
-/**
- * @brief Controla el relé de la bomba sumergible
- */
-esp_err_t tasks_set_pump_relay(bool enable)
-{
-    if (g_pump_relay_pin < 0) {
-        ESP_LOGE(TAG, "✗ Pin del relé no configurado");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    // Evitar cambios innecesarios
-    if (g_pump_relay_state != enable) {
-        gpio_set_level(g_pump_relay_pin, enable ? 1 : 0);
-        g_pump_relay_state = enable;
-        
-        ESP_LOGI(TAG, "→ Relé de bomba: %s", enable ? "ENCENDIDO" : "APAGADO");
-    }
-
-    return ESP_OK;
-}
-
-/**
- * @brief Obtiene el estado actual del relé de la bomba
- */
-bool tasks_get_pump_relay_state(void)
-{
-    return g_pump_relay_state;
-}
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "tasks.h"
+#include "boot_prof.h"
+#include "power.h"
+#include "sched.h"
+#include "level_kf.h"
+#include "tank_history.h"
+#include "../sensors/sensor.h"
+
+static const char *TAG = "TASKS";
+
+// Declaración forward de función estática
+static void task_sensor_read_loop(void *pvParameters);
+
+// Variables globales
+static shared_sensor_data_t g_sensor_data = {
+    .tanks = {{0}},
+    .tank_count = 0,
+    .mutex = NULL
+};
+
+// Historial SoA por tanque; se escribe y se lee bajo g_sensor_data.mutex
+_Static_assert(TANK_HIST_MAX_TANKS >= SENSOR_MAX_TANKS, "historial chico para SENSOR_MAX_TANKS");
+static tank_history_t g_history;
+static int g_pump_tank = 0;
+
+static int g_pump_relay_pin = -1;
+static bool g_pump_relay_state = false;
+
+// Períodos adaptativos por sensor: el nivel cambia rápido con la bomba
+// encendida; el TDS varía en minutos
+#define SCHED_LEVEL_MIN_MS      500
+#define SCHED_LEVEL_MAX_MS      5000
+#define SCHED_LEVEL_FAST_CM_S   0.5f     // Llenado/vaciado activo
+#define SCHED_LEVEL_STABLE_CM_S 0.05f    // Por debajo del ruido del HC-SR04
+#define SCHED_TDS_MIN_MS        2000
+#define SCHED_TDS_MAX_MS        60000
+#define SCHED_TDS_FAST_PPM_S    5.0f
+#define SCHED_TDS_STABLE_PPM_S  0.5f
+
+static sched_t g_sched;
+static int g_sched_level[SENSOR_MAX_TANKS];
+static int g_sched_tds[SENSOR_MAX_TANKS];    // -1 si el tanque no tiene sonda
+static char g_sched_names[SENSOR_MAX_TANKS][2][SENSOR_TANK_NAME_LEN + 8];
+static portMUX_TYPE g_sched_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Filtro de Kalman del nivel. El avance con la bomba encendida es una
+// estimación del caudal: el filtro corrige la diferencia en la tasa.
+#define KF_PUMP_RATE_CM_S       0.3f
+#define KF_ACCEL_NOISE          1e-5f    // cm²/s³: la tasa real cambia lento
+#define KF_MEAS_VAR_CM2         4.0f     // σ ≈ 2 cm por ráfaga con confianza 100
+#define KF_PUMP_SWITCH_VAR      0.05f
+#define KF_GATE_SIGMA           4.0f
+#define KF_MAX_DT_S             120.0f
+
+static level_kf_t g_level_kf[SENSOR_MAX_TANKS];
+
+/**
+ * @brief Inicializa el sistema de tareas FreeRTOS
+ */
+esp_err_t tasks_init(const task_config_t *config)
+{
+    if (config == NULL) {
+        ESP_LOGE(TAG, "✗ Configuración de tareas es NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->tanks == NULL || config->tank_count <= 0 ||
+        config->tank_count > SENSOR_MAX_TANKS ||
+        config->pump_tank < 0 || config->pump_tank >= config->tank_count) {
+        ESP_LOGE(TAG, "✗ Tabla de tanques inválida (%d tanques, bomba en %d)",
+                 config->tank_count, config->pump_tank);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(TAG, "→ Inicializando sistema de tareas...");
+
+    // ========== Crear semáforo mutex ==========
+    g_sensor_data.mutex = xSemaphoreCreateMutex();
+    if (g_sensor_data.mutex == NULL) {
+        ESP_LOGE(TAG, "✗ Error creando mutex");
+        return ESP_FAIL;
+    }
+    ESP_LOGD(TAG, "  ✓ Mutex creado");
+
+    // ========== Inicializar sensores ==========
+    esp_err_t ret = sensor_init_tanks(config->tanks, config->tank_count);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error inicializando sensores: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    g_sensor_data.tank_count = config->tank_count;
+    // Sin dato hasta la primera lectura: con ceros la regla vería nivel 0 con
+    // varianza válida y agua limpia, y encendería la bomba al arrancar
+    for (int i = 0; i < SENSOR_MAX_TANKS; i++) {
+        sensor_data_init_empty(&g_sensor_data.tanks[i]);
+    }
+    g_pump_tank = config->pump_tank;
+    tank_history_init(&g_history);
+
+    // ========== Configurar pin del relé ==========
+    g_pump_relay_pin = config->pump_relay_pin;
+    
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << g_pump_relay_pin),
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+    };
+
+    ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error configurando pin del relé: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Mantener la salida del relé durante el light sleep automático
+    gpio_sleep_sel_dis(g_pump_relay_pin);
+
+    // Apagar bomba inicialmente
+    gpio_set_level(g_pump_relay_pin, 0);
+    g_pump_relay_state = false;
+    ESP_LOGD(TAG, "  ✓ Pin del relé configurado (pin %d)", g_pump_relay_pin);
+
+    // ========== Crear tarea de lectura de sensores ==========
+    int prof = boot_prof_begin("task_create");
+    xTaskCreate(task_sensor_read_loop,
+                "sensor_read_task",
+                4096,                           // Stack size
+                (void *)config,                  // Parámetros
+                2,                              // Prioridad
+                NULL);                          // Handle
+    boot_prof_end(prof);
+
+    ESP_LOGI(TAG, "✓ Sistema de tareas inicializado");
+    return ESP_OK;
+}
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Tarea FreeRTOS para lectura periódica de sensores
+ * 
+ * Cada sensor de cada tanque se lee con su propio período adaptativo
+ * (sched.c). Todo lo vencido en una vuelta se lee en un solo recorrido de
+ * sensor_read_tanks(): los TDS durante el vuelo del primer eco y los pings
+ * de nivel intercalados entre tanques. Se actualizan solo los campos leídos
+ * en la estructura compartida, protegida por el semáforo mutex, y se agrega
+ * una muestra al historial del tanque. Cada lectura de nivel pasa por el
+ * filtro de Kalman (level_kf.c) del tanque; el estado del relé es entrada
+ * conocida solo para el tanque que llena la bomba, que mientras está
+ * encendida se muestrea al período mínimo.
+ * Una sola tarea atiende todos los tanques: agregar uno no agrega stacks.
+ * Los locks de energía se toman solo durante la lectura; el resto del
+ * período el sistema puede bajar la frecuencia o entrar en light sleep.
+ */
+static void task_sensor_read_loop(void *pvParameters)
+{
+    const task_config_t *config = (const task_config_t *)pvParameters;
+    int tanks = config->tank_count;
+    
+    ESP_LOGI(TAG, "→ Tarea de lectura de sensores iniciada (%d tanque(s))", tanks);
+    ESP_LOGI(TAG, "  Nivel: %d-%d ms | TDS: %d-%d ms (referencia fija %" PRIu32 " ms)",
+             SCHED_LEVEL_MIN_MS, SCHED_LEVEL_MAX_MS, SCHED_TDS_MIN_MS, SCHED_TDS_MAX_MS,
+             config->sampling_interval_ms);
+
+    sched_sensor_cfg_t level_cfg = {
+        .name = "nivel",
+        .min_period_ms = SCHED_LEVEL_MIN_MS,
+        .max_period_ms = SCHED_LEVEL_MAX_MS,
+        .fast_rate = SCHED_LEVEL_FAST_CM_S,
+        .stable_rate = SCHED_LEVEL_STABLE_CM_S,
+    };
+    sched_sensor_cfg_t tds_cfg = {
+        .name = "tds",
+        .min_period_ms = SCHED_TDS_MIN_MS,
+        .max_period_ms = SCHED_TDS_MAX_MS,
+        .fast_rate = SCHED_TDS_FAST_PPM_S,
+        .stable_rate = SCHED_TDS_STABLE_PPM_S,
+    };
+    const level_kf_cfg_t kf_cfg = {
+        .pump_rate_cm_s = KF_PUMP_RATE_CM_S,
+        .accel_noise = KF_ACCEL_NOISE,
+        .meas_var_cm2 = KF_MEAS_VAR_CM2,
+        .pump_switch_var = KF_PUMP_SWITCH_VAR,
+        .gate_sigma = KF_GATE_SIGMA,
+        .max_dt_s = KF_MAX_DT_S,
+    };
+
+    sensor_data_t local_data[SENSOR_MAX_TANKS] = {0};
+    uint32_t t = now_ms();
+    taskENTER_CRITICAL(&g_sched_lock);
+    sched_init(&g_sched, config->sampling_interval_ms, t);
+    taskEXIT_CRITICAL(&g_sched_lock);
+    for (int i = 0; i < tanks; i++) {
+        // Con un solo tanque se conservan los nombres de siempre
+        if (tanks > 1) {
+            snprintf(g_sched_names[i][0], sizeof(g_sched_names[i][0]), "nivel:%s", sensor_tank_name(i));
+            snprintf(g_sched_names[i][1], sizeof(g_sched_names[i][1]), "tds:%s", sensor_tank_name(i));
+            level_cfg.name = g_sched_names[i][0];
+            tds_cfg.name = g_sched_names[i][1];
+        }
+        taskENTER_CRITICAL(&g_sched_lock);
+        g_sched_level[i] = sched_add(&g_sched, &level_cfg, t);
+        g_sched_tds[i] = sensor_tank_has_tds(i) ? sched_add(&g_sched, &tds_cfg, t) : -1;
+        taskEXIT_CRITICAL(&g_sched_lock);
+
+        level_kf_init(&g_level_kf[i], &kf_cfg);
+        sensor_data_init_empty(&local_data[i]);
+    }
+
+    while (1) {
+        uint32_t due = sched_due(&g_sched, now_ms());
+
+        if (due != 0) {
+            // Tanques con nivel/TDS vencido en esta vuelta
+            uint32_t level_mask = 0;
+            uint32_t tds_mask = 0;
+            int n_level = 0;
+            int n_tds = 0;
+            for (int i = 0; i < tanks; i++) {
+                if (g_sched_level[i] >= 0 && (due & (1u << g_sched_level[i]))) {
+                    level_mask |= 1u << i;
+                    n_level++;
+                }
+                if (g_sched_tds[i] >= 0 && (due & (1u << g_sched_tds[i]))) {
+                    tds_mask |= 1u << i;
+                    n_tds++;
+                }
+            }
+
+            // Leer sensores (ADC + captura del eco) a frecuencia máxima y sin dormir
+            power_sensor_begin();
+            sensor_data_t scan[SENSOR_MAX_TANKS];
+            int64_t t0 = esp_timer_get_time();
+            sensor_read_tanks(level_mask, tds_mask, scan);
+            int64_t t1 = esp_timer_get_time();
+            power_sensor_end();
+
+            // El ADC se reparte entre los TDS; el resto del recorrido (eco no
+            // cubierto por el ADC y ráfagas intercaladas) entre los niveles
+            sensor_cycle_stats_t cyc;
+            sensor_get_cycle_stats(&cyc);
+            uint32_t scan_us = (uint32_t)(t1 - t0);
+            uint32_t adc_us = (tds_mask != 0) ? cyc.last_adc_us : 0;
+            uint32_t level_cost = n_level ? (scan_us - adc_us) / n_level : 0;
+            uint32_t tds_cost = n_tds ? adc_us / n_tds : 0;
+            uint32_t t1_ms = (uint32_t)(t1 / 1000);
+
+            for (int i = 0; i < tanks; i++) {
+                uint32_t bit = 1u << i;
+                if (!((level_mask | tds_mask) & bit)) {
+                    continue;
+                }
+                sensor_data_t *d = &local_data[i];
+                bool pump = (i == g_pump_tank) && g_pump_relay_state;
+
+                if (level_mask & bit) {
+                    d->water_level = scan[i].water_level;
+                    d->level_pings = scan[i].level_pings;
+                    d->level_valid = scan[i].level_valid;
+                    d->level_confidence = scan[i].level_confidence;
+                    taskENTER_CRITICAL(&g_sched_lock);
+                    sched_report(&g_sched, g_sched_level[i], d->water_level,
+                                 d->water_level >= 0.0f, pump, t1_ms, level_cost);
+                    taskEXIT_CRITICAL(&g_sched_lock);
+
+                    // Fusionar la nueva lectura de nivel con el modelo de la bomba
+                    // Confianza 0 = solo predicción; una ráfaga válida pesa al menos 1
+                    uint8_t conf = 0;
+                    if (d->level_valid > 0) {
+                        conf = d->level_confidence > 0 ? d->level_confidence : 1;
+                    }
+                    level_kf_step(&g_level_kf[i], t1_ms, pump, d->water_level, conf);
+                    if (g_level_kf[i].initialized) {
+                        d->level_filtered = g_level_kf[i].level;
+                        d->level_rate = level_kf_total_rate(&g_level_kf[i]);
+                        d->level_var = g_level_kf[i].p00;
+                    }
+                }
+                if (tds_mask & bit) {
+                    d->tds_value = scan[i].tds_value;
+                    d->tds_samples = scan[i].tds_samples;
+                    d->water_state = scan[i].water_state;
+                    taskENTER_CRITICAL(&g_sched_lock);
+                    sched_report(&g_sched, g_sched_tds[i], d->tds_value, d->tds_value >= 0.0f,
+                                 false, t1_ms, tds_cost);
+                    taskEXIT_CRITICAL(&g_sched_lock);
+                }
+                d->sample_us = t1;
+                d->timestamp = (uint32_t)(d->sample_us / 1000000);
+            }
+            boot_prof_event_once("first_sample");
+
+            // Actualizar estructura compartida e historial de forma segura
+            if (xSemaphoreTake(g_sensor_data.mutex, pdMS_TO_TICKS(100))) {
+                for (int i = 0; i < tanks; i++) {
+                    uint32_t bit = 1u << i;
+                    if (!((level_mask | tds_mask) & bit)) {
+                        continue;
+                    }
+                    memcpy(&g_sensor_data.tanks[i], &local_data[i], sizeof(sensor_data_t));
+                    // Solo lo medido en esta vuelta; lo demás queda como -1
+                    tank_history_push(&g_history, i, t1_ms,
+                                      (level_mask & bit) ? local_data[i].water_level : -1.0f,
+                                      (tds_mask & bit) ? local_data[i].tds_value : -1.0f,
+                                      (level_mask & bit) ? local_data[i].level_confidence : 0);
+                }
+                xSemaphoreGive(g_sensor_data.mutex);
+            } else {
+                ESP_LOGW(TAG, "⚠ Timeout adquiriendo mutex");
+            }
+        }
+
+        // Dormir hasta el próximo sensor vencido
+        power_cycle_mark();
+        TickType_t wait = pdMS_TO_TICKS(sched_wait_ms(&g_sched, now_ms()));
+        vTaskDelay(wait > 0 ? wait : 1);
+    }
+}
+
+/**
+ * @brief Imprime período actual, tasa efectiva y CPU ahorrada por sensor
+ */
+void tasks_print_sched_stats(void)
+{
+    uint32_t t = now_ms();
+    ESP_LOGI(TAG, "=== MUESTREO ADAPTATIVO (referencia fija %" PRIu32 " ms) ===", g_sched.baseline_period_ms);
+    for (int i = 0; i < g_sched.count; i++) {
+        sched_sensor_stats_t st;
+        taskENTER_CRITICAL(&g_sched_lock);
+        sched_get_stats(&g_sched, i, t, &st);
+        taskEXIT_CRITICAL(&g_sched_lock);
+        ESP_LOGI(TAG, "%-6s período=%" PRIu32 " ms | %" PRIu32 " lecturas (%" PRIu32 ".%03" PRIu32
+                 " Hz) | costo=%" PRIu32 " us | ahorro=%" PRIu32 " lecturas, %" PRIu32 " ms CPU",
+                 g_sched.sensors[i].cfg.name, st.period_ms, st.samples,
+                 st.rate_mhz / 1000, st.rate_mhz % 1000, st.avg_cost_us,
+                 st.baseline_samples > st.samples ? st.baseline_samples - st.samples : 0,
+                 (uint32_t)(st.saved_cpu_us / 1000));
+    }
+}
+
+/**
+ * @brief Obtiene la estructura compartida de datos de sensores
+ */
+shared_sensor_data_t* tasks_get_shared_sensor_data(void)
+{
+    return &g_sensor_data;
+}
+
+/**
+ * @brief Lee datos de sensores del tanque de la bomba de forma segura (con semáforo)
+ */
+esp_err_t tasks_read_sensor_data(sensor_data_t *data, uint32_t timeout_ms)
+{
+    return tasks_read_tank_data(g_pump_tank, data, timeout_ms);
+}
+
+/**
+ * @brief Lee datos de sensores de un tanque de forma segura (con semáforo)
+ */
+esp_err_t tasks_read_tank_data(int tank, sensor_data_t *data, uint32_t timeout_ms)
+{
+    if (data == NULL || tank < 0 || tank >= g_sensor_data.tank_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (g_sensor_data.mutex == NULL) {
+        ESP_LOGE(TAG, "✗ Mutex no inicializado");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Intentar adquirir el mutex
+    if (xSemaphoreTake(g_sensor_data.mutex, pdMS_TO_TICKS(timeout_ms))) {
+        // Copiar datos
+        memcpy(data, &g_sensor_data.tanks[tank], sizeof(sensor_data_t));
+        xSemaphoreGive(g_sensor_data.mutex);
+        return ESP_OK;
+    } else {
+        ESP_LOGW(TAG, "⚠ Timeout adquiriendo mutex (timeout=%" PRIu32 " ms)", timeout_ms);
+        return ESP_ERR_TIMEOUT;
+    }
+}
+
+int tasks_get_tank_count(void)
+{
+    return g_sensor_data.tank_count;
+}
+
+int tasks_get_pump_tank(void)
+{
+    return g_pump_tank;
+}
+
+/**
+ * @brief Resumen del historial reciente de un tanque
+ */
+esp_err_t tasks_get_tank_summary(int tank, int window, tank_history_summary_t *out,
+                                 uint32_t timeout_ms)
+{
+    if (out == NULL || tank < 0 || tank >= g_sensor_data.tank_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_sensor_data.mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!xSemaphoreTake(g_sensor_data.mutex, pdMS_TO_TICKS(timeout_ms))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    bool ok = tank_history_summary(&g_history, tank, window, out);
+    xSemaphoreGive(g_sensor_data.mutex);
+    return ok ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+/**
+ * @brief Controla el relé de la bomba sumergible
+ */
+esp_err_t tasks_set_pump_relay(bool enable)
+{
+    if (g_pump_relay_pin < 0) {
+        ESP_LOGE(TAG, "✗ Pin del relé no configurado");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Evitar cambios innecesarios
+    if (g_pump_relay_state != enable) {
+        gpio_set_level(g_pump_relay_pin, enable ? 1 : 0);
+        g_pump_relay_state = enable;
+        
+        ESP_LOGI(TAG, "→ Relé de bomba: %s", enable ? "ENCENDIDO" : "APAGADO");
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Obtiene el estado actual del relé de la bomba
+ */
+bool tasks_get_pump_relay_state(void)
+{
+    return g_pump_relay_state;
+}
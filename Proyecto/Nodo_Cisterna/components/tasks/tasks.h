@@ -1,67 +1,106 @@
-#ifndef TASKS_H
-#define TASKS_H
-
-#include "esp_err.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "../sensors/sensor.h"
-
-/**
- * @brief Estructura para compartir datos entre tareas de forma sincronizada
- */
-typedef struct {
-    sensor_data_t sensor_data;
-    SemaphoreHandle_t mutex;     // Semáforo para sincronizar acceso
-} shared_sensor_data_t;
-
-/**
- * @brief Estructura para configuración de tareas
- */
-typedef struct {
-    uint32_t sampling_interval_ms;  // Intervalo de muestreo (1000ms = 1 segundo)
-    int ultrasonic_trig_pin;        // Pin GPIO del sensor ultrasónico TRIG
-    int ultrasonic_echo_pin;        // Pin GPIO del sensor ultrasónico ECHO
-    int tds_adc_pin;                // Pin ADC del sensor TDS
-    int pump_relay_pin;             // Pin GPIO del relé que controla la bomba
-} task_config_t;
-
-/**
- * @brief Inicializa el sistema de tareas FreeRTOS
- * 
- * @param config Estructura con configuración de tareas
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t tasks_init(const task_config_t *config);
-
-/**
- * @brief Obtiene la estructura compartida de datos de sensores
- * 
- * @return shared_sensor_data_t* Puntero a estructura de datos compartidos
- */
-shared_sensor_data_t* tasks_get_shared_sensor_data(void);
-
-/**
- * @brief Lee datos de sensores de forma segura (con semáforo)
- * 
- * @param data Puntero para almacenar los datos leídos
- * @param timeout_ms Timeout en ms para adquirir el semáforo
- * @return esp_err_t ESP_OK si es exitoso, ESP_ERR_TIMEOUT si agota tiempo
- */
-esp_err_t tasks_read_sensor_data(sensor_data_t *data, uint32_t timeout_ms);
-
-/**
- * @brief Controla el relé de la bomba sumergible
- * 
- * @param enable true para encender, false para apagar
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t tasks_set_pump_relay(bool enable);
-
-/**
- * @brief Obtiene el estado actual del relé de la bomba
- * 
- * @return bool true si está encendido, false si está apagado
- */
-bool tasks_get_pump_relay_state(void);
-
-#endif // TASKS_H
+#ifndef TASKS_H
+#define TASKS_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "../sensors/sensor.h"
+#include "tank_history.h"
+
+/**
+ * @brief Estructura para compartir datos entre tareas de forma sincronizada
+ */
+typedef struct {
+    sensor_data_t tanks[SENSOR_MAX_TANKS];  // Última lectura por tanque
+    int tank_count;
+    SemaphoreHandle_t mutex;     // Semáforo para sincronizar acceso
+} shared_sensor_data_t;
+
+/**
+ * @brief Estructura para configuración de tareas
+ */
+typedef struct {
+    uint32_t sampling_interval_ms;  // Intervalo fijo de referencia (los períodos reales son adaptativos)
+    const sensor_tank_cfg_t *tanks; // Tabla de tanques (ultrasónico + TDS por tanque)
+    int tank_count;                 // Entradas de la tabla (1..SENSOR_MAX_TANKS)
+    int pump_tank;                  // Tanque que llena la bomba (entrada del Kalman)
+    int pump_relay_pin;             // Pin GPIO del relé que controla la bomba
+} task_config_t;
+
+/**
+ * @brief Inicializa el sistema de tareas FreeRTOS
+ * 
+ * @param config Estructura con configuración de tareas
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t tasks_init(const task_config_t *config);
+
+/**
+ * @brief Obtiene la estructura compartida de datos de sensores
+ * 
+ * @return shared_sensor_data_t* Puntero a estructura de datos compartidos
+ */
+shared_sensor_data_t* tasks_get_shared_sensor_data(void);
+
+/**
+ * @brief Lee datos de sensores del tanque de la bomba de forma segura (con semáforo)
+ * 
+ * @param data Puntero para almacenar los datos leídos
+ * @param timeout_ms Timeout en ms para adquirir el semáforo
+ * @return esp_err_t ESP_OK si es exitoso, ESP_ERR_TIMEOUT si agota tiempo
+ */
+esp_err_t tasks_read_sensor_data(sensor_data_t *data, uint32_t timeout_ms);
+
+/**
+ * @brief Lee datos de sensores de un tanque de forma segura (con semáforo)
+ *
+ * @param tank Índice en la tabla de tanques
+ * @param data Puntero para almacenar los datos leídos
+ * @param timeout_ms Timeout en ms para adquirir el semáforo
+ * @return esp_err_t ESP_ERR_INVALID_ARG si el tanque no existe
+ */
+esp_err_t tasks_read_tank_data(int tank, sensor_data_t *data, uint32_t timeout_ms);
+
+/**
+ * @brief Tanques configurados
+ */
+int tasks_get_tank_count(void);
+
+/**
+ * @brief Tanque que llena la bomba (el de tasks_read_sensor_data)
+ */
+int tasks_get_pump_tank(void);
+
+/**
+ * @brief Resumen del historial reciente de un tanque (ver tank_history.h)
+ *
+ * @param window Últimas muestras a resumir (0 = todo el historial)
+ * @return esp_err_t ESP_ERR_NOT_FOUND si el tanque aún no tiene muestras
+ */
+esp_err_t tasks_get_tank_summary(int tank, int window, tank_history_summary_t *out,
+                                 uint32_t timeout_ms);
+
+/**
+ * @brief Controla el relé de la bomba sumergible
+ * 
+ * @param enable true para encender, false para apagar
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t tasks_set_pump_relay(bool enable);
+
+/**
+ * @brief Obtiene el estado actual del relé de la bomba
+ * 
+ * @return bool true si está encendido, false si está apagado
+ */
+bool tasks_get_pump_relay_state(void);
+
+/**
+ * @brief Imprime las estadísticas del muestreo adaptativo por sensor
+ * 
+ * Período actual, tasa efectiva y lecturas/CPU ahorradas respecto del
+ * muestreo fijo a sampling_interval_ms.
+ */
+void tasks_print_sched_stats(void);
+
+#endif // TASKS_H
@@ -4,6 +4,7 @@
 #include "esp_log.h"
 #include "adc_driver.h"
 #include "storage.h"
+#include "boot_prof.h"
 #include "esp_err.h"
 
 static const char *TAG = "tds";
@@ -17,7 +18,9 @@ static const char *KEY_GAIN = "tds_gain";
 
 static float tds_offset = 0.0f;
 static float tds_gain = 1.0f;
-static float last_raw = 0.0f;
+
+// Scanned values older than this fall back to a direct (blocking) read
+#define TDS_SCAN_MAX_AGE_MS 5000
 
 void tds_init(void)
 {
@@ -30,23 +33,80 @@ void tds_init(void)
     }
 }
 
+// Noise-adaptive, oversampled direct read
+static esp_err_t tds_read_direct(int channel, float *raw, uint16_t *samples)
+{
+    static const adc_adaptive_cfg_t stop = {
+        .min_samples = TDS_ADC_MIN_SAMPLES,
+        .max_samples = TDS_ADC_SAMPLES,
+        .target_sem_mlsb = TDS_ADC_TARGET_SEM_MLSB,
+    };
+    adc_adaptive_result_t res;
+    esp_err_t r = adc_read_adaptive(channel, &stop, TDS_ADC_EXTRA_BITS, &res);
+    if (r != ESP_OK) {
+        *raw = 0.0f;
+        *samples = 0;
+        return r;
+    }
+    *raw = (float)res.value_q / (float)(1 << TDS_ADC_EXTRA_BITS);
+    *samples = res.samples;
+    return ESP_OK;
+}
+
 float tds_read_raw(void)
 {
-    // Use ADC driver to read raw and return as float
-    int raw = adc_read_raw(20);
-    last_raw = (float)raw;
-    return last_raw;
+    // Local result: calA/calB (console) and the sensor task may both call this
+    float raw = 0.0f;
+    uint16_t samples = 0;
+    tds_read_direct(-1, &raw, &samples);   // Default ADC channel
+    return raw;
 }
 
-float tds_read_ppm(void)
+float tds_raw_to_ppm(float raw)
 {
-    float raw = tds_read_raw();
     float normalized = (raw - tds_offset) * tds_gain;
     // Temperature compensation could be applied here based on WATER_TEMP
     float tds_ppm = normalized * 1000.0f; // arbitrary scaling to ppm-like units
     return tds_ppm;
 }
 
+float tds_read_ppm(void)
+{
+    return tds_raw_to_ppm(tds_read_raw());
+}
+
+esp_err_t tds_read_channel(int channel, tds_reading_t *out)
+{
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Latest value from the ADC scan when the channel is scheduled
+    esp_err_t r = ESP_OK;
+    adc_scan_value_t v;
+    if (adc_read_latest(channel, TDS_SCAN_MAX_AGE_MS, &v)) {
+        out->raw = (float)v.value / (float)(1 << TDS_ADC_EXTRA_BITS);
+        out->samples = v.samples;
+    } else {
+        r = tds_read_direct(channel, &out->raw, &out->samples);
+    }
+    out->ppm = tds_raw_to_ppm(out->raw);
+    return r;
+}
+
+float tds_read_raw_channel(int channel)
+{
+    tds_reading_t rd;
+    tds_read_channel(channel, &rd);
+    return rd.raw;
+}
+
+float tds_read_ppm_channel(int channel)
+{
+    tds_reading_t rd;
+    tds_read_channel(channel, &rd);
+    return rd.ppm;
+}
+
 void tds_set_calibration_point_A(float raw)
 {
     tds_offset = raw;
@@ -75,8 +135,10 @@ esp_err_t tds_save_calibration(void)
 esp_err_t tds_load_calibration(void)
 {
     float offset = 0.0f, gain = 1.0f;
+    int prof = boot_prof_begin("tds_cal");
     esp_err_t r1 = storage_load_float(KEY_OFFSET, &offset);
     esp_err_t r2 = storage_load_float(KEY_GAIN, &gain);
+    boot_prof_end(prof);
     if (r1 == ESP_OK) tds_offset = offset;
     if (r2 == ESP_OK) tds_gain = gain;
 
@@ -1,16 +1,54 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 
+/**
+ * Conversions per TDS reading (direct reads and ADC scan): the burst stops
+ * once the standard error of the mean reaches TDS_ADC_TARGET_SEM_MLSB, so a
+ * quiet probe takes the minimum and a noisy one up to the maximum.
+ */
+#define TDS_ADC_MIN_SAMPLES     8
+#define TDS_ADC_SAMPLES         32      // Maximum (ADC_SCAN_MAX_SAMPLES)
+#define TDS_ADC_TARGET_SEM_MLSB 400     // 0.4 LSB
+/**
+ * Extra bits kept from the average (16 or more samples resolve 2). Raw
+ * readings stay in 12-bit LSB units, with a fractional part.
+ */
+#define TDS_ADC_EXTRA_BITS 2
+
+/** One TDS reading and what it cost */
+typedef struct {
+    float raw;                   // Averaged ADC reading (hardware units)
+    float ppm;
+    uint16_t samples;            // Conversions used by the adaptive burst
+} tds_reading_t;
+
 void tds_init(void);
 /**
- * Return averaged raw ADC reading (hardware units)
+ * Return averaged raw ADC reading (hardware units, fractional: see
+ * TDS_ADC_EXTRA_BITS)
  */
 float tds_read_raw(void);
 
 /** Return TDS in ppm (relative) using offset/gain calibration. */
 float tds_read_ppm(void);
 
+/**
+ * Same as tds_read_raw()/tds_read_ppm() for a probe on another ADC channel.
+ * All probes share the offset/gain calibration (same probe model).
+ * If the channel is in the ADC scan (adc_scan_add_channel) the reading comes
+ * from its latest-value table without blocking.
+ */
+float tds_read_raw_channel(int channel);
+float tds_read_ppm_channel(int channel);
+
+/** Same as tds_read_ppm_channel() with the raw value and sample count */
+esp_err_t tds_read_channel(int channel, tds_reading_t *out);
+
+/** Convert an averaged raw reading with the current offset/gain (no ADC access) */
+float tds_raw_to_ppm(float raw);
+
 void tds_set_calibration_point_A(float raw);
 void tds_set_calibration_point_B(float raw);
 esp_err_t tds_save_calibration(void);
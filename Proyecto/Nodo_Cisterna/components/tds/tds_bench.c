@@ -0,0 +1,22 @@
+#include "tds.h"
+#include "bench.h"
+
+static const float s_raw[] = { 1834.25f, 1836.50f, 1829.75f, 1841.00f };
+static unsigned s_next;
+
+/** Calibration arithmetic only */
+static void bench_tds_convert(void)
+{
+    s_next = (s_next + 1) % (sizeof(s_raw) / sizeof(s_raw[0]));
+    BENCH_KEEP_F(tds_raw_to_ppm(s_raw[s_next]));
+}
+BENCH_REGISTER("tds_convert", bench_tds_convert);
+
+/** Full reading on the default channel: adaptive ADC burst through the acquisition service */
+static void bench_tds_read(void)
+{
+    tds_reading_t rd;
+    tds_read_channel(-1, &rd);
+    BENCH_KEEP_F(rd.ppm);
+}
+BENCH_REGISTER("tds_read", bench_tds_read);
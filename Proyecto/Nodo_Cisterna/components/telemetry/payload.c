@@ -0,0 +1,117 @@
+#include "payload.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+static const char *WATER_STATE_STR[] = { "LIMPIA", "MEDIA", "SUCIA" };
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t pos;
+    bool overflow;
+} out_t;
+
+static void put(out_t *o, const char *fmt, ...)
+{
+    if (o->overflow) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(o->buf + o->pos, o->len - o->pos, fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= o->len - o->pos) {
+        o->overflow = true;
+        return;
+    }
+    o->pos += (size_t)n;
+}
+
+static int finish(const out_t *o)
+{
+    return o->overflow ? -1 : (int)o->pos;
+}
+
+static bool out_init(out_t *o, char *buf, size_t len)
+{
+    o->buf = buf;
+    o->len = len;
+    o->pos = 0;
+    o->overflow = (buf == NULL || len == 0);
+    return !o->overflow;
+}
+
+const char *payload_water_state(water_state_t state)
+{
+    unsigned i = (unsigned)state;
+    return i < sizeof(WATER_STATE_STR) / sizeof(WATER_STATE_STR[0]) ? WATER_STATE_STR[i] : "?";
+}
+
+int payload_level_quality(char *buf, size_t len, const sensor_data_t *d)
+{
+    out_t o;
+    if (out_init(&o, buf, len)) {
+        put(&o, "{\"pings\":%u,\"valid\":%u,\"confidence\":%u}",
+            d->level_pings, d->level_valid, d->level_confidence);
+    }
+    return finish(&o);
+}
+
+int payload_level_filtered(char *buf, size_t len, const sensor_data_t *d)
+{
+    out_t o;
+    if (out_init(&o, buf, len)) {
+        put(&o, "{\"level\":%.2f,\"rate\":%.4f,\"var\":%.3f}",
+            d->level_filtered, d->level_rate, d->level_var);
+    }
+    return finish(&o);
+}
+
+int payload_volume(char *buf, size_t len, float height_cm, float liters)
+{
+    out_t o;
+    if (out_init(&o, buf, len)) {
+        put(&o, "{\"height_cm\":%.1f,\"liters\":%.1f}", height_cm, liters);
+    }
+    return finish(&o);
+}
+
+int payload_tank_state(char *buf, size_t len, const sensor_data_t *d, bool has_tds,
+                       float height_cm, float liters, const tank_history_summary_t *sum)
+{
+    out_t o;
+    if (!out_init(&o, buf, len)) {
+        return -1;
+    }
+    put(&o, "{\"level\":%.2f,\"filtered\":%.2f,\"tds\":%.1f,\"tds_n\":%u,\"state\":\"%s\"",
+        d->water_level, d->level_filtered, d->tds_value, d->tds_samples,
+        has_tds ? payload_water_state(d->water_state) : "");
+    if (liters >= 0.0f) {
+        put(&o, ",\"height_cm\":%.1f,\"liters\":%.1f", height_cm, liters);
+    }
+    if (sum != NULL && sum->level_samples > 0) {
+        put(&o, ",\"hist\":{\"n\":%u,\"min\":%.2f,\"max\":%.2f,\"mean\":%.2f,\"span_s\":%" PRIu32 "}",
+            sum->level_samples, sum->level_min_cm, sum->level_max_cm,
+            sum->level_mean_cm, sum->span_ms / 1000);
+    }
+    put(&o, "}");
+    return finish(&o);
+}
+
+int payload_level_batch(char *buf, size_t len, const float *levels, size_t n,
+                        uint32_t reason, uint32_t dropped, uint32_t period_ms)
+{
+    out_t o;
+    if (!out_init(&o, buf, len)) {
+        return -1;
+    }
+    put(&o, "{\"reason\":%" PRIu32 ",\"dropped\":%" PRIu32 ",\"period_ms\":%" PRIu32 ",\"levels_cm\":[",
+        reason, dropped, period_ms);
+    for (size_t i = 0; i < n; i++) {
+        put(&o, "%s%.1f", i ? "," : "", levels[i]);
+    }
+    put(&o, "]}");
+    return finish(&o);
+}
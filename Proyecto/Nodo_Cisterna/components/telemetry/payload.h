@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sensor.h"
+#include "tank_history.h"
+
+/**
+ * Cuerpos JSON de los tópicos MQTT del nodo.
+ *
+ * Solo formatean: publish_task y lp_publish_batch (main.c) leen los datos y
+ * publican. C puro, sin heap, para probar el formato y medir su costo en el
+ * host (host_test/test_payload.c, bench_host).
+ *
+ * Todas retornan la longitud escrita (sin el '\0') o -1 si el buffer no
+ * alcanza; en ese caso el contenido no debe publicarse.
+ */
+
+/** @brief "LIMPIA", "MEDIA" o "SUCIA" (cistern/water_state); "?" fuera de rango */
+const char *payload_water_state(water_state_t state);
+
+/** @brief cistern/level_quality: {"pings":5,"valid":4,"confidence":80} */
+int payload_level_quality(char *buf, size_t len, const sensor_data_t *d);
+
+/** @brief cistern/level_filtered: {"level":..,"rate":..,"var":..} */
+int payload_level_filtered(char *buf, size_t len, const sensor_data_t *d);
+
+/** @brief cistern/volume: {"height_cm":..,"liters":..} */
+int payload_volume(char *buf, size_t len, float height_cm, float liters);
+
+/**
+ * @brief cistern/tank/<nombre>: última lectura, altura y litros si el tanque
+ * tiene geometría y, si sum tiene niveles válidos, el resumen del historial en "hist"
+ *
+ * @param has_tds false deja "state" vacío (tanque sin sonda)
+ * @param height_cm Nivel sobre el fondo (tank_geometry_convert)
+ * @param liters Volumen; negativo omite "height_cm" y "liters" (sin geometría)
+ * @param sum Resumen del historial o NULL
+ */
+int payload_tank_state(char *buf, size_t len, const sensor_data_t *d, bool has_tds,
+                       float height_cm, float liters, const tank_history_summary_t *sum);
+
+/** @brief cistern/level_batch: lote del núcleo LP con niveles a 0.1 cm */
+int payload_level_batch(char *buf, size_t len, const float *levels, size_t n,
+                        uint32_t reason, uint32_t dropped, uint32_t period_ms);
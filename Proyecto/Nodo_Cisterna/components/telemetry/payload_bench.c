@@ -0,0 +1,61 @@
+#include <stdio.h>
+
+#include "payload.h"
+#include "bench.h"
+
+static char s_buf[512];
+static unsigned s_next;
+
+static const sensor_data_t s_data = {
+    .water_level = 123.45f,
+    .tds_value = 412.7f,
+    .tds_samples = 12,
+    .water_state = WATER_STATE_MEDIUM,
+    .level_pings = 5,
+    .level_valid = 4,
+    .level_confidence = 82,
+    .level_filtered = 123.12f,
+    .level_rate = -0.0031f,
+    .level_var = 0.84f,
+};
+static const tank_history_summary_t s_sum = {
+    .samples = 60,
+    .level_samples = 58,
+    .level_min_cm = 121.9f,
+    .level_max_cm = 124.6f,
+    .level_mean_cm = 123.3f,
+    .tds_mean_ppm = 410.2f,
+    .span_ms = 59000,
+};
+
+/** Lo mínimo que cuesta un valor en cistern/water_level */
+static void bench_fmt_float(void)
+{
+    static const float levels[] = { 123.45f, 87.1f, 179.99f, 20.5f };
+    s_next = (s_next + 1) & 3;
+    BENCH_KEEP(snprintf(s_buf, sizeof(s_buf), "%.2f", levels[s_next]));
+}
+BENCH_REGISTER("fmt_float", bench_fmt_float);
+
+static void bench_payload_tank(void)
+{
+    BENCH_KEEP(payload_tank_state(s_buf, sizeof(s_buf), &s_data, true, 76.9f, 3462.0f, &s_sum));
+}
+BENCH_REGISTER("payload_tank", bench_payload_tank);
+
+// Lote completo del núcleo LP: un despertar por minuto a 1 muestra/s
+static float s_levels[60];
+
+static bool bench_payload_batch_setup(void)
+{
+    for (int i = 0; i < 60; i++) {
+        s_levels[i] = 120.0f + (float)((i * 7) % 13) * 0.1f;
+    }
+    return true;
+}
+
+static void bench_payload_batch(void)
+{
+    BENCH_KEEP(payload_level_batch(s_buf, sizeof(s_buf), s_levels, 60, 1, 0, 1000));
+}
+BENCH_REGISTER_SETUP("payload_batch", bench_payload_batch_setup, bench_payload_batch);
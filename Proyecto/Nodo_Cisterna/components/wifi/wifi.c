@@ -1,174 +1,503 @@
-#include <string.h>
-#include "esp_log.h"
-#include "esp_system.h"
-#include "esp_wifi.h"
-#include "esp_netif.h"
-#include "esp_event.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/event_groups.h"
-#include "lwip/err.h"
-#include "lwip/sys.h"
-
-#include "wifi.h"
-
-static const char *TAG = "WIFI";
-
-// Event group para el estado de conexión Wi-Fi
-static EventGroupHandle_t wifi_event_group = NULL;
-#define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT BIT1
-
-static int retry_count = 0;
-static const int MAXIMUM_RETRY = 5;
-
-/**
- * @brief Event handler para eventos de Wi-Fi
- */
-static void wifi_event_handler(void *arg, esp_event_base_t event_base,
-                               int32_t event_id, void *event_data)
-{
-    if (event_base == WIFI_EVENT) {
-        if (event_id == WIFI_EVENT_STA_START) {
-            ESP_LOGI(TAG, "→ Iniciando conexión a Wi-Fi...");
-            esp_wifi_connect();
-        } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
-            if (retry_count < MAXIMUM_RETRY) {
-                ESP_LOGI(TAG, "→ Intentando reconectar a Wi-Fi... (intento %d/%d)",
-                         retry_count + 1, MAXIMUM_RETRY);
-                esp_wifi_connect();
-                retry_count++;
-            } else {
-                xEventGroupSetBits(wifi_event_group, WIFI_FAIL_BIT);
-                ESP_LOGE(TAG, "✗ No se pudo conectar a Wi-Fi después de %d intentos",
-                         MAXIMUM_RETRY);
-            }
-        }
-    } else if (event_base == IP_EVENT) {
-        if (event_id == IP_EVENT_STA_GOT_IP) {
-            ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
-            ESP_LOGI(TAG, "✓ Conectado a Wi-Fi | IP obtenida: " IPSTR,
-                     IP2STR(&event->ip_info.ip));
-            retry_count = 0;
-            xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
-        }
-    }
-}
-
-/**
- * @brief Inicializa Wi-Fi en modo estación
- */
-esp_err_t wifi_init(const char *ssid, const char *password)
-{
-    if (ssid == NULL || password == NULL) {
-        ESP_LOGE(TAG, "✗ SSID y contraseña no pueden ser NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Crear event group
-    wifi_event_group = xEventGroupCreate();
-    if (wifi_event_group == NULL) {
-        ESP_LOGE(TAG, "✗ Error al crear event group");
-        return ESP_FAIL;
-    }
-
-    // Inicializar netif
-    // Inicializar TCP/IP stack and event loop if not already done
-    esp_err_t ret = esp_netif_init();
-    if (ret != ESP_OK && ret != ESP_ERR_NO_MEM && ret != ESP_ERR_INVALID_STATE) {
-        ESP_LOGE(TAG, "✗ Error inicializando esp_netif: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    ret = esp_event_loop_create_default();
-    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
-        ESP_LOGE(TAG, "✗ Error creando event loop por defecto: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    if (esp_netif_get_handle_from_ifkey("WIFI_STA_DEF") == NULL) {
-        esp_netif_create_default_wifi_sta();
-    }
-
-    // Crear y configurar Wi-Fi
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ret = esp_wifi_init(&cfg);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al inicializar Wi-Fi: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // Registrar event handlers
-    ret = esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
-                                     &wifi_event_handler, NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al registrar handler de WIFI_EVENT");
-        return ret;
-    }
-
-    ret = esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
-                                     &wifi_event_handler, NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al registrar handler de IP_EVENT");
-        return ret;
-    }
-
-    // Configurar credenciales
-    wifi_config_t wifi_config = {};
-    
-    // Configurar parámetros de seguridad
-    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
-    wifi_config.sta.sae_pwe_h2e = WPA3_SAE_PWE_BOTH;
-
-    // Copiar SSID y contraseña
-    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
-    wifi_config.sta.ssid[sizeof(wifi_config.sta.ssid) - 1] = '\0';
-    
-    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
-    wifi_config.sta.password[sizeof(wifi_config.sta.password) - 1] = '\0';
-
-    ret = esp_wifi_set_mode(WIFI_MODE_STA);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al configurar modo STA");
-        return ret;
-    }
-
-    ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al configurar credenciales Wi-Fi");
-        return ret;
-    }
-
-    ret = esp_wifi_start();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al iniciar Wi-Fi");
-        return ret;
-    }
-
-    ESP_LOGI(TAG, "✓ Wi-Fi inicializado correctamente");
-    return ESP_OK;
-}
-
-
-/**
- * @brief Obtiene estado actual de conexión Wi-Fi
- */
-bool wifi_is_connected(void)
-{
-    if (wifi_event_group == NULL) {
-        return false;
-    }
-
-    EventBits_t bits = xEventGroupGetBits(wifi_event_group);
-    return (bits & WIFI_CONNECTED_BIT) != 0;
-}
-
-/**
- * @brief Desconecta del Wi-Fi
- */
-esp_err_t wifi_disconnect(void)
-{
-    if (wifi_is_connected()) {
-        return esp_wifi_disconnect();
-    }
-    return ESP_OK;
-}
\ No newline at end of file
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "lwip/err.h"
+#include "lwip/sys.h"
+
+#include "wifi.h"
+#include "boot_prof.h"
+
+static const char *TAG = "WIFI";
+
+// Event group para el estado de conexión Wi-Fi
+static EventGroupHandle_t wifi_event_group = NULL;
+#define WIFI_CONNECTED_BIT BIT0
+#define WIFI_FAIL_BIT BIT1
+
+// Intentos antes de reportar WIFI_FAIL_BIT (se sigue reintentando después)
+static int retry_count = 0;
+static const int MAXIMUM_RETRY = 5;
+
+// Backoff exponencial con jitter para reconexiones
+#define WIFI_BACKOFF_BASE_MS   250
+#define WIFI_BACKOFF_MAX_MS    30000
+
+// Caché de conexión rápida en NVS (BSSID, canal y último lease DHCP)
+#define WIFI_CACHE_NAMESPACE   "wifi_cache"
+#define WIFI_CACHE_KEY         "conn"
+#define WIFI_CACHE_MAGIC       0x57464331u  // "WFC1"
+
+typedef struct {
+    uint32_t magic;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t has_lease;
+    uint32_t ip;        // Último lease DHCP (orden de red, como esp_ip4_addr_t)
+    uint32_t gw;
+    uint32_t netmask;
+} wifi_conn_cache_t;
+
+static wifi_conn_cache_t s_cache = {0};
+static bool s_fast_attempt = false;       // Intento actual usa BSSID/canal de la caché
+static bool s_manual_disconnect = false;  // wifi_disconnect() no debe reconectar
+static bool s_reassociating = false;      // wifi_reassociate(): reconectar sin contar la caída
+
+// IP estática opcional (configurada antes de wifi_init)
+static bool s_static_ip_enabled = false;
+static esp_netif_ip_info_t s_static_ip = {0};
+static esp_netif_t *s_sta_netif = NULL;
+
+static esp_timer_handle_t s_reconnect_timer = NULL;
+
+// Instrumentación
+static wifi_stats_t s_stats = {0};
+static int64_t s_disconnect_ts_us = 0;
+
+/**
+ * @brief Carga la caché de conexión desde NVS
+ */
+static bool wifi_cache_load(wifi_conn_cache_t *cache)
+{
+    nvs_handle_t handle;
+    if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*cache);
+    esp_err_t ret = nvs_get_blob(handle, WIFI_CACHE_KEY, cache, &len);
+    nvs_close(handle);
+
+    return ret == ESP_OK && len == sizeof(*cache) && cache->magic == WIFI_CACHE_MAGIC &&
+           cache->channel != 0;
+}
+
+/**
+ * @brief Guarda la caché en NVS solo si cambió (evita desgaste de flash)
+ */
+static void wifi_cache_store(const wifi_conn_cache_t *cache)
+{
+    if (memcmp(cache, &s_cache, sizeof(*cache)) == 0) {
+        return;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠ No se pudo abrir NVS para la caché Wi-Fi: %s", esp_err_to_name(ret));
+        return;
+    }
+    ret = nvs_set_blob(handle, WIFI_CACHE_KEY, cache, sizeof(*cache));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (ret == ESP_OK) {
+        memcpy(&s_cache, cache, sizeof(*cache));
+        ESP_LOGI(TAG, "✓ Caché Wi-Fi actualizada (canal %d)", cache->channel);
+    } else {
+        ESP_LOGW(TAG, "⚠ Error guardando caché Wi-Fi: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Descarta BSSID/canal de la caché y vuelve al escaneo completo
+ */
+static void wifi_fallback_full_scan(void)
+{
+    wifi_config_t wifi_config;
+    if (esp_wifi_get_config(WIFI_IF_STA, &wifi_config) != ESP_OK) {
+        return;
+    }
+    wifi_config.sta.bssid_set = false;
+    wifi_config.sta.channel = 0;
+    wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    s_fast_attempt = false;
+}
+
+/**
+ * @brief Calcula el retardo de reconexión: backoff exponencial con "equal jitter"
+ *
+ * La mitad del retardo es fija y la otra mitad aleatoria, de forma que varios
+ * nodos que pierden el AP a la vez no reintenten sincronizados.
+ */
+static uint32_t wifi_backoff_delay_ms(int attempt)
+{
+    uint32_t delay = WIFI_BACKOFF_BASE_MS;
+    for (int i = 0; i < attempt && delay < WIFI_BACKOFF_MAX_MS; i++) {
+        delay <<= 1;
+    }
+    if (delay > WIFI_BACKOFF_MAX_MS) {
+        delay = WIFI_BACKOFF_MAX_MS;
+    }
+    uint32_t half = delay / 2;
+    return half + (esp_random() % (half + 1));
+}
+
+static void wifi_reconnect_timer_cb(void *arg)
+{
+    (void)arg;
+    if (!s_manual_disconnect) {
+        esp_wifi_connect();
+    }
+}
+
+/**
+ * @brief Event handler para eventos de Wi-Fi
+ */
+static void wifi_event_handler(void *arg, esp_event_base_t event_base,
+                               int32_t event_id, void *event_data)
+{
+    if (event_base == WIFI_EVENT) {
+        if (event_id == WIFI_EVENT_STA_START) {
+            ESP_LOGI(TAG, "→ Iniciando conexión a Wi-Fi%s...",
+                     s_fast_attempt ? " (rápida, BSSID/canal en caché)" : "");
+            esp_wifi_connect();
+        } else if (event_id == WIFI_EVENT_STA_CONNECTED) {
+            if (s_static_ip_enabled && s_sta_netif != NULL) {
+                esp_netif_dhcpc_stop(s_sta_netif);
+                esp_err_t ret = esp_netif_set_ip_info(s_sta_netif, &s_static_ip);
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "✗ Error aplicando IP estática: %s", esp_err_to_name(ret));
+                }
+            }
+        } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
+            wifi_event_sta_disconnected_t *event = (wifi_event_sta_disconnected_t *)event_data;
+            bool was_connected = (xEventGroupGetBits(wifi_event_group) & WIFI_CONNECTED_BIT) != 0;
+            xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
+
+            if (s_manual_disconnect) {
+                ESP_LOGI(TAG, "→ Desconectado de Wi-Fi (solicitado)");
+                return;
+            }
+            if (s_reassociating) {
+                // Caída pedida por wifi_reassociate(): no es una desconexión ni
+                // un reintento para las estadísticas
+                s_reassociating = false;
+                esp_wifi_connect();
+                return;
+            }
+            if (was_connected) {
+                s_disconnect_ts_us = esp_timer_get_time();
+                s_stats.disconnect_count++;
+            }
+
+            // Si la caché ya no es válida (AP cambió de canal o de BSSID),
+            // reintentar de inmediato con escaneo completo
+            if (s_fast_attempt) {
+                ESP_LOGW(TAG, "⚠ Conexión rápida fallida (razón %d), usando escaneo completo",
+                         event->reason);
+                wifi_fallback_full_scan();
+                esp_wifi_connect();
+                return;
+            }
+
+            uint32_t delay_ms = wifi_backoff_delay_ms(retry_count);
+            retry_count++;
+            if (retry_count == MAXIMUM_RETRY) {
+                xEventGroupSetBits(wifi_event_group, WIFI_FAIL_BIT);
+                ESP_LOGE(TAG, "✗ No se pudo conectar a Wi-Fi después de %d intentos, se sigue reintentando",
+                         MAXIMUM_RETRY);
+            }
+            ESP_LOGI(TAG, "→ Reconectando a Wi-Fi en %" PRIu32 " ms (intento %d, razón %d)",
+                     delay_ms, retry_count, event->reason);
+            esp_timer_stop(s_reconnect_timer);
+            esp_timer_start_once(s_reconnect_timer, (uint64_t)delay_ms * 1000);
+        }
+    } else if (event_base == IP_EVENT) {
+        if (event_id == IP_EVENT_STA_GOT_IP) {
+            ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+            int64_t now = esp_timer_get_time();
+            ESP_LOGI(TAG, "✓ Conectado a Wi-Fi | IP obtenida: " IPSTR,
+                     IP2STR(&event->ip_info.ip));
+
+            // Instrumentación: arranque→IP y desconexión→reconexión
+            if (s_stats.boot_to_ip_us == 0) {
+                boot_prof_event_once("wifi_ip");
+                s_stats.boot_to_ip_us = now;
+                s_stats.fast_connect_used = s_fast_attempt;
+                ESP_LOGI(TAG, "  Arranque→IP: %" PRId64 " ms%s", now / 1000,
+                         s_fast_attempt ? " (conexión rápida)" : "");
+            } else if (s_disconnect_ts_us != 0) {
+                int64_t dt = now - s_disconnect_ts_us;
+                s_stats.last_reconnect_us = dt;
+                if (dt > s_stats.max_reconnect_us) {
+                    s_stats.max_reconnect_us = dt;
+                }
+                s_stats.reconnect_count++;
+                ESP_LOGI(TAG, "  Desconexión→reconexión: %" PRId64 " ms", dt / 1000);
+            }
+            s_disconnect_ts_us = 0;
+            retry_count = 0;
+            s_fast_attempt = false;
+            s_manual_disconnect = false;
+            xEventGroupClearBits(wifi_event_group, WIFI_FAIL_BIT);
+            xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
+
+            // Actualizar caché con el AP y el lease actuales
+            wifi_ap_record_t ap;
+            if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+                wifi_conn_cache_t cache = {
+                    .magic = WIFI_CACHE_MAGIC,
+                    .channel = ap.primary,
+                    .has_lease = !s_static_ip_enabled,
+                    .ip = s_static_ip_enabled ? 0 : event->ip_info.ip.addr,
+                    .gw = s_static_ip_enabled ? 0 : event->ip_info.gw.addr,
+                    .netmask = s_static_ip_enabled ? 0 : event->ip_info.netmask.addr,
+                };
+                memcpy(cache.bssid, ap.bssid, sizeof(cache.bssid));
+                wifi_cache_store(&cache);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Configura una IP estática (llamar antes de wifi_init)
+ */
+esp_err_t wifi_set_static_ip(const char *ip, const char *gateway, const char *netmask)
+{
+    if (ip == NULL || gateway == NULL || netmask == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_netif_ip_info_t info = {0};
+    if (esp_netif_str_to_ip4(ip, &info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(gateway, &info.gw) != ESP_OK ||
+        esp_netif_str_to_ip4(netmask, &info.netmask) != ESP_OK) {
+        ESP_LOGE(TAG, "✗ IP estática inválida");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_static_ip = info;
+    s_static_ip_enabled = true;
+    ESP_LOGI(TAG, "→ IP estática configurada: " IPSTR, IP2STR(&info.ip));
+    return ESP_OK;
+}
+
+/**
+ * @brief Inicializa Wi-Fi en modo estación
+ */
+esp_err_t wifi_init(const char *ssid, const char *password)
+{
+    if (ssid == NULL || password == NULL) {
+        ESP_LOGE(TAG, "✗ SSID y contraseña no pueden ser NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_manual_disconnect = false;
+
+    // Crear event group
+    wifi_event_group = xEventGroupCreate();
+    if (wifi_event_group == NULL) {
+        ESP_LOGE(TAG, "✗ Error al crear event group");
+        return ESP_FAIL;
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &wifi_reconnect_timer_cb,
+        .name = "wifi_reconnect",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &s_reconnect_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al crear timer de reconexión: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Inicializar netif
+    // Inicializar TCP/IP stack and event loop if not already done
+    ret = esp_netif_init();
+    if (ret != ESP_OK && ret != ESP_ERR_NO_MEM && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "✗ Error inicializando esp_netif: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "✗ Error creando event loop por defecto: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_sta_netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (s_sta_netif == NULL) {
+        s_sta_netif = esp_netif_create_default_wifi_sta();
+    }
+
+    // Crear y configurar Wi-Fi
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ret = esp_wifi_init(&cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al inicializar Wi-Fi: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // La configuración la gestiona este módulo; evitar escrituras extra en flash
+    esp_wifi_set_storage(WIFI_STORAGE_RAM);
+
+    // Registrar event handlers
+    ret = esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
+                                     &wifi_event_handler, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al registrar handler de WIFI_EVENT");
+        return ret;
+    }
+
+    ret = esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
+                                     &wifi_event_handler, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al registrar handler de IP_EVENT");
+        return ret;
+    }
+
+    // Configurar credenciales
+    wifi_config_t wifi_config = {};
+
+    // Configurar parámetros de seguridad
+    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+    wifi_config.sta.sae_pwe_h2e = WPA3_SAE_PWE_BOTH;
+
+    // Copiar SSID y contraseña
+    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
+    wifi_config.sta.ssid[sizeof(wifi_config.sta.ssid) - 1] = '\0';
+
+    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
+    wifi_config.sta.password[sizeof(wifi_config.sta.password) - 1] = '\0';
+
+    // Conexión rápida: intentar primero el último AP conocido sin escanear
+    // todos los canales. El lease DHCP anterior se reutiliza vía
+    // CONFIG_LWIP_DHCP_RESTORE_LAST_IP (DHCPREQUEST directo, sin DISCOVER).
+    wifi_conn_cache_t cache;
+    if (wifi_cache_load(&cache)) {
+        memcpy(&s_cache, &cache, sizeof(cache));
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, cache.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = cache.channel;
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+        s_fast_attempt = true;
+        if (cache.has_lease) {
+            esp_ip4_addr_t ip = { .addr = cache.ip };
+            ESP_LOGI(TAG, "→ Caché Wi-Fi: canal %d, último lease " IPSTR,
+                     cache.channel, IP2STR(&ip));
+        }
+    } else {
+        wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    }
+
+    ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al configurar modo STA");
+        return ret;
+    }
+
+    ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al configurar credenciales Wi-Fi");
+        return ret;
+    }
+
+    ret = esp_wifi_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al iniciar Wi-Fi");
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "✓ Wi-Fi inicializado correctamente");
+    return ESP_OK;
+}
+
+
+/**
+ * @brief Obtiene estado actual de conexión Wi-Fi
+ */
+bool wifi_is_connected(void)
+{
+    if (wifi_event_group == NULL) {
+        return false;
+    }
+
+    EventBits_t bits = xEventGroupGetBits(wifi_event_group);
+    return (bits & WIFI_CONNECTED_BIT) != 0;
+}
+
+/**
+ * @brief Espera (bloqueando la tarea, sin sondeo) a que haya IP
+ */
+bool wifi_wait_connected(uint32_t timeout_ms)
+{
+    if (wifi_event_group == NULL) {
+        return false;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(wifi_event_group, WIFI_CONNECTED_BIT,
+                                           pdFALSE, pdTRUE, pdMS_TO_TICKS(timeout_ms));
+    return (bits & WIFI_CONNECTED_BIT) != 0;
+}
+
+/**
+ * @brief Copia las estadísticas de conexión
+ */
+void wifi_get_stats(wifi_stats_t *stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &s_stats, sizeof(*stats));
+    }
+}
+
+/**
+ * @brief Vuelve a conectar tras wifi_disconnect() y reactiva la reconexión automática
+ */
+esp_err_t wifi_connect(void)
+{
+    if (wifi_event_group == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_manual_disconnect = false;
+    retry_count = 0;
+    if (wifi_is_connected()) {
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "→ Reconectando a Wi-Fi (solicitado)");
+    return esp_wifi_connect();
+}
+
+/**
+ * @brief Fuerza una reasociación sin contarla como desconexión
+ */
+esp_err_t wifi_reassociate(void)
+{
+    if (!wifi_is_connected()) {
+        return ESP_OK;
+    }
+    s_reassociating = true;
+    if (s_reconnect_timer != NULL) {
+        esp_timer_stop(s_reconnect_timer);
+    }
+    esp_err_t ret = esp_wifi_disconnect();
+    if (ret != ESP_OK) {
+        s_reassociating = false;
+    }
+    return ret;
+}
+
+/**
+ * @brief Desconecta del Wi-Fi
+ */
+esp_err_t wifi_disconnect(void)
+{
+    s_manual_disconnect = true;
+    if (s_reconnect_timer != NULL) {
+        esp_timer_stop(s_reconnect_timer);
+    }
+    if (wifi_is_connected()) {
+        return esp_wifi_disconnect();
+    }
+    return ESP_OK;
+}
@@ -1,30 +1,167 @@
-#ifndef WIFI_H
-#define WIFI_H
-
-#include "esp_wifi.h"
-#include "esp_event.h"
-
-/**
- * @brief Inicializa y conecta el ESP32-C6 a la red Wi-Fi
- * 
- * @param ssid SSID de la red Wi-Fi
- * @param password Contraseña de la red Wi-Fi
- * @return esp_err_t ESP_OK si es exitoso, de lo contrario código de error
- */
-esp_err_t wifi_init(const char *ssid, const char *password);
-
-/**
- * @brief Obtiene el estado actual de la conexión Wi-Fi
- * 
- * @return bool true si está conectado, false en caso contrario
- */
-bool wifi_is_connected(void);
-
-/**
- * @brief Desconecta del Wi-Fi
- * 
- * @return esp_err_t ESP_OK si es exitoso
- */
-esp_err_t wifi_disconnect(void);
-
-#endif // WIFI_H
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "esp_wifi.h"
+#include "esp_event.h"
+
+/**
+ * @brief Estadísticas de conexión Wi-Fi (instrumentación)
+ */
+typedef struct {
+    int64_t boot_to_ip_us;        // Tiempo desde el arranque hasta la primera IP
+    bool fast_connect_used;       // La primera conexión usó BSSID/canal en caché
+    uint32_t disconnect_count;    // Desconexiones no solicitadas
+    uint32_t reconnect_count;     // Reconexiones completadas
+    int64_t last_reconnect_us;    // Última duración desconexión→IP
+    int64_t max_reconnect_us;     // Peor duración desconexión→IP
+} wifi_stats_t;
+
+/**
+ * @brief Perfiles de ahorro de energía de la radio
+ */
+typedef enum {
+    WIFI_PS_PROFILE_NONE = 0,     // Radio siempre encendida: mínima latencia, máximo consumo
+    WIFI_PS_PROFILE_MIN_MODEM,    // Despierta en cada DTIM del AP (por defecto en ESP-IDF)
+    WIFI_PS_PROFILE_MAX_MODEM,    // Despierta cada listen_interval beacons
+    WIFI_PS_PROFILE_CUSTOM_DTIM,  // Despierta cada listen_interval DTIMs del AP
+} wifi_ps_profile_t;
+
+typedef struct {
+    wifi_ps_profile_t profile;
+    uint16_t listen_interval;     // Beacons (MAX_MODEM) o múltiplos de DTIM (CUSTOM_DTIM)
+    uint8_t ap_dtim_period;       // DTIM configurado en el AP (hostapd: dtim_period)
+} wifi_ps_config_t;
+
+/**
+ * @brief Instrumentación del perfil de energía activo
+ */
+typedef struct {
+    wifi_ps_profile_t profile;
+    uint32_t window_ms;           // Período entre ventanas de escucha (0 = siempre despierto)
+    uint32_t elapsed_ms;          // Tiempo medido con este perfil
+    uint32_t tx_bursts;           // Ráfagas de publicación
+    uint32_t latency_samples;     // Comandos/pings de ida y vuelta medidos
+    uint32_t latency_last_ms;
+    uint32_t latency_avg_ms;
+    uint32_t latency_max_ms;
+    uint32_t radio_on_est_ms;     // Tiempo estimado con la radio encendida
+    uint16_t radio_on_permille;   // Fracción estimada de radio encendida (‰)
+} wifi_ps_stats_t;
+
+/**
+ * @brief Configura una IP estática en lugar de DHCP
+ *
+ * Debe llamarse antes de wifi_init(). Sin IP estática se usa DHCP
+ * reutilizando el último lease conocido.
+ *
+ * @param ip Dirección IP (ej: "10.42.0.50")
+ * @param gateway Puerta de enlace
+ * @param netmask Máscara de red
+ * @return esp_err_t ESP_OK si es exitoso, ESP_ERR_INVALID_ARG si alguna dirección es inválida
+ */
+esp_err_t wifi_set_static_ip(const char *ip, const char *gateway, const char *netmask);
+
+/**
+ * @brief Inicializa y conecta el ESP32-C6 a la red Wi-Fi
+ * 
+ * Si hay una conexión previa en caché (NVS), intenta primero el mismo
+ * BSSID y canal sin escaneo completo. Las reconexiones usan backoff
+ * exponencial con jitter y no se abandonan.
+ * 
+ * @param ssid SSID de la red Wi-Fi
+ * @param password Contraseña de la red Wi-Fi
+ * @return esp_err_t ESP_OK si es exitoso, de lo contrario código de error
+ */
+esp_err_t wifi_init(const char *ssid, const char *password);
+
+/**
+ * @brief Obtiene el estado actual de la conexión Wi-Fi
+ * 
+ * @return bool true si está conectado, false en caso contrario
+ */
+bool wifi_is_connected(void);
+
+/**
+ * @brief Espera a que el Wi-Fi obtenga IP
+ * 
+ * @param timeout_ms Tiempo máximo de espera en ms
+ * @return bool true si está conectado al retornar
+ */
+bool wifi_wait_connected(uint32_t timeout_ms);
+
+/**
+ * @brief Obtiene las estadísticas de conexión (arranque→IP, reconexiones)
+ * 
+ * @param stats Puntero a estructura donde copiar las estadísticas
+ */
+void wifi_get_stats(wifi_stats_t *stats);
+
+/**
+ * @brief Aplica un perfil de ahorro de energía y reinicia su instrumentación
+ * 
+ * Si el listen interval cambia con la conexión activa, se fuerza una
+ * reasociación para que el AP lo acepte.
+ * 
+ * @param cfg Perfil a aplicar
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t wifi_set_ps_profile(const wifi_ps_config_t *cfg);
+
+/**
+ * @brief Período entre ventanas de escucha del perfil actual en ms (0 = sin ahorro)
+ */
+uint32_t wifi_ps_wake_window_ms(void);
+
+/**
+ * @brief Retardo hasta la próxima publicación alineada con una ventana de escucha
+ * 
+ * @param nominal_ms Intervalo de publicación deseado
+ * @return uint32_t Retardo en ms (>= nominal_ms, múltiplo de la ventana)
+ */
+uint32_t wifi_ps_next_publish_delay_ms(uint32_t nominal_ms);
+
+/** @brief Marca una recepción (fase de la ventana de escucha) */
+void wifi_ps_note_rx(void);
+
+/** @brief Cuenta una ráfaga de transmisión para la estimación de radio encendida */
+void wifi_ps_note_tx_burst(void);
+
+/** @brief Registra una latencia de ida y vuelta de comando en µs */
+void wifi_ps_record_latency_us(int64_t latency_us);
+
+/** @brief Copia la instrumentación del perfil actual */
+void wifi_ps_get_stats(wifi_ps_stats_t *stats);
+
+/** @brief Nombre corto del perfil ("none", "min-modem", "max-modem", "dtim") */
+const char *wifi_ps_profile_name(wifi_ps_profile_t profile);
+
+/**
+ * @brief Vuelve a conectar después de wifi_disconnect()
+ *
+ * Reactiva la reconexión automática con backoff que wifi_disconnect() suspende.
+ *
+ * @return esp_err_t ESP_OK si es exitoso, ESP_ERR_INVALID_STATE sin wifi_init()
+ */
+esp_err_t wifi_connect(void);
+
+/**
+ * @brief Desasocia y vuelve a asociar de inmediato (p. ej. para negociar otro
+ * listen interval)
+ *
+ * La caída no cuenta en disconnect_count ni en los tiempos de reconexión, y
+ * no pasa por el backoff. Sin conexión no hace nada.
+ *
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t wifi_reassociate(void);
+
+/**
+ * @brief Desconecta del Wi-Fi
+ * 
+ * La reconexión automática queda suspendida hasta wifi_connect().
+ *
+ * @return esp_err_t ESP_OK si es exitoso
+ */
+esp_err_t wifi_disconnect(void);
+
+#endif // WIFI_H
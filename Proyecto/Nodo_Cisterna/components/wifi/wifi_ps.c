@@ -0,0 +1,260 @@
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+#include "wifi.h"
+
+static const char *TAG = "WIFI_PS";
+
+// Intervalo de beacon típico (100 TU = 102.4 ms). El AP no lo expone al STA
+// en la API de ESP-IDF, así que se asume el valor por defecto de hostapd.
+#define WIFI_BEACON_INTERVAL_US   102400
+
+// Modelo de costo de radio para la estimación de tiempo encendido:
+// cada ventana de escucha (despertar + recibir beacon) y cada ráfaga de TX
+// (transmisión + ACK + cola activa antes de volver a dormir).
+#define WIFI_PS_WAKE_COST_US      3000
+#define WIFI_PS_TX_COST_US        15000
+
+static wifi_ps_config_t s_ps_cfg = {
+    .profile = WIFI_PS_PROFILE_MIN_MODEM,   // Igual al valor por defecto de ESP-IDF
+    .listen_interval = 3,
+    .ap_dtim_period = 1,
+};
+
+static portMUX_TYPE s_ps_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_since_us = 0;
+static int64_t s_rx_anchor_us = 0;        // Última RX: la radio estaba en ventana
+static uint32_t s_tx_bursts = 0;
+static uint32_t s_lat_count = 0;
+static uint64_t s_lat_sum_us = 0;
+static int64_t s_lat_last_us = 0;
+static int64_t s_lat_max_us = 0;
+
+const char *wifi_ps_profile_name(wifi_ps_profile_t profile)
+{
+    switch (profile) {
+        case WIFI_PS_PROFILE_NONE:        return "none";
+        case WIFI_PS_PROFILE_MIN_MODEM:   return "min-modem";
+        case WIFI_PS_PROFILE_MAX_MODEM:   return "max-modem";
+        case WIFI_PS_PROFILE_CUSTOM_DTIM: return "dtim";
+    }
+    return "?";
+}
+
+/**
+ * @brief Beacons entre ventanas de escucha para el perfil actual
+ */
+static uint32_t wifi_ps_beacons_per_window(void)
+{
+    switch (s_ps_cfg.profile) {
+        case WIFI_PS_PROFILE_MIN_MODEM:
+            return s_ps_cfg.ap_dtim_period;
+        case WIFI_PS_PROFILE_MAX_MODEM:
+            return s_ps_cfg.listen_interval;
+        case WIFI_PS_PROFILE_CUSTOM_DTIM:
+            return (uint32_t)s_ps_cfg.listen_interval * s_ps_cfg.ap_dtim_period;
+        case WIFI_PS_PROFILE_NONE:
+        default:
+            return 0;
+    }
+}
+
+static void wifi_ps_reset_stats(void)
+{
+    taskENTER_CRITICAL(&s_ps_lock);
+    s_since_us = esp_timer_get_time();
+    s_rx_anchor_us = 0;
+    s_tx_bursts = 0;
+    s_lat_count = 0;
+    s_lat_sum_us = 0;
+    s_lat_last_us = 0;
+    s_lat_max_us = 0;
+    taskEXIT_CRITICAL(&s_ps_lock);
+}
+
+/**
+ * @brief Aplica un perfil de ahorro de energía
+ */
+esp_err_t wifi_set_ps_profile(const wifi_ps_config_t *cfg)
+{
+    if (cfg == NULL || cfg->ap_dtim_period == 0 ||
+        (cfg->profile != WIFI_PS_PROFILE_NONE && cfg->profile != WIFI_PS_PROFILE_MIN_MODEM &&
+         cfg->listen_interval == 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    wifi_ps_type_t ps_type = WIFI_PS_MIN_MODEM;
+    uint16_t listen_interval = 0;
+    switch (cfg->profile) {
+        case WIFI_PS_PROFILE_NONE:
+            ps_type = WIFI_PS_NONE;
+            break;
+        case WIFI_PS_PROFILE_MIN_MODEM:
+            ps_type = WIFI_PS_MIN_MODEM;
+            break;
+        case WIFI_PS_PROFILE_MAX_MODEM:
+            ps_type = WIFI_PS_MAX_MODEM;
+            listen_interval = cfg->listen_interval;
+            break;
+        case WIFI_PS_PROFILE_CUSTOM_DTIM:
+            // Despertar solo en uno de cada N DTIM: múltiplo exacto del DTIM del AP
+            ps_type = WIFI_PS_MAX_MODEM;
+            listen_interval = cfg->listen_interval * cfg->ap_dtim_period;
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    // El listen interval se negocia al asociarse: si cambia y ya hay
+    // conexión, forzar una reasociación (la reconexión es automática)
+    bool reassociate = false;
+    if (listen_interval != 0) {
+        wifi_config_t wifi_config;
+        esp_err_t ret = esp_wifi_get_config(WIFI_IF_STA, &wifi_config);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (wifi_config.sta.listen_interval != listen_interval) {
+            wifi_config.sta.listen_interval = listen_interval;
+            ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "✗ Error configurando listen interval: %s", esp_err_to_name(ret));
+                return ret;
+            }
+            reassociate = wifi_is_connected();
+        }
+    }
+
+    esp_err_t ret = esp_wifi_set_ps(ps_type);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error aplicando modo de ahorro: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_ps_cfg = *cfg;
+    wifi_ps_reset_stats();
+
+    ESP_LOGI(TAG, "✓ Perfil de energía: %s (ventana %" PRIu32 " ms)",
+             wifi_ps_profile_name(cfg->profile), wifi_ps_wake_window_ms());
+    if (reassociate) {
+        ESP_LOGI(TAG, "→ Reasociando para aplicar listen interval=%u", listen_interval);
+        wifi_reassociate();
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Período entre ventanas de escucha del perfil actual (0 = siempre despierto)
+ */
+uint32_t wifi_ps_wake_window_ms(void)
+{
+    return (uint32_t)(((uint64_t)wifi_ps_beacons_per_window() * WIFI_BEACON_INTERVAL_US) / 1000);
+}
+
+/**
+ * @brief Retardo hasta la próxima publicación alineada con una ventana de escucha
+ *
+ * El período nominal se redondea hacia arriba a un múltiplo de la ventana y
+ * la fase se ancla a la última recepción (los frames guardados por el AP se
+ * entregan justo tras el beacon), para que el PUBACK y los comandos en
+ * espera lleguen en la misma ventana en que la radio ya está despierta.
+ */
+uint32_t wifi_ps_next_publish_delay_ms(uint32_t nominal_ms)
+{
+    uint32_t window_ms = wifi_ps_wake_window_ms();
+    if (window_ms == 0) {
+        return nominal_ms;
+    }
+
+    uint32_t period_ms = ((nominal_ms + window_ms - 1) / window_ms) * window_ms;
+
+    taskENTER_CRITICAL(&s_ps_lock);
+    int64_t anchor = s_rx_anchor_us;
+    taskEXIT_CRITICAL(&s_ps_lock);
+    if (anchor == 0) {
+        return period_ms;
+    }
+
+    int64_t now = esp_timer_get_time();
+    int64_t window_us = (int64_t)window_ms * 1000;
+    int64_t target = now + (int64_t)period_ms * 1000;
+    // Mover el objetivo al siguiente borde de ventana según la fase del ancla
+    int64_t phase = (target - anchor) % window_us;
+    if (phase != 0) {
+        target += window_us - phase;
+    }
+    return (uint32_t)((target - now) / 1000);
+}
+
+void wifi_ps_note_rx(void)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&s_ps_lock);
+    s_rx_anchor_us = now;
+    taskEXIT_CRITICAL(&s_ps_lock);
+}
+
+void wifi_ps_note_tx_burst(void)
+{
+    taskENTER_CRITICAL(&s_ps_lock);
+    s_tx_bursts++;
+    taskEXIT_CRITICAL(&s_ps_lock);
+}
+
+void wifi_ps_record_latency_us(int64_t latency_us)
+{
+    if (latency_us < 0) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_ps_lock);
+    s_lat_count++;
+    s_lat_sum_us += (uint64_t)latency_us;
+    s_lat_last_us = latency_us;
+    if (latency_us > s_lat_max_us) {
+        s_lat_max_us = latency_us;
+    }
+    taskEXIT_CRITICAL(&s_ps_lock);
+}
+
+/**
+ * @brief Estadísticas del perfil actual desde que se aplicó
+ */
+void wifi_ps_get_stats(wifi_ps_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&s_ps_lock);
+    int64_t elapsed_us = now - s_since_us;
+    stats->tx_bursts = s_tx_bursts;
+    stats->latency_samples = s_lat_count;
+    stats->latency_last_ms = (uint32_t)(s_lat_last_us / 1000);
+    stats->latency_max_ms = (uint32_t)(s_lat_max_us / 1000);
+    stats->latency_avg_ms = s_lat_count ? (uint32_t)(s_lat_sum_us / s_lat_count / 1000) : 0;
+    taskEXIT_CRITICAL(&s_ps_lock);
+
+    stats->profile = s_ps_cfg.profile;
+    stats->window_ms = wifi_ps_wake_window_ms();
+    stats->elapsed_ms = (uint32_t)(elapsed_us / 1000);
+
+    // Estimación de tiempo de radio encendida según el modelo de costo
+    uint64_t on_us;
+    if (stats->window_ms == 0) {
+        on_us = (uint64_t)elapsed_us;
+    } else {
+        uint64_t wakes = (uint64_t)elapsed_us / ((uint64_t)stats->window_ms * 1000);
+        on_us = wakes * WIFI_PS_WAKE_COST_US + (uint64_t)stats->tx_bursts * WIFI_PS_TX_COST_US;
+        if (on_us > (uint64_t)elapsed_us) {
+            on_us = (uint64_t)elapsed_us;
+        }
+    }
+    stats->radio_on_est_ms = (uint32_t)(on_us / 1000);
+    stats->radio_on_permille = elapsed_us > 0 ? (uint16_t)((on_us * 1000) / (uint64_t)elapsed_us) : 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * bench_host: los benchmarks de lógica pura (TDS, clasificación, regla de
+ * la bomba, formato de los mensajes, filtro del ultrasónico, Kalman) en el
+ * PC, con el mismo registro que el comando `bench` del firmware. Informa
+ * ns/op (mediana) para detectar regresiones antes de flashear; los números
+ * son del PC, no del ESP32-C6.
+ *
+ *   bench_host [-n iteraciones] [-o actual.txt] [-c base.txt [-p tolerancia_%]] [prefijo|all]
+ *
+ * -o guarda "nombre ns_op" por línea; -c compara contra un archivo así y
+ * termina con 1 si algún benchmark es más lento que la base más la
+ * tolerancia (50 % por defecto: la máquina no es la misma entre corridas).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+static bool base_lookup(FILE *f, const char *name, double *ns)
+{
+    char line[128], key[64];
+    double v;
+    rewind(f);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%63s %lf", key, &v) == 2 && strcmp(key, name) == 0) {
+            *ns = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long iters = 1000;
+    const char *out_path = NULL;
+    const char *base_path = NULL;
+    double tolerance = 50.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:c:p:")) != -1) {
+        switch (opt) {
+        case 'n': iters = strtoul(optarg, NULL, 10); break;
+        case 'o': out_path = optarg; break;
+        case 'c': base_path = optarg; break;
+        case 'p': tolerance = strtod(optarg, NULL); break;
+        default:
+            fprintf(stderr, "uso: %s [-n N] [-o actual.txt] [-c base.txt [-p %%]] [prefijo|all]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    const char *filter = optind < argc ? argv[optind] : "all";
+
+    FILE *out = NULL, *base = NULL;
+    if (out_path != NULL && (out = fopen(out_path, "w")) == NULL) {
+        perror(out_path);
+        return 2;
+    }
+    if (base_path != NULL && (base = fopen(base_path, "r")) == NULL) {
+        perror(base_path);
+        return 2;
+    }
+
+    printf("%-20s %10s %10s %10s %10s\n", "nombre", "ns/op", "min ns", "p99 ns", "base ns");
+    int ran = 0, regressions = 0;
+    for (int i = 0; i < bench_count(); i++) {
+        const bench_t *b = bench_get(i);
+        if (!bench_matches(b, filter)) {
+            continue;
+        }
+        bench_result_t r;
+        if (!bench_run(b, (uint32_t)iters, &r)) {
+            printf("%-20s omitido\n", b->name);
+            continue;
+        }
+        double ns = r.median_us * 1000.0;
+        double base_ns = 0.0;
+        bool has_base = base != NULL && base_lookup(base, b->name, &base_ns);
+        bool slow = has_base && ns > base_ns * (1.0 + tolerance / 100.0);
+        printf("%-20s %10.1f %10.1f %10.1f", b->name, ns, r.min_us * 1000.0, r.p99_us * 1000.0);
+        if (has_base) {
+            printf(" %10.1f %s", base_ns, slow ? "✗ regresión" : "✓");
+        }
+        printf("\n");
+        if (out != NULL) {
+            fprintf(out, "%s %.1f\n", b->name, ns);
+        }
+        regressions += slow;
+        ran++;
+    }
+    if (out != NULL) {
+        fclose(out);
+    }
+    if (base != NULL) {
+        fclose(base);
+    }
+    if (ran == 0) {
+        fprintf(stderr, "ninguno coincide con \"%s\"\n", filter);
+        return 1;
+    }
+    return regressions ? 1 : 0;
+}
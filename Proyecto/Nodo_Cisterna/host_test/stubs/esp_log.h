@@ -0,0 +1,15 @@
+#pragma once
+/* Sustituto de esp_log.h para el host: los logs se descartan (el formato se sigue verificando) */
+
+__attribute__((format(printf, 2, 3)))
+static inline void esp_log_stub(const char *tag, const char *fmt, ...)
+{
+    (void)tag;
+    (void)fmt;
+}
+
+#define ESP_LOGE(tag, fmt, ...) esp_log_stub(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) esp_log_stub(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) esp_log_stub(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) esp_log_stub(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) esp_log_stub(tag, fmt, ##__VA_ARGS__)
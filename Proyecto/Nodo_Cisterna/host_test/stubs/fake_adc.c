@@ -0,0 +1,57 @@
+#include "adc_driver.h"
+#include "fake_adc.h"
+
+#define FAKE_ADC_CHANNELS 8
+
+static int32_t s_direct_q;
+static uint16_t s_direct_samples;
+static esp_err_t s_direct_err;
+static uint32_t s_direct_reads;
+static adc_scan_value_t s_scan[FAKE_ADC_CHANNELS];
+static bool s_scan_set[FAKE_ADC_CHANNELS];
+
+void fake_adc_set_direct(int32_t value_q, uint16_t samples, esp_err_t err)
+{
+    s_direct_q = value_q;
+    s_direct_samples = samples;
+    s_direct_err = err;
+    s_direct_reads = 0;
+}
+
+void fake_adc_set_scan(int channel, int32_t value, uint8_t samples)
+{
+    if (channel < 0 || channel >= FAKE_ADC_CHANNELS) {
+        return;
+    }
+    s_scan_set[channel] = value >= 0;
+    s_scan[channel] = (adc_scan_value_t){ .raw = value, .value = value, .samples = samples };
+}
+
+uint32_t fake_adc_direct_reads(void)
+{
+    return s_direct_reads;
+}
+
+esp_err_t adc_read_adaptive(int channel, const adc_adaptive_cfg_t *cfg, uint8_t extra_bits,
+                            adc_adaptive_result_t *out)
+{
+    (void)channel;
+    (void)cfg;
+    (void)extra_bits;
+    s_direct_reads++;
+    if (s_direct_err != ESP_OK) {
+        return s_direct_err;
+    }
+    *out = (adc_adaptive_result_t){ .value_q = s_direct_q, .samples = s_direct_samples };
+    return ESP_OK;
+}
+
+bool adc_read_latest(int channel, uint32_t max_age_ms, adc_scan_value_t *out)
+{
+    (void)max_age_ms;
+    if (channel < 0 || channel >= FAKE_ADC_CHANNELS || !s_scan_set[channel]) {
+        return false;
+    }
+    *out = s_scan[channel];
+    return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Control del ADC falso de fake_adc.c (lecturas de tds.c sin hardware) */
+
+/** Próximas lecturas directas (adc_read_adaptive): valor en LSB · 2^extra_bits */
+void fake_adc_set_direct(int32_t value_q, uint16_t samples, esp_err_t err);
+
+/** Valor del escaneo para un canal (adc_read_latest); value < 0 lo quita */
+void fake_adc_set_scan(int channel, int32_t value, uint8_t samples);
+
+/** Lecturas directas pedidas desde el último set */
+uint32_t fake_adc_direct_reads(void);
@@ -0,0 +1,14 @@
+#include "boot_prof.h"
+
+/* Perfilador de arranque sin efecto para los componentes que lo llaman */
+
+int boot_prof_begin(const char *name)
+{
+    (void)name;
+    return -1;
+}
+
+void boot_prof_end(int slot)
+{
+    (void)slot;
+}
@@ -0,0 +1,123 @@
+#include <string.h>
+
+#include "nvs_flash.h"
+#include "fake_nvs.h"
+
+#define FAKE_NVS_MAX_KEYS 16
+#define FAKE_NVS_KEY_LEN  16       // Límite de NVS (15 caracteres + '\0')
+
+typedef struct {
+    char ns[FAKE_NVS_KEY_LEN];
+    char key[FAKE_NVS_KEY_LEN];
+    uint32_t value;
+} entry_t;
+
+static entry_t s_entries[FAKE_NVS_MAX_KEYS];
+static int s_count;
+static char s_open_ns[FAKE_NVS_KEY_LEN];
+static nvs_open_mode_t s_open_mode;
+static esp_err_t s_write_err;
+static uint32_t s_commits;
+
+void fake_nvs_reset(void)
+{
+    s_count = 0;
+    s_write_err = ESP_OK;
+    s_commits = 0;
+}
+
+void fake_nvs_fail_writes(esp_err_t err)
+{
+    s_write_err = err;
+}
+
+uint32_t fake_nvs_commits(void)
+{
+    return s_commits;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    fake_nvs_reset();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    if (strlen(name) >= FAKE_NVS_KEY_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(s_open_ns, name);
+    s_open_mode = mode;
+    *out = 1;
+    return ESP_OK;
+}
+
+static entry_t *find(const char *key)
+{
+    for (int i = 0; i < s_count; i++) {
+        if (strcmp(s_entries[i].ns, s_open_ns) == 0 && strcmp(s_entries[i].key, key) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    if (handle != 1) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (s_open_mode == NVS_READONLY) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    if (s_write_err != ESP_OK) {
+        return s_write_err;
+    }
+    if (strlen(key) >= FAKE_NVS_KEY_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    entry_t *e = find(key);
+    if (e == NULL) {
+        if (s_count == FAKE_NVS_MAX_KEYS) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        e = &s_entries[s_count++];
+        strcpy(e->ns, s_open_ns);
+        strcpy(e->key, key);
+    }
+    e->value = value;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out)
+{
+    if (handle != 1) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    const entry_t *e = find(key);
+    if (e == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *out = e->value;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    if (handle != 1) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    s_commits++;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
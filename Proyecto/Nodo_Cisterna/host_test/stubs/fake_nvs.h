@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Control de la NVS en memoria de fake_nvs.c */
+
+/** Borra todas las claves y contadores ("flash nueva") */
+void fake_nvs_reset(void);
+
+/** Las próximas escrituras fallan con err (ESP_OK vuelve a la normalidad) */
+void fake_nvs_fail_writes(esp_err_t err);
+
+/** Commits exitosos desde el último reset */
+uint32_t fake_nvs_commits(void);
@@ -0,0 +1,5 @@
+#pragma once
+/* Sustituto de FreeRTOS para los encabezados que solo nombran sus tipos */
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
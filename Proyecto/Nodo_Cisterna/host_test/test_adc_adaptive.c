@@ -0,0 +1,105 @@
+#include "adc_adaptive.h"
+#include "adc_sim.h"
+#include "test_unit.h"
+
+/** Ráfaga adaptativa sobre el canal simulado, como adc_read_adaptive() */
+static void burst(int channel, const adc_adaptive_cfg_t *cfg, adc_adaptive_result_t *res)
+{
+    adc_welford_t w;
+    adc_welford_reset(&w);
+    while (!adc_adaptive_done(cfg, &w)) {
+        int raw = 0;
+        adc_sim_read(channel, &raw);
+        adc_welford_push(&w, raw);
+    }
+    adc_adaptive_result(&w, 2, res);
+}
+
+static void test_welford_matches_two_pass(void)
+{
+    // {2,4,4,4,5,5,7,9}: media 5, varianza muestral 32/7
+    const int x[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    adc_welford_t w;
+    adc_welford_reset(&w);
+    TEST_ASSERT_EQ(adc_welford_var_mlsb2(&w), 0);
+    for (int i = 0; i < 8; i++) {
+        adc_welford_push(&w, x[i]);
+    }
+    TEST_ASSERT_EQ(w.n, 8);
+    TEST_ASSERT_EQ(w.mean_q16, 5 << 16);
+    uint64_t var = adc_welford_var_mlsb2(&w);
+    TEST_ASSERT(var >= 4571380 && var <= 4571480);          // 4.571428 LSB² (Q16)
+    TEST_ASSERT_EQ(adc_welford_sigma_mlsb(&w), 2138);
+    TEST_ASSERT_EQ(adc_welford_sem_mlsb(&w), 755);          // 2.138 / √8
+
+    // Media grande y desvío chico: sin cancelación
+    adc_welford_reset(&w);
+    for (int i = 0; i < 1000; i++) {
+        adc_welford_push(&w, (i & 1) ? 4001 : 3999);
+    }
+    TEST_ASSERT(adc_welford_sigma_mlsb(&w) >= 999 && adc_welford_sigma_mlsb(&w) <= 1001);
+}
+
+static void test_cfg_valid(void)
+{
+    adc_adaptive_cfg_t c = { .min_samples = 8, .max_samples = 32, .target_sem_mlsb = 400 };
+    TEST_ASSERT(adc_adaptive_cfg_valid(&c));
+    c.min_samples = 1;
+    TEST_ASSERT(!adc_adaptive_cfg_valid(&c));
+    c.min_samples = 33;
+    TEST_ASSERT(!adc_adaptive_cfg_valid(&c));
+    TEST_ASSERT(!adc_adaptive_cfg_valid(NULL));
+}
+
+static void test_quiet_input_stops_at_min(void)
+{
+    adc_adaptive_cfg_t c = { .min_samples = 8, .max_samples = 32, .target_sem_mlsb = 400 };
+    adc_adaptive_result_t r;
+    adc_sim_set_raw_q8(0, 1500 << 8);
+    adc_sim_set_noise(0, 0);
+    burst(0, &c, &r);
+    TEST_ASSERT_EQ(r.samples, 8);
+    TEST_ASSERT_EQ(r.value_q, 1500 * 4);
+    TEST_ASSERT_EQ(r.sigma_mlsb, 0);
+}
+
+static void test_noise_sets_the_count(void)
+{
+    // σ = 2 LSB, objetivo 0.4 LSB → (2/0.4)² = 25 conversiones en promedio
+    adc_adaptive_cfg_t c = { .min_samples = 8, .max_samples = 32, .target_sem_mlsb = 400 };
+    adc_adaptive_result_t r;
+    adc_sim_seed(5);
+    adc_sim_set_raw_q8(1, 2000 << 8);
+    adc_sim_set_noise(1, 32);
+    uint32_t total = 0;
+    int at_max = 0;
+    for (int i = 0; i < 200; i++) {
+        burst(1, &c, &r);
+        total += r.samples;
+        if (r.samples == c.max_samples) {
+            at_max++;
+        } else {
+            TEST_ASSERT(r.sem_mlsb <= c.target_sem_mlsb);
+        }
+        TEST_ASSERT(r.value_q >= 1997 * 4 && r.value_q <= 2003 * 4);
+    }
+    uint32_t avg = total / 200;
+    TEST_ASSERT(avg >= 18 && avg <= 30);
+    TEST_ASSERT(at_max < 100);
+
+    // σ = 6 LSB: el objetivo es inalcanzable, siempre el máximo
+    adc_sim_set_noise(1, 96);
+    burst(1, &c, &r);
+    TEST_ASSERT_EQ(r.samples, 32);
+    TEST_ASSERT(r.sem_mlsb > c.target_sem_mlsb);
+    adc_sim_set_noise(1, 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_welford_matches_two_pass);
+    TEST_RUN(test_cfg_valid);
+    TEST_RUN(test_quiet_input_stops_at_min);
+    TEST_RUN(test_noise_sets_the_count);
+    return TEST_EXIT();
+}
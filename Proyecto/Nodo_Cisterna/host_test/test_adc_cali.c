@@ -0,0 +1,100 @@
+#include <stdlib.h>
+
+#include "adc_cali_lut.h"
+#include "adc_sim.h"
+#include "test_unit.h"
+
+static adc_cali_lut_t s_lut;
+
+static bool failing_curve(void *ctx, int raw, int *mv)
+{
+    (void)ctx;
+    *mv = raw;
+    return raw < 100;       // Falla a mitad de la tabla
+}
+
+static void test_lut_matches_curve(void)
+{
+    TEST_ASSERT(adc_cali_lut_build(&s_lut, adc_sim_curve_mv, NULL, 3100));
+    TEST_ASSERT(s_lut.calibrated);
+    for (int raw = 0; raw <= ADC_SIM_RAW_MAX; raw += 7) {
+        int mv = 0;
+        adc_sim_curve_mv(NULL, raw, &mv);
+        TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, raw), mv);
+    }
+    // Monótona y saturada en los extremos
+    for (int raw = 1; raw < ADC_CALI_LUT_SIZE; raw++) {
+        TEST_ASSERT(s_lut.mv[raw] >= s_lut.mv[raw - 1]);
+    }
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, -5), s_lut.mv[0]);
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, 5000), s_lut.mv[ADC_CALI_LUT_SIZE - 1]);
+}
+
+static void test_fallback_is_linear(void)
+{
+    TEST_ASSERT(!adc_cali_lut_build(&s_lut, failing_curve, NULL, 3100));
+    TEST_ASSERT(!s_lut.calibrated);
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, 0), 0);
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, 4095), 3100);
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, 2048), 1550);
+
+    TEST_ASSERT(!adc_cali_lut_build(&s_lut, NULL, NULL, 2500));
+    TEST_ASSERT_EQ(adc_cali_lut_mv(&s_lut, 4095), 2500);
+}
+
+static void test_inverse(void)
+{
+    adc_cali_lut_build(&s_lut, adc_sim_curve_mv, NULL, 3100);
+    int raw = adc_cali_lut_raw_for_mv(&s_lut, 1500);
+    TEST_ASSERT(s_lut.mv[raw] >= 1500);
+    TEST_ASSERT(raw == 0 || s_lut.mv[raw - 1] < 1500);
+    TEST_ASSERT_EQ(adc_cali_lut_raw_for_mv(&s_lut, 0), 0);
+    TEST_ASSERT_EQ(adc_cali_lut_raw_for_mv(&s_lut, 9999), ADC_CALI_LUT_SIZE - 1);
+}
+
+static void test_sim_roundtrip(void)
+{
+    // Entrada en mV → conversión simulada → tabla: error ≤ 1 LSB (~0.8 mV)
+    adc_cali_lut_build(&s_lut, adc_sim_curve_mv, NULL, 3100);
+    adc_sim_set_noise(2, 0);
+    for (int mv = 50; mv <= 2900; mv += 137) {
+        adc_sim_set_mv(2, mv);
+        int raw = 0;
+        TEST_ASSERT(adc_sim_read(2, &raw) == ESP_OK);
+        TEST_ASSERT(abs(adc_cali_lut_mv(&s_lut, raw) - mv) <= 1);
+    }
+    int raw;
+    TEST_ASSERT(adc_sim_read(ADC_SIM_MAX_CHANNELS, &raw) != ESP_OK);
+}
+
+static void test_sim_noise_is_centered(void)
+{
+    // σ = 2 LSB: la media de muchas conversiones vuelve al valor de entrada
+    adc_sim_seed(42);
+    adc_sim_set_raw_q8(1, (1000 << 8) + 128);   // 1000.5 LSB
+    adc_sim_set_noise(1, 32);
+    long sum = 0;
+    int lo = 4096, hi = 0;
+    const int n = 20000;
+    for (int i = 0; i < n; i++) {
+        int raw = 0;
+        adc_sim_read(1, &raw);
+        sum += raw;
+        if (raw < lo) lo = raw;
+        if (raw > hi) hi = raw;
+    }
+    long mean_x100 = sum * 100 / n;
+    TEST_ASSERT(mean_x100 >= 100045 && mean_x100 <= 100055);
+    TEST_ASSERT(hi - lo >= 8);                    // Hay dispersión real
+    adc_sim_set_noise(1, 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_lut_matches_curve);
+    TEST_RUN(test_fallback_is_linear);
+    TEST_RUN(test_inverse);
+    TEST_RUN(test_sim_roundtrip);
+    TEST_RUN(test_sim_noise_is_centered);
+    return TEST_EXIT();
+}
@@ -0,0 +1,159 @@
+#include <stdlib.h>
+
+#include "adc_decim.h"
+#include "adc_sim.h"
+#include "test_unit.h"
+
+#define OUTPUTS 64
+
+static adc_decim_t s_decim;
+
+/** Pasa `n` salidas del canal simulado por el decimador */
+static int run(int channel, const adc_decim_cfg_t *cfg, int32_t *out, int n)
+{
+    adc_decim_init(&s_decim, cfg);
+    int got = 0;
+    while (got < n) {
+        int raw = 0;
+        adc_sim_read(channel, &raw);
+        if (adc_decim_push(&s_decim, raw, &out[got])) {
+            got++;
+        }
+    }
+    return got;
+}
+
+static void test_init_limits(void)
+{
+    adc_decim_cfg_t c = { .extra_bits = 2, .window = 16 };
+    TEST_ASSERT(adc_decim_init(&s_decim, &c));
+    TEST_ASSERT_EQ(s_decim.cfg.stride, 16);                 // stride 0 = integrar y descargar
+    c.window = 0;
+    TEST_ASSERT(!adc_decim_init(&s_decim, &c));
+    c.window = ADC_DECIM_MAX_WINDOW + 1;
+    TEST_ASSERT(!adc_decim_init(&s_decim, &c));
+    c.window = 16;
+    c.stride = 17;
+    TEST_ASSERT(!adc_decim_init(&s_decim, &c));
+    c.stride = 4;
+    c.extra_bits = ADC_DECIM_MAX_EXTRA_BITS + 1;
+    TEST_ASSERT(!adc_decim_init(&s_decim, &c));
+}
+
+static void test_output_rate(void)
+{
+    // Media móvil de 16 con una salida cada 4 muestras, tras llenar la ventana
+    adc_decim_cfg_t c = { .extra_bits = 2, .window = 16, .stride = 4 };
+    adc_decim_init(&s_decim, &c);
+    int outputs = 0;
+    int32_t v = 0;
+    for (int i = 1; i <= 64; i++) {
+        if (adc_decim_push(&s_decim, 1000, &v)) {
+            outputs++;
+            TEST_ASSERT(i >= 16 && i % 4 == 0);
+            TEST_ASSERT_EQ(v, 4000);
+        }
+    }
+    TEST_ASSERT_EQ(outputs, (64 - 16) / 4 + 1);
+
+    // Escalón: la salida sigue la ventana deslizante
+    adc_decim_reset(&s_decim);
+    for (int i = 0; i < 16; i++) {
+        adc_decim_push(&s_decim, 1000, &v);
+    }
+    for (int i = 0; i < 4; i++) {
+        adc_decim_push(&s_decim, 1004, &v);
+    }
+    TEST_ASSERT_EQ(v, 4004);                                // (12·1000 + 4·1004)/16 = 1001
+}
+
+static void test_block_rounds(void)
+{
+    // La media entera truncaba 1000.5 a 1000
+    TEST_ASSERT_EQ(adc_decim_block(2001, 2, 0), 1001);
+    TEST_ASSERT_EQ(adc_decim_block(2001, 2, 1), 2001);
+    TEST_ASSERT_EQ(adc_decim_block(16 * 4095, 16, ADC_DECIM_MAX_EXTRA_BITS), 4095 * 16);
+    TEST_ASSERT_EQ(adc_decim_block(10, 0, 2), 0);
+}
+
+static void test_resolves_sub_lsb(void)
+{
+    // Entrada 1000.3 LSB: sin ruido el cuantizador siempre da 1000,
+    // con ~1 LSB de ruido la decimación recupera la fracción
+    int32_t out[OUTPUTS];
+    adc_decim_cfg_t c = { .extra_bits = 4, .window = 256 };
+    adc_sim_seed(7);
+    adc_sim_set_raw_q8(0, (1000 << 8) + 77);
+
+    adc_sim_set_noise(0, 0);
+    run(0, &c, out, 4);
+    TEST_ASSERT_EQ(out[0], 1000 * 16);
+
+    adc_sim_set_noise(0, 16);
+    run(0, &c, out, OUTPUTS);
+    adc_noise_t n;
+    adc_noise_measure(out, OUTPUTS, c.extra_bits, &n);
+    TEST_ASSERT(abs(n.mean_q - 16005) <= 1);                // 1000.3 · 16 = 16004.8
+    adc_sim_set_noise(0, 0);
+}
+
+static void test_noise_and_enob(void)
+{
+    // σ = 2 LSB: cada ventana 4x divide el ruido por 2 y suma un bit
+    int32_t out[OUTPUTS];
+    adc_noise_t n1, n16;
+    adc_sim_seed(11);
+    adc_sim_set_raw_q8(3, 2000 << 8);
+    adc_sim_set_noise(3, 32);
+
+    adc_decim_cfg_t c1 = { .extra_bits = 0, .window = 1 };
+    run(3, &c1, out, OUTPUTS);
+    adc_noise_measure(out, OUTPUTS, 0, &n1);
+    TEST_ASSERT(n1.sigma_mlsb > 1600 && n1.sigma_mlsb < 2400);
+
+    adc_decim_cfg_t c16 = { .extra_bits = 2, .window = 16 };
+    run(3, &c16, out, OUTPUTS);
+    adc_noise_measure(out, OUTPUTS, 2, &n16);
+    TEST_ASSERT(n16.sigma_mlsb > 380 && n16.sigma_mlsb < 640);
+    TEST_ASSERT(n16.enob_x100 > n1.enob_x100 + 150 && n16.enob_x100 < n1.enob_x100 + 250);
+    // 12 − log2(2·√12) ≈ 9.2 bits
+    TEST_ASSERT(n1.enob_x100 > 890 && n1.enob_x100 < 950);
+    adc_sim_set_noise(3, 0);
+
+    // Sin ruido medible la resolución de salida es el límite
+    int32_t flat[8] = {4000, 4000, 4000, 4000, 4000, 4000, 4000, 4000};
+    adc_noise_measure(flat, 8, 2, &n1);
+    TEST_ASSERT_EQ(n1.sigma_mlsb, 0);
+    TEST_ASSERT_EQ(n1.enob_x100, 1400);
+    TEST_ASSERT_EQ(n1.mean_q, 4000);
+    TEST_ASSERT_EQ(n1.p2p_q, 0);
+}
+
+static void test_cfg_for_noise(void)
+{
+    adc_decim_cfg_t c;
+    adc_decim_cfg_for_noise(2000, 250, &c);                 // (2/0.25)² = 64
+    TEST_ASSERT_EQ(c.window, 64);
+    TEST_ASSERT_EQ(c.extra_bits, 3);
+    TEST_ASSERT_EQ(c.stride, 64);
+    adc_decim_cfg_for_noise(2000, 300, &c);                 // 44.4 → 45
+    TEST_ASSERT_EQ(c.window, 45);
+    TEST_ASSERT_EQ(c.extra_bits, 2);
+    adc_decim_cfg_for_noise(100, 250, &c);                  // Ya está bajo el piso
+    TEST_ASSERT_EQ(c.window, 1);
+    TEST_ASSERT_EQ(c.extra_bits, 0);
+    adc_decim_cfg_for_noise(8000, 100, &c);                 // Limitado a la ventana máxima
+    TEST_ASSERT_EQ(c.window, ADC_DECIM_MAX_WINDOW);
+    TEST_ASSERT_EQ(c.extra_bits, ADC_DECIM_MAX_EXTRA_BITS);
+}
+
+int main(void)
+{
+    TEST_RUN(test_init_limits);
+    TEST_RUN(test_output_rate);
+    TEST_RUN(test_block_rounds);
+    TEST_RUN(test_resolves_sub_lsb);
+    TEST_RUN(test_noise_and_enob);
+    TEST_RUN(test_cfg_for_noise);
+    return TEST_EXIT();
+}
@@ -0,0 +1,184 @@
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "adc_scan.h"
+#include "test_unit.h"
+
+static adc_scan_t s_scan;
+
+static adc_scan_channel_cfg_t cfg(int channel, uint8_t samples, adc_scan_reduce_t reduce, uint8_t shift)
+{
+    adc_scan_channel_cfg_t c = {
+        .name = "ch",
+        .channel = channel,
+        .samples = samples,
+        .reduce = reduce,
+        .ema_shift = shift,
+    };
+    return c;
+}
+
+static void test_add_and_find(void)
+{
+    adc_scan_init(&s_scan);
+    adc_scan_channel_cfg_t c = cfg(3, 20, ADC_SCAN_REDUCE_MEAN, 0);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), 0);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);          // Canal repetido
+    c = cfg(5, 0, ADC_SCAN_REDUCE_MEAN, 0);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);          // Sin muestras
+    c = cfg(5, ADC_SCAN_MAX_SAMPLES + 1, ADC_SCAN_REDUCE_MEAN, 0);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);
+    c = cfg(5, 8, ADC_SCAN_REDUCE_MEAN, 0);
+    c.target_sem_mlsb = 300;
+    c.min_samples = 1;
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);          // La varianza necesita 2
+    c.min_samples = 9;
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);          // Mínimo sobre el máximo
+    c = cfg(5, 8, ADC_SCAN_REDUCE_MEDIAN, 3);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), 1);
+    TEST_ASSERT_EQ(adc_scan_find(&s_scan, 3), 0);
+    TEST_ASSERT_EQ(adc_scan_find(&s_scan, 5), 1);
+    TEST_ASSERT_EQ(adc_scan_find(&s_scan, 4), -1);
+
+    for (int i = 2; i < ADC_SCAN_MAX_CHANNELS; i++) {
+        c = cfg(10 + i, 1, ADC_SCAN_REDUCE_MEAN, 0);
+        TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), i);
+    }
+    c = cfg(99, 1, ADC_SCAN_REDUCE_MEAN, 0);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &c), -1);          // Tabla llena
+}
+
+static void test_round_robin(void)
+{
+    adc_scan_init(&s_scan);
+    TEST_ASSERT_EQ(adc_scan_next(&s_scan), -1);
+    for (int ch = 0; ch < 3; ch++) {
+        adc_scan_channel_cfg_t c = cfg(ch, 4, ADC_SCAN_REDUCE_MEAN, 0);
+        adc_scan_add(&s_scan, &c);
+    }
+    for (int k = 0; k < 9; k++) {
+        TEST_ASSERT_EQ(adc_scan_next(&s_scan), k % 3);
+    }
+    TEST_ASSERT_EQ(s_scan.rounds, 3);
+
+    // Un canal agregado en marcha entra en la ronda siguiente
+    adc_scan_channel_cfg_t c = cfg(7, 4, ADC_SCAN_REDUCE_MEAN, 0);
+    adc_scan_add(&s_scan, &c);
+    for (int k = 0; k < 4; k++) {
+        TEST_ASSERT_EQ(adc_scan_next(&s_scan), k);
+    }
+}
+
+static void test_reduce(void)
+{
+    adc_scan_channel_cfg_t mean = cfg(0, 5, ADC_SCAN_REDUCE_MEAN, 0);
+    adc_scan_channel_cfg_t median = cfg(0, 5, ADC_SCAN_REDUCE_MEDIAN, 0);
+    int32_t a[5] = {100, 102, 4095, 98, 100};
+    TEST_ASSERT_EQ(adc_scan_reduce(&mean, a, 5), 899);
+    TEST_ASSERT_EQ(adc_scan_reduce(&median, a, 5), 100);    // El pico no cuenta
+    int32_t b[4] = {10, 40, 20, 30};
+    TEST_ASSERT_EQ(adc_scan_reduce(&median, b, 4), 25);
+    TEST_ASSERT_EQ(adc_scan_reduce(&mean, b, 0), 0);
+}
+
+static void test_reduce_extra_bits(void)
+{
+    // 1000.75 LSB: antes se truncaba a 1000; ahora se redondea o se guarda la fracción
+    adc_scan_channel_cfg_t mean = cfg(0, 4, ADC_SCAN_REDUCE_MEAN, 0);
+    int32_t a[4] = {1000, 1001, 1001, 1001};
+    TEST_ASSERT_EQ(adc_scan_reduce(&mean, a, 4), 1001);
+    mean.extra_bits = 2;
+    TEST_ASSERT_EQ(adc_scan_reduce(&mean, a, 4), 4003);
+    adc_scan_channel_cfg_t median = cfg(0, 4, ADC_SCAN_REDUCE_MEDIAN, 0);
+    median.extra_bits = 2;
+    int32_t b[4] = {10, 40, 20, 30};
+    TEST_ASSERT_EQ(adc_scan_reduce(&median, b, 4), 100);    // Solo escala
+    mean.extra_bits = ADC_DECIM_MAX_EXTRA_BITS + 1;
+    adc_scan_init(&s_scan);
+    TEST_ASSERT_EQ(adc_scan_add(&s_scan, &mean), -1);
+}
+
+static void test_publish_and_ema(void)
+{
+    adc_scan_init(&s_scan);
+    adc_scan_channel_cfg_t c = cfg(1, 4, ADC_SCAN_REDUCE_MEAN, 2);
+    int slot = adc_scan_add(&s_scan, &c);
+    adc_scan_value_t v;
+    TEST_ASSERT(!adc_scan_latest(&s_scan, slot, &v));       // Sin publicar
+    TEST_ASSERT(!adc_scan_latest(&s_scan, 5, &v));
+
+    adc_scan_publish(&s_scan, slot, 1000, 4, 10);
+    TEST_ASSERT(adc_scan_latest(&s_scan, slot, &v));
+    TEST_ASSERT_EQ(v.raw, 1000);
+    TEST_ASSERT_EQ(v.value, 1000);                          // Primera muestra siembra el filtro
+    TEST_ASSERT_EQ(v.t_ms, 10);
+
+    // Escalón: alfa 1/4 → 1100, 1175, 1231 … hacia 1400
+    adc_scan_publish(&s_scan, slot, 1400, 3, 20);
+    TEST_ASSERT(adc_scan_latest(&s_scan, slot, &v));
+    TEST_ASSERT_EQ(v.raw, 1400);
+    TEST_ASSERT_EQ(v.value, 1100);
+    TEST_ASSERT_EQ(v.samples, 3);                           // Ráfaga adaptativa más corta
+    for (int i = 0; i < 40; i++) {
+        adc_scan_publish(&s_scan, slot, 1400, 4, 30 + i);
+    }
+    TEST_ASSERT(adc_scan_latest(&s_scan, slot, &v));
+    TEST_ASSERT(v.value >= 1398 && v.value <= 1400);
+    TEST_ASSERT_EQ(v.updates, 42);
+}
+
+// Un escritor publica raw == t_ms; los lectores nunca deben ver una mezcla
+static atomic_bool s_stop;
+static atomic_uint s_torn;
+
+static void *writer(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 1; i <= 200000; i++) {
+        adc_scan_publish(&s_scan, 0, (int32_t)i, (uint8_t)i, i);
+    }
+    atomic_store(&s_stop, true);
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    (void)arg;
+    adc_scan_value_t v;
+    while (!atomic_load(&s_stop)) {
+        if (adc_scan_latest(&s_scan, 0, &v) &&
+            ((uint32_t)v.raw != v.t_ms || v.updates != v.t_ms || v.samples != (uint8_t)v.t_ms)) {
+            atomic_fetch_add(&s_torn, 1);
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_reads_are_consistent(void)
+{
+    adc_scan_init(&s_scan);
+    adc_scan_channel_cfg_t c = cfg(0, 1, ADC_SCAN_REDUCE_MEAN, 0);
+    adc_scan_add(&s_scan, &c);
+    atomic_store(&s_stop, false);
+    atomic_store(&s_torn, 0);
+
+    pthread_t w, r1, r2;
+    pthread_create(&r1, NULL, reader, NULL);
+    pthread_create(&r2, NULL, reader, NULL);
+    pthread_create(&w, NULL, writer, NULL);
+    pthread_join(w, NULL);
+    pthread_join(r1, NULL);
+    pthread_join(r2, NULL);
+    TEST_ASSERT_EQ(atomic_load(&s_torn), 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_add_and_find);
+    TEST_RUN(test_round_robin);
+    TEST_RUN(test_reduce);
+    TEST_RUN(test_reduce_extra_bits);
+    TEST_RUN(test_publish_and_ema);
+    TEST_RUN(test_concurrent_reads_are_consistent);
+    return TEST_EXIT();
+}
@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "bench.h"
+#include "test_unit.h"
+
+static int s_setup_calls = 0;
+static int s_iterations = 0;
+
+static void bench_count_iterations(void)
+{
+    s_iterations++;
+}
+BENCH_REGISTER("zz_count", bench_count_iterations);
+
+static bool skip_setup(void)
+{
+    s_setup_calls++;
+    return false;
+}
+
+static void bench_skipped(void)
+{
+    s_iterations += 1000;
+}
+BENCH_REGISTER_SETUP("aa_skipped", skip_setup, bench_skipped);
+
+static void bench_spin(void)
+{
+    uint32_t x = 1;
+    for (int i = 0; i < 200; i++) {
+        x = x * 1103515245u + 12345u;
+    }
+    BENCH_KEEP(x);
+}
+BENCH_REGISTER("mm_spin", bench_spin);
+
+static void test_summary_percentiles(void)
+{
+    uint32_t c[100];
+    for (int i = 0; i < 100; i++) {
+        c[i] = 100 - i;                     // 100..1 desordenado
+    }
+    bench_result_t r;
+    bench_summarize(c, 100, 10.0f, &r);
+    TEST_ASSERT_EQ(r.iters, 100);
+    TEST_ASSERT_EQ(r.min_cycles, 1);
+    TEST_ASSERT_EQ(r.median_cycles, 50);    // (50 + 51) / 2
+    TEST_ASSERT_EQ(r.p99_cycles, 99);
+    TEST_ASSERT(r.min_us > 0.099f && r.min_us < 0.101f);
+    TEST_ASSERT(r.p99_us > 9.89f && r.p99_us < 9.91f);
+
+    // Pocas muestras: el p99 es el máximo y la mediana la del medio
+    uint32_t few[5] = { 7, 3, 900, 5, 4 };
+    bench_summarize(few, 5, 1.0f, &r);
+    TEST_ASSERT_EQ(r.min_cycles, 3);
+    TEST_ASSERT_EQ(r.median_cycles, 5);
+    TEST_ASSERT_EQ(r.p99_cycles, 900);
+
+    bench_summarize(few, 0, 1.0f, &r);
+    TEST_ASSERT_EQ(r.iters, 0);
+}
+
+static void test_registry_sorted_and_filtered(void)
+{
+    TEST_ASSERT_EQ(bench_count(), 3);
+    TEST_ASSERT(strcmp(bench_get(0)->name, "aa_skipped") == 0);
+    TEST_ASSERT(strcmp(bench_get(1)->name, "mm_spin") == 0);
+    TEST_ASSERT(strcmp(bench_get(2)->name, "zz_count") == 0);
+    TEST_ASSERT(bench_get(3) == NULL);
+
+    // Registrar de nuevo el mismo no lo duplica
+    bench_register((bench_t *)bench_get(1));
+    TEST_ASSERT_EQ(bench_count(), 3);
+
+    TEST_ASSERT(bench_matches(bench_get(1), ""));
+    TEST_ASSERT(bench_matches(bench_get(1), "all"));
+    TEST_ASSERT(bench_matches(bench_get(1), "mm"));
+    TEST_ASSERT(!bench_matches(bench_get(1), "zz"));
+}
+
+static void test_run_counts_warmup_and_iterations(void)
+{
+    bench_result_t r;
+    s_iterations = 0;
+    TEST_ASSERT(bench_run(bench_get(2), 50, &r));
+    TEST_ASSERT_EQ(s_iterations, 50 + BENCH_WARMUP_ITERS);
+    TEST_ASSERT_EQ(r.iters, 50);
+    TEST_ASSERT(r.min_cycles <= r.median_cycles && r.median_cycles <= r.p99_cycles);
+
+    // Iteraciones fuera de rango se recortan
+    s_iterations = 0;
+    TEST_ASSERT(bench_run(bench_get(2), BENCH_MAX_ITERS + 10, &r));
+    TEST_ASSERT_EQ(r.iters, BENCH_MAX_ITERS);
+    TEST_ASSERT(bench_run(bench_get(2), 0, &r));
+    TEST_ASSERT_EQ(r.iters, 1);
+}
+
+static void test_setup_can_skip(void)
+{
+    bench_result_t r;
+    s_iterations = 0;
+    TEST_ASSERT(!bench_run(bench_get(0), 10, &r));
+    TEST_ASSERT_EQ(s_setup_calls, 1);
+    TEST_ASSERT_EQ(s_iterations, 0);
+
+    // La tabla corre los que coinciden y saltea el omitido
+    TEST_ASSERT_EQ(bench_run_matching("all", 20), 2);
+    TEST_ASSERT_EQ(bench_run_matching("nada", 20), 0);
+}
+
+static void test_measures_work(void)
+{
+    // 200 multiplicaciones encadenadas cuestan más que una iteración vacía
+    bench_result_t spin, empty;
+    TEST_ASSERT(bench_run(bench_get(1), 100, &spin));
+    TEST_ASSERT(bench_run(bench_get(2), 100, &empty));
+    TEST_ASSERT(spin.min_cycles > empty.min_cycles);
+    TEST_ASSERT(spin.min_us > 0.0f);
+}
+
+int main(void)
+{
+    TEST_RUN(test_summary_percentiles);
+    TEST_RUN(test_registry_sorted_and_filtered);
+    TEST_RUN(test_run_counts_warmup_and_iterations);
+    TEST_RUN(test_setup_can_skip);
+    TEST_RUN(test_measures_work);
+    return TEST_EXIT();
+}
@@ -0,0 +1,137 @@
+#include <string.h>
+
+#include "cmdline.h"
+#include "test_unit.h"
+
+static int64_t s_clock_us = 0;
+static char s_last_args[CMDLINE_LINE_MAX];
+static int s_calls_ps = 0;
+
+static int64_t fake_clock(void)
+{
+    return s_clock_us;
+}
+
+static void cmd_ps(const char *args)
+{
+    s_calls_ps++;
+    strcpy(s_last_args, args);
+    s_clock_us += 250;                      // El manejador "tarda" 250 µs
+}
+
+static void cmd_pm(const char *args)
+{
+    strcpy(s_last_args, args);
+}
+
+static const cmdline_cmd_t TABLE[] = {
+    { "ps", "ps [modo]", cmd_ps },
+    { "pm", "pm [on|off]", cmd_pm },
+};
+
+static void test_init_rejects_bad_tables(void)
+{
+    const cmdline_cmd_t no_fn[] = { { "x", NULL, NULL } };
+    TEST_ASSERT_EQ(cmdline_init(no_fn, 1, fake_clock), ESP_ERR_INVALID_ARG);
+    TEST_ASSERT_EQ(cmdline_init(TABLE, 2, NULL), ESP_ERR_INVALID_ARG);
+    TEST_ASSERT_EQ(cmdline_init(TABLE, CMDLINE_MAX_COMMANDS + 1, fake_clock), ESP_ERR_INVALID_ARG);
+    TEST_ASSERT_EQ(cmdline_init(TABLE, 2, fake_clock), ESP_OK);
+    TEST_ASSERT_EQ(cmdline_count(), 2);
+}
+
+static void test_dispatch_matches_whole_words(void)
+{
+    cmdline_init(TABLE, 2, fake_clock);
+    s_calls_ps = 0;
+
+    TEST_ASSERT_EQ(cmdline_dispatch("PS"), ESP_OK);
+    TEST_ASSERT_EQ(s_last_args[0], '\0');
+    TEST_ASSERT_EQ(cmdline_dispatch("  ps   max 3"), ESP_OK);
+    TEST_ASSERT(strcmp(s_last_args, "max 3") == 0);
+    TEST_ASSERT_EQ(cmdline_dispatch("pm on"), ESP_OK);
+    TEST_ASSERT(strcmp(s_last_args, "on") == 0);
+
+    // Prefijos y palabras más largas no son el comando
+    TEST_ASSERT_EQ(cmdline_dispatch("psx"), ESP_ERR_NOT_FOUND);
+    TEST_ASSERT_EQ(cmdline_dispatch("p"), ESP_ERR_NOT_FOUND);
+    TEST_ASSERT_EQ(cmdline_unknown_count(), 2);
+    TEST_ASSERT_EQ(s_calls_ps, 2);
+}
+
+static void test_handler_timing(void)
+{
+    cmdline_init(TABLE, 2, fake_clock);
+    cmdline_dispatch("ps");
+    cmdline_dispatch("ps min");
+    cmdline_stats_t st;
+    const cmdline_cmd_t *cmd = cmdline_get(0, &st);
+    TEST_ASSERT(cmd == &TABLE[0]);
+    TEST_ASSERT_EQ(st.calls, 2);
+    TEST_ASSERT_EQ(st.total_us, 500);
+    TEST_ASSERT_EQ(st.max_us, 250);
+    cmdline_get(1, &st);
+    TEST_ASSERT_EQ(st.calls, 0);
+    TEST_ASSERT(cmdline_get(2, NULL) == NULL);
+}
+
+/** Entrega `s` en trozos de `chunk` bytes; devuelve las líneas concatenadas con '|' */
+static void feed_all(cmdline_reader_t *r, const char *s, size_t chunk, char *out)
+{
+    out[0] = '\0';
+    size_t len = strlen(s);
+    for (size_t pos = 0; pos < len; pos += chunk) {
+        size_t n = len - pos < chunk ? len - pos : chunk;
+        size_t off = 0;
+        while (off < n) {
+            size_t used = 0;
+            const char *line = cmdline_reader_feed(r, (const uint8_t *)s + pos + off, n - off,
+                                                   &used);
+            off += used;
+            if (line != NULL) {
+                strcat(out, line);
+                strcat(out, "|");
+            }
+        }
+    }
+}
+
+static void test_reader_lines(void)
+{
+    cmdline_reader_t r;
+    char out[512];
+    for (size_t chunk = 1; chunk <= 8; chunk++) {
+        cmdline_reader_init(&r);
+        // CRLF, CR solo, líneas vacías, borrado y un byte de control
+        feed_all(&r, "calA\r\nps max\r\r\n\nshoo\bw\x01\npm", chunk, out);
+        TEST_ASSERT(strcmp(out, "calA|ps max|show|") == 0);
+        // La línea sin terminar queda pendiente
+        feed_all(&r, " on\n", chunk, out);
+        TEST_ASSERT(strcmp(out, "pm on|") == 0);
+    }
+}
+
+static void test_reader_overflow(void)
+{
+    cmdline_reader_t r;
+    char out[512];
+    char big[CMDLINE_LINE_MAX + 40];
+    memset(big, 'x', sizeof(big) - 2);
+    big[sizeof(big) - 2] = '\n';
+    big[sizeof(big) - 1] = '\0';
+    cmdline_reader_init(&r);
+    feed_all(&r, big, 16, out);
+    TEST_ASSERT_EQ(out[0], '\0');           // Descartada entera, no truncada
+    TEST_ASSERT_EQ(r.overflows, 1);
+    feed_all(&r, "tanks\n", 16, out);
+    TEST_ASSERT(strcmp(out, "tanks|") == 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_init_rejects_bad_tables);
+    TEST_RUN(test_dispatch_matches_whole_words);
+    TEST_RUN(test_handler_timing);
+    TEST_RUN(test_reader_lines);
+    TEST_RUN(test_reader_overflow);
+    return TEST_EXIT();
+}
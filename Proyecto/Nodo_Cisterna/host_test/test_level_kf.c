@@ -0,0 +1,161 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "level_kf.h"
+#include "test_unit.h"
+
+static const level_kf_cfg_t s_cfg = {
+    .pump_rate_cm_s = 0.3f,
+    .accel_noise = 1e-5f,
+    .meas_var_cm2 = 4.0f,
+    .pump_switch_var = 0.05f,
+    .gate_sigma = 4.0f,
+    .max_dt_s = 120.0f,
+};
+
+// Ruido gaussiano aproximado (suma de uniformes) con semilla fija
+static float noise(float sigma)
+{
+    float acc = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        acc += (float)rand() / (float)RAND_MAX;
+    }
+    return (acc - 6.0f) * sigma;
+}
+
+static void test_first_measurement_initializes(void)
+{
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    TEST_ASSERT(!level_kf_step(&kf, 0, false, 0.0f, 0));
+    TEST_ASSERT(!kf.initialized);
+    TEST_ASSERT(level_kf_step(&kf, 0, false, 100.0f, 100));
+    TEST_ASSERT(fabsf(kf.level - 100.0f) < 1e-3f);
+}
+
+static void test_static_level_reduces_jitter(void)
+{
+    srand(1);
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    float max_err = 0.0f;
+    for (int i = 0; i < 600; i++) {
+        level_kf_step(&kf, (uint32_t)i * 1000, false, 100.0f + noise(2.0f), 100);
+        if (i > 60 && fabsf(kf.level - 100.0f) > max_err) {
+            max_err = fabsf(kf.level - 100.0f);
+        }
+    }
+    // Medición con σ = 2 cm; tras converger el filtro queda dentro de ±1 cm
+    TEST_ASSERT(max_err < 1.0f);
+    TEST_ASSERT(fabsf(level_kf_total_rate(&kf)) < 0.02f);
+    TEST_ASSERT(kf.p00 < 1.0f);
+}
+
+static void test_pump_input_tracks_fill(void)
+{
+    srand(2);
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    float truth = 20.0f;
+    for (int i = 0; i < 300; i++) {
+        bool pump = i >= 60;
+        if (pump) {
+            truth += 0.3f * 0.5f;
+        }
+        level_kf_step(&kf, (uint32_t)i * 500, pump, truth + noise(2.0f), 100);
+    }
+    TEST_ASSERT(fabsf(kf.level - truth) < 1.5f);
+    TEST_ASSERT(fabsf(level_kf_total_rate(&kf) - 0.3f) < 0.05f);
+}
+
+static void test_threshold_crossing_does_not_chatter(void)
+{
+    // Nivel fijo 2 cm sobre el umbral de 20 cm con σ = 2.5 cm de jitter: la
+    // lectura cruda cruza el umbral a menudo, la filtrada no
+    srand(3);
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    int raw_cross = 0, kf_cross = 0;
+    bool raw_low = false, kf_low = false;
+    for (int i = 0; i < 600; i++) {
+        float z = 22.0f + noise(2.5f);
+        level_kf_step(&kf, (uint32_t)i * 1000, false, z, 100);
+        if (i < 30) {
+            continue;
+        }
+        if ((z < 20.0f) != raw_low) {
+            raw_low = !raw_low;
+            raw_cross++;
+        }
+        if ((kf.level < 20.0f) != kf_low) {
+            kf_low = !kf_low;
+            kf_cross++;
+        }
+    }
+    TEST_ASSERT(raw_cross > 50);
+    TEST_ASSERT(kf_cross <= 2);
+}
+
+static void test_outlier_gated(void)
+{
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    for (int i = 0; i < 50; i++) {
+        level_kf_step(&kf, (uint32_t)i * 1000, false, 100.0f, 100);
+    }
+    TEST_ASSERT(!level_kf_step(&kf, 50000, false, 160.0f, 100));
+    TEST_ASSERT_EQ(kf.rejected, 1);
+    TEST_ASSERT(fabsf(kf.level - 100.0f) < 0.5f);
+}
+
+static void test_persistent_step_resets(void)
+{
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    for (int i = 0; i < 50; i++) {
+        level_kf_step(&kf, (uint32_t)i * 1000, false, 100.0f, 100);
+    }
+    for (int i = 0; i < LEVEL_KF_MAX_REJECTS; i++) {
+        level_kf_step(&kf, (uint32_t)(50 + i) * 1000, false, 150.0f, 100);
+    }
+    TEST_ASSERT(fabsf(kf.level - 150.0f) < 1e-3f);
+}
+
+static void test_low_confidence_weighs_less(void)
+{
+    level_kf_t a, b;
+    level_kf_init(&a, &s_cfg);
+    level_kf_init(&b, &s_cfg);
+    for (int i = 0; i < 30; i++) {
+        level_kf_step(&a, (uint32_t)i * 1000, false, 100.0f, 100);
+        level_kf_step(&b, (uint32_t)i * 1000, false, 100.0f, 100);
+    }
+    level_kf_step(&a, 30000, false, 103.0f, 100);
+    level_kf_step(&b, 30000, false, 103.0f, 20);
+    TEST_ASSERT(a.level - 100.0f > b.level - 100.0f);
+}
+
+static void test_prediction_without_measurement(void)
+{
+    level_kf_t kf;
+    level_kf_init(&kf, &s_cfg);
+    level_kf_step(&kf, 0, true, 50.0f, 100);
+    float p_before = kf.p00;
+    TEST_ASSERT(!level_kf_step(&kf, 10000, true, 0.0f, 0));
+    // Con la bomba encendida avanza 0.3 cm/s aun sin medición
+    TEST_ASSERT(fabsf(kf.level - 53.0f) < 1e-3f);
+    TEST_ASSERT(kf.p00 > p_before);
+}
+
+int main(void)
+{
+    TEST_RUN(test_first_measurement_initializes);
+    TEST_RUN(test_static_level_reduces_jitter);
+    TEST_RUN(test_pump_input_tracks_fill);
+    TEST_RUN(test_threshold_crossing_does_not_chatter);
+    TEST_RUN(test_outlier_gated);
+    TEST_RUN(test_persistent_step_resets);
+    TEST_RUN(test_low_confidence_weighs_less);
+    TEST_RUN(test_prediction_without_measurement);
+    return TEST_EXIT();
+}
@@ -0,0 +1,97 @@
+#include "lp_decision.h"
+#include "test_unit.h"
+
+static const lp_decision_cfg_t s_cfg = {
+    .level_low_us = 1000,
+    .level_high_us = 10000,
+    .level_deadband_us = 200,
+    .tds_high_raw = 2000,
+    .tds_deadband_raw = 100,
+    .batch_size = 8,
+};
+
+static uint32_t step(lp_decision_state_t *st, uint32_t echo_us, uint32_t tds_raw, uint32_t count)
+{
+    lp_sample_t s = { .echo_us = echo_us, .tds_raw = tds_raw };
+    return lp_decision_step(st, &s_cfg, &s, count);
+}
+
+static void test_first_sample_sets_zone_without_wake(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    TEST_ASSERT_EQ(step(&st, 500, LP_TDS_NONE, 1), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(st.level_zone, LP_ZONE_LOW);
+}
+
+static void test_threshold_crossing_wakes(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    step(&st, 5000, LP_TDS_NONE, 1);
+    TEST_ASSERT_EQ(step(&st, 900, LP_TDS_NONE, 2), LP_WAKE_LEVEL_LOW);
+    TEST_ASSERT_EQ(step(&st, 800, LP_TDS_NONE, 3), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 12000, LP_TDS_NONE, 4), LP_WAKE_LEVEL_HIGH);
+}
+
+static void test_deadband_suppresses_chatter(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    step(&st, 5000, LP_TDS_NONE, 1);
+    TEST_ASSERT_EQ(step(&st, 990, LP_TDS_NONE, 2), LP_WAKE_LEVEL_LOW);
+    // Oscilar justo sobre el umbral no vuelve a la zona normal
+    TEST_ASSERT_EQ(step(&st, 1010, LP_TDS_NONE, 3), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 1150, LP_TDS_NONE, 4), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 1250, LP_TDS_NONE, 5), LP_WAKE_LEVEL_OK);
+}
+
+static void test_batch_full_wakes(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    for (uint32_t i = 1; i < s_cfg.batch_size; i++) {
+        TEST_ASSERT_EQ(step(&st, 5000, LP_TDS_NONE, i), LP_WAKE_NONE);
+    }
+    TEST_ASSERT_EQ(step(&st, 5000, LP_TDS_NONE, s_cfg.batch_size), LP_WAKE_BATCH_FULL);
+}
+
+static void test_sensor_fail_wakes_once(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    step(&st, 5000, LP_TDS_NONE, 1);
+    uint32_t wakes = 0;
+    for (uint32_t i = 0; i < 2 * LP_FAIL_WAKE_COUNT; i++) {
+        wakes |= step(&st, 0, LP_TDS_NONE, 2);
+        if (i + 1 == LP_FAIL_WAKE_COUNT) {
+            TEST_ASSERT_EQ(wakes, LP_WAKE_SENSOR_FAIL);
+            wakes = 0;
+        }
+    }
+    TEST_ASSERT_EQ(wakes, LP_WAKE_NONE);
+    // Un fallo no altera la zona de nivel
+    TEST_ASSERT_EQ(st.level_zone, LP_ZONE_NORMAL);
+}
+
+static void test_tds_hysteresis(void)
+{
+    lp_decision_state_t st;
+    lp_decision_reset(&st);
+    TEST_ASSERT_EQ(step(&st, 5000, 2100, 1), LP_WAKE_TDS_HIGH);
+    TEST_ASSERT_EQ(step(&st, 5000, 1950, 2), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 5000, 2100, 3), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 5000, 1800, 4), LP_WAKE_NONE);
+    TEST_ASSERT_EQ(step(&st, 5000, 2100, 5), LP_WAKE_TDS_HIGH);
+}
+
+int main(void)
+{
+    TEST_RUN(test_first_sample_sets_zone_without_wake);
+    TEST_RUN(test_threshold_crossing_wakes);
+    TEST_RUN(test_deadband_suppresses_chatter);
+    TEST_RUN(test_batch_full_wakes);
+    TEST_RUN(test_sensor_fail_wakes_once);
+    TEST_RUN(test_tds_hysteresis);
+    return TEST_EXIT();
+}
@@ -0,0 +1,119 @@
+#include <string.h>
+
+#include "payload.h"
+#include "test_unit.h"
+
+static sensor_data_t sample(void)
+{
+    sensor_data_t d = {0};
+    d.water_level = 123.456f;
+    d.tds_value = 412.66f;
+    d.tds_samples = 12;
+    d.water_state = WATER_STATE_MEDIUM;
+    d.level_pings = 5;
+    d.level_valid = 4;
+    d.level_confidence = 82;
+    d.level_filtered = 123.12f;
+    d.level_rate = -0.0031f;
+    d.level_var = 0.84f;
+    return d;
+}
+
+static void test_simple_payloads(void)
+{
+    char buf[128];
+    sensor_data_t d = sample();
+    const char *q = "{\"pings\":5,\"valid\":4,\"confidence\":82}";
+    TEST_ASSERT_EQ(payload_level_quality(buf, sizeof(buf), &d), strlen(q));
+    TEST_ASSERT(strcmp(buf, q) == 0);
+
+    const char *f = "{\"level\":123.12,\"rate\":-0.0031,\"var\":0.840}";
+    TEST_ASSERT_EQ(payload_level_filtered(buf, sizeof(buf), &d), strlen(f));
+    TEST_ASSERT(strcmp(buf, f) == 0);
+
+    const char *v = "{\"height_cm\":76.9,\"liters\":2307.0}";
+    TEST_ASSERT_EQ(payload_volume(buf, sizeof(buf), 76.88f, 2307.0f), strlen(v));
+    TEST_ASSERT(strcmp(buf, v) == 0);
+}
+
+static void test_water_state_names(void)
+{
+    TEST_ASSERT(strcmp(payload_water_state(WATER_STATE_CLEAN), "LIMPIA") == 0);
+    TEST_ASSERT(strcmp(payload_water_state(WATER_STATE_MEDIUM), "MEDIA") == 0);
+    TEST_ASSERT(strcmp(payload_water_state(WATER_STATE_DIRTY), "SUCIA") == 0);
+    TEST_ASSERT(strcmp(payload_water_state((water_state_t)7), "?") == 0);
+}
+
+static void test_tank_state(void)
+{
+    char buf[256];
+    sensor_data_t d = sample();
+    const char *plain = "{\"level\":123.46,\"filtered\":123.12,\"tds\":412.7,\"tds_n\":12,\"state\":\"MEDIA\"}";
+    TEST_ASSERT_EQ(payload_tank_state(buf, sizeof(buf), &d, true, 0.0f, -1.0f, NULL), strlen(plain));
+    TEST_ASSERT(strcmp(buf, plain) == 0);
+
+    // Sin sonda el estado queda vacío; un resumen sin niveles no agrega "hist"
+    tank_history_summary_t sum = {0};
+    payload_tank_state(buf, sizeof(buf), &d, false, 0.0f, -1.0f, &sum);
+    TEST_ASSERT(strstr(buf, "\"state\":\"\"}") != NULL);
+
+    sum = (tank_history_summary_t){ .samples = 60, .level_samples = 58, .level_min_cm = 121.9f,
+                                    .level_max_cm = 124.6f, .level_mean_cm = 123.3f,
+                                    .span_ms = 59999 };
+    const char *hist = "{\"level\":123.46,\"filtered\":123.12,\"tds\":412.7,\"tds_n\":12,\"state\":\"MEDIA\","
+                       "\"hist\":{\"n\":58,\"min\":121.90,\"max\":124.60,\"mean\":123.30,\"span_s\":59}}";
+    TEST_ASSERT_EQ(payload_tank_state(buf, sizeof(buf), &d, true, 0.0f, -1.0f, &sum), strlen(hist));
+    TEST_ASSERT(strcmp(buf, hist) == 0);
+
+    // Con geometría, altura y litros del tanque antes del historial
+    const char *vol = "{\"level\":123.46,\"filtered\":123.12,\"tds\":412.7,\"tds_n\":12,\"state\":\"MEDIA\","
+                      "\"height_cm\":76.9,\"liters\":2306.6,"
+                      "\"hist\":{\"n\":58,\"min\":121.90,\"max\":124.60,\"mean\":123.30,\"span_s\":59}}";
+    TEST_ASSERT_EQ(payload_tank_state(buf, sizeof(buf), &d, true, 76.88f, 2306.6f, &sum), strlen(vol));
+    TEST_ASSERT(strcmp(buf, vol) == 0);
+}
+
+static void test_level_batch(void)
+{
+    char buf[128];
+    const float levels[] = { 120.04f, 119.96f, -1.0f };
+    const char *b = "{\"reason\":2,\"dropped\":1,\"period_ms\":1000,\"levels_cm\":[120.0,120.0,-1.0]}";
+    TEST_ASSERT_EQ(payload_level_batch(buf, sizeof(buf), levels, 3, 2, 1, 1000), strlen(b));
+    TEST_ASSERT(strcmp(buf, b) == 0);
+
+    const char *empty = "{\"reason\":0,\"dropped\":0,\"period_ms\":1000,\"levels_cm\":[]}";
+    TEST_ASSERT_EQ(payload_level_batch(buf, sizeof(buf), NULL, 0, 0, 0, 1000), strlen(empty));
+    TEST_ASSERT(strcmp(buf, empty) == 0);
+}
+
+static void test_short_buffer(void)
+{
+    // Justo el largo + '\0' entra; un byte menos, y cualquier largo menor, no
+    char buf[256];
+    sensor_data_t d = sample();
+    int n = payload_tank_state(buf, sizeof(buf), &d, true, 0.0f, -1.0f, NULL);
+    TEST_ASSERT(n > 0);
+    TEST_ASSERT_EQ(payload_tank_state(buf, (size_t)n + 1, &d, true, 0.0f, -1.0f, NULL), n);
+    int fails = 0;
+    for (size_t len = 0; len <= (size_t)n; len++) {
+        fails += payload_tank_state(buf, len, &d, true, 0.0f, -1.0f, NULL) == -1;
+    }
+    TEST_ASSERT_EQ(fails, n + 1);
+    TEST_ASSERT_EQ(payload_level_quality(buf, 8, &d), -1);
+
+    float levels[60];
+    for (int i = 0; i < 60; i++) {
+        levels[i] = 150.0f;
+    }
+    TEST_ASSERT_EQ(payload_level_batch(buf, 64, levels, 60, 0, 0, 1000), -1);
+}
+
+int main(void)
+{
+    TEST_RUN(test_simple_payloads);
+    TEST_RUN(test_water_state_names);
+    TEST_RUN(test_tank_state);
+    TEST_RUN(test_level_batch);
+    TEST_RUN(test_short_buffer);
+    return TEST_EXIT();
+}
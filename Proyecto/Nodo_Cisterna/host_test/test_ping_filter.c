@@ -0,0 +1,121 @@
+#include <math.h>
+
+#include "ping_filter.h"
+#include "test_unit.h"
+
+#define NEAR(a, b, tol) (fabsf((a) - (b)) <= (tol))
+
+static ping_filter_cfg_t s_cfg;
+
+static void test_clean_burst_averages_all(void)
+{
+    const uint32_t echo[] = {5830, 5832, 5829, 5831, 5833};
+    ping_result_t r;
+    TEST_ASSERT(ping_filter_run(&s_cfg, echo, 5, &r));
+    TEST_ASSERT_EQ(r.valid, 5);
+    TEST_ASSERT_EQ(r.pings, 5);
+    TEST_ASSERT(NEAR(r.distance_cm, 5831.0f * PING_CM_PER_US, 0.01f));
+    TEST_ASSERT(r.confidence >= 90);
+}
+
+static void test_multipath_outlier_rejected(void)
+{
+    // Un eco de la pared lateral llega antes y otro doble rebote llega tarde
+    const uint32_t echo[] = {5830, 3100, 5840, 11660, 5825};
+    ping_result_t r;
+    TEST_ASSERT(ping_filter_run(&s_cfg, echo, 5, &r));
+    TEST_ASSERT_EQ(r.valid, 3);
+    TEST_ASSERT(NEAR(r.distance_cm, 100.0f, 0.5f));
+    TEST_ASSERT(r.confidence < 70);
+}
+
+static void test_timeouts_lower_confidence(void)
+{
+    const uint32_t echo[] = {0, 5830, 0, 5832, 5831};
+    ping_result_t r;
+    TEST_ASSERT(ping_filter_run(&s_cfg, echo, 5, &r));
+    TEST_ASSERT_EQ(r.in_range, 3);
+    TEST_ASSERT_EQ(r.valid, 3);
+    TEST_ASSERT(r.confidence <= 60);
+}
+
+static void test_too_few_echoes_is_invalid(void)
+{
+    const uint32_t echo[] = {0, 0, 5830, 0, 60000};
+    ping_result_t r;
+    TEST_ASSERT(!ping_filter_run(&s_cfg, echo, 5, &r));
+    TEST_ASSERT(r.distance_cm < 0.0f);
+    TEST_ASSERT_EQ(r.valid, 1);
+}
+
+static void test_identical_echoes_not_rejected(void)
+{
+    // MAD = 0: el piso de la MAD evita rechazar ecos a 1 µs de la mediana
+    const uint32_t echo[] = {4000, 4000, 4000, 4001, 3999};
+    ping_result_t r;
+    TEST_ASSERT(ping_filter_run(&s_cfg, echo, 5, &r));
+    TEST_ASSERT_EQ(r.valid, 5);
+}
+
+static void test_count_clamped_to_buffer(void)
+{
+    uint32_t echo[PING_BURST_MAX + 4];
+    for (int i = 0; i < PING_BURST_MAX + 4; i++) {
+        echo[i] = 2000;
+    }
+    ping_result_t r;
+    TEST_ASSERT(ping_filter_run(&s_cfg, echo, PING_BURST_MAX + 4, &r));
+    TEST_ASSERT_EQ(r.pings, PING_BURST_MAX);
+}
+
+/**
+ * Reproduce un archivo de duraciones grabadas (una ráfaga por línea,
+ * valores en µs separados por espacios; 0 = timeout).
+ *   ./test_ping_filter grabacion.txt
+ */
+static int replay(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        printf("✗ No se pudo abrir %s\n", path);
+        return 1;
+    }
+    char line[256];
+    int burst = 0;
+    while (fgets(line, sizeof(line), f)) {
+        uint32_t echo[PING_BURST_MAX];
+        int n = 0;
+        char *p = line;
+        int used;
+        unsigned v;
+        while (n < PING_BURST_MAX && sscanf(p, "%u%n", &v, &used) == 1) {
+            echo[n++] = v;
+            p += used;
+        }
+        if (n == 0) {
+            continue;
+        }
+        ping_result_t r;
+        bool ok = ping_filter_run(&s_cfg, echo, n, &r);
+        printf("%4d %s %7.2f cm | %u/%u válidos | dispersión %.2f cm | confianza %u\n",
+               ++burst, ok ? "✓" : "✗", r.distance_cm, r.valid, r.pings, r.spread_cm,
+               r.confidence);
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ping_filter_default_cfg(&s_cfg);
+    if (argc > 1) {
+        return replay(argv[1]);
+    }
+    TEST_RUN(test_clean_burst_averages_all);
+    TEST_RUN(test_multipath_outlier_rejected);
+    TEST_RUN(test_timeouts_lower_confidence);
+    TEST_RUN(test_too_few_echoes_is_invalid);
+    TEST_RUN(test_identical_echoes_not_rejected);
+    TEST_RUN(test_count_clamped_to_buffer);
+    return TEST_EXIT();
+}
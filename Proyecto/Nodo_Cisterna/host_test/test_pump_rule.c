@@ -0,0 +1,70 @@
+#include "pump_rule.h"
+#include "test_unit.h"
+
+static const pump_rule_cfg_t CFG = { .level_low_cm = 20.0f, .level_high_cm = 180.0f };
+
+static sensor_data_t reading(float level, float var, water_state_t state)
+{
+    sensor_data_t d = {0};
+    d.level_filtered = level;
+    d.level_var = var;
+    d.water_state = state;
+    return d;
+}
+
+static void test_low_level_turns_on(void)
+{
+    sensor_data_t d = reading(15.0f, 0.5f, WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_ON);
+    d.water_state = WATER_STATE_MEDIUM;
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_ON);
+}
+
+static void test_high_level_or_dirty_turns_off(void)
+{
+    sensor_data_t d = reading(185.0f, 0.5f, WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_OFF);
+    // Agua sucia apaga aunque el nivel esté bajo
+    d = reading(15.0f, 0.5f, WATER_STATE_DIRTY);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_OFF);
+}
+
+static void test_between_thresholds_keeps(void)
+{
+    sensor_data_t d = reading(90.0f, 0.5f, WATER_STATE_MEDIUM);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+    // Los umbrales son estrictos
+    d.level_filtered = 20.0f;
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+    d.level_filtered = 180.0f;
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+}
+
+static void test_without_estimate_only_dirty_acts(void)
+{
+    sensor_data_t d = reading(5.0f, -1.0f, WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+    d.level_filtered = 300.0f;
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+    d.water_state = WATER_STATE_DIRTY;
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_OFF);
+}
+
+static void test_initial_shared_state_keeps(void)
+{
+    // Estado de tasks_init antes de la primera lectura
+    sensor_data_t d;
+    sensor_data_init_empty(&d);
+    TEST_ASSERT_EQ(d.water_state, WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(pump_rule_decide(&CFG, &d), PUMP_RULE_KEEP);
+}
+
+int main(void)
+{
+    TEST_RUN(test_low_level_turns_on);
+    TEST_RUN(test_high_level_or_dirty_turns_off);
+    TEST_RUN(test_between_thresholds_keeps);
+    TEST_RUN(test_without_estimate_only_dirty_acts);
+    TEST_RUN(test_initial_shared_state_keeps);
+    return TEST_EXIT();
+}
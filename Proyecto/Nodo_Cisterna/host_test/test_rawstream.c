@@ -0,0 +1,125 @@
+#include <string.h>
+
+#include "rawstream.h"
+#include "test_unit.h"
+
+static int feed(rawstream_decoder_t *d, const uint8_t *wire, size_t n, rawstream_rec_t *out)
+{
+    int got = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (rawstream_decoder_feed(d, wire[i], &out[got])) {
+            got++;
+        }
+    }
+    return got;
+}
+
+static void test_crc16_check_value(void)
+{
+    // Valor de verificación de CRC-16/CCITT-FALSE
+    TEST_ASSERT_EQ(rawstream_crc16((const uint8_t *)"123456789", 9), 0x29B1);
+}
+
+static void test_cobs_roundtrip(void)
+{
+    const uint8_t cases[][6] = {
+        {0, 0, 0, 0, 0, 0},
+        {1, 2, 3, 4, 5, 6},
+        {0, 1, 0, 2, 0, 3},
+        {7, 0, 0, 8, 9, 0},
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint8_t enc[8], dec[8];
+        size_t n = rawstream_cobs_encode(cases[c], 6, enc);
+        TEST_ASSERT_EQ(n, 7);
+        TEST_ASSERT(memchr(enc, 0, n) == NULL);
+        TEST_ASSERT_EQ(rawstream_cobs_decode(enc, n, dec, sizeof(dec)), 6);
+        TEST_ASSERT(memcmp(dec, cases[c], 6) == 0);
+    }
+
+    // Bloque de 254 bytes sin ceros: código 0xFF sin cero implícito
+    uint8_t big[300], enc[310], dec[300];
+    for (int i = 0; i < 300; i++) {
+        big[i] = (uint8_t)(i % 255 + 1);
+    }
+    size_t n = rawstream_cobs_encode(big, 300, enc);
+    TEST_ASSERT_EQ(n, 302);
+    TEST_ASSERT_EQ(rawstream_cobs_decode(enc, n, dec, sizeof(dec)), 300);
+    TEST_ASSERT(memcmp(dec, big, 300) == 0);
+
+    // Código que apunta más allá del final
+    const uint8_t bad[] = {5, 1, 2};
+    TEST_ASSERT_EQ(rawstream_cobs_decode(bad, sizeof(bad), dec, sizeof(dec)), -1);
+}
+
+static void test_record_roundtrip(void)
+{
+    rawstream_rec_t in = {
+        .type = RAWSTREAM_REC_SAMPLE, .channel = RAWSTREAM_CH_ECHO(2), .seq = 0x0100,
+        .t_us = 0x00FF0000, .value = -1,
+    };
+    uint8_t wire[RAWSTREAM_WIRE_MAX];
+    size_t n = rawstream_encode(&in, wire);
+    TEST_ASSERT(n <= RAWSTREAM_WIRE_MAX);
+    TEST_ASSERT_EQ(wire[n - 1], 0);
+    TEST_ASSERT(memchr(wire, 0, n - 1) == NULL);
+
+    rawstream_decoder_t d;
+    rawstream_rec_t out[2];
+    rawstream_decoder_init(&d);
+    TEST_ASSERT_EQ(feed(&d, wire, n, out), 1);
+    TEST_ASSERT_EQ(out[0].channel, 0x82);
+    TEST_ASSERT(RAWSTREAM_CH_IS_ECHO(out[0].channel));
+    TEST_ASSERT_EQ(out[0].seq, 0x0100);
+    TEST_ASSERT_EQ(out[0].t_us, 0x00FF0000);
+    TEST_ASSERT_EQ(out[0].value, -1);
+    TEST_ASSERT_EQ(d.stats.frames, 1);
+}
+
+static void test_gaps_and_corruption(void)
+{
+    rawstream_decoder_t d;
+    rawstream_decoder_init(&d);
+    rawstream_rec_t out[8];
+    uint8_t wire[RAWSTREAM_WIRE_MAX];
+
+    // Basura antes de la primera trama (arranque a mitad de un registro)
+    const uint8_t junk[] = {0x31, 0x32, 0x00, 0x00};
+    TEST_ASSERT_EQ(feed(&d, junk, sizeof(junk), out), 0);
+    TEST_ASSERT_EQ(d.stats.framing_errors, 1);
+
+    // seq 65534, 65535, (0 descartado en el dispositivo), 1 corrupto, 2
+    const uint16_t seqs[] = {65534, 65535, 1, 2};
+    int got = 0;
+    for (int i = 0; i < 4; i++) {
+        rawstream_rec_t r = { .type = RAWSTREAM_REC_SAMPLE, .channel = 3, .seq = seqs[i],
+                              .t_us = 1000u * i, .value = 2000 + i };
+        size_t n = rawstream_encode(&r, wire);
+        if (seqs[i] == 1) {
+            wire[5] ^= 0x10;
+        }
+        got += feed(&d, wire, n, &out[got]);
+    }
+    TEST_ASSERT_EQ(got, 3);
+    TEST_ASSERT_EQ(out[2].seq, 2);
+    TEST_ASSERT_EQ(d.stats.crc_errors, 1);
+    // Sin contar la vuelta de 65535 a 0: faltan 0 y 1
+    TEST_ASSERT_EQ(d.stats.dropped, 2);
+
+    // Trama demasiado larga (sin delimitador) se descarta entera
+    uint8_t longrun[40];
+    memset(longrun, 0x55, sizeof(longrun));
+    TEST_ASSERT_EQ(feed(&d, longrun, sizeof(longrun), out), 0);
+    const uint8_t zero = 0;
+    TEST_ASSERT_EQ(feed(&d, &zero, 1, out), 0);
+    TEST_ASSERT_EQ(d.stats.framing_errors, 2);
+}
+
+int main(void)
+{
+    TEST_RUN(test_crc16_check_value);
+    TEST_RUN(test_cobs_roundtrip);
+    TEST_RUN(test_record_roundtrip);
+    TEST_RUN(test_gaps_and_corruption);
+    return TEST_EXIT();
+}
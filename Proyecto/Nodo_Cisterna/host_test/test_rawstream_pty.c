@@ -0,0 +1,152 @@
+/*
+ * Prueba de punta a punta de tools/rawstream_dump sobre un pseudo-terminal:
+ * el lado maestro hace de nodo (tramas con huecos, una corrupta y texto de
+ * log intercalado) y el decodificador lee el esclavo como si fuera la UART.
+ *
+ *   test_rawstream_pty <ruta de rawstream_dump>
+ */
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "rawstream.h"
+#include "test_unit.h"
+
+#define RECORDS 2000
+
+static const char *s_dump = NULL;
+
+static void write_all(int fd, const uint8_t *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w <= 0) {
+            return;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+/** Lanza el decodificador sobre `slave`; stderr (el resumen) va a `stats` */
+static pid_t spawn_dump(const char *slave, const char *csv, const char *stats)
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        int fd = open(stats, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(fd, STDERR_FILENO);
+        execl(s_dump, s_dump, "-t", "0.5", "-o", csv, slave, (char *)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+static void test_stream_over_pty(void)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    TEST_ASSERT(master >= 0);
+    TEST_ASSERT_EQ(grantpt(master), 0);
+    TEST_ASSERT_EQ(unlockpt(master), 0);
+    const char *slave = ptsname(master);
+
+    // El esclavo queda abierto y en modo crudo: sin eco ni edición de línea
+    int keep = open(slave, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    tcgetattr(keep, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(keep, TCSANOW, &tio);
+
+    char csv[] = "/tmp/rawstream_pty_XXXXXX";
+    char stats[] = "/tmp/rawstream_stats_XXXXXX";
+    close(mkstemp(csv));
+    close(mkstemp(stats));
+    pid_t pid = spawn_dump(slave, csv, stats);
+    TEST_ASSERT(pid > 0);
+
+    // Una línea de log que se coló antes de la primera trama
+    const char *log = "I (1234) adc_driver: scan: started\r\n";
+    write_all(master, (const uint8_t *)log, strlen(log));
+    // rawstream_start() envía un 0x00 suelto: cierra la basura sin perder el primer registro
+    const uint8_t sync = 0;
+    write_all(master, &sync, 1);
+
+    // RECORDS registros: cada 100 uno no sale (cola llena) y el 1500 llega corrupto
+    int sent = 0;
+    for (int i = 0; i < RECORDS; i++) {
+        if (i % 100 == 50) {
+            continue;
+        }
+        rawstream_rec_t r = {
+            .type = RAWSTREAM_REC_SAMPLE, .channel = (uint8_t)(i & 1 ? RAWSTREAM_CH_ECHO(1) : 4),
+            .seq = (uint16_t)i, .t_us = 1000u * i, .value = i & 1 ? 5800 : 1000 + i,
+        };
+        uint8_t wire[RAWSTREAM_WIRE_MAX];
+        size_t n = rawstream_encode(&r, wire);
+        if (i == 1500) {
+            wire[3] ^= 0x01;
+        }
+        write_all(master, wire, n);
+        sent++;
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    close(keep);
+    close(master);
+
+    // CSV: encabezado + registros válidos, en orden
+    FILE *f = fopen(csv, "r");
+    TEST_ASSERT(f != NULL);
+    char line[128];
+    TEST_ASSERT(fgets(line, sizeof(line), f) != NULL);
+    TEST_ASSERT(strcmp(line, "t_us,channel,seq,value\n") == 0);
+    int rows = 0;
+    unsigned t, ch, seq;
+    int value;
+    unsigned last_seq = 0;
+    bool ordered = true;
+    while (fscanf(f, "%u,%u,%u,%d\n", &t, &ch, &seq, &value) == 4) {
+        if (rows > 0 && seq <= last_seq) {
+            ordered = false;
+        }
+        if (seq == 0) {
+            TEST_ASSERT_EQ(value, 1000);
+            TEST_ASSERT_EQ(ch, 4);
+        }
+        last_seq = seq;
+        rows++;
+    }
+    fclose(f);
+    TEST_ASSERT(ordered);
+    TEST_ASSERT_EQ(rows, sent - 1);
+
+    f = fopen(stats, "r");
+    unsigned frames = 0, dropped = 0, crc = 0, framing = 0, bytes = 0;
+    TEST_ASSERT(f != NULL);
+    TEST_ASSERT_EQ(fscanf(f, "frames=%u dropped=%u crc_errors=%u framing_errors=%u bytes=%u",
+                          &frames, &dropped, &crc, &framing, &bytes), 5);
+    fclose(f);
+    TEST_ASSERT_EQ(frames, sent - 1);
+    TEST_ASSERT_EQ(crc, 1);
+    TEST_ASSERT_EQ(framing, 1);                  // La línea de log
+    TEST_ASSERT_EQ(dropped, RECORDS / 100 + 1);  // Descartados + el corrupto
+    unlink(csv);
+    unlink(stats);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("uso: %s <rawstream_dump>\n", argv[0]);
+        return 2;
+    }
+    s_dump = argv[1];
+    TEST_RUN(test_stream_over_pty);
+    return TEST_EXIT();
+}
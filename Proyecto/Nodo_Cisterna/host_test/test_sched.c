@@ -0,0 +1,135 @@
+#include "sched.h"
+#include "test_unit.h"
+
+static const sched_sensor_cfg_t s_level = {
+    .name = "nivel",
+    .min_period_ms = 500,
+    .max_period_ms = 5000,
+    .fast_rate = 0.5f,
+    .stable_rate = 0.05f,
+};
+
+static const sched_sensor_cfg_t s_tds = {
+    .name = "tds",
+    .min_period_ms = 2000,
+    .max_period_ms = 60000,
+    .fast_rate = 5.0f,
+    .stable_rate = 0.5f,
+};
+
+static void test_first_reading_is_immediate(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 100);
+    int a = sched_add(&s, &s_level, 100);
+    int b = sched_add(&s, &s_tds, 100);
+    TEST_ASSERT_EQ(sched_due(&s, 100), (1u << a) | (1u << b));
+    TEST_ASSERT_EQ(sched_wait_ms(&s, 100), 0);
+}
+
+static void test_stable_signal_backs_off_to_max(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 0);
+    int id = sched_add(&s, &s_level, 0);
+    uint32_t now = 0;
+    for (int i = 0; i < 40; i++) {
+        sched_report(&s, id, 100.0f, true, false, now, 50);
+        now += s.sensors[id].period_ms;
+    }
+    TEST_ASSERT_EQ(s.sensors[id].period_ms, 5000);
+    TEST_ASSERT_EQ(sched_wait_ms(&s, now - 1000), 1000);
+}
+
+static void test_fast_change_and_boost_drop_to_min(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 0);
+    int id = sched_add(&s, &s_level, 0);
+    sched_report(&s, id, 100.0f, true, false, 0, 50);
+    sched_report(&s, id, 100.0f, true, false, 500, 50);
+    sched_report(&s, id, 100.0f, true, false, 1125, 50);
+    TEST_ASSERT(s.sensors[id].period_ms > 500);
+
+    // 10 cm en ~1.5 s supera 0.5 cm/s
+    sched_report(&s, id, 110.0f, true, false, 2600, 50);
+    TEST_ASSERT_EQ(s.sensors[id].period_ms, 500);
+
+    // Estable pero con la bomba encendida: sigue al mínimo
+    sched_report(&s, id, 110.0f, true, false, 3100, 50);
+    TEST_ASSERT(s.sensors[id].period_ms > 500);
+    sched_report(&s, id, 110.0f, true, true, 3725, 50);
+    TEST_ASSERT_EQ(s.sensors[id].period_ms, 500);
+}
+
+static void test_moderate_change_halves_period(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 0);
+    int id = sched_add(&s, &s_tds, 0);
+    uint32_t now = 0;
+    for (int i = 0; i < 10; i++) {
+        sched_report(&s, id, 250.0f, true, false, now, 800);
+        now += s.sensors[id].period_ms;
+    }
+    uint32_t before = s.sensors[id].period_ms;
+    // 1 ppm/s: entre stable (0.5) y fast (5)
+    sched_report(&s, id, 250.0f + before / 1000.0f, true, false, now, 800);
+    TEST_ASSERT_EQ(s.sensors[id].period_ms, before / 2);
+}
+
+static void test_failed_reading_retries_at_min(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 0);
+    int id = sched_add(&s, &s_level, 0);
+    sched_report(&s, id, 100.0f, true, false, 0, 50);
+    sched_report(&s, id, 100.0f, true, false, 500, 50);
+    sched_report(&s, id, -1.0f, false, false, 1125, 50);
+    TEST_ASSERT_EQ(s.sensors[id].period_ms, 500);
+    // La referencia no cambia con la lectura fallida
+    TEST_ASSERT(s.sensors[id].last_value == 100.0f);
+}
+
+static void test_stats_report_savings(void)
+{
+    sched_t s;
+    sched_init(&s, 1000, 0);
+    int id = sched_add(&s, &s_tds, 0);
+    uint32_t now = 0;
+    while (now < 600000) {
+        sched_report(&s, id, 250.0f, true, false, now, 1000);
+        now += s.sensors[id].period_ms;
+    }
+    sched_sensor_stats_t st;
+    sched_get_stats(&s, id, 600000, &st);
+    TEST_ASSERT_EQ(st.baseline_samples, 601);
+    TEST_ASSERT(st.samples < 30);
+    TEST_ASSERT_EQ(st.avg_cost_us, 1000);
+    TEST_ASSERT_EQ(st.saved_cpu_us, (uint64_t)(st.baseline_samples - st.samples) * 1000);
+    TEST_ASSERT(st.rate_mhz > 0 && st.rate_mhz < 100);
+}
+
+static void test_wraparound(void)
+{
+    sched_t s;
+    uint32_t start = UINT32_MAX - 200;
+    sched_init(&s, 1000, start);
+    int id = sched_add(&s, &s_level, start);
+    sched_report(&s, id, 100.0f, true, false, start, 50);
+    TEST_ASSERT_EQ(sched_due(&s, start + 100), 0);
+    TEST_ASSERT_EQ(sched_wait_ms(&s, start + 100), 400);
+    TEST_ASSERT_EQ(sched_due(&s, start + 500), 1u << id);
+}
+
+int main(void)
+{
+    TEST_RUN(test_first_reading_is_immediate);
+    TEST_RUN(test_stable_signal_backs_off_to_max);
+    TEST_RUN(test_fast_change_and_boost_drop_to_min);
+    TEST_RUN(test_moderate_change_halves_period);
+    TEST_RUN(test_failed_reading_retries_at_min);
+    TEST_RUN(test_stats_report_savings);
+    TEST_RUN(test_wraparound);
+    return TEST_EXIT();
+}
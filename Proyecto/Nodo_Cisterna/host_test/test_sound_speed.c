@@ -0,0 +1,88 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "sound_speed.h"
+#include "test_unit.h"
+
+// Semi-velocidad de referencia en µm/µs: c(T) / 2
+static double half_speed_um_per_us(double temp_c)
+{
+    return 331.3 * sqrt(1.0 + temp_c / 273.15) / 2.0;
+}
+
+static void test_factor_matches_formula(void)
+{
+    sound_speed_t ss;
+    for (int dc = SOUND_SPEED_TEMP_MIN_DC; dc <= SOUND_SPEED_TEMP_MAX_DC; dc += 7) {
+        sound_speed_init(&ss, (int16_t)dc);
+        double expected = half_speed_um_per_us(dc / 10.0);
+        double got = ss.um_per_us_q16 / 65536.0;
+        // Interpolación lineal entre grados: error < 0.001 µm/µs (< 0.01 mm a 2 m)
+        TEST_ASSERT(fabs(got - expected) < 0.001);
+    }
+}
+
+static void test_update_only_on_change(void)
+{
+    sound_speed_t ss;
+    sound_speed_init(&ss, 200);
+    uint32_t updates = ss.updates;
+    uint32_t factor = ss.um_per_us_q16;
+    TEST_ASSERT(!sound_speed_set_temp_dc(&ss, 200));
+    TEST_ASSERT_EQ(ss.updates, updates);
+    TEST_ASSERT_EQ(ss.um_per_us_q16, factor);
+
+    TEST_ASSERT(sound_speed_set_temp_dc(&ss, 215));
+    TEST_ASSERT_EQ(ss.updates, updates + 1);
+    TEST_ASSERT(ss.um_per_us_q16 > factor);
+}
+
+static void test_clamps_out_of_range(void)
+{
+    sound_speed_t lo, hi, ss;
+    sound_speed_init(&lo, SOUND_SPEED_TEMP_MIN_DC);
+    sound_speed_init(&hi, SOUND_SPEED_TEMP_MAX_DC);
+    sound_speed_init(&ss, -500);
+    TEST_ASSERT_EQ(ss.um_per_us_q16, lo.um_per_us_q16);
+    sound_speed_set_temp_dc(&ss, 900);
+    TEST_ASSERT_EQ(ss.um_per_us_q16, hi.um_per_us_q16);
+}
+
+static void test_round_trip(void)
+{
+    sound_speed_t ss;
+    sound_speed_init(&ss, 253);
+    for (uint32_t echo = 116; echo <= 23324; echo += 97) {
+        uint32_t um = sound_speed_echo_to_um(&ss, echo);
+        uint32_t back = sound_speed_um_to_echo_us(&ss, um);
+        TEST_ASSERT(abs((int)back - (int)echo) <= 1);
+    }
+}
+
+// Error de la constante fija (0.0343 cm/µs) frente a la compensada a 2 m
+static void test_fixed_constant_error(void)
+{
+    sound_speed_t ss;
+    const uint32_t true_um = 2000000;
+    const int temps_dc[] = { 0, 350 };
+    for (size_t i = 0; i < sizeof(temps_dc) / sizeof(temps_dc[0]); i++) {
+        sound_speed_init(&ss, (int16_t)temps_dc[i]);
+        uint32_t echo = sound_speed_um_to_echo_us(&ss, true_um);
+        double fixed_um = echo * 0.0343 / 2.0 * 10000.0;
+        double comp_um = sound_speed_echo_to_um(&ss, echo);
+        // Compensada: dentro de medio µs de eco (~0.1 mm)
+        TEST_ASSERT(fabs(comp_um - true_um) < 100.0);
+        // Constante fija: varios cm de error en los extremos
+        TEST_ASSERT(fabs(fixed_um - true_um) > 20000.0);
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_factor_matches_formula);
+    TEST_RUN(test_update_only_on_change);
+    TEST_RUN(test_clamps_out_of_range);
+    TEST_RUN(test_round_trip);
+    TEST_RUN(test_fixed_constant_error);
+    return TEST_EXIT();
+}
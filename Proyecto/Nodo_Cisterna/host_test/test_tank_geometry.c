@@ -0,0 +1,122 @@
+#include <math.h>
+
+#include "tank_geometry.h"
+#include "test_unit.h"
+
+#define NEAR(a, b, tol) (fabsf((a) - (b)) <= (tol))
+
+static void test_rect_is_linear(void)
+{
+    const tank_geometry_cfg_t cfg = {
+        .shape = TANK_SHAPE_RECT,
+        .sensor_height_cm = 200.0f,
+        .max_level_cm = 180.0f,
+        .length_cm = 200.0f,
+        .width_cm = 150.0f,
+    };
+    tank_geometry_t tg;
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &cfg), ESP_OK);
+    // 200 × 150 cm = 30 L por cm de altura
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 200.0f), 0.0f, 0.01f));
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 150.0f), 1500.0f, 0.5f));
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 123.4f), 76.6f * 30.0f, 0.5f));
+    TEST_ASSERT(NEAR(tank_geometry_level_cm(&tg, 123.4f), 76.6f, 0.001f));
+}
+
+static void test_saturates_outside_range(void)
+{
+    const tank_geometry_cfg_t cfg = {
+        .shape = TANK_SHAPE_CYLINDER_V,
+        .sensor_height_cm = 150.0f,
+        .max_level_cm = 140.0f,
+        .diameter_cm = 100.0f,
+    };
+    tank_geometry_t tg;
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &cfg), ESP_OK);
+    float full = 3.14159265f * 50.0f * 50.0f * 140.0f / 1000.0f;
+    TEST_ASSERT(NEAR(tank_geometry_capacity_liters(&tg), full, 0.5f));
+    // Agua por encima del rebose (distancia < 10 cm) → capacidad
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 2.0f), full, 0.5f));
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, -5.0f), full, 0.5f));
+    // Más lejos que el fondo → vacío
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 400.0f), 0.0f, 0.01f));
+}
+
+static void test_horizontal_cylinder_matches_exact(void)
+{
+    const tank_geometry_cfg_t cfg = {
+        .shape = TANK_SHAPE_CYLINDER_H,
+        .sensor_height_cm = 130.0f,
+        .max_level_cm = 120.0f,
+        .diameter_cm = 120.0f,
+        .length_cm = 250.0f,
+    };
+    tank_geometry_t tg;
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &cfg), ESP_OK);
+    float r = 60.0f;
+    float worst = 0.0f;
+    for (float h = 0.5f; h < 120.0f; h += 0.7f) {
+        float exact = (r * r * acosf((r - h) / r) - (r - h) * sqrtf(2.0f * r * h - h * h)) * 250.0f / 1000.0f;
+        float err = fabsf(tank_geometry_liters(&tg, 130.0f - h) - exact);
+        if (err > worst) {
+            worst = err;
+        }
+    }
+    // Capacidad ≈ 2827 L; la interpolación de 256 puntos queda bajo 0.1 %
+    TEST_ASSERT(worst < 2.5f);
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 70.0f), 2827.4f / 2.0f, 2.0f));
+}
+
+static void test_strapping_table(void)
+{
+    tank_geometry_cfg_t cfg = {
+        .shape = TANK_SHAPE_TABLE,
+        .sensor_height_cm = 200.0f,
+        .max_level_cm = 180.0f,
+        .table_count = 3,
+        .table_level_cm = {20.0f, 100.0f, 180.0f},
+        .table_liters = {300.0f, 2000.0f, 4500.0f},
+    };
+    tank_geometry_t tg;
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &cfg), ESP_OK);
+    // En el quiebre de pendiente la tabla densa suaviza a lo sumo ~2 L
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 100.0f), 2000.0f, 3.0f));
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 60.0f), 3250.0f, 5.0f));
+    TEST_ASSERT(NEAR(tank_geometry_liters(&tg, 190.0f), 150.0f, 5.0f));
+    TEST_ASSERT(NEAR(tank_geometry_capacity_liters(&tg), 4500.0f, 0.5f));
+}
+
+static void test_invalid_configs_rejected(void)
+{
+    tank_geometry_t tg;
+    tank_geometry_cfg_t cfg = {
+        .shape = TANK_SHAPE_RECT,
+        .sensor_height_cm = 100.0f,
+        .max_level_cm = 150.0f,          // Rebose sobre el sensor
+        .length_cm = 100.0f,
+        .width_cm = 100.0f,
+    };
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &cfg), ESP_ERR_INVALID_ARG);
+
+    tank_geometry_cfg_t table = {
+        .shape = TANK_SHAPE_TABLE,
+        .sensor_height_cm = 200.0f,
+        .max_level_cm = 180.0f,
+        .table_count = 3,
+        .table_level_cm = {20.0f, 10.0f, 180.0f},   // No creciente
+        .table_liters = {300.0f, 2000.0f, 4500.0f},
+    };
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &table), ESP_ERR_INVALID_ARG);
+    table.table_count = 1;
+    TEST_ASSERT_EQ(tank_geometry_build(&tg, &table), ESP_ERR_INVALID_ARG);
+}
+
+int main(void)
+{
+    TEST_RUN(test_rect_is_linear);
+    TEST_RUN(test_saturates_outside_range);
+    TEST_RUN(test_horizontal_cylinder_matches_exact);
+    TEST_RUN(test_strapping_table);
+    TEST_RUN(test_invalid_configs_rejected);
+    return TEST_EXIT();
+}
@@ -0,0 +1,89 @@
+#include <math.h>
+
+#include "tank_history.h"
+#include "test_unit.h"
+
+static tank_history_t s_h;
+
+static void test_empty_tank_has_no_summary(void)
+{
+    tank_history_init(&s_h);
+    tank_history_summary_t sum;
+    TEST_ASSERT(!tank_history_summary(&s_h, 0, 0, &sum));
+    TEST_ASSERT(!tank_history_summary(&s_h, -1, 0, &sum));
+    TEST_ASSERT(!tank_history_summary(&s_h, TANK_HIST_MAX_TANKS, 0, &sum));
+}
+
+static void test_tanks_are_independent(void)
+{
+    tank_history_init(&s_h);
+    for (int i = 0; i < 10; i++) {
+        tank_history_push(&s_h, 0, 1000u * i, 100.0f + i, 250.0f, 90);
+        tank_history_push(&s_h, 2, 1000u * i, 50.0f, -1.0f, 80);
+    }
+    tank_history_summary_t a, c;
+    TEST_ASSERT(tank_history_summary(&s_h, 0, 0, &a));
+    TEST_ASSERT(tank_history_summary(&s_h, 2, 0, &c));
+    TEST_ASSERT_EQ(a.samples, 10);
+    TEST_ASSERT(fabsf(a.level_min_cm - 100.0f) < 1e-4f);
+    TEST_ASSERT(fabsf(a.level_max_cm - 109.0f) < 1e-4f);
+    TEST_ASSERT(fabsf(a.level_mean_cm - 104.5f) < 1e-4f);
+    TEST_ASSERT(fabsf(a.tds_mean_ppm - 250.0f) < 1e-4f);
+    TEST_ASSERT_EQ(a.span_ms, 9000);
+    // Tanque sin sonda TDS
+    TEST_ASSERT(fabsf(c.level_mean_cm - 50.0f) < 1e-4f);
+    TEST_ASSERT(c.tds_mean_ppm < 0.0f);
+    tank_history_summary_t b;
+    TEST_ASSERT(!tank_history_summary(&s_h, 1, 0, &b));
+}
+
+static void test_invalid_levels_are_skipped(void)
+{
+    tank_history_init(&s_h);
+    tank_history_push(&s_h, 1, 0, 80.0f, 300.0f, 100);
+    tank_history_push(&s_h, 1, 500, -1.0f, 320.0f, 0);     // Solo TDS en esta vuelta
+    tank_history_push(&s_h, 1, 1000, 82.0f, -1.0f, 100);   // Solo nivel
+    tank_history_summary_t sum;
+    TEST_ASSERT(tank_history_summary(&s_h, 1, 0, &sum));
+    TEST_ASSERT_EQ(sum.samples, 3);
+    TEST_ASSERT_EQ(sum.level_samples, 2);
+    TEST_ASSERT(fabsf(sum.level_mean_cm - 81.0f) < 1e-4f);
+    TEST_ASSERT(fabsf(sum.tds_mean_ppm - 310.0f) < 1e-4f);
+
+    // Sin ningún nivel válido en la ventana
+    tank_history_push(&s_h, 1, 1500, -1.0f, 330.0f, 0);
+    TEST_ASSERT(tank_history_summary(&s_h, 1, 1, &sum));
+    TEST_ASSERT_EQ(sum.level_samples, 0);
+    TEST_ASSERT(sum.level_mean_cm < 0.0f);
+}
+
+static void test_ring_wraps_and_window(void)
+{
+    tank_history_init(&s_h);
+    int total = TANK_HIST_LEN + 15;
+    for (int i = 0; i < total; i++) {
+        tank_history_push(&s_h, 3, 100u * i, (float)i, -1.0f, 100);
+    }
+    tank_history_summary_t sum;
+    TEST_ASSERT(tank_history_summary(&s_h, 3, 0, &sum));
+    TEST_ASSERT_EQ(sum.samples, TANK_HIST_LEN);
+    TEST_ASSERT(fabsf(sum.level_min_cm - (float)(total - TANK_HIST_LEN)) < 1e-4f);
+    TEST_ASSERT(fabsf(sum.level_max_cm - (float)(total - 1)) < 1e-4f);
+    TEST_ASSERT_EQ(sum.span_ms, 100u * (TANK_HIST_LEN - 1));
+
+    // Ventana de las últimas 5 muestras, cruzando el borde del anillo
+    TEST_ASSERT(tank_history_summary(&s_h, 3, 5, &sum));
+    TEST_ASSERT_EQ(sum.samples, 5);
+    TEST_ASSERT(fabsf(sum.level_min_cm - (float)(total - 5)) < 1e-4f);
+    TEST_ASSERT(fabsf(sum.level_mean_cm - (float)(total - 3)) < 1e-4f);
+    TEST_ASSERT_EQ(sum.span_ms, 400);
+}
+
+int main(void)
+{
+    TEST_RUN(test_empty_tank_has_no_summary);
+    TEST_RUN(test_tanks_are_independent);
+    TEST_RUN(test_invalid_levels_are_skipped);
+    TEST_RUN(test_ring_wraps_and_window);
+    return TEST_EXIT();
+}
@@ -0,0 +1,115 @@
+#include <math.h>
+
+#include "tds.h"
+#include "storage.h"
+#include "fake_adc.h"
+#include "fake_nvs.h"
+#include "nvs.h"
+#include "test_unit.h"
+
+#define NEAR(a, b, tol) (fabsf((a) - (b)) <= (tol))
+
+static void reset_calibration(void)
+{
+    // A = 0 y B = 1 equivalen a offset 0, gain 1
+    tds_set_calibration_point_A(0.0f);
+    tds_set_calibration_point_B(1.0f);
+}
+
+static void test_default_calibration(void)
+{
+    fake_nvs_reset();
+    tds_init();                             // NVS vacía: offset 0, gain 1
+    TEST_ASSERT(NEAR(tds_get_offset(), 0.0f, 1e-6f));
+    TEST_ASSERT(NEAR(tds_get_gain(), 1.0f, 1e-6f));
+    TEST_ASSERT(NEAR(tds_raw_to_ppm(0.25f), 250.0f, 1e-3f));
+}
+
+static void test_two_point_calibration(void)
+{
+    tds_set_calibration_point_A(1000.0f);
+    tds_set_calibration_point_B(1500.0f);
+    TEST_ASSERT(NEAR(tds_get_offset(), 1000.0f, 1e-3f));
+    TEST_ASSERT(NEAR(tds_get_gain(), 1.0f / 500.0f, 1e-9f));
+    TEST_ASSERT(NEAR(tds_raw_to_ppm(1000.0f), 0.0f, 1e-3f));
+    TEST_ASSERT(NEAR(tds_raw_to_ppm(1250.0f), 500.0f, 1e-2f));
+    TEST_ASSERT(NEAR(tds_raw_to_ppm(1500.0f), 1000.0f, 1e-2f));
+
+    // B igual a A daría ganancia infinita: se ignora y queda la anterior
+    tds_set_calibration_point_B(1000.0f);
+    TEST_ASSERT(NEAR(tds_get_gain(), 1.0f / 500.0f, 1e-9f));
+    reset_calibration();
+}
+
+static void test_save_and_load(void)
+{
+    fake_nvs_reset();
+    tds_set_calibration_point_A(812.5f);
+    tds_set_calibration_point_B(2140.0f);
+    float gain = tds_get_gain();
+    TEST_ASSERT_EQ(tds_save_calibration(), ESP_OK);
+    TEST_ASSERT_EQ(fake_nvs_commits(), 2);  // offset y gain
+
+    reset_calibration();
+    TEST_ASSERT_EQ(tds_load_calibration(), ESP_OK);
+    TEST_ASSERT(tds_get_offset() == 812.5f);  // Bits del float tal cual
+    TEST_ASSERT(tds_get_gain() == gain);
+
+    // Escritura fallida: se informa y la NVS no cambia
+    fake_nvs_fail_writes(ESP_ERR_NVS_NOT_ENOUGH_SPACE);
+    tds_set_calibration_point_A(1.0f);
+    TEST_ASSERT_EQ(tds_save_calibration(), ESP_ERR_NVS_NOT_ENOUGH_SPACE);
+    fake_nvs_fail_writes(ESP_OK);
+    TEST_ASSERT_EQ(tds_load_calibration(), ESP_OK);
+    TEST_ASSERT(tds_get_offset() == 812.5f);
+
+    // Sin claves guardadas la calibración en RAM se conserva
+    fake_nvs_reset();
+    TEST_ASSERT(tds_load_calibration() != ESP_OK);
+    TEST_ASSERT(tds_get_offset() == 812.5f);
+    reset_calibration();
+}
+
+static void test_read_prefers_scan(void)
+{
+    reset_calibration();
+    // Valor del escaneo en LSB · 2^TDS_ADC_EXTRA_BITS: 1834.25 LSB
+    fake_adc_set_direct(0, 0, ESP_OK);
+    fake_adc_set_scan(2, 1834 * 4 + 1, 16);
+    tds_reading_t rd;
+    TEST_ASSERT_EQ(tds_read_channel(2, &rd), ESP_OK);
+    TEST_ASSERT(NEAR(rd.raw, 1834.25f, 1e-4f));
+    TEST_ASSERT_EQ(rd.samples, 16);
+    TEST_ASSERT(NEAR(rd.ppm, 1834250.0f, 1.0f));
+    TEST_ASSERT_EQ(fake_adc_direct_reads(), 0);
+    fake_adc_set_scan(2, -1, 0);
+}
+
+static void test_read_direct_fallback(void)
+{
+    reset_calibration();
+    fake_adc_set_direct(2000 * 4 + 2, 12, ESP_OK);
+    tds_reading_t rd;
+    TEST_ASSERT_EQ(tds_read_channel(3, &rd), ESP_OK);
+    TEST_ASSERT(NEAR(rd.raw, 2000.5f, 1e-4f));
+    TEST_ASSERT_EQ(rd.samples, 12);
+    TEST_ASSERT_EQ(fake_adc_direct_reads(), 1);
+    TEST_ASSERT(NEAR(tds_read_raw(), 2000.5f, 1e-4f));
+
+    // Error del ADC: se propaga con raw 0 (el sensor lo marca inválido)
+    fake_adc_set_direct(0, 0, ESP_ERR_TIMEOUT);
+    TEST_ASSERT_EQ(tds_read_channel(3, &rd), ESP_ERR_TIMEOUT);
+    TEST_ASSERT(rd.raw == 0.0f);
+    TEST_ASSERT_EQ(rd.samples, 0);
+    TEST_ASSERT_EQ(tds_read_channel(3, NULL), ESP_ERR_INVALID_ARG);
+}
+
+int main(void)
+{
+    TEST_RUN(test_default_calibration);
+    TEST_RUN(test_two_point_calibration);
+    TEST_RUN(test_save_and_load);
+    TEST_RUN(test_read_prefers_scan);
+    TEST_RUN(test_read_direct_fallback);
+    return TEST_EXIT();
+}
@@ -0,0 +1,127 @@
+#include <math.h>
+
+#include "tds_settle.h"
+#include "test_unit.h"
+
+static const tds_settle_cfg_t CFG = {
+    .window = 20, .hold = 4, .max_slope = 0.5f, .max_sigma = 3.0f,
+};
+
+/** Ruido determinista de ±amp (alterna el signo) */
+static float wiggle(int i, float amp)
+{
+    return (i & 1) ? amp : -amp;
+}
+
+static void test_cfg_valid(void)
+{
+    tds_settle_t s;
+    TEST_ASSERT(tds_settle_init(&s, &CFG));
+    tds_settle_cfg_t c = CFG;
+    c.window = 2;
+    TEST_ASSERT(!tds_settle_init(&s, &c));
+    c.window = TDS_SETTLE_MAX_WINDOW + 1;
+    TEST_ASSERT(!tds_settle_init(&s, &c));
+    c = CFG;
+    c.hold = 0;
+    TEST_ASSERT(!tds_settle_init(&s, &c));
+    c = CFG;
+    c.max_sigma = 0.0f;
+    TEST_ASSERT(!tds_settle_init(&s, &c));
+}
+
+static void test_stable_probe_captures_after_hold(void)
+{
+    tds_settle_t s;
+    tds_settle_stats_t st;
+    tds_settle_init(&s, &CFG);
+    int captured_at = -1;
+    for (int i = 0; i < 40 && captured_at < 0; i++) {
+        if (tds_settle_push(&s, i * 0.25f, 1200.0f + wiggle(i, 1.0f), &st)) {
+            captured_at = i;
+        }
+        if (i < CFG.window - 1) {
+            TEST_ASSERT(!st.settled);
+            TEST_ASSERT(st.progress < 50);
+        }
+    }
+    // Ventana llena en la lectura 20, luego 4 ventanas estables
+    TEST_ASSERT_EQ(captured_at, CFG.window - 1 + CFG.hold - 1);
+    TEST_ASSERT_EQ(st.progress, 100);
+    TEST_ASSERT(fabsf(st.mean - 1200.0f) < 0.2f);
+    TEST_ASSERT(fabsf(st.slope) < 0.1f);
+    TEST_ASSERT(st.sigma > 0.9f && st.sigma < 1.2f);
+    // σ/√n ≈ 0.23 más la deriva residual
+    TEST_ASSERT(st.uncertainty > 0.2f && st.uncertainty < 0.4f);
+}
+
+static void test_drifting_probe_waits(void)
+{
+    // Sonda que se asienta: exponencial hacia 1500 con τ = 4 s
+    tds_settle_t s;
+    tds_settle_stats_t st;
+    tds_settle_init(&s, &CFG);
+    int captured_at = -1;
+    for (int i = 0; i < 400 && captured_at < 0; i++) {
+        float t = i * 0.25f;
+        float x = 1500.0f - 300.0f * expf(-t / 4.0f) + wiggle(i, 0.5f);
+        if (tds_settle_push(&s, t, x, &st)) {
+            captured_at = i;
+        }
+        if (i == CFG.window) {
+            // Ventana llena pero con deriva fuerte: no estable, progreso < 50%
+            TEST_ASSERT(!st.settled);
+            TEST_ASSERT(st.slope > CFG.max_slope);
+            TEST_ASSERT(st.progress < 50);
+        }
+    }
+    TEST_ASSERT(captured_at > CFG.window + CFG.hold);
+    TEST_ASSERT(fabsf(st.slope) <= CFG.max_slope);
+    // La captura queda cerca del valor final y la incertidumbre lo cubre con holgura
+    TEST_ASSERT(fabsf(st.mean - 1500.0f) < 3.0f);
+    TEST_ASSERT(st.uncertainty > 0.1f);
+}
+
+static void test_noisy_probe_never_settles(void)
+{
+    tds_settle_t s;
+    tds_settle_stats_t st;
+    tds_settle_init(&s, &CFG);
+    bool captured = false;
+    for (int i = 0; i < 200; i++) {
+        captured |= tds_settle_push(&s, i * 0.25f, 900.0f + wiggle(i, 5.0f), &st);
+    }
+    TEST_ASSERT(!captured);
+    TEST_ASSERT(st.sigma > CFG.max_sigma);
+    TEST_ASSERT(fabsf(st.slope) < CFG.max_slope);     // El ruido no se confunde con deriva
+    TEST_ASSERT(st.progress >= 25 && st.progress < 50);
+}
+
+static void test_disturbance_restarts_hold(void)
+{
+    tds_settle_t s;
+    tds_settle_stats_t st;
+    tds_settle_init(&s, &CFG);
+    int i = 0;
+    for (; i < CFG.window + 1; i++) {
+        TEST_ASSERT(!tds_settle_push(&s, i * 0.25f, 700.0f, &st));
+    }
+    TEST_ASSERT(st.settled);
+    // Un golpe a la sonda rompe la racha aunque faltaba una sola lectura
+    TEST_ASSERT(!tds_settle_push(&s, i * 0.25f, 760.0f, &st));
+    i++;
+    TEST_ASSERT(!st.settled);
+    tds_settle_reset(&s);
+    TEST_ASSERT(!tds_settle_push(&s, i * 0.25f, 700.0f, &st));
+    TEST_ASSERT_EQ(st.count, 1);
+}
+
+int main(void)
+{
+    TEST_RUN(test_cfg_valid);
+    TEST_RUN(test_stable_probe_captures_after_hold);
+    TEST_RUN(test_drifting_probe_waits);
+    TEST_RUN(test_noisy_probe_never_settles);
+    TEST_RUN(test_disturbance_restarts_hold);
+    return TEST_EXIT();
+}
@@ -0,0 +1,153 @@
+#include <stdlib.h>
+
+#include "ultrasonic.h"
+#include "ultrasonic_sim.h"
+#include "test_unit.h"
+
+static ultrasonic_handle_t make(int trig, int echo)
+{
+    ultrasonic_config_t cfg = ULTRASONIC_CONFIG_DEFAULT(trig, echo);
+    ultrasonic_handle_t h = NULL;
+    TEST_ASSERT_EQ(ultrasonic_create(&cfg, &h), ESP_OK);
+    return h;
+}
+
+static void test_blocking_measure(void)
+{
+    ultrasonic_handle_t h = make(2, 3);
+    ultrasonic_sim_set_distance_um(h, 1500000);   // 150 cm
+
+    ultrasonic_reading_t r;
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &r), ESP_OK);
+    TEST_ASSERT(abs((int)r.distance_um - 1500000) < 200);
+    TEST_ASSERT_EQ(r.end_us - r.trigger_us, ULTRASONIC_SIM_RISE_DELAY_US + r.echo_us);
+
+    // La segunda medición espera la guarda sola
+    int64_t first_end = r.end_us;
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &r), ESP_OK);
+    TEST_ASSERT(r.trigger_us >= first_end + ULTRASONIC_GUARD_US);
+
+    ultrasonic_stats_t st;
+    ultrasonic_get_stats(h, &st);
+    TEST_ASSERT_EQ(st.pings, 2);
+    TEST_ASSERT_EQ(st.echoes, 2);
+    TEST_ASSERT_EQ(st.latency_avg_us, ULTRASONIC_SIM_RISE_DELAY_US + r.echo_us);
+    TEST_ASSERT_EQ(ultrasonic_delete(h), ESP_OK);
+}
+
+static void test_non_blocking_poll(void)
+{
+    ultrasonic_handle_t h = make(2, 3);
+    ultrasonic_sim_set_echo_us(h, 5000);
+
+    ultrasonic_reading_t r;
+    TEST_ASSERT_EQ(ultrasonic_poll(h, &r), ESP_ERR_INVALID_STATE);
+    TEST_ASSERT_EQ(ultrasonic_trigger(h), ESP_OK);
+    TEST_ASSERT_EQ(ultrasonic_trigger(h), ESP_ERR_INVALID_STATE);
+    TEST_ASSERT_EQ(ultrasonic_poll(h, &r), ESP_ERR_NOT_FINISHED);
+
+    // El llamador hace otro trabajo mientras el eco está en vuelo
+    ultrasonic_sim_advance_us(3000);
+    TEST_ASSERT_EQ(ultrasonic_poll(h, &r), ESP_ERR_NOT_FINISHED);
+    ultrasonic_sim_advance_us(3000);
+    TEST_ASSERT_EQ(ultrasonic_poll(h, &r), ESP_OK);
+    TEST_ASSERT_EQ(r.echo_us, 5000);
+
+    // Dentro de la guarda no se puede volver a disparar
+    TEST_ASSERT(ultrasonic_guard_remaining_us(h) > 0);
+    TEST_ASSERT_EQ(ultrasonic_trigger(h), ESP_ERR_INVALID_STATE);
+    ultrasonic_sim_advance_us(ULTRASONIC_GUARD_US);
+    TEST_ASSERT_EQ(ultrasonic_guard_remaining_us(h), 0);
+    TEST_ASSERT_EQ(ultrasonic_trigger(h), ESP_OK);
+    TEST_ASSERT_EQ(ultrasonic_wait(h, &r), ESP_OK);
+
+    ultrasonic_stats_t st;
+    ultrasonic_get_stats(h, &st);
+    TEST_ASSERT_EQ(st.busy_rejects, 2);
+    ultrasonic_delete(h);
+}
+
+static void test_timeouts(void)
+{
+    ultrasonic_handle_t h = make(2, 3);
+    ultrasonic_reading_t r;
+
+    ultrasonic_sim_set_echo_us(h, 0);             // Sensor desconectado
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &r), ESP_ERR_TIMEOUT);
+    TEST_ASSERT(!r.rise_seen);
+    TEST_ASSERT_EQ(r.end_us - r.trigger_us, ULTRASONIC_RISE_TIMEOUT_US);
+
+    ultrasonic_sim_set_echo_us(h, ULTRASONIC_ECHO_TIMEOUT_US + 5000);   // Sin objeto
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &r), ESP_ERR_TIMEOUT);
+    TEST_ASSERT(r.rise_seen);
+    TEST_ASSERT_EQ(r.echo_us, 0);
+
+    ultrasonic_stats_t st;
+    ultrasonic_get_stats(h, &st);
+    TEST_ASSERT_EQ(st.pings, 2);
+    TEST_ASSERT_EQ(st.echoes, 0);
+    TEST_ASSERT_EQ(st.rise_timeouts, 1);
+    TEST_ASSERT_EQ(st.echo_timeouts, 1);
+    TEST_ASSERT_EQ(st.latency_avg_us, 0);
+    ultrasonic_delete(h);
+}
+
+static void test_instances(void)
+{
+    ultrasonic_handle_t h[ULTRASONIC_MAX_INSTANCES];
+    for (int i = 0; i < ULTRASONIC_MAX_INSTANCES; i++) {
+        h[i] = make(10 + 2 * i, 11 + 2 * i);
+        ultrasonic_sim_set_distance_um(h[i], 500000 + 100000 * i);
+    }
+
+    ultrasonic_config_t cfg = ULTRASONIC_CONFIG_DEFAULT(40, 41);
+    ultrasonic_handle_t extra;
+    TEST_ASSERT_EQ(ultrasonic_create(&cfg, &extra), ESP_ERR_NO_MEM);
+
+    // Cada instancia mide su propio eco y lleva sus propias estadísticas
+    for (int i = 0; i < ULTRASONIC_MAX_INSTANCES; i++) {
+        ultrasonic_reading_t r;
+        TEST_ASSERT_EQ(ultrasonic_measure(h[i], &r), ESP_OK);
+        TEST_ASSERT(abs((int)r.distance_um - (500000 + 100000 * i)) < 200);
+    }
+    ultrasonic_stats_t st;
+    ultrasonic_get_stats(h[1], &st);
+    TEST_ASSERT_EQ(st.pings, 1);
+
+    // Un pin ya asignado se rechaza; al liberar la ranura se puede reutilizar
+    ultrasonic_delete(h[0]);
+    cfg = (ultrasonic_config_t)ULTRASONIC_CONFIG_DEFAULT(12, 50);
+    TEST_ASSERT_EQ(ultrasonic_create(&cfg, &extra), ESP_ERR_INVALID_STATE);
+    cfg = (ultrasonic_config_t)ULTRASONIC_CONFIG_DEFAULT(10, 11);
+    TEST_ASSERT_EQ(ultrasonic_create(&cfg, &extra), ESP_OK);
+    ultrasonic_delete(extra);
+    for (int i = 1; i < ULTRASONIC_MAX_INSTANCES; i++) {
+        ultrasonic_delete(h[i]);
+    }
+}
+
+static void test_temperature(void)
+{
+    ultrasonic_handle_t h = make(2, 3);
+    ultrasonic_sim_set_echo_us(h, 11655);          // ~2 m a 20 °C
+    ultrasonic_reading_t cold, warm;
+    ultrasonic_set_temp_dc(h, 0);
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &cold), ESP_OK);
+    TEST_ASSERT(ultrasonic_set_temp_dc(h, 350));
+    TEST_ASSERT(!ultrasonic_set_temp_dc(h, 350));
+    TEST_ASSERT_EQ(ultrasonic_measure(h, &warm), ESP_OK);
+    // Mismo eco, aire más caliente → más distancia (~2 % a 2 m)
+    TEST_ASSERT(warm.distance_um > cold.distance_um + 100000);
+    TEST_ASSERT_EQ(ultrasonic_echo_to_um(h, warm.echo_us), warm.distance_um);
+    ultrasonic_delete(h);
+}
+
+int main(void)
+{
+    TEST_RUN(test_blocking_measure);
+    TEST_RUN(test_non_blocking_poll);
+    TEST_RUN(test_timeouts);
+    TEST_RUN(test_instances);
+    TEST_RUN(test_temperature);
+    return TEST_EXIT();
+}
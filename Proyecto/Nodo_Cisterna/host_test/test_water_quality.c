@@ -0,0 +1,30 @@
+#include <math.h>
+
+#include "sensor.h"
+#include "test_unit.h"
+
+static void test_thresholds(void)
+{
+    TEST_ASSERT_EQ(sensor_classify_water_quality(0.0f), WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(299.99f), WATER_STATE_CLEAN);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(300.0f), WATER_STATE_MEDIUM);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(600.0f), WATER_STATE_MEDIUM);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(600.01f), WATER_STATE_DIRTY);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(5000.0f), WATER_STATE_DIRTY);
+}
+
+static void test_invalid_values(void)
+{
+    // -1 es "lectura inválida" en sensor_data_t: cae en limpia
+    TEST_ASSERT_EQ(sensor_classify_water_quality(-1.0f), WATER_STATE_CLEAN);
+    // Un NaN no pasa ninguna comparación: sucia, la bomba se apaga
+    TEST_ASSERT_EQ(sensor_classify_water_quality(NAN), WATER_STATE_DIRTY);
+    TEST_ASSERT_EQ(sensor_classify_water_quality(INFINITY), WATER_STATE_DIRTY);
+}
+
+int main(void)
+{
+    TEST_RUN(test_thresholds);
+    TEST_RUN(test_invalid_values);
+    return TEST_EXIT();
+}
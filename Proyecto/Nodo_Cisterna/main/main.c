@@ -1,396 +1,1137 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <inttypes.h>
-#include "driver/gpio.h"
-#include "esp_log.h"
-#include "esp_system.h"
-#include "nvs_flash.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "freertos/semphr.h"
-
-#include "esp_console.h"
-#include "linenoise/linenoise.h"
-#include "esp_vfs_dev.h"
-#include "driver/uart.h"
-#include <strings.h>
-
-// Componentes locales
-#include "wifi.h"
-#include "mqtt.h"
-
-#include "sensor.h"
-#include "tasks.h"
-
-#define WIFI_SSID       "RPi-Hotspot"        // Cambiar por el SSID de tu red Wi-Fi RPi-Hotspot
-#define WIFI_PASSWORD   "12345678"    // Cambiar por la contraseña de tu red Wi-Fi
-#define MQTT_BROKER_URI "mqtt://10.42.0.111:1883"  // Cambiar según broker 10.162.31.132  10.42.0.1     10.42.0.111
-static const char *TAG = "CISTERNA_MAIN";
-
-// Variables globales para configuración
-static void *mqtt_client = NULL;
-static bool pump_manual_override = false;
-
-/**
- * @brief Callback para eventos MQTT
- * 
- * Maneja eventos de conexión, desconexión, suscripción y recepción de mensajes.
- * Particularmente, procesa comandos de control de bomba desde el topic "cistern_control"
- * 
- * Tópicos esperados:
- * - Recibir: cistern_control → mensajes "ON"/"OFF"/"AUTO" para control de bomba
- */
-static void mqtt_event_handler(void *handler_args, esp_event_base_t base, 
-                               int32_t event_id, void *event_data)
-{
-    esp_mqtt_event_handle_t event = (esp_mqtt_event_handle_t)event_data;
-    
-    if (event_id == MQTT_EVENT_DATA) {
-        // Procesar mensajes recibidos
-        if (strncmp(event->topic, "cistern_control", event->topic_len) == 0) {
-            // Procesar comando de control de bomba
-            char payload[32] = {0};
-            int len = (event->data_len < (int)sizeof(payload) - 1) ? event->data_len : (int)sizeof(payload) - 1;
-            strncpy(payload, event->data, len);
-            payload[len] = '\0';
-            
-            ESP_LOGI(TAG, "-> Comando de bomba recibido: '%s'", payload);
-            
-            // Procesar comandos desde Node-RED
-            if (strcasecmp(payload, "ON") == 0) {
-                tasks_set_pump_relay(true);
-                pump_manual_override = true;
-                ESP_LOGI(TAG, "OK Bomba encendida (desde Node-RED)");
-            } else if (strcasecmp(payload, "OFF") == 0) {
-                tasks_set_pump_relay(false);
-                pump_manual_override = true;
-                ESP_LOGI(TAG, "OK Bomba apagada (desde Node-RED)");
-            } else if (strcasecmp(payload, "AUTO") == 0) {
-                pump_manual_override = false;
-                ESP_LOGI(TAG, "OK Control automatico de bomba activado");
-            }
-        }
-    }
-}
-
-/**
- * @brief Tarea FreeRTOS para lectura de sensores y publicación de datos
- * 
- * Esta tarea:
- * 1. Lee los sensores (nivel de agua y TDS) cada 1 segundo
- * 2. Clasifica la calidad del agua
- * 3. Implementa lógica automática de control de bomba
- * 4. Publica los datos en formato JSON al broker MQTT
- * 
- * Reglas de control automático de bomba:
- * - Si nivel bajo Y agua aceptable (≤600 ppm) → encender
- * - Si nivel alto O agua sucia (>600 ppm) → apagar
- */
-static void sensor_read_and_publish_task(void *pvParameters)
-{
-    ESP_LOGI(TAG, "→ Iniciando tarea de lectura y publicación de sensores");
-    
-    const uint32_t publish_interval = 1000;  // 1 segundo
-    sensor_data_t sensor_data;
-    const size_t json_buf_sz = 512;
-    char *json_payload = (char *) malloc(json_buf_sz);
-    if (json_payload == NULL) {
-        ESP_LOGE(TAG, "✗ No memory for JSON buffer");
-        vTaskDelete(NULL);
-        return;
-    }
-    
-    while (1) {
-        // Leer datos de sensores de forma segura (con semáforo)
-        esp_err_t err = tasks_read_sensor_data(&sensor_data, pdMS_TO_TICKS(500));
-        
-        if (err == ESP_OK) {
-            // Lógica de control automático de bomba
-            if (!pump_manual_override) {
-                // Umbral de nivel bajo: 20cm, nivel alto: 180cm
-                bool level_low = (sensor_data.water_level < 20.0f);
-                bool level_high = (sensor_data.water_level > 180.0f);
-                bool water_acceptable = (sensor_data.water_state != WATER_STATE_DIRTY);
-                
-                if (level_low && water_acceptable) {
-                    // Encender bomba: nivel bajo y agua aceptable
-                    tasks_set_pump_relay(true);
-                } else if (level_high || !water_acceptable) {
-                    // Apagar bomba: nivel alto o agua sucia
-                    tasks_set_pump_relay(false);
-                }
-            }
-            
-            // Preparar datos de sensores
-            const char *water_state_str[] = {"LIMPIA", "MEDIA", "SUCIA"};
-            const char *pump_state_str = tasks_get_pump_relay_state() ? "ON" : "OFF";
-            
-            // Publicar en topicos separados si MQTT esta conectado
-            if (mqtt_is_connected(mqtt_client)) {
-                // 1. Publicar nivel de agua (en cm)
-                snprintf(json_payload, json_buf_sz, "%.2f", sensor_data.water_level);
-                mqtt_publish(mqtt_client, "cistern/water_level", json_payload, strlen(json_payload), 1);
-                
-                // 2. Publicar TDS (en ppm)
-                snprintf(json_payload, json_buf_sz, "%.1f", sensor_data.tds_value);
-                mqtt_publish(mqtt_client, "cistern/tds_value", json_payload, strlen(json_payload), 1);
-                
-                // 3. Publicar estado del agua (LIMPIA/MEDIA/SUCIA)
-                snprintf(json_payload, json_buf_sz, "%s", water_state_str[sensor_data.water_state]);
-                mqtt_publish(mqtt_client, "cistern/water_state", json_payload, strlen(json_payload), 1);
-                
-                // 4. Publicar estado de la bomba (ON/OFF)
-                snprintf(json_payload, json_buf_sz, "%s", pump_state_str);
-                mqtt_publish(mqtt_client, "cistern/pump_state", json_payload, strlen(json_payload), 1);
-                
-                ESP_LOGD(TAG, "-> Datos publicados en topicos MQTT");
-            } else {
-                ESP_LOGW(TAG, "X MQTT desconectado, datos no publicados");
-            }
-            
-            // Log de información
-            ESP_LOGI(TAG, "Lectura #%" PRIu32 " | Nivel: %.2f cm | TDS: %.1f ppm (%s) | Bomba: %s",
-                     sensor_data.timestamp,
-                     sensor_data.water_level,
-                     sensor_data.tds_value,
-                     water_state_str[sensor_data.water_state],
-                     pump_state_str);
-        } else {
-            ESP_LOGE(TAG, "✗ Error al leer sensores: %s", esp_err_to_name(err));
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(publish_interval));
-    }
-}
-
-/**
- * @brief Inicialización de NVS Flash
- * 
- * El almacenamiento NVS es necesario para que funcionen correctamente
- * algunos componentes como Wi-Fi y MQTT
- */
-static void nvs_init(void)
-{
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        // Si NVS está lleno o es versión antigua, borrarlo
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
-    }
-    ESP_ERROR_CHECK(ret);
-}
-
-// Console REPL task (defined as a proper C function instead of a C++ lambda)
-static void console_repl_task(void *arg)
-{
-    (void)arg;
-    ESP_LOGI(TAG, "→ Console REPL task starting");
-    /* Initialize console but avoid heavy linenoise features that consume significant stack.
-       Use VFS UART driver and a small heap-allocated input buffer read via fgets(). */
-    esp_console_config_t cfg = ESP_CONSOLE_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK( esp_console_init(&cfg) );
-    esp_console_register_help_command();
-
-    /* Enable VFS for the UART used by the console */
-    esp_vfs_dev_uart_use_driver(CONFIG_CONSOLE_UART_NUM);
-    /* Disable stdio buffering for immediate echo/read */
-    setvbuf(stdin, NULL, _IONBF, 0);
-
-    const size_t line_sz = 256;
-    char *line = (char *) calloc(1, line_sz);
-    if (line == NULL) {
-        ESP_LOGE(TAG, "✗ No se pudo reservar memoria para la consola");
-        vTaskDelete(NULL);
-        return;
-    }
-
-    const char *prompt = "cisterna> ";
-    while (true) {
-        // Print prompt and read a line using fgets which allocates input on the heap
-        fputs(prompt, stdout);
-        fflush(stdout);
-        if (fgets(line, line_sz, stdin) == NULL) {
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
-
-        // Strip newline
-        size_t len = strlen(line);
-        if (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
-            line[len-1] = '\0';
-            if (len > 1 && line[len-2] == '\r') line[len-2] = '\0';
-        }
-
-        if (strlen(line) > 0) {
-            int ret;
-            esp_console_run(line, &ret);
-        }
-    }
-    free(line);
-}
-
-// Minimal UART command parser task. Reads lines from UART0 and calls sensor handlers.
-static void uart_command_task(void *arg)
-{
-    (void)arg;
-    ESP_LOGI(TAG, "→ UART command task starting");
-    uart_config_t uart_config = {
-        .baud_rate = 115200,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
-    };
-    uart_param_config(UART_NUM_0, &uart_config);
-    // RX buffer 256, no TX buffer
-    uart_driver_install(UART_NUM_0, 256, 0, 0, NULL, 0);
-
-    char line[128];
-    int idx = 0;
-    while (1) {
-        uint8_t ch;
-        int len = uart_read_bytes(UART_NUM_0, &ch, 1, pdMS_TO_TICKS(100));
-        if (len > 0) {
-            if (ch == '\r' || ch == '\n') {
-                if (idx > 0) {
-                    line[idx] = '\0';
-                    ESP_LOGI(TAG, "UART CMD received: %s", line);
-                    if (strcasecmp(line, "calA") == 0) {
-                        sensor_do_calA();
-                    } else if (strcasecmp(line, "calB") == 0) {
-                        sensor_do_calB();
-                    } else if (strcasecmp(line, "save") == 0) {
-                        sensor_do_save();
-                    } else if (strcasecmp(line, "show") == 0) {
-                        sensor_do_show();
-                    } else {
-                        ESP_LOGI(TAG, "Unknown command: %s", line);
-                    }
-                    idx = 0;
-                }
-            } else {
-                if (idx < (int)sizeof(line) - 1) {
-                    line[idx++] = (char)ch;
-                }
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
-}
-
-/**
- * @brief Función principal de la aplicación
- * 
- * Inicializa todos los subsistemas:
- * 1. NVS Flash
- * 2. Wi-Fi
- * 3. MQTT
- * 4. Sensores y tareas FreeRTOS
- */
-void app_main(void)
-{
-    ESP_LOGI(TAG, "\n\n=== NODO DE CONTROL DE CISTERNA ===");
-    ESP_LOGI(TAG, "ESP32-C6 | Sistema de monitoreo y control de cisterna");
-    ESP_LOGI(TAG, "Sensores: Ultrasónico + TDS | Control: Relé HW-307");
-    ESP_LOGI(TAG, "===================================\n");
-
-    // ========== INICIALIZACIÓN DE COMPONENTES ==========
-    
-    // 1. Inicializar NVS
-    ESP_LOGI(TAG, "→ Inicializando NVS Flash...");
-    nvs_init();
-    
-    // 2. Inicializar Wi-Fi
-    ESP_LOGI(TAG, "→ Inicializando Wi-Fi...");
-    // Configurar con credenciales (cambiar según red local)
-    esp_err_t wifi_err = wifi_init(WIFI_SSID, WIFI_PASSWORD);
-    if (wifi_err != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al inicializar Wi-Fi: %s", esp_err_to_name(wifi_err));
-        // Continuar de todas formas para permitir debugging
-    }
-    
-    // Esperar a que se conecte a Wi-Fi (máximo 10 segundos)
-    uint32_t wifi_timeout = 10000;
-    uint32_t start_time = esp_log_timestamp();
-    while (!wifi_is_connected() && (esp_log_timestamp() - start_time) < wifi_timeout) {
-        vTaskDelay(pdMS_TO_TICKS(100));
-    }
-    
-    if (wifi_is_connected()) {
-        ESP_LOGI(TAG, "✓ Conectado a Wi-Fi");
-    } else {
-        ESP_LOGW(TAG, "✗ No se pudo conectar a Wi-Fi en 10 segundos");
-    }
-    
-    // 3. Inicializar MQTT
-    ESP_LOGI(TAG, "→ Inicializando MQTT...");
-    mqtt_config_t mqtt_cfg = {
-        .broker_uri = MQTT_BROKER_URI,
-        .client_id = "esp32c6_cisterna",
-        .username = "",  // Opcional
-        .password = ""   // Opcional
-    };
-    
-    mqtt_client = mqtt_init(&mqtt_cfg, mqtt_event_handler);
-    if (mqtt_client == NULL) {
-        ESP_LOGE(TAG, "✗ Error al inicializar cliente MQTT");
-        // Continuar para permitir operación offline
-    } else {
-        mqtt_connect(mqtt_client);
-        // Suscribirse al topico de control de bomba (sera procesado en mqtt_event_handler)
-        mqtt_subscribe(mqtt_client, "cistern_control", 1);
-        ESP_LOGI(TAG, "-> Suscrito a topico 'cistern_control' para recibir comandos desde Node-RED");
-    }
-    
-    // 4. Inicializar sensores y tareas
-    ESP_LOGI(TAG, "→ Inicializando sensores y tareas FreeRTOS...");
-    task_config_t task_cfg = {
-        .sampling_interval_ms = 1000,        // 1 segundo
-        .ultrasonic_trig_pin = GPIO_NUM_5,  // Pin TRIG del sensor ultrasónico
-        .ultrasonic_echo_pin = GPIO_NUM_18,   // Pin ECHO del sensor ultrasónico
-        .tds_adc_pin = 0,                    // Canal ADC 0 del sensor TDS
-        .pump_relay_pin = GPIO_NUM_8         // Pin del relé de la bomba
-    };
-    
-    esp_err_t tasks_err = tasks_init(&task_cfg);
-    if (tasks_err != ESP_OK) {
-        ESP_LOGE(TAG, "✗ Error al inicializar tareas: %s", esp_err_to_name(tasks_err));
-        return;
-    }
-    
-    // 5. Crear tarea de lectura y publicación
-    // Increase stack for sensor task to reduce risk of stack overflow (allocations done on heap)
-    xTaskCreate(sensor_read_and_publish_task, 
-                "sensor_task", 
-                8192,                      // Stack size (increased)
-                NULL,                      // Parámetros
-                3,                         // Prioridad (más alta)
-                NULL);                     // Handle
-
-    // Start minimal UART command task (reads lines and triggers sensor commands)
-    xTaskCreate(uart_command_task, "uart_cmd", 3072, NULL, 2, NULL);
-    
-    ESP_LOGI(TAG, "\n✓ INICIALIZACIÓN COMPLETADA");
-    ESP_LOGI(TAG, "El sistema está en funcionamiento...\n");
-    
-    // ========== LOOP PRINCIPAL ==========
-    // El sistema continúa funcionando a través de tareas FreeRTOS
-    // Esta función puede monitorear memoria o ejecutar otras funciones
-    
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    while (1) {
-        // Mostrar información cada 10 segundos
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(10000));
-        
-        ESP_LOGI(TAG, "→ Estado: WiFi=%s | MQTT=%s | Relé=%s",
-                 wifi_is_connected() ? "✓" : "✗",
-                 mqtt_is_connected(mqtt_client) ? "✓" : "✗",
-                 tasks_get_pump_relay_state() ? "ON" : "OFF");
-        
-        // Información de memoria
-        uint32_t free_heap = esp_get_free_heap_size();
-        uint32_t min_free_heap = esp_get_minimum_free_heap_size();
-        ESP_LOGD(TAG, "  Memoria: Libre=%" PRIu32 " B | Mínima=%" PRIu32 " B", free_heap, min_free_heap);
-    }
-}
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include "nvs_flash.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "driver/uart.h"
+#include <strings.h>
+
+// Componentes locales
+#include "wifi.h"
+#include "mqtt.h"
+
+#include "sensor.h"
+#include "tasks.h"
+#include "pump_rule.h"
+#include "boot.h"
+#include "boot_prof.h"
+#include "lp_sampler.h"
+#include "power.h"
+#include "tank_geometry.h"
+#include "adc_driver.h"
+#include "rawstream_uart.h"
+#include "cmdline_uart.h"
+#include "bench.h"
+#include "payload.h"
+
+#define WIFI_SSID       "RPi-Hotspot"        // Cambiar por el SSID de tu red Wi-Fi RPi-Hotspot
+#define WIFI_PASSWORD   "12345678"    // Cambiar por la contraseña de tu red Wi-Fi
+#define MQTT_BROKER_URI "mqtt://10.42.0.111:1883"  // Cambiar según broker 10.162.31.132  10.42.0.1     10.42.0.111
+#define WIFI_AP_DTIM_PERIOD 1           // DTIM configurado en el AP (hostapd: dtim_period)
+#define PS_PING_TOPIC "cistern/diag/ping"
+#define PS_PING_EVERY_N_PUBLISH 10      // Sonda de latencia cada N ráfagas de publicación
+
+// Umbrales de la regla automática de bomba (lectura del ultrasónico en cm)
+#define PUMP_LEVEL_LOW_CM   20.0f
+#define PUMP_LEVEL_HIGH_CM  180.0f
+
+// Geometría por defecto de la cisterna (prisma de obra, tanque 0); se
+// reemplaza con el comando UART `geom` y queda guardada en NVS
+#define CISTERN_SENSOR_HEIGHT_CM  200.0f   // Sensor → fondo
+#define CISTERN_MAX_LEVEL_CM      180.0f   // Rebose
+#define CISTERN_LENGTH_CM         200.0f
+#define CISTERN_WIDTH_CM          150.0f
+
+// Muestreo en el núcleo LP con el HP en deep sleep. Requiere habilitar
+// CONFIG_ULP_COPROC_TYPE_LP_CORE y cablear el ultrasónico a pines LP IO
+// (GPIO0-7): TRIG=GPIO5 y ECHO=GPIO4 en este modo.
+#if CONFIG_ULP_COPROC_TYPE_LP_CORE
+#define CISTERNA_LP_SAMPLING 1
+#else
+#define CISTERNA_LP_SAMPLING 0
+#endif
+#define LP_ECHO_PIN         GPIO_NUM_4
+#define LP_HP_AWAKE_MS      5000        // HP despierto por ciclo: control de bomba + publicación
+
+// Monitor de la alimentación: divisor resistivo a un canal ADC que entra en
+// el escaneo de fondo junto con las sondas TDS (-1 = sin monitor)
+#define VSUPPLY_ADC_CHANNEL   -1
+#define VSUPPLY_DIVIDER_X100  200       // (R1 + R2) / R2 · 100
+#define ADC_SCAN_ROUND_MS     2000      // Igual a la ronda que usan las sondas TDS
+// Piso de ruido objetivo del comando "noise" (milésimas de LSB)
+#define ADC_NOISE_FLOOR_MLSB  250
+
+// Light sleep automático entre muestras (requiere CONFIG_PM_ENABLE y tickless idle)
+#define POWER_LIGHT_SLEEP   true
+static const char *TAG = "CISTERNA_MAIN";
+
+// Variables globales para configuración
+static void *mqtt_client = NULL;
+static bool pump_manual_override = false;
+
+/**
+ * @brief Callback para eventos MQTT
+ * 
+ * Maneja eventos de conexión, desconexión, suscripción y recepción de mensajes.
+ * Particularmente, procesa comandos de control de bomba desde el topic "cistern_control"
+ * 
+ * Tópicos esperados:
+ * - Recibir: cistern_control → mensajes "ON"/"OFF"/"AUTO" para control de bomba
+ */
+static void mqtt_event_handler(void *handler_args, esp_event_base_t base, 
+                               int32_t event_id, void *event_data)
+{
+    esp_mqtt_event_handle_t event = (esp_mqtt_event_handle_t)event_data;
+    
+    if (event_id == MQTT_EVENT_CONNECTED) {
+        boot_prof_event_once("mqtt_conn");
+        // Suscribirse en cada conexión: el cliente puede arrancar antes de tener red.
+        // event->client y no mqtt_client: la etapa de arranque asigna el global
+        // después de mqtt_init() y el primer CONNECTED puede llegar antes
+        mqtt_subscribe(event->client, "cistern_control", 1);
+        ESP_LOGI(TAG, "-> Suscrito a topico 'cistern_control' para recibir comandos desde Node-RED");
+        // Sonda de latencia: el nodo se publica a sí mismo a través del broker
+        mqtt_subscribe(event->client, PS_PING_TOPIC, 0);
+    } else if (event_id == MQTT_EVENT_PUBLISHED) {
+        // PUBACK recibido: la radio está en una ventana de escucha
+        wifi_ps_note_rx();
+    } else if (event_id == MQTT_EVENT_DATA) {
+        wifi_ps_note_rx();
+        // Procesar mensajes recibidos
+        if (event->topic_len == (int)strlen(PS_PING_TOPIC) &&
+            strncmp(event->topic, PS_PING_TOPIC, event->topic_len) == 0) {
+            // Latencia de ida y vuelta (incluye el buffering del AP en modo ahorro)
+            char ts[24] = {0};
+            int len = (event->data_len < (int)sizeof(ts) - 1) ? event->data_len : (int)sizeof(ts) - 1;
+            memcpy(ts, event->data, len);
+            int64_t sent_us = strtoll(ts, NULL, 10);
+            wifi_ps_record_latency_us(esp_timer_get_time() - sent_us);
+        } else if (strncmp(event->topic, "cistern_control", event->topic_len) == 0) {
+            // Procesar comando de control de bomba
+            char payload[32] = {0};
+            int len = (event->data_len < (int)sizeof(payload) - 1) ? event->data_len : (int)sizeof(payload) - 1;
+            strncpy(payload, event->data, len);
+            payload[len] = '\0';
+            
+            ESP_LOGI(TAG, "-> Comando de bomba recibido: '%s'", payload);
+            
+            // Procesar comandos desde Node-RED
+            if (strcasecmp(payload, "ON") == 0) {
+                tasks_set_pump_relay(true);
+                pump_manual_override = true;
+                ESP_LOGI(TAG, "OK Bomba encendida (desde Node-RED)");
+            } else if (strcasecmp(payload, "OFF") == 0) {
+                tasks_set_pump_relay(false);
+                pump_manual_override = true;
+                ESP_LOGI(TAG, "OK Bomba apagada (desde Node-RED)");
+            } else if (strcasecmp(payload, "AUTO") == 0) {
+                pump_manual_override = false;
+                ESP_LOGI(TAG, "OK Control automatico de bomba activado");
+            }
+        }
+    }
+}
+
+static const pump_rule_cfg_t s_pump_rule = {
+    .level_low_cm = PUMP_LEVEL_LOW_CM,
+    .level_high_cm = PUMP_LEVEL_HIGH_CM,
+};
+
+/**
+ * @brief Tarea FreeRTOS de control automático de bomba
+ * 
+ * Arranca en cuanto los sensores están listos, sin esperar a la red:
+ * 1. Toma la última lectura de sensores cada 1 segundo
+ * 2. Implementa lógica automática de control de bomba
+ * 3. Registra la lectura en el log
+ * 
+ * Reglas de control automático de bomba (sobre el nivel filtrado):
+ * - Si nivel bajo Y agua aceptable (≤600 ppm) → encender
+ * - Si nivel alto O agua sucia (>600 ppm) → apagar
+ */
+static void pump_control_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "→ Iniciando tarea de control de bomba");
+    
+    const uint32_t control_interval = 1000;  // 1 segundo
+    sensor_data_t sensor_data;
+    
+    while (1) {
+        // Leer datos de sensores de forma segura (con semáforo)
+        esp_err_t err = tasks_read_sensor_data(&sensor_data, pdMS_TO_TICKS(500));
+        
+        if (err == ESP_OK) {
+            // Lógica de control automático de bomba
+            if (!pump_manual_override) {
+                // Umbrales sobre el nivel filtrado (Kalman), ver pump_rule.h
+                bool relay_before = tasks_get_pump_relay_state();
+                pump_rule_action_t action = pump_rule_decide(&s_pump_rule, &sensor_data);
+                
+                if (action == PUMP_RULE_ON) {
+                    // Encender bomba: nivel bajo y agua aceptable
+                    tasks_set_pump_relay(true);
+                } else if (action == PUMP_RULE_OFF) {
+                    // Apagar bomba: nivel alto o agua sucia
+                    tasks_set_pump_relay(false);
+                }
+                
+                // Latencia desde la lectura que disparó la regla hasta el relé
+                if (tasks_get_pump_relay_state() != relay_before) {
+                    power_note_pump_latency_us(esp_timer_get_time() - sensor_data.sample_us);
+                }
+            }
+            
+            // Log de información
+            ESP_LOGI(TAG, "Lectura #%" PRIu32 " | Nivel: %.2f cm (%u/%u, %u%%) → %.2f cm | TDS: %.1f ppm (%s) | Bomba: %s",
+                     sensor_data.timestamp,
+                     sensor_data.water_level,
+                     sensor_data.level_valid, sensor_data.level_pings, sensor_data.level_confidence,
+                     sensor_data.level_filtered,
+                     sensor_data.tds_value,
+                     payload_water_state(sensor_data.water_state),
+                     tasks_get_pump_relay_state() ? "ON" : "OFF");
+        } else {
+            ESP_LOGE(TAG, "✗ Error al leer sensores: %s", esp_err_to_name(err));
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(control_interval));
+    }
+}
+
+/**
+ * @brief Publica un cuerpo de payload.c; len < 0 (no entró en el buffer) se descarta con aviso
+ */
+static void publish_payload(const char *topic, const char *buf, int len)
+{
+    if (len < 0) {
+        ESP_LOGW(TAG, "⚠ %s descartado: el mensaje no entra en el buffer", topic);
+        return;
+    }
+    mqtt_publish(mqtt_client, topic, buf, len, 1);
+}
+
+/**
+ * @brief Distancia para la geometría: la filtrada si hay estimación, si no la cruda
+ */
+static float tank_distance_cm(const sensor_data_t *d)
+{
+    return (d->level_var >= 0.0f) ? d->level_filtered : d->water_level;
+}
+
+/**
+ * @brief Publica cistern/tank/<nombre> para cada tanque de la tabla
+ *
+ * Un mensaje por tanque en la misma ráfaga: la telemetría crece con la
+ * cantidad de tanques sin agregar tareas ni tópicos por campo.
+ */
+static void publish_tank_states(char *buf, size_t buf_sz)
+{
+    char topic[48];
+    for (int i = 0; i < tasks_get_tank_count(); i++) {
+        sensor_data_t d;
+        if (tasks_read_tank_data(i, &d, 100) != ESP_OK) {
+            continue;
+        }
+        tank_history_summary_t sum;
+        bool has_sum = tasks_get_tank_summary(i, 0, &sum, 100) == ESP_OK;
+        float height_cm = 0.0f, liters = -1.0f;
+        tank_geometry_convert(i, tank_distance_cm(&d), &height_cm, &liters);
+        int pos = payload_tank_state(buf, buf_sz, &d, sensor_tank_has_tds(i), height_cm, liters,
+                                     has_sum ? &sum : NULL);
+        snprintf(topic, sizeof(topic), "cistern/tank/%s", sensor_tank_name(i));
+        publish_payload(topic, buf, pos);
+    }
+}
+
+/**
+ * @brief Tensión de alimentación en mV desde el escaneo ADC (-1 sin monitor o sin dato)
+ */
+static int vsupply_mv(void)
+{
+    adc_scan_value_t v;
+    if (VSUPPLY_ADC_CHANNEL < 0 || !adc_read_latest(VSUPPLY_ADC_CHANNEL, 0, &v)) {
+        return -1;
+    }
+    return adc_raw_to_mv_channel(VSUPPLY_ADC_CHANNEL, v.value) * VSUPPLY_DIVIDER_X100 / 100;
+}
+
+static void vsupply_print(void)
+{
+    int mv = vsupply_mv();
+    if (mv >= 0) {
+        ESP_LOGI(TAG, "(cmd) adc: alimentación=%d mV", mv);
+    }
+}
+
+/**
+ * @brief Comando UART "noise [canal] [piso_mlsb]": ruido y ENOB del ADC por ventana de decimación
+ */
+static void noise_command(const char *args)
+{
+    char *end = NULL;
+    long channel = strtol(args, &end, 10);
+    if (end == args) {
+        channel = -1;                       // Canal por defecto (primera sonda TDS)
+    }
+    long floor_mlsb = strtol(end, NULL, 10);
+    adc_noise_report((int)channel, floor_mlsb > 0 ? (uint32_t)floor_mlsb : ADC_NOISE_FLOOR_MLSB);
+}
+
+/**
+ * @brief Comando UART "stream": muestras crudas en binario (rawstream) para
+ * tools/rawstream_dump
+ *
+ *   stream                  → contadores
+ *   stream on [baud]        → cada conversión del ADC y cada eco del ultrasónico
+ *   stream adc <canal> [baud] → además convierte el canal en continuo (kHz)
+ *   stream off              → vuelve a 115200 y a los logs
+ */
+static void stream_command(const char *args)
+{
+    while (*args == ' ') {
+        args++;
+    }
+    if (*args == '\0') {
+        rawstream_print_stats();
+        adc_scan_print();
+        return;
+    }
+    if (strcasecmp(args, "off") == 0) {
+        adc_capture_stop();
+        rawstream_stop();
+        return;
+    }
+
+    char *end = NULL;
+    long channel = -1;
+    if (strncasecmp(args, "adc ", 4) == 0) {
+        channel = strtol(args + 4, &end, 10);
+        if (end == args + 4) {
+            ESP_LOGW(TAG, "(cmd) stream: uso: stream adc <canal> [baud]");
+            return;
+        }
+    } else if (strncasecmp(args, "on", 2) == 0) {
+        end = (char *)args + 2;
+    } else {
+        ESP_LOGW(TAG, "(cmd) stream: uso: stream [on [baud] | adc <canal> [baud] | off]");
+        return;
+    }
+    long baud = strtol(end, NULL, 10);
+    if (channel >= 0) {
+        esp_err_t err = adc_capture_start((int)channel);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "(cmd) stream: canal ADC %ld no configurado", channel);
+            return;
+        }
+    }
+    esp_err_t err = rawstream_start(baud > 0 ? (uint32_t)baud : 0);
+    if (err != ESP_OK) {
+        adc_capture_stop();
+        ESP_LOGE(TAG, "(cmd) stream: error: %s", esp_err_to_name(err));
+    }
+}
+
+/**
+ * @brief Comando UART "tanks": última lectura y resumen de cada tanque
+ */
+static void tanks_command(void)
+{
+    ESP_LOGI(TAG, "=== TANQUES (%d) ===", tasks_get_tank_count());
+    for (int i = 0; i < tasks_get_tank_count(); i++) {
+        sensor_data_t d;
+        if (tasks_read_tank_data(i, &d, 100) != ESP_OK) {
+            continue;
+        }
+        ESP_LOGI(TAG, "[%d] %-10s nivel=%.1f cm (filtrado %.1f) conf=%u | TDS=%.1f ppm",
+                 i, sensor_tank_name(i), d.water_level, d.level_filtered,
+                 d.level_confidence, d.tds_value);
+        tank_history_summary_t sum;
+        if (tasks_get_tank_summary(i, 0, &sum, 100) == ESP_OK) {
+            ESP_LOGI(TAG, "    historial: %u muestras (%u con nivel) en %" PRIu32
+                     " s | nivel mín=%.1f máx=%.1f media=%.1f | TDS media=%.1f",
+                     sum.samples, sum.level_samples, sum.span_ms / 1000,
+                     sum.level_min_cm, sum.level_max_cm, sum.level_mean_cm, sum.tds_mean_ppm);
+        }
+    }
+}
+
+/**
+ * @brief Tarea FreeRTOS de publicación de datos en MQTT
+ * 
+ * Publica la última lectura en tópicos separados cada 1 segundo:
+ * cistern/water_level, cistern/level_quality, cistern/level_filtered,
+ * cistern/volume, cistern/tds_value, cistern/water_state y cistern/pump_state
+ * (tanque de la bomba), más cistern/tank/<nombre> por cada tanque
+ * 
+ * Tras la primera publicación envía una única vez la línea de tiempo de
+ * arranque en cistern/diag/boot (JSON de boot_prof).
+ * 
+ * Con ahorro de energía activo, las publicaciones salen en una sola ráfaga
+ * alineada con la ventana de escucha del perfil Wi-Fi (wifi_ps_next_publish_delay_ms).
+ */
+static void publish_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "→ Iniciando tarea de publicación MQTT");
+    
+    const uint32_t publish_interval = 1000;  // 1 segundo
+    sensor_data_t sensor_data;
+    bool boot_timeline_sent = false;
+    uint32_t burst_count = 0;
+    const size_t json_buf_sz = 1536;
+    char *json_payload = (char *) malloc(json_buf_sz);
+    if (json_payload == NULL) {
+        ESP_LOGE(TAG, "✗ No memory for JSON buffer");
+        vTaskDelete(NULL);
+        return;
+    }
+    
+    while (1) {
+        esp_err_t err = tasks_read_sensor_data(&sensor_data, pdMS_TO_TICKS(500));
+        
+        if (err == ESP_OK) {
+            const char *pump_state_str = tasks_get_pump_relay_state() ? "ON" : "OFF";
+            
+            // Publicar en topicos separados si MQTT esta conectado
+            if (mqtt_is_connected(mqtt_client)) {
+                // 1. Publicar nivel de agua (en cm)
+                snprintf(json_payload, json_buf_sz, "%.2f", sensor_data.water_level);
+                mqtt_publish(mqtt_client, "cistern/water_level", json_payload, strlen(json_payload), 1);
+                
+                // 1b. Calidad de la ráfaga de nivel
+                int len = payload_level_quality(json_payload, json_buf_sz, &sensor_data);
+                publish_payload("cistern/level_quality", json_payload, len);
+                
+                // 1c. Nivel filtrado, tasa y varianza (Kalman)
+                if (sensor_data.level_var >= 0.0f) {
+                    len = payload_level_filtered(json_payload, json_buf_sz, &sensor_data);
+                    publish_payload("cistern/level_filtered", json_payload, len);
+                }
+                
+                // 1d. Nivel sobre el fondo y volumen del tanque de la bomba
+                //     (el resto de los tanques los lleva cistern/tank/<nombre>)
+                float height_cm, liters;
+                if (tank_geometry_convert(tasks_get_pump_tank(), tank_distance_cm(&sensor_data),
+                                          &height_cm, &liters)) {
+                    len = payload_volume(json_payload, json_buf_sz, height_cm, liters);
+                    publish_payload("cistern/volume", json_payload, len);
+                }
+                
+                // 2. Publicar TDS (en ppm)
+                snprintf(json_payload, json_buf_sz, "%.1f", sensor_data.tds_value);
+                mqtt_publish(mqtt_client, "cistern/tds_value", json_payload, strlen(json_payload), 1);
+                // Conversiones que usó la ráfaga adaptativa (ruido de la sonda)
+                snprintf(json_payload, json_buf_sz, "%u", sensor_data.tds_samples);
+                mqtt_publish(mqtt_client, "cistern/diag/tds_samples", json_payload, strlen(json_payload), 1);
+                
+                // 3. Publicar estado del agua (LIMPIA/MEDIA/SUCIA)
+                snprintf(json_payload, json_buf_sz, "%s", payload_water_state(sensor_data.water_state));
+                mqtt_publish(mqtt_client, "cistern/water_state", json_payload, strlen(json_payload), 1);
+                
+                // 4. Publicar estado de la bomba (ON/OFF)
+                snprintf(json_payload, json_buf_sz, "%s", pump_state_str);
+                mqtt_publish(mqtt_client, "cistern/pump_state", json_payload, strlen(json_payload), 1);
+                
+                // 4b. Un JSON por tanque con la última lectura y el resumen del historial
+                publish_tank_states(json_payload, json_buf_sz);
+                
+                // 4c. Tensión de alimentación (si hay monitor en el escaneo ADC)
+                int vsupply = vsupply_mv();
+                if (vsupply >= 0) {
+                    snprintf(json_payload, json_buf_sz, "%d", vsupply);
+                    mqtt_publish(mqtt_client, "cistern/diag/vsupply_mv", json_payload, strlen(json_payload), 1);
+                }
+                
+                ESP_LOGD(TAG, "-> Datos publicados en topicos MQTT");
+                
+                // Sonda de latencia periódica dentro de la misma ráfaga
+                if (++burst_count % PS_PING_EVERY_N_PUBLISH == 0) {
+                    snprintf(json_payload, json_buf_sz, "%" PRId64, esp_timer_get_time());
+                    mqtt_publish(mqtt_client, PS_PING_TOPIC, json_payload, strlen(json_payload), 0);
+                }
+                wifi_ps_note_tx_burst();
+                
+                // 5. Diagnóstico: línea de tiempo de arranque (una sola vez)
+                if (!boot_timeline_sent) {
+                    boot_prof_event_once("first_publish");
+                    int n = boot_prof_to_json(json_payload, json_buf_sz);
+                    if (n > 0) {
+                        mqtt_publish(mqtt_client, "cistern/diag/boot", json_payload, n, 1);
+                    }
+                    boot_prof_print();
+                    boot_timeline_sent = true;
+                }
+            } else {
+                ESP_LOGW(TAG, "X MQTT desconectado, datos no publicados");
+            }
+        } else {
+            ESP_LOGE(TAG, "✗ Error al leer sensores: %s", esp_err_to_name(err));
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(wifi_ps_next_publish_delay_ms(publish_interval)));
+    }
+}
+
+/**
+ * @brief Inicialización de NVS Flash
+ * 
+ * El almacenamiento NVS es necesario para que funcionen correctamente
+ * algunos componentes como Wi-Fi y MQTT
+ */
+static esp_err_t nvs_init(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        // Si NVS está lleno o es versión antigua, borrarlo
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    return ret;
+}
+
+/**
+ * @brief Muestra las estadísticas de conexión Wi-Fi (comando UART "wifi")
+ */
+static void wifi_print_stats(void)
+{
+    wifi_stats_t st;
+    wifi_get_stats(&st);
+    ESP_LOGI(TAG, "(cmd) wifi: conectado=%s | arranque->IP=%" PRId64 " ms (%s)",
+             wifi_is_connected() ? "si" : "no",
+             st.boot_to_ip_us / 1000,
+             st.fast_connect_used ? "rapida" : "escaneo completo");
+    ESP_LOGI(TAG, "(cmd) wifi: desconexiones=%" PRIu32 " reconexiones=%" PRIu32
+             " | ultima=%" PRId64 " ms | max=%" PRId64 " ms",
+             st.disconnect_count, st.reconnect_count,
+             st.last_reconnect_us / 1000, st.max_reconnect_us / 1000);
+}
+
+/**
+ * @brief Comando UART "ps": muestra o cambia el perfil de ahorro de energía
+ * 
+ * ps            → estadísticas del perfil actual
+ * ps none       → radio siempre encendida
+ * ps min        → despertar en cada DTIM
+ * ps max <N>    → despertar cada N beacons
+ * ps dtim <N>   → despertar cada N DTIMs del AP
+ */
+static void wifi_ps_command(const char *args)
+{
+    while (*args == ' ') args++;
+
+    if (*args != '\0') {
+        wifi_ps_config_t cfg = {
+            .profile = WIFI_PS_PROFILE_MIN_MODEM,
+            .listen_interval = 0,
+            .ap_dtim_period = WIFI_AP_DTIM_PERIOD,
+        };
+        char mode[8] = {0};
+        int n = 0;
+        sscanf(args, "%7s %d", mode, &n);
+        if (strcasecmp(mode, "none") == 0) {
+            cfg.profile = WIFI_PS_PROFILE_NONE;
+        } else if (strcasecmp(mode, "min") == 0) {
+            cfg.profile = WIFI_PS_PROFILE_MIN_MODEM;
+        } else if (strcasecmp(mode, "max") == 0) {
+            cfg.profile = WIFI_PS_PROFILE_MAX_MODEM;
+            cfg.listen_interval = (n > 0) ? n : 3;
+        } else if (strcasecmp(mode, "dtim") == 0) {
+            cfg.profile = WIFI_PS_PROFILE_CUSTOM_DTIM;
+            cfg.listen_interval = (n > 0) ? n : 1;
+        } else {
+            ESP_LOGI(TAG, "(cmd) ps: uso: ps [none|min|max <beacons>|dtim <N>]");
+            return;
+        }
+        esp_err_t err = wifi_set_ps_profile(&cfg);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "(cmd) ps: error: %s", esp_err_to_name(err));
+        }
+        return;
+    }
+
+    wifi_ps_stats_t st;
+    wifi_ps_get_stats(&st);
+    ESP_LOGI(TAG, "(cmd) ps: perfil=%s ventana=%" PRIu32 " ms medido=%" PRIu32 " s rafagas=%" PRIu32,
+             wifi_ps_profile_name(st.profile), st.window_ms, st.elapsed_ms / 1000, st.tx_bursts);
+    ESP_LOGI(TAG, "(cmd) ps: latencia n=%" PRIu32 " ultima=%" PRIu32 " prom=%" PRIu32 " max=%" PRIu32 " ms",
+             st.latency_samples, st.latency_last_ms, st.latency_avg_ms, st.latency_max_ms);
+    ESP_LOGI(TAG, "(cmd) ps: radio encendida (estimada)=%" PRIu32 " ms (%u.%u%%)",
+             st.radio_on_est_ms, st.radio_on_permille / 10, st.radio_on_permille % 10);
+}
+
+/**
+ * @brief Tanque al inicio de los argumentos de "geom" (índice o nombre)
+ *
+ * Avanza *args después del tanque; sin tanque explícito retorna 0 (la
+ * cisterna) y no avanza. -1 si el índice está fuera de rango.
+ */
+static int geometry_parse_tank(const char **args)
+{
+    const char *p = *args;
+    size_t n = strcspn(p, " ");
+    if (n == 0) {
+        return 0;
+    }
+    int tank = -2;
+    if (p[0] >= '0' && p[0] <= '9') {
+        tank = atoi(p);
+        if (tank >= tasks_get_tank_count() || tank >= TANK_GEOM_MAX_TANKS) {
+            tank = -1;
+        }
+    } else {
+        for (int i = 0; i < tasks_get_tank_count(); i++) {
+            if (strlen(sensor_tank_name(i)) == n && strncasecmp(p, sensor_tank_name(i), n) == 0) {
+                tank = i;
+                break;
+            }
+        }
+    }
+    if (tank == -2) {
+        return 0;                // Primer token es el modo: tanque 0
+    }
+    p += n;
+    while (*p == ' ') p++;
+    *args = p;
+    return tank;
+}
+
+/**
+ * @brief Comando UART "geom": muestra o cambia la geometría de un tanque
+ *
+ * <tanque> es el índice o el nombre de la tabla de tanques; si se omite, 0.
+ *
+ *   geom                                    → geometría de todos los tanques
+ *   geom <tanque>                           → geometría del tanque
+ *   geom [tanque] cyl <sensor> <rebose> <diámetro>
+ *   geom [tanque] hcyl <sensor> <diámetro> <largo>
+ *   geom [tanque] rect <sensor> <rebose> <largo> <ancho>
+ *   geom [tanque] pt <nivel> <litros>       → agrega un punto de aforo (en RAM)
+ *   geom [tanque] table <sensor> <rebose>   → aplica la tabla de aforo acumulada
+ */
+static void geometry_command(const char *args)
+{
+    static tank_geometry_cfg_t s_table_cfg[TANK_GEOM_MAX_TANKS];   // Puntos de aforo pendientes
+    while (*args == ' ') args++;
+
+    if (*args == '\0') {
+        for (int i = 0; i < tasks_get_tank_count() && i < TANK_GEOM_MAX_TANKS; i++) {
+            tank_geometry_print(i);
+        }
+        return;
+    }
+
+    int tank = geometry_parse_tank(&args);
+    if (tank < 0) {
+        ESP_LOGE(TAG, "(cmd) geom: tanque fuera de rango (%d tanques)", tasks_get_tank_count());
+        return;
+    }
+    if (*args == '\0') {
+        tank_geometry_print(tank);
+        return;
+    }
+
+    tank_geometry_cfg_t *table = &s_table_cfg[tank];
+    tank_geometry_cfg_t cfg;
+    tank_geometry_get_cfg(tank, &cfg);
+    char mode[8] = {0};
+    float a = 0.0f, b = 0.0f, c = 0.0f, d = 0.0f;
+    int n = sscanf(args, "%7s %f %f %f %f", mode, &a, &b, &c, &d);
+
+    if (strcasecmp(mode, "cyl") == 0 && n == 4) {
+        cfg.shape = TANK_SHAPE_CYLINDER_V;
+        cfg.sensor_height_cm = a;
+        cfg.max_level_cm = b;
+        cfg.diameter_cm = c;
+    } else if (strcasecmp(mode, "hcyl") == 0 && n == 4) {
+        cfg.shape = TANK_SHAPE_CYLINDER_H;
+        cfg.sensor_height_cm = a;
+        cfg.max_level_cm = b;
+        cfg.diameter_cm = b;
+        cfg.length_cm = c;
+    } else if (strcasecmp(mode, "rect") == 0 && n == 5) {
+        cfg.shape = TANK_SHAPE_RECT;
+        cfg.sensor_height_cm = a;
+        cfg.max_level_cm = b;
+        cfg.length_cm = c;
+        cfg.width_cm = d;
+    } else if (strcasecmp(mode, "pt") == 0 && n == 3) {
+        if (table->table_count >= TANK_GEOM_TABLE_MAX) {
+            ESP_LOGE(TAG, "(cmd) geom: tabla llena (%d puntos)", TANK_GEOM_TABLE_MAX);
+            return;
+        }
+        table->table_level_cm[table->table_count] = a;
+        table->table_liters[table->table_count] = b;
+        table->table_count++;
+        ESP_LOGI(TAG, "(cmd) geom: tanque %d, punto %u: %.1f cm → %.1f L",
+                 tank, table->table_count, a, b);
+        return;
+    } else if (strcasecmp(mode, "table") == 0 && n == 3) {
+        cfg.shape = TANK_SHAPE_TABLE;
+        cfg.sensor_height_cm = a;
+        cfg.max_level_cm = b;
+        cfg.table_count = table->table_count;
+        memcpy(cfg.table_level_cm, table->table_level_cm, sizeof(cfg.table_level_cm));
+        memcpy(cfg.table_liters, table->table_liters, sizeof(cfg.table_liters));
+    } else {
+        ESP_LOGI(TAG, "(cmd) geom: uso: geom [tanque] [cyl H M D | hcyl H D L | rect H M L W | pt nivel litros | table H M]");
+        return;
+    }
+
+    esp_err_t err = tank_geometry_apply(tank, &cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "(cmd) geom: error: %s", esp_err_to_name(err));
+        return;
+    }
+    if (cfg.shape == TANK_SHAPE_TABLE) {
+        table->table_count = 0;
+    }
+    tank_geometry_print(tank);
+}
+
+// ========== BENCHMARKS ==========
+// Caminos que dependen de las tareas; los de filtros, formato, TDS y ADC se
+// registran en sus componentes. La publicación MQTT no se mide: cada
+// iteración iría al broker de producción.
+#if CONFIG_BENCH_ENABLE
+
+/** Se omite si los sensores no arrancaron */
+static bool bench_data_setup(void)
+{
+    sensor_data_t d;
+    return tasks_read_sensor_data(&d, 100) == ESP_OK;
+}
+
+static void bench_snapshot(void)
+{
+    sensor_data_t d;
+    tasks_read_sensor_data(&d, 100);
+    BENCH_KEEP(d.timestamp);
+}
+BENCH_REGISTER_SETUP("snapshot", bench_data_setup, bench_snapshot);
+
+#endif // CONFIG_BENCH_ENABLE
+
+// ========== COMANDOS ==========
+// Tabla única de comandos: la despacha el lector UART (cmdline_uart)
+
+static void cmd_calA(const char *args)  { (void)args; sensor_do_calA(); }
+static void cmd_calB(const char *args)  { (void)args; sensor_do_calB(); }
+static void cmd_save(const char *args)  { (void)args; sensor_do_save(); }
+static void cmd_show(const char *args)  { (void)args; sensor_do_show(); }
+static void cmd_wifi(const char *args)  { (void)args; wifi_print_stats(); }
+static void cmd_sched(const char *args) { (void)args; tasks_print_sched_stats(); }
+static void cmd_tanks(const char *args) { (void)args; tanks_command(); }
+static void cmd_cycle(const char *args) { (void)args; sensor_print_cycle_stats(); }
+static void cmd_help(const char *args)  { (void)args; cmdline_print_help(); }
+static void cmd_stats(const char *args) { (void)args; cmdline_print_stats(); }
+
+static void cmd_temp(const char *args)
+{
+    if (*args == '\0') {
+        ESP_LOGI(TAG, "(cmd) temp: aire=%.1f °C", sensor_get_air_temp_c());
+    } else {
+        sensor_set_air_temp_c(strtof(args, NULL));
+    }
+}
+
+static void cmd_adc(const char *args)
+{
+    (void)args;
+    adc_scan_print();
+    vsupply_print();
+}
+
+static void cmd_pm(const char *args)
+{
+    if (*args == '\0') {
+        power_print_stats();
+        return;
+    }
+    if (strcasecmp(args, "on") != 0 && strcasecmp(args, "off") != 0) {
+        ESP_LOGI(TAG, "(cmd) pm: uso: pm [on|off]");
+        return;
+    }
+    esp_err_t pm_err = power_set_light_sleep(strcasecmp(args, "on") == 0);
+    if (pm_err != ESP_OK) {
+        ESP_LOGE(TAG, "(cmd) pm: error: %s", esp_err_to_name(pm_err));
+    }
+}
+
+static void cmd_boot(const char *args)
+{
+    (void)args;
+    boot_print_report();
+    boot_prof_print();
+}
+
+static const cmdline_cmd_t s_commands[] = {
+    { "calA",   "Calibrar punto A (offset) con la lectura actual",   cmd_calA },
+    { "calB",   "Calibrar punto B (gain) con la lectura actual",     cmd_calB },
+    { "save",   "Guardar la calibración TDS en NVS",                 cmd_save },
+    { "show",   "Mostrar offset y gain de TDS",                      cmd_show },
+    { "wifi",   "Estadísticas de conexión Wi-Fi",                    cmd_wifi },
+    { "ps",     "ps [none|min|max <beacons>|dtim <N>]",              wifi_ps_command },
+    { "sched",  "Estadísticas del planificador de sensores",         cmd_sched },
+    { "geom",   "geom [tanque] [...]: geometría por tanque",         geometry_command },
+    { "temp",   "temp [°C]: temperatura del aire",                   cmd_temp },
+    { "adc",    "Tabla del escaneo ADC y alimentación",              cmd_adc },
+    { "noise",  "noise [canal] [piso_mlsb]: ruido y ENOB",           noise_command },
+    { "stream", "stream [on [baud] | adc <canal> [baud] | off]",     stream_command },
+    { "tanks",  "Última lectura de cada tanque",                     cmd_tanks },
+    { "cycle",  "Desglose de tiempos del ciclo de sensores",         cmd_cycle },
+    { "pm",     "pm [on|off]: light sleep automático",               cmd_pm },
+    { "boot",   "Informe de arranque por etapas",                    cmd_boot },
+    { "cmd",    "Latencia y CPU de los comandos",                    cmd_stats },
+    { "bench",  "bench [prefijo|all] [N]: microbenchmarks",         bench_command },
+    { "help",   "Esta lista",                                        cmd_help },
+};
+
+static int64_t cmd_clock_us(void)
+{
+    return esp_timer_get_time();
+}
+
+// ========== ETAPAS DE ARRANQUE ==========
+// Grafo de dependencias:
+//   storage → sensors → control
+//   power   ↗
+//           ↘ wifi → mqtt → publisher (también requiere sensors)
+//   sensors → uart_cmd
+
+enum {
+    STAGE_POWER = 0,
+    STAGE_STORAGE,
+    STAGE_SENSORS,
+    STAGE_CONTROL,
+    STAGE_WIFI,
+    STAGE_MQTT,
+    STAGE_PUBLISHER,
+    STAGE_UART_CMD,
+};
+
+// Tabla de tanques del nodo: un ultrasónico por tanque y TDS opcional.
+// El índice es el del resto del firmware; el primero es el que muestrea el
+// núcleo LP y el nombre va en el tópico cistern/tank/<nombre>.
+static const sensor_tank_cfg_t s_tanks[] = {
+    {
+        .name = "cisterna",
+        .trig_pin = GPIO_NUM_5,          // Pin TRIG del sensor ultrasónico
+#if CISTERNA_LP_SAMPLING
+        .echo_pin = LP_ECHO_PIN,         // Pin ECHO (LP IO, compartido con el núcleo LP)
+#else
+        .echo_pin = GPIO_NUM_18,         // Pin ECHO del sensor ultrasónico
+#endif
+        .tds_adc_channel = 0,            // Canal ADC 0 del sensor TDS
+    },
+    // Segundo tanque (ejemplo): otro HC-SR04 y sonda TDS en el canal 1
+    // { .name = "elevado", .trig_pin = GPIO_NUM_6, .echo_pin = GPIO_NUM_19, .tds_adc_channel = 1 },
+};
+
+// Geometría por defecto de cada tanque (mismo índice que s_tanks); el comando
+// `geom <tanque> ...` la reemplaza y queda en NVS
+static const tank_geometry_cfg_t s_tank_geom_defaults[] = {
+    {
+        .shape = TANK_SHAPE_RECT,
+        .sensor_height_cm = CISTERN_SENSOR_HEIGHT_CM,
+        .max_level_cm = CISTERN_MAX_LEVEL_CM,
+        .length_cm = CISTERN_LENGTH_CM,
+        .width_cm = CISTERN_WIDTH_CM,
+    },
+    // Tinaco elevado del ejemplo: cilindro vertical de ~1100 L
+    // { .shape = TANK_SHAPE_CYLINDER_V, .sensor_height_cm = 150.0f, .max_level_cm = 140.0f,
+    //   .diameter_cm = 100.0f },
+};
+_Static_assert(sizeof(s_tank_geom_defaults) / sizeof(s_tank_geom_defaults[0]) ==
+               sizeof(s_tanks) / sizeof(s_tanks[0]), "una geometría por tanque");
+_Static_assert(sizeof(s_tanks) / sizeof(s_tanks[0]) <= TANK_GEOM_MAX_TANKS,
+               "subir CONFIG_TANK_GEOM_MAX_TANKS");
+
+static task_config_t s_task_cfg = {
+    .sampling_interval_ms = 1000,        // 1 segundo
+    .tanks = s_tanks,
+    .tank_count = sizeof(s_tanks) / sizeof(s_tanks[0]),
+    .pump_tank = 0,                      // La bomba llena la cisterna
+    .pump_relay_pin = GPIO_NUM_8         // Pin del relé de la bomba
+};
+
+static esp_err_t boot_power(void *arg)
+{
+    // Sin CONFIG_PM_ENABLE el nodo funciona igual, solo sin ahorro
+    esp_err_t err = power_init(POWER_LIGHT_SLEEP);
+    return (err == ESP_ERR_NOT_SUPPORTED) ? ESP_OK : err;
+}
+
+static esp_err_t boot_storage(void *arg)
+{
+    ESP_LOGI(TAG, "→ Inicializando NVS Flash...");
+    esp_err_t err = nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    for (int i = 0; i < s_task_cfg.tank_count; i++) {
+        err = tank_geometry_load(i, &s_tank_geom_defaults[i]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t boot_sensors(void *arg)
+{
+    ESP_LOGI(TAG, "→ Inicializando sensores y tareas FreeRTOS...");
+#if CISTERNA_LP_SAMPLING
+    // Recuperar TRIG/ECHO del núcleo LP y liberar el relé retenido en deep sleep
+    lp_sampler_stop();
+    gpio_hold_dis(s_task_cfg.pump_relay_pin);
+#endif
+    esp_err_t err = tasks_init(&s_task_cfg);
+    if (err != ESP_OK || VSUPPLY_ADC_CHANNEL < 0) {
+        return err;
+    }
+    const adc_scan_channel_cfg_t vsupply_cfg = {
+        .name = "vsupply",
+        .channel = VSUPPLY_ADC_CHANNEL,
+        .samples = 8,
+        .reduce = ADC_SCAN_REDUCE_MEDIAN,   // El ruido de la bomba llega en picos
+        .ema_shift = 3,
+    };
+    err = adc_scan_add_channel(&vsupply_cfg);
+    if (err == ESP_OK) {
+        err = adc_scan_start(ADC_SCAN_ROUND_MS);
+    }
+    return err;
+}
+
+static esp_err_t boot_control(void *arg)
+{
+    BaseType_t ok = xTaskCreate(pump_control_task, "pump_ctrl", 4096, NULL, 3, NULL);
+    return ok == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t boot_wifi(void *arg)
+{
+    ESP_LOGI(TAG, "→ Inicializando Wi-Fi...");
+    // Configurar con credenciales (cambiar según red local)
+    esp_err_t wifi_err = wifi_init(WIFI_SSID, WIFI_PASSWORD);
+    if (wifi_err != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al inicializar Wi-Fi: %s", esp_err_to_name(wifi_err));
+        return wifi_err;
+    }
+    
+    // Perfil de energía por defecto: despertar en cada DTIM (cambiar con "ps")
+    wifi_ps_config_t ps_cfg = {
+        .profile = WIFI_PS_PROFILE_MIN_MODEM,
+        .listen_interval = 0,
+        .ap_dtim_period = WIFI_AP_DTIM_PERIOD,
+    };
+    wifi_set_ps_profile(&ps_cfg);
+    
+    // Esperar a que se conecte a Wi-Fi (máximo 10 segundos, sin sondeo).
+    // Sin conexión se sigue adelante: el cliente MQTT reintenta por su cuenta.
+    if (wifi_wait_connected(10000)) {
+        ESP_LOGI(TAG, "✓ Conectado a Wi-Fi");
+    } else {
+        ESP_LOGW(TAG, "✗ No se pudo conectar a Wi-Fi en 10 segundos");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t boot_mqtt(void *arg)
+{
+    ESP_LOGI(TAG, "→ Inicializando MQTT...");
+    mqtt_config_t mqtt_cfg = {
+        .broker_uri = MQTT_BROKER_URI,
+        .client_id = "esp32c6_cisterna",
+        .username = "",  // Opcional
+        .password = ""   // Opcional
+    };
+    
+    mqtt_client = mqtt_init(&mqtt_cfg, mqtt_event_handler);
+    if (mqtt_client == NULL) {
+        ESP_LOGE(TAG, "✗ Error al inicializar cliente MQTT");
+        return ESP_FAIL;
+    }
+    // La suscripción a 'cistern_control' se hace en MQTT_EVENT_CONNECTED
+    return mqtt_connect(mqtt_client);
+}
+
+static esp_err_t boot_publisher(void *arg)
+{
+    // Stack amplio para la tarea de publicación (buffers en heap)
+    BaseType_t ok = xTaskCreate(publish_task, "publish_task", 8192, NULL, 3, NULL);
+    return ok == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t boot_uart_cmd(void *arg)
+{
+    esp_err_t err = cmdline_init(s_commands, sizeof(s_commands) / sizeof(s_commands[0]),
+                                 cmd_clock_us);
+    if (err == ESP_OK) {
+        // La tarea lectora duerme en la cola de eventos del driver
+        err = cmdline_uart_start(UART_NUM_0, 115200);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+#if CONFIG_PM_ENABLE
+    // En light sleep la UART despierta al sistema; los primeros caracteres
+    // se consumen en el despertar (enviar Enter antes del comando)
+    uart_set_wakeup_threshold(UART_NUM_0, 3);
+    esp_sleep_enable_uart_wakeup(UART_NUM_0);
+#endif
+    return ESP_OK;
+}
+
+static const boot_stage_t s_boot_stages[] = {
+    [STAGE_POWER]     = { "power",     boot_power,     NULL, 0,                                          0 },
+    [STAGE_STORAGE]   = { "storage",   boot_storage,   NULL, 0,                                          0 },
+    [STAGE_SENSORS]   = { "sensors",   boot_sensors,   NULL, BOOT_DEP(STAGE_STORAGE) | BOOT_DEP(STAGE_POWER), 0 },
+    [STAGE_CONTROL]   = { "control",   boot_control,   NULL, BOOT_DEP(STAGE_SENSORS),                    0 },
+    [STAGE_WIFI]      = { "wifi",      boot_wifi,      NULL, BOOT_DEP(STAGE_STORAGE),                    0 },
+    [STAGE_MQTT]      = { "mqtt",      boot_mqtt,      NULL, BOOT_DEP(STAGE_WIFI),                       0 },
+    [STAGE_PUBLISHER] = { "publisher", boot_publisher, NULL, BOOT_DEP(STAGE_MQTT) | BOOT_DEP(STAGE_SENSORS), 0 },
+    [STAGE_UART_CMD]  = { "uart_cmd",  boot_uart_cmd,  NULL, BOOT_DEP(STAGE_SENSORS),                    0 },
+};
+
+#if CISTERNA_LP_SAMPLING
+static const lp_sampler_config_t s_lp_cfg = {
+    .trig_pin = GPIO_NUM_5,
+    .echo_pin = LP_ECHO_PIN,
+    .period_ms = 1000,                   // Mismo período que el muestreo del HP
+    .level_low_cm = PUMP_LEVEL_LOW_CM,   // Despertar al HP en los umbrales de la bomba
+    .level_high_cm = PUMP_LEVEL_HIGH_CM,
+    .level_deadband_cm = 2.0f,
+    .batch_size = 60,                    // Como máximo un despertar por minuto
+};
+
+/**
+ * @brief Publica el lote acumulado por el núcleo LP en cistern/level_batch
+ */
+static void lp_publish_batch(const float *levels, size_t n, uint32_t reason, uint32_t dropped)
+{
+    static char payload[LP_BATCH_MAX * 8 + 96];
+
+    // Esperar la conexión MQTT (el arranque ya esperó la del Wi-Fi)
+    for (int i = 0; i < 50 && !mqtt_is_connected(mqtt_client); i++) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    if (!mqtt_is_connected(mqtt_client)) {
+        ESP_LOGW(TAG, "⚠ Lote LP descartado: MQTT no conectado");
+        return;
+    }
+
+    int pos = payload_level_batch(payload, sizeof(payload), levels, n, reason, dropped,
+                                  s_lp_cfg.period_ms);
+    if (pos < 0) {
+        ESP_LOGW(TAG, "⚠ Lote LP descartado: %u niveles no entran en el mensaje", (unsigned)n);
+        return;
+    }
+    mqtt_publish(mqtt_client, "cistern/level_batch", payload, pos, 1);
+}
+
+/**
+ * @brief Ciclo del modo LP: vaciar el lote, dejar actuar al HP y dormir
+ * 
+ * Con la bomba encendida el HP no duerme: la regla de apagado (nivel alto o
+ * agua sucia) necesita el TDS, que el núcleo LP del C6 no puede muestrear.
+ * Solo retorna si no se pudo entrar en deep sleep.
+ */
+static void lp_mode_cycle(void)
+{
+    static float levels[LP_BATCH_MAX];
+
+    if (lp_sampler_woke_main()) {
+        uint32_t reason = lp_sampler_wake_reason();
+        uint32_t dropped = 0;
+        size_t n = lp_sampler_drain(levels, LP_BATCH_MAX, &dropped);
+        ESP_LOGI(TAG, "→ Despertar por núcleo LP (razón 0x%02" PRIx32 "): %u muestras, %" PRIu32 " perdidas",
+                 reason, (unsigned)n, dropped);
+        lp_publish_batch(levels, n, reason, dropped);
+    }
+
+    // Dar tiempo al control de bomba y al publicador con lecturas del HP
+    vTaskDelay(pdMS_TO_TICKS(LP_HP_AWAKE_MS));
+    while (tasks_get_pump_relay_state()) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+
+    // Relé retenido en apagado durante el deep sleep. Se apaga de nuevo justo
+    // antes de retenerlo: el control de bomba pudo encenderlo tras la espera
+    tasks_set_pump_relay(false);
+    gpio_hold_en(s_task_cfg.pump_relay_pin);
+    gpio_deep_sleep_hold_en();
+    if (mqtt_client != NULL) {
+        mqtt_disconnect(mqtt_client);   // Sin cliente si la red no llegó a levantar
+    }
+
+    esp_err_t err = lp_sampler_sleep(&s_lp_cfg);
+    ESP_LOGE(TAG, "✗ No se pudo dormir con muestreo LP: %s", esp_err_to_name(err));
+    gpio_hold_dis(s_task_cfg.pump_relay_pin);
+}
+#endif
+
+/**
+ * @brief Función principal de la aplicación
+ * 
+ * Lanza el arranque por etapas. Sensores y control de bomba no esperan a la
+ * red: la rama storage → sensors → control corre en paralelo con
+ * wifi → mqtt → publisher.
+ */
+void app_main(void)
+{
+    ESP_LOGI(TAG, "\n\n=== NODO DE CONTROL DE CISTERNA ===");
+    ESP_LOGI(TAG, "ESP32-C6 | Sistema de monitoreo y control de cisterna");
+    ESP_LOGI(TAG, "Sensores: Ultrasónico + TDS | Control: Relé HW-307");
+    ESP_LOGI(TAG, "===================================\n");
+
+    // ========== INICIALIZACIÓN DE COMPONENTES ==========
+    esp_err_t err = boot_run(s_boot_stages, sizeof(s_boot_stages) / sizeof(s_boot_stages[0]));
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error al lanzar el arranque: %s", esp_err_to_name(err));
+        return;
+    }
+    
+    err = boot_wait(30000);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "\n✓ INICIALIZACIÓN COMPLETADA");
+    } else {
+        ESP_LOGW(TAG, "\n⚠ INICIALIZACIÓN INCOMPLETA: %s", esp_err_to_name(err));
+    }
+    boot_print_report();
+    ESP_LOGI(TAG, "El sistema está en funcionamiento...\n");
+    
+#if CISTERNA_LP_SAMPLING
+    // En modo LP el HP duerme entre eventos; si no puede, sigue en modo continuo
+    lp_mode_cycle();
+#endif
+    
+    // ========== LOOP PRINCIPAL ==========
+    // El sistema continúa funcionando a través de tareas FreeRTOS
+    // Esta función puede monitorear memoria o ejecutar otras funciones
+    
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    while (1) {
+        // Mostrar información cada 10 segundos
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(10000));
+        
+        ESP_LOGI(TAG, "→ Estado: WiFi=%s | MQTT=%s | Relé=%s",
+                 wifi_is_connected() ? "✓" : "✗",
+                 mqtt_is_connected(mqtt_client) ? "✓" : "✗",
+                 tasks_get_pump_relay_state() ? "ON" : "OFF");
+        
+        // Información de memoria
+        uint32_t free_heap = esp_get_free_heap_size();
+        uint32_t min_free_heap = esp_get_minimum_free_heap_size();
+        ESP_LOGD(TAG, "  Memoria: Libre=%" PRIu32 " B | Mínima=%" PRIu32 " B", free_heap, min_free_heap);
+    }
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Compara líneas de tiempo de arranque del Nodo de Cisterna entre firmwares.
+
+Acepta como entrada:
+  - Un log de consola (idf.py monitor) con líneas "BOOTPROF <nombre> <inicio_us> <duracion_us>"
+  - El JSON publicado en cistern/diag/boot (mosquitto_sub -t cistern/diag/boot -C 1 > nuevo.json)
+
+Uso:
+  python3 tools/boot_timeline.py base.log             # muestra una línea de tiempo
+  python3 tools/boot_timeline.py base.log nuevo.json  # compara dos firmwares
+"""
+
+import json
+import re
+import sys
+
+LINE_RE = re.compile(r"BOOTPROF\s+(\S+)\s+(-?\d+)\s+(-?\d+)")
+HEADER_RE = re.compile(r"BOOTPROF_BEGIN\s+ver=(\S+)")
+
+
+def load_timeline(path):
+    """Retorna (version, {nombre: (inicio_us, duracion_us)}) en orden de aparición."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    stripped = text.strip()
+    if stripped.startswith("{"):
+        data = json.loads(stripped.splitlines()[0])
+        entries = {e["n"]: (int(e["t"]), int(e["d"])) for e in data.get("entries", [])}
+        return data.get("ver", "?"), entries
+
+    version = "?"
+    entries = {}
+    # Si el log contiene varios arranques, quedarse con el último
+    for line in text.splitlines():
+        header = HEADER_RE.search(line)
+        if header:
+            version = header.group(1)
+            entries = {}
+            continue
+        m = LINE_RE.search(line)
+        if m:
+            entries[m.group(1)] = (int(m.group(2)), int(m.group(3)))
+    return version, entries
+
+
+def fmt_ms(us):
+    return "-" if us is None or us < 0 else f"{us / 1000.0:9.1f}"
+
+
+def print_single(version, entries):
+    print(f"Firmware: {version}")
+    print(f"{'etapa':<14}{'inicio ms':>10}{'dur ms':>10}")
+    for name, (start, dur) in sorted(entries.items(), key=lambda kv: kv[1][0]):
+        print(f"{name:<14}{fmt_ms(start):>10}{fmt_ms(dur):>10}")
+
+
+def print_compare(base, new):
+    (ver_a, a), (ver_b, b) = base, new
+    print(f"A: {ver_a}    B: {ver_b}")
+    print(f"{'etapa':<14}{'inicio A':>10}{'inicio B':>10}{'dur A':>10}{'dur B':>10}{'Δdur ms':>10}")
+
+    names = list(a.keys()) + [n for n in b.keys() if n not in a]
+    names.sort(key=lambda n: (a.get(n) or b.get(n))[0])
+    for name in names:
+        sa, da = a.get(name, (None, None))
+        sb, db = b.get(name, (None, None))
+        delta = "-"
+        if da is not None and db is not None and da >= 0 and db >= 0:
+            delta = f"{(db - da) / 1000.0:+9.1f}"
+        print(f"{name:<14}{fmt_ms(sa):>10}{fmt_ms(sb):>10}{fmt_ms(da):>10}{fmt_ms(db):>10}{delta:>10}")
+
+    for label, key in (("primera muestra", "first_sample"), ("primera publicación", "first_publish")):
+        if key in a and key in b:
+            d = (b[key][0] - a[key][0]) / 1000.0
+            print(f"{label}: {a[key][0] / 1000.0:.1f} ms → {b[key][0] / 1000.0:.1f} ms ({d:+.1f} ms)")
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        print(__doc__)
+        return 1
+    timelines = [load_timeline(p) for p in argv[1:]]
+    for path, (_, entries) in zip(argv[1:], timelines):
+        if not entries:
+            print(f"✗ No se encontraron entradas BOOTPROF en {path}")
+            return 1
+    if len(timelines) == 1:
+        print_single(*timelines[0])
+    else:
+        print_compare(timelines[0], timelines[1])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
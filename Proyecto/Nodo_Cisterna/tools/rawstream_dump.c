@@ -0,0 +1,226 @@
+/*
+ * rawstream_dump: decodificador de host para la trama binaria de muestras
+ * crudas (components/rawstream) de Nodo_Cisterna y Calibrar_TDS.
+ *
+ *   rawstream_dump [-b baud] [-c comando] [-f csv|bin] [-o archivo]
+ *                  [-n registros] [-t segundos_sin_datos] <puerto>
+ *
+ * -c envía el comando a 115200 (p. ej. "stream adc 0"), pasa a -b y al
+ * salir envía "stream off". La salida CSV es "t_us,channel,seq,value"; la
+ * binaria son los registros de 12 bytes tal como vienen (little-endian,
+ * sin CRC). Al terminar (Ctrl+C, -n o -t) imprime en stderr:
+ *
+ *   frames=N dropped=N crc_errors=N framing_errors=N bytes=N
+ *
+ * Se compila con las pruebas de host (host_test/CMakeLists.txt), que lo
+ * ejercitan sobre un pseudo-terminal.
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rawstream.h"
+
+#define CONSOLE_BAUD 115200
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+static speed_t baud_to_speed(long baud)
+{
+    switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    default: return 0;
+    }
+}
+
+static int set_raw(int fd, long baud)
+{
+    speed_t sp = baud_to_speed(baud);
+    if (sp == 0) {
+        fprintf(stderr, "✗ baud no soportado: %ld\n", baud);
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        perror("tcgetattr");
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, sp);
+    cfsetospeed(&tio, sp);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror("tcsetattr");
+        return -1;
+    }
+    return 0;
+}
+
+static void send_line(int fd, const char *cmd)
+{
+    // Enter previo: la UART puede estar despertando del light sleep
+    if (write(fd, "\n", 1) < 0 || write(fd, cmd, strlen(cmd)) < 0 || write(fd, "\n", 1) < 0) {
+        perror("write");
+    }
+    tcdrain(fd);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_record(FILE *out, int binary, const rawstream_rec_t *r)
+{
+    if (!binary) {
+        fprintf(out, "%u,%u,%u,%d\n", (unsigned)r->t_us, r->channel, r->seq, (int)r->value);
+        return;
+    }
+    uint8_t b[RAWSTREAM_PAYLOAD_LEN] = {
+        r->type, r->channel, (uint8_t)r->seq, (uint8_t)(r->seq >> 8),
+        (uint8_t)r->t_us, (uint8_t)(r->t_us >> 8), (uint8_t)(r->t_us >> 16),
+        (uint8_t)(r->t_us >> 24),
+        (uint8_t)r->value, (uint8_t)((uint32_t)r->value >> 8),
+        (uint8_t)((uint32_t)r->value >> 16), (uint8_t)((uint32_t)r->value >> 24),
+    };
+    fwrite(b, 1, sizeof(b), out);
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "uso: %s [-b baud] [-c comando] [-f csv|bin] [-o archivo] [-n registros] "
+            "[-t segundos] <puerto>\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    long baud = 921600;
+    const char *cmd = NULL;
+    const char *out_path = NULL;
+    int binary = 0;
+    long max_records = 0;
+    double idle_s = 0.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:c:f:o:n:t:")) != -1) {
+        switch (opt) {
+        case 'b': baud = strtol(optarg, NULL, 10); break;
+        case 'c': cmd = optarg; break;
+        case 'f': binary = strcmp(optarg, "bin") == 0; break;
+        case 'o': out_path = optarg; break;
+        case 'n': max_records = strtol(optarg, NULL, 10); break;
+        case 't': idle_s = strtod(optarg, NULL); break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[optind], O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (cmd != NULL) {
+        if (set_raw(fd, CONSOLE_BAUD) != 0) {
+            return 1;
+        }
+        send_line(fd, cmd);
+        usleep(100000);         // El nodo cambia de velocidad después de responder
+    }
+    if (set_raw(fd, baud) != 0) {
+        return 1;
+    }
+    if (cmd != NULL) {
+        tcflush(fd, TCIFLUSH);  // Eco y respuesta del comando a la velocidad anterior
+    }
+
+    FILE *out = stdout;
+    if (out_path != NULL) {
+        out = fopen(out_path, binary ? "wb" : "w");
+        if (out == NULL) {
+            perror(out_path);
+            return 1;
+        }
+    }
+    if (!binary) {
+        fprintf(out, "t_us,channel,seq,value\n");
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    rawstream_decoder_t dec;
+    rawstream_decoder_init(&dec);
+    uint8_t buf[4096];
+    long records = 0;
+    double last_data = now_s();
+    while (!s_stop && (max_records == 0 || records < max_records)) {
+        struct pollfd p = { .fd = fd, .events = POLLIN };
+        int pr = poll(&p, 1, 100);
+        if (pr < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+        ssize_t n = 0;
+        if (pr > 0) {
+            n = read(fd, buf, sizeof(buf));
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                break;          // Puerto desconectado (o el otro extremo del pty cerró)
+            }
+        }
+        if (n > 0) {
+            last_data = now_s();
+            for (ssize_t i = 0; i < n; i++) {
+                rawstream_rec_t rec;
+                if (rawstream_decoder_feed(&dec, buf[i], &rec)) {
+                    write_record(out, binary, &rec);
+                    if (max_records > 0 && ++records >= max_records) {
+                        break;
+                    }
+                }
+            }
+        } else if (idle_s > 0.0 && now_s() - last_data > idle_s) {
+            break;
+        }
+    }
+
+    if (cmd != NULL) {
+        send_line(fd, "stream off");
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    close(fd);
+
+    const rawstream_stats_t *st = &dec.stats;
+    fprintf(stderr, "frames=%u dropped=%u crc_errors=%u framing_errors=%u bytes=%u\n",
+            st->frames, st->dropped, st->crc_errors, st->framing_errors, st->bytes);
+    return 0;
+}
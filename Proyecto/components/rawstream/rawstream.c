@@ -0,0 +1,159 @@
+#include "rawstream.h"
+
+#include <string.h>
+
+uint16_t rawstream_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t rawstream_cobs_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t code_at = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] != 0) {
+            out[o++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    return o;
+}
+
+int rawstream_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t cap)
+{
+    size_t o = 0;
+    size_t i = 0;
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) {
+            return -1;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            if (in[i] == 0 || o >= cap) {
+                return -1;
+            }
+            out[o++] = in[i++];
+        }
+        // Un código < 0xFF implica un cero, salvo al final del bloque
+        if (code < 0xFF && i < len) {
+            if (o >= cap) {
+                return -1;
+            }
+            out[o++] = 0;
+        }
+    }
+    return (int)o;
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+size_t rawstream_encode(const rawstream_rec_t *rec, uint8_t out[RAWSTREAM_WIRE_MAX])
+{
+    uint8_t frame[RAWSTREAM_FRAME_LEN];
+    frame[0] = rec->type;
+    frame[1] = rec->channel;
+    put_u16(&frame[2], rec->seq);
+    put_u32(&frame[4], rec->t_us);
+    put_u32(&frame[8], (uint32_t)rec->value);
+    put_u16(&frame[12], rawstream_crc16(frame, RAWSTREAM_PAYLOAD_LEN));
+    size_t n = rawstream_cobs_encode(frame, sizeof(frame), out);
+    out[n++] = 0;
+    return n;
+}
+
+void rawstream_decoder_init(rawstream_decoder_t *d)
+{
+    memset(d, 0, sizeof(*d));
+}
+
+/** Trama completa (sin el 0x00) → registro, con las cuentas de error y huecos */
+static bool decode_frame(rawstream_decoder_t *d, rawstream_rec_t *out)
+{
+    uint8_t frame[RAWSTREAM_FRAME_LEN + 1];
+    int n = rawstream_cobs_decode(d->buf, d->len, frame, sizeof(frame));
+    if (n != RAWSTREAM_FRAME_LEN) {
+        d->stats.framing_errors++;
+        return false;
+    }
+    if (get_u16(&frame[12]) != rawstream_crc16(frame, RAWSTREAM_PAYLOAD_LEN)) {
+        d->stats.crc_errors++;
+        return false;
+    }
+    if (frame[0] != RAWSTREAM_REC_SAMPLE) {
+        d->stats.framing_errors++;
+        return false;
+    }
+    out->type = frame[0];
+    out->channel = frame[1];
+    out->seq = get_u16(&frame[2]);
+    out->t_us = get_u32(&frame[4]);
+    out->value = (int32_t)get_u32(&frame[8]);
+
+    if (d->have_seq) {
+        d->stats.dropped += (uint16_t)(out->seq - d->next_seq);
+    }
+    d->have_seq = true;
+    d->next_seq = (uint16_t)(out->seq + 1);
+    d->stats.frames++;
+    return true;
+}
+
+bool rawstream_decoder_feed(rawstream_decoder_t *d, uint8_t byte, rawstream_rec_t *out)
+{
+    d->stats.bytes++;
+    if (byte != 0) {
+        if (d->len < sizeof(d->buf)) {
+            d->buf[d->len++] = byte;
+        } else {
+            d->overflow = true;
+        }
+        return false;
+    }
+    // Delimitador: dos seguidos (o el primero de la conexión) no son una trama
+    bool ok = false;
+    if (d->overflow) {
+        d->stats.framing_errors++;
+    } else if (d->len > 0) {
+        ok = decode_frame(d, out);
+    }
+    d->len = 0;
+    d->overflow = false;
+    return ok;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Trama binaria de muestras crudas (compartida por Nodo_Cisterna y
+ * Calibrar_TDS) para ajustar filtros con datos a kHz en lugar de las líneas
+ * de log a 1 Hz.
+ *
+ * Registro de 12 bytes little-endian + CRC-16/CCITT-FALSE, enmarcado con
+ * COBS y terminado en 0x00: 16 bytes por muestra, ~5700 muestras/s a
+ * 921600 baud. Un byte perdido o una línea de log intercalada solo arruinan
+ * la trama en curso; el decodificador se resincroniza en el siguiente 0x00.
+ * El número de secuencia lo asigna el dispositivo al generar la muestra,
+ * también si después la descarta por cola llena, así el host cuenta tanto
+ * las tramas corruptas como las que nunca salieron.
+ *
+ * Este archivo es C puro: lo usan el firmware, las pruebas de host y el
+ * decodificador tools/rawstream_dump.c.
+ */
+
+#define RAWSTREAM_PAYLOAD_LEN  12
+#define RAWSTREAM_FRAME_LEN    (RAWSTREAM_PAYLOAD_LEN + 2)
+// COBS agrega un byte por cada 254; más el delimitador
+#define RAWSTREAM_WIRE_MAX     (RAWSTREAM_FRAME_LEN + 2)
+
+#define RAWSTREAM_REC_SAMPLE   1
+
+// Canales: ADC por número de canal, ecos por tanque
+#define RAWSTREAM_CH_ADC(ch)    ((uint8_t)(ch))
+#define RAWSTREAM_CH_ECHO(tank) ((uint8_t)(0x80 | (tank)))
+#define RAWSTREAM_CH_IS_ECHO(c) (((c) & 0x80) != 0)
+
+typedef struct {
+    uint8_t type;          // RAWSTREAM_REC_*
+    uint8_t channel;       // RAWSTREAM_CH_*
+    uint16_t seq;          // Consecutivo del dispositivo (vuelve a 0)
+    uint32_t t_us;         // esp_timer_get_time() truncado (vuelve a 0 cada ~71 min)
+    int32_t value;         // Código ADC o duración del eco en µs (-1: sin eco)
+} rawstream_rec_t;
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t frames;          // Registros válidos
+    uint32_t crc_errors;
+    uint32_t framing_errors;  // COBS inválido, largo incorrecto o tipo desconocido
+    uint32_t dropped;         // Huecos en la secuencia
+} rawstream_stats_t;
+
+typedef struct {
+    uint8_t buf[RAWSTREAM_WIRE_MAX];
+    uint16_t len;
+    bool overflow;
+    bool have_seq;
+    uint16_t next_seq;
+    rawstream_stats_t stats;
+} rawstream_decoder_t;
+
+/** @brief CRC-16/CCITT-FALSE (polinomio 0x1021, inicial 0xFFFF) */
+uint16_t rawstream_crc16(const uint8_t *data, size_t len);
+
+/** @brief COBS sin el delimitador; out debe tener len + len/254 + 1 bytes */
+size_t rawstream_cobs_encode(const uint8_t *in, size_t len, uint8_t *out);
+
+/** @brief Inverso de rawstream_cobs_encode(); -1 si la trama es inválida o no cabe */
+int rawstream_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t cap);
+
+/** @brief Registro → bytes en el cable (incluye el 0x00 final); devuelve el largo */
+size_t rawstream_encode(const rawstream_rec_t *rec, uint8_t out[RAWSTREAM_WIRE_MAX]);
+
+void rawstream_decoder_init(rawstream_decoder_t *d);
+
+/**
+ * @brief Entrega un byte recibido
+ * @return true si completó un registro válido (en *out)
+ */
+bool rawstream_decoder_feed(rawstream_decoder_t *d, uint8_t byte, rawstream_rec_t *out);
@@ -0,0 +1,144 @@
+#include "rawstream_uart.h"
+
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_vfs_dev.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+static const char *TAG = "rawstream";
+
+#define RAWSTREAM_UART       ((uart_port_t)CONFIG_RAWSTREAM_UART_NUM)
+#define RAWSTREAM_TASK_STACK 3072
+#define RAWSTREAM_TASK_PRIO  3
+#define RAWSTREAM_BATCH      32      // Muestras por uart_write_bytes()
+#define RAWSTREAM_STOP_MS    500     // Plazo para vaciar la cola al detener
+
+static QueueHandle_t s_queue = NULL;
+static TaskHandle_t s_task = NULL;
+static atomic_bool s_active;
+static atomic_uint s_seq;
+static atomic_uint s_sent;
+static atomic_uint s_dropped;
+static uint32_t s_prev_baud = 0;
+static vprintf_like_t s_prev_vprintf = NULL;
+
+/** Salida de logs durante la transmisión: se descarta sin tocar los niveles por tag */
+static int silent_vprintf(const char *fmt, va_list args)
+{
+    (void)fmt;
+    (void)args;
+    return 0;
+}
+
+static void writer_task(void *arg)
+{
+    (void)arg;
+    static uint8_t out[RAWSTREAM_BATCH * RAWSTREAM_WIRE_MAX];
+    while (1) {
+        rawstream_rec_t rec;
+        if (xQueueReceive(s_queue, &rec, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        // Un lote por escritura: menos llamadas al driver a kHz
+        size_t n = 0;
+        int count = 0;
+        do {
+            n += rawstream_encode(&rec, &out[n]);
+            count++;
+        } while (count < RAWSTREAM_BATCH && xQueueReceive(s_queue, &rec, 0) == pdTRUE);
+        uart_write_bytes(RAWSTREAM_UART, out, n);
+        atomic_fetch_add(&s_sent, (unsigned)count);
+    }
+}
+
+esp_err_t rawstream_start(uint32_t baud)
+{
+    if (atomic_load(&s_active)) {
+        return ESP_OK;
+    }
+    if (baud == 0) {
+        baud = CONFIG_RAWSTREAM_BAUD;
+    }
+    if (!uart_is_driver_installed(RAWSTREAM_UART)) {
+        esp_err_t ret = uart_driver_install(RAWSTREAM_UART, 256, 0, 0, NULL, 0);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "✗ uart_driver_install: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        esp_vfs_dev_uart_use_driver(RAWSTREAM_UART);
+    }
+    if (s_task == NULL) {
+        s_queue = xQueueCreate(CONFIG_RAWSTREAM_QUEUE_LEN, sizeof(rawstream_rec_t));
+        if (s_queue == NULL ||
+            xTaskCreate(writer_task, "rawstream", RAWSTREAM_TASK_STACK, NULL,
+                        RAWSTREAM_TASK_PRIO, &s_task) != pdPASS) {
+            ESP_LOGE(TAG, "✗ Sin memoria para la cola/tarea");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    uart_get_baudrate(RAWSTREAM_UART, &s_prev_baud);
+    ESP_LOGI(TAG, "→ Transmitiendo a %" PRIu32 " baud (enviar \"stream off\" para volver a "
+             "%" PRIu32 ")", baud, s_prev_baud);
+    uart_wait_tx_done(RAWSTREAM_UART, pdMS_TO_TICKS(100));
+    s_prev_vprintf = esp_log_set_vprintf(silent_vprintf);
+    uart_set_baudrate(RAWSTREAM_UART, baud);
+    // Delimitador suelto: lo que quedó en el receptor del host no se come el primer registro
+    const uint8_t sync = 0;
+    uart_write_bytes(RAWSTREAM_UART, &sync, 1);
+    atomic_store(&s_active, true);
+    return ESP_OK;
+}
+
+esp_err_t rawstream_stop(void)
+{
+    if (!atomic_exchange(&s_active, false)) {
+        return ESP_OK;
+    }
+    for (int waited = 0; uxQueueMessagesWaiting(s_queue) > 0 && waited < RAWSTREAM_STOP_MS;
+         waited += 10) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    uart_wait_tx_done(RAWSTREAM_UART, pdMS_TO_TICKS(100));
+    uart_set_baudrate(RAWSTREAM_UART, s_prev_baud);
+    esp_log_set_vprintf(s_prev_vprintf);
+    ESP_LOGI(TAG, "✓ Transmisión detenida");
+    rawstream_print_stats();
+    return ESP_OK;
+}
+
+bool rawstream_active(void)
+{
+    return atomic_load(&s_active);
+}
+
+void rawstream_push(uint8_t channel, int32_t value, int64_t t_us)
+{
+    if (!atomic_load(&s_active)) {
+        return;
+    }
+    rawstream_rec_t rec = {
+        .type = RAWSTREAM_REC_SAMPLE,
+        .channel = channel,
+        .seq = (uint16_t)atomic_fetch_add(&s_seq, 1),
+        .t_us = (uint32_t)t_us,
+        .value = value,
+    };
+    // La secuencia ya avanzó: una muestra descartada es un hueco para el host
+    if (xQueueSend(s_queue, &rec, 0) != pdTRUE) {
+        atomic_fetch_add(&s_dropped, 1);
+    }
+}
+
+void rawstream_print_stats(void)
+{
+    ESP_LOGI(TAG, "rawstream: %s, %u enviadas, %u descartadas (cola llena)",
+             atomic_load(&s_active) ? "activo" : "inactivo", atomic_load(&s_sent),
+             atomic_load(&s_dropped));
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rawstream.h"
+
+/**
+ * Transmisión de rawstream por UART.
+ *
+ * rawstream_push() nunca bloquea: encola la muestra (o la descarta y la
+ * cuenta si la cola está llena) y una tarea la codifica y la escribe en
+ * lotes. Mientras transmite, la UART pasa a CONFIG_RAWSTREAM_BAUD y la
+ * salida de los logs se descarta para no mezclar texto con la trama; los
+ * niveles por tag no cambian.
+ */
+
+/**
+ * @brief Empieza a transmitir (baud 0: CONFIG_RAWSTREAM_BAUD). Instala el
+ * driver de la UART si la aplicación no lo hizo (la consola por stdin sigue
+ * funcionando).
+ */
+esp_err_t rawstream_start(uint32_t baud);
+
+/** @brief Vacía la cola, restaura la velocidad anterior y la salida de los logs */
+esp_err_t rawstream_stop(void);
+
+bool rawstream_active(void);
+
+/** @brief Encola una muestra si la transmisión está activa (cualquier tarea) */
+void rawstream_push(uint8_t channel, int32_t value, int64_t t_us);
+
+/** @brief Muestras enviadas y descartadas desde el arranque */
+void rawstream_print_stats(void);
@@ -0,0 +1,138 @@
+#include "tank_geometry.h"
+
+#include <math.h>
+#include <string.h>
+
+#define TANK_PI 3.14159265f
+
+const char *tank_geometry_shape_name(tank_shape_t shape)
+{
+    switch (shape) {
+        case TANK_SHAPE_CYLINDER_V: return "cilindro-v";
+        case TANK_SHAPE_CYLINDER_H: return "cilindro-h";
+        case TANK_SHAPE_RECT:       return "rect";
+        case TANK_SHAPE_TABLE:      return "tabla";
+    }
+    return "?";
+}
+
+static bool cfg_valid(const tank_geometry_cfg_t *cfg)
+{
+    if (!(cfg->sensor_height_cm > 0.0f) || !(cfg->max_level_cm > 0.0f) ||
+        cfg->max_level_cm > cfg->sensor_height_cm) {
+        return false;
+    }
+    switch (cfg->shape) {
+        case TANK_SHAPE_CYLINDER_V:
+            return cfg->diameter_cm > 0.0f;
+        case TANK_SHAPE_CYLINDER_H:
+            return cfg->diameter_cm > 0.0f && cfg->length_cm > 0.0f &&
+                   cfg->max_level_cm <= cfg->diameter_cm;
+        case TANK_SHAPE_RECT:
+            return cfg->length_cm > 0.0f && cfg->width_cm > 0.0f;
+        case TANK_SHAPE_TABLE:
+            if (cfg->table_count < 2 || cfg->table_count > TANK_GEOM_TABLE_MAX) {
+                return false;
+            }
+            for (int i = 0; i < cfg->table_count; i++) {
+                if (cfg->table_level_cm[i] < 0.0f || cfg->table_liters[i] < 0.0f) {
+                    return false;
+                }
+                if (i > 0 && (cfg->table_level_cm[i] <= cfg->table_level_cm[i - 1] ||
+                              cfg->table_liters[i] < cfg->table_liters[i - 1])) {
+                    return false;
+                }
+            }
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Volumen exacto para un nivel (solo al construir la tabla)
+ */
+static float volume_at_level(const tank_geometry_cfg_t *cfg, float h)
+{
+    switch (cfg->shape) {
+        case TANK_SHAPE_CYLINDER_V: {
+            float r = cfg->diameter_cm / 2.0f;
+            return TANK_PI * r * r * h / 1000.0f;
+        }
+        case TANK_SHAPE_CYLINDER_H: {
+            // Área del segmento circular de altura h por el largo
+            float r = cfg->diameter_cm / 2.0f;
+            float c = (r - h) / r;
+            if (c > 1.0f) c = 1.0f;
+            if (c < -1.0f) c = -1.0f;
+            float chord = 2.0f * h * r - h * h;
+            float area = r * r * acosf(c) - (r - h) * sqrtf(chord > 0.0f ? chord : 0.0f);
+            return area * cfg->length_cm / 1000.0f;
+        }
+        case TANK_SHAPE_RECT:
+            return cfg->length_cm * cfg->width_cm * h / 1000.0f;
+        case TANK_SHAPE_TABLE: {
+            // Interpolación lineal entre puntos de aforo; bajo el primero se
+            // asume una recta desde (0, 0)
+            const float *lv = cfg->table_level_cm;
+            const float *li = cfg->table_liters;
+            int n = cfg->table_count;
+            if (h <= lv[0]) {
+                return lv[0] > 0.0f ? li[0] * h / lv[0] : li[0];
+            }
+            for (int i = 1; i < n; i++) {
+                if (h <= lv[i]) {
+                    float f = (h - lv[i - 1]) / (lv[i] - lv[i - 1]);
+                    return li[i - 1] + f * (li[i] - li[i - 1]);
+                }
+            }
+            return li[n - 1];
+        }
+    }
+    return 0.0f;
+}
+
+esp_err_t tank_geometry_build(tank_geometry_t *tg, const tank_geometry_cfg_t *cfg)
+{
+    if (tg == NULL || cfg == NULL || !cfg_valid(cfg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    tg->cfg = *cfg;
+    float step = cfg->sensor_height_cm / (float)(TANK_GEOM_LUT_SIZE - 1);
+    tg->inv_step = 1.0f / step;
+    for (int i = 0; i < TANK_GEOM_LUT_SIZE; i++) {
+        tg->lut_liters[i] = volume_at_level(cfg, tank_geometry_level_cm(tg, (float)i * step));
+    }
+    return ESP_OK;
+}
+
+float tank_geometry_level_cm(const tank_geometry_t *tg, float distance_cm)
+{
+    float h = tg->cfg.sensor_height_cm - distance_cm;
+    if (h < 0.0f) {
+        return 0.0f;
+    }
+    if (h > tg->cfg.max_level_cm) {
+        return tg->cfg.max_level_cm;
+    }
+    return h;
+}
+
+float tank_geometry_liters(const tank_geometry_t *tg, float distance_cm)
+{
+    float pos = distance_cm * tg->inv_step;
+    if (!(pos > 0.0f)) {
+        return tg->lut_liters[0];
+    }
+    if (pos >= (float)(TANK_GEOM_LUT_SIZE - 1)) {
+        return tg->lut_liters[TANK_GEOM_LUT_SIZE - 1];
+    }
+    int i = (int)pos;
+    float f = pos - (float)i;
+    return tg->lut_liters[i] + f * (tg->lut_liters[i + 1] - tg->lut_liters[i]);
+}
+
+float tank_geometry_capacity_liters(const tank_geometry_t *tg)
+{
+    return tg->lut_liters[0];
+}
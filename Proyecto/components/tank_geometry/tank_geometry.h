@@ -0,0 +1,119 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+/**
+ * Geometría del tanque: convierte la distancia medida por el sensor
+ * ultrasónico (desde el sensor hasta el agua) en nivel y volumen.
+ *
+ * Al configurar se precalcula una tabla densa distancia → litros con
+ * TANK_GEOM_LUT_SIZE puntos equiespaciados entre 0 y la altura del sensor;
+ * cada muestra se convierte luego con una interpolación O(1), sin importar
+ * la forma del tanque (incluida la trigonometría del cilindro horizontal o
+ * una tabla de aforo arbitraria).
+ *
+ * Cada tanque del nodo (índice 0..TANK_GEOM_MAX_TANKS-1, el mismo de la
+ * tabla de tanques de sensor.h) tiene su propia geometría y su clave en NVS.
+ *
+ * Componente compartido por Nodo_Cisterna y Node_Tank
+ * (EXTRA_COMPONENT_DIRS = Proyecto/components).
+ */
+
+#define TANK_GEOM_LUT_SIZE     256
+#define TANK_GEOM_TABLE_MAX    16
+#ifdef CONFIG_TANK_GEOM_MAX_TANKS
+#define TANK_GEOM_MAX_TANKS    CONFIG_TANK_GEOM_MAX_TANKS
+#else
+#define TANK_GEOM_MAX_TANKS    4
+#endif
+
+typedef enum {
+    TANK_SHAPE_CYLINDER_V = 0,   // Cilindro vertical (tinaco)
+    TANK_SHAPE_CYLINDER_H,       // Cilindro horizontal (la sección varía con el nivel)
+    TANK_SHAPE_RECT,             // Prisma rectangular (cisterna de obra)
+    TANK_SHAPE_TABLE,            // Tabla de aforo nivel → litros
+} tank_shape_t;
+
+typedef struct {
+    tank_shape_t shape;
+    float sensor_height_cm;      // Distancia del sensor al fondo del tanque
+    float max_level_cm;          // Nivel de rebose (el volumen se satura aquí)
+    float diameter_cm;           // Cilindros
+    float length_cm;             // Rectangular y cilindro horizontal
+    float width_cm;              // Rectangular
+    uint8_t table_count;         // Tabla de aforo: puntos con nivel creciente
+    float table_level_cm[TANK_GEOM_TABLE_MAX];
+    float table_liters[TANK_GEOM_TABLE_MAX];
+} tank_geometry_cfg_t;
+
+typedef struct {
+    tank_geometry_cfg_t cfg;
+    float inv_step;              // Índices de tabla por cm de distancia
+    float lut_liters[TANK_GEOM_LUT_SIZE];
+} tank_geometry_t;
+
+// ========== Núcleo (C puro, probado en el host) ==========
+
+/**
+ * @brief Valida la configuración y precalcula la tabla distancia → litros
+ * @return ESP_ERR_INVALID_ARG si las dimensiones o la tabla no son coherentes
+ */
+esp_err_t tank_geometry_build(tank_geometry_t *tg, const tank_geometry_cfg_t *cfg);
+
+/**
+ * @brief Nivel de agua (cm sobre el fondo) para una distancia medida
+ */
+float tank_geometry_level_cm(const tank_geometry_t *tg, float distance_cm);
+
+/**
+ * @brief Volumen en litros para una distancia medida (O(1))
+ */
+float tank_geometry_liters(const tank_geometry_t *tg, float distance_cm);
+
+/**
+ * @brief Volumen con el tanque lleno hasta max_level_cm
+ */
+float tank_geometry_capacity_liters(const tank_geometry_t *tg);
+
+const char *tank_geometry_shape_name(tank_shape_t shape);
+
+// ========== Geometría activa por tanque, persistida en NVS (ESP-IDF) ==========
+
+/**
+ * @brief Carga la configuración del tanque de NVS (o usa `defaults`) y construye la tabla
+ *
+ * Requiere nvs_flash_init() previo. Una configuración inválida en NVS se
+ * ignora con un aviso. El tanque 0 usa la clave "cfg" (la de las versiones
+ * con un solo tanque); el resto "cfg1", "cfg2"...
+ *
+ * @return ESP_ERR_INVALID_ARG si tank está fuera de rango o defaults es inválido
+ */
+esp_err_t tank_geometry_load(int tank, const tank_geometry_cfg_t *defaults);
+
+/**
+ * @brief Reconstruye la tabla del tanque con una nueva configuración y la guarda en NVS
+ *
+ * La tabla nueva se arma fuera de la sección crítica y se publica con un
+ * intercambio de puntero, así las conversiones en curso no se bloquean.
+ */
+esp_err_t tank_geometry_apply(int tank, const tank_geometry_cfg_t *cfg);
+
+/**
+ * @brief Copia la configuración activa del tanque (en cero si no hay)
+ */
+void tank_geometry_get_cfg(int tank, tank_geometry_cfg_t *cfg);
+
+/**
+ * @brief Convierte una distancia con la geometría activa del tanque
+ * @return false si el tanque no tiene geometría cargada o la distancia es inválida
+ */
+bool tank_geometry_convert(int tank, float distance_cm, float *level_cm, float *liters);
+
+/**
+ * @brief Imprime la configuración activa del tanque y la capacidad
+ */
+void tank_geometry_print(int tank);
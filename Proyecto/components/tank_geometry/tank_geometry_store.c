@@ -0,0 +1,195 @@
+#include "tank_geometry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "tank_geom";
+
+#define TANK_GEOM_NVS_NAMESPACE "tank_geom"
+#define TANK_GEOM_NVS_KEY       "cfg"      // Tanque 0; el resto "cfg<n>"
+#define TANK_GEOM_NVS_VERSION   1
+
+typedef struct {
+    uint32_t version;
+    tank_geometry_cfg_t cfg;
+} tank_geometry_blob_t;
+
+// Doble buffer por tanque: se construye en el inactivo y se publica cambiando el puntero
+static tank_geometry_t s_geom[TANK_GEOM_MAX_TANKS][2];
+static tank_geometry_t *s_active[TANK_GEOM_MAX_TANKS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static bool tank_valid(int tank)
+{
+    return tank >= 0 && tank < TANK_GEOM_MAX_TANKS;
+}
+
+static void nvs_key(int tank, char *key, size_t len)
+{
+    if (tank == 0) {
+        snprintf(key, len, "%s", TANK_GEOM_NVS_KEY);
+    } else {
+        snprintf(key, len, "%s%d", TANK_GEOM_NVS_KEY, tank);
+    }
+}
+
+static esp_err_t publish(int tank, const tank_geometry_cfg_t *cfg)
+{
+    tank_geometry_t *next = (s_active[tank] == &s_geom[tank][0]) ? &s_geom[tank][1]
+                                                                 : &s_geom[tank][0];
+    esp_err_t ret = tank_geometry_build(next, cfg);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    taskENTER_CRITICAL(&s_lock);
+    s_active[tank] = next;
+    taskEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+static esp_err_t save_cfg(int tank, const tank_geometry_cfg_t *cfg)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(TANK_GEOM_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    char key[8];
+    nvs_key(tank, key, sizeof(key));
+    tank_geometry_blob_t blob = { .version = TANK_GEOM_NVS_VERSION, .cfg = *cfg };
+    ret = nvs_set_blob(handle, key, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+esp_err_t tank_geometry_load(int tank, const tank_geometry_cfg_t *defaults)
+{
+    if (!tank_valid(tank) || defaults == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    tank_geometry_blob_t blob;
+    size_t len = sizeof(blob);
+    bool from_nvs = false;
+    char key[8];
+    nvs_key(tank, key, sizeof(key));
+
+    nvs_handle_t handle;
+    if (nvs_open(TANK_GEOM_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        if (nvs_get_blob(handle, key, &blob, &len) == ESP_OK &&
+            len == sizeof(blob) && blob.version == TANK_GEOM_NVS_VERSION) {
+            from_nvs = true;
+        }
+        nvs_close(handle);
+    }
+
+    if (from_nvs && publish(tank, &blob.cfg) == ESP_OK) {
+        ESP_LOGI(TAG, "✓ Tanque %d: geometría cargada de NVS (%s)", tank,
+                 tank_geometry_shape_name(blob.cfg.shape));
+        return ESP_OK;
+    }
+    if (from_nvs) {
+        ESP_LOGW(TAG, "⚠ Tanque %d: geometría en NVS inválida, usando valores por defecto", tank);
+    }
+
+    esp_err_t ret = publish(tank, defaults);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Tanque %d: geometría por defecto inválida", tank);
+        return ret;
+    }
+    ESP_LOGI(TAG, "✓ Tanque %d: geometría por defecto (%s)", tank,
+             tank_geometry_shape_name(defaults->shape));
+    return ESP_OK;
+}
+
+esp_err_t tank_geometry_apply(int tank, const tank_geometry_cfg_t *cfg)
+{
+    if (!tank_valid(tank)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = publish(tank, cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Tanque %d: configuración de geometría inválida", tank);
+        return ret;
+    }
+    ret = save_cfg(tank, cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠ Tanque %d: geometría aplicada pero no guardada en NVS: %s", tank,
+                 esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "✓ Tanque %d: geometría aplicada y guardada (%s)", tank,
+             tank_geometry_shape_name(cfg->shape));
+    return ESP_OK;
+}
+
+void tank_geometry_get_cfg(int tank, tank_geometry_cfg_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    if (!tank_valid(tank)) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_lock);
+    if (s_active[tank] != NULL) {
+        *cfg = s_active[tank]->cfg;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+bool tank_geometry_convert(int tank, float distance_cm, float *level_cm, float *liters)
+{
+    if (!tank_valid(tank) || distance_cm < 0.0f) {
+        return false;
+    }
+    bool ok = false;
+    taskENTER_CRITICAL(&s_lock);
+    const tank_geometry_t *tg = s_active[tank];
+    if (tg != NULL) {
+        if (level_cm) {
+            *level_cm = tank_geometry_level_cm(tg, distance_cm);
+        }
+        if (liters) {
+            *liters = tank_geometry_liters(tg, distance_cm);
+        }
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    return ok;
+}
+
+void tank_geometry_print(int tank)
+{
+    tank_geometry_cfg_t cfg;
+    tank_geometry_get_cfg(tank, &cfg);
+    if (cfg.sensor_height_cm <= 0.0f) {
+        ESP_LOGI(TAG, "Tanque %d: sin geometría cargada", tank);
+        return;
+    }
+    float capacity = 0.0f;
+    tank_geometry_convert(tank, 0.0f, NULL, &capacity);
+    ESP_LOGI(TAG, "Tanque %d: %s | sensor a %.1f cm del fondo | rebose %.1f cm | capacidad %.1f L",
+             tank, tank_geometry_shape_name(cfg.shape), cfg.sensor_height_cm, cfg.max_level_cm,
+             capacity);
+    switch (cfg.shape) {
+        case TANK_SHAPE_CYLINDER_V:
+            ESP_LOGI(TAG, "Diámetro %.1f cm", cfg.diameter_cm);
+            break;
+        case TANK_SHAPE_CYLINDER_H:
+            ESP_LOGI(TAG, "Diámetro %.1f cm | largo %.1f cm", cfg.diameter_cm, cfg.length_cm);
+            break;
+        case TANK_SHAPE_RECT:
+            ESP_LOGI(TAG, "Largo %.1f cm | ancho %.1f cm", cfg.length_cm, cfg.width_cm);
+            break;
+        case TANK_SHAPE_TABLE:
+            for (int i = 0; i < cfg.table_count; i++) {
+                ESP_LOGI(TAG, "  %6.1f cm → %8.1f L", cfg.table_level_cm[i], cfg.table_liters[i]);
+            }
+            break;
+    }
+}
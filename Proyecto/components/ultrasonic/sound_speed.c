@@ -0,0 +1,69 @@
+#include "sound_speed.h"
+
+/*
+ * round(331.3 · √(1 + T/273.15) / 2 · 65536) para T = -20 … 60 °C.
+ * Generada con:
+ *   [round(331.3*math.sqrt(1+t/273.15)/2*65536) for t in range(-20, 61)]
+ */
+static const uint32_t s_um_per_us_q16[] = {
+    10451045, 10471667, 10492248, 10512789, 10533290, 10553751,
+    10574172, 10594554, 10614897, 10635201, 10655466, 10675693,
+    10695882, 10716032, 10736145, 10756220, 10776258, 10796258,
+    10816222, 10836148, 10856038, 10875892, 10895710, 10915491,
+    10935237, 10954947, 10974622, 10994262, 11013867, 11033436,
+    11052972, 11072472, 11091939, 11111371, 11130769, 11150134,
+    11169465, 11188763, 11208027, 11227258, 11246457, 11265623,
+    11284756, 11303857, 11322925, 11341962, 11360966, 11379939,
+    11398881, 11417790, 11436669, 11455517, 11474333, 11493119,
+    11511874, 11530599, 11549293, 11567957, 11586591, 11605195,
+    11623769, 11642314, 11660829, 11679315, 11697771, 11716199,
+    11734597, 11752967, 11771308, 11789621, 11807905, 11826161,
+    11844389, 11862588, 11880760, 11898904, 11917021, 11935110,
+    11953171, 11971206, 11989213,
+};
+
+#define SOUND_SPEED_TABLE_LEN (sizeof(s_um_per_us_q16) / sizeof(s_um_per_us_q16[0]))
+
+static uint32_t factor_for(int16_t temp_dc)
+{
+    if (temp_dc <= SOUND_SPEED_TEMP_MIN_DC) {
+        return s_um_per_us_q16[0];
+    }
+    if (temp_dc >= SOUND_SPEED_TEMP_MAX_DC) {
+        return s_um_per_us_q16[SOUND_SPEED_TABLE_LEN - 1];
+    }
+    // Índice entero de °C y fracción en décimas
+    int32_t off = temp_dc - SOUND_SPEED_TEMP_MIN_DC;
+    int32_t i = off / 10;
+    int32_t frac = off % 10;
+    uint32_t a = s_um_per_us_q16[i];
+    uint32_t b = s_um_per_us_q16[i + 1];
+    return a + (uint32_t)(((b - a) * (uint32_t)frac + 5) / 10);
+}
+
+void sound_speed_init(sound_speed_t *ss, int16_t temp_dc)
+{
+    ss->temp_dc = temp_dc;
+    ss->um_per_us_q16 = factor_for(temp_dc);
+    ss->updates = 0;
+}
+
+bool sound_speed_set_temp_dc(sound_speed_t *ss, int16_t temp_dc)
+{
+    if (temp_dc == ss->temp_dc) {
+        return false;
+    }
+    ss->temp_dc = temp_dc;
+    uint32_t f = factor_for(temp_dc);
+    if (f == ss->um_per_us_q16) {
+        return false;
+    }
+    ss->um_per_us_q16 = f;
+    ss->updates++;
+    return true;
+}
+
+uint32_t sound_speed_um_to_echo_us(const sound_speed_t *ss, uint32_t distance_um)
+{
+    return (uint32_t)((((uint64_t)distance_um << 16) + ss->um_per_us_q16 / 2) / ss->um_per_us_q16);
+}
@@ -0,0 +1,246 @@
+#include <string.h>
+
+#include "ultrasonic_priv.h"
+
+static struct ultrasonic_s s_pool[ULTRASONIC_MAX_INSTANCES];
+
+static bool pin_in_use(int gpio)
+{
+    for (int i = 0; i < ULTRASONIC_MAX_INSTANCES; i++) {
+        if (s_pool[i].used &&
+            (s_pool[i].cfg.trig_gpio == gpio || s_pool[i].cfg.echo_gpio == gpio)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t ultrasonic_create(const ultrasonic_config_t *cfg, ultrasonic_handle_t *out)
+{
+    if (cfg == NULL || out == NULL || cfg->trig_gpio < 0 || cfg->echo_gpio < 0 ||
+        cfg->trig_gpio == cfg->echo_gpio || cfg->rise_timeout_us == 0 ||
+        cfg->echo_timeout_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pin_in_use(cfg->trig_gpio) || pin_in_use(cfg->echo_gpio)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    struct ultrasonic_s *us = NULL;
+    for (int i = 0; i < ULTRASONIC_MAX_INSTANCES; i++) {
+        if (!s_pool[i].used) {
+            us = &s_pool[i];
+            memset(us, 0, sizeof(*us));
+            us->index = (uint8_t)i;
+            break;
+        }
+    }
+    if (us == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    us->cfg = *cfg;
+    us->state = ULTRASONIC_IDLE;
+    sound_speed_init(&us->sound, cfg->temp_dc);
+
+    esp_err_t ret = ultrasonic_port_attach(us);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    us->used = true;
+    *out = us;
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_delete(ultrasonic_handle_t h)
+{
+    if (h == NULL || !h->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ultrasonic_port_detach(h);
+    h->used = false;
+    return ESP_OK;
+}
+
+uint32_t ultrasonic_guard_remaining_us(ultrasonic_handle_t h)
+{
+    if (h->state == ULTRASONIC_IN_FLIGHT) {
+        // Lo que resta del plazo más la guarda: cota superior
+        int64_t left = h->start_us + h->cfg.rise_timeout_us + h->cfg.echo_timeout_us +
+                       h->cfg.guard_us - ultrasonic_port_now_us();
+        return left > 0 ? (uint32_t)left : 0;
+    }
+    if (h->last_end_us == 0) {
+        return 0;
+    }
+    int64_t left = h->last_end_us + h->cfg.guard_us - ultrasonic_port_now_us();
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+esp_err_t ultrasonic_trigger(ultrasonic_handle_t h)
+{
+    if (h == NULL || !h->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (h->state == ULTRASONIC_IN_FLIGHT || ultrasonic_guard_remaining_us(h) > 0) {
+        ultrasonic_port_lock();
+        h->stats.busy_rejects++;
+        ultrasonic_port_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    h->rise_us = 0;
+    h->fall_us = 0;
+    h->state = ULTRASONIC_IN_FLIGHT;
+    ultrasonic_port_trigger(h);
+
+    ultrasonic_port_lock();
+    h->stats.pings++;
+    ultrasonic_port_unlock();
+    return ESP_OK;
+}
+
+/**
+ * @brief Cierra el ping en vuelo y actualiza las estadísticas
+ */
+static esp_err_t finish(struct ultrasonic_s *us, esp_err_t result, int64_t end_us,
+                        ultrasonic_reading_t *reading)
+{
+    uint32_t echo = 0;
+    bool rise_seen = (us->rise_us != 0);
+    if (result == ESP_OK) {
+        echo = (uint32_t)(us->fall_us - us->rise_us);
+    }
+
+    us->state = ULTRASONIC_IDLE;
+    us->last_end_us = end_us;
+
+    uint32_t latency = (uint32_t)(end_us - us->start_us);
+    ultrasonic_port_lock();
+    if (result == ESP_OK) {
+        us->stats.echoes++;
+        us->stats.last_echo_us = echo;
+        us->latency_sum_us += latency;
+        if (latency > us->stats.latency_max_us) {
+            us->stats.latency_max_us = latency;
+        }
+    } else if (rise_seen) {
+        us->stats.echo_timeouts++;
+    } else {
+        us->stats.rise_timeouts++;
+    }
+    ultrasonic_port_unlock();
+
+    if (reading) {
+        reading->echo_us = echo;
+        reading->distance_um = echo ? sound_speed_echo_to_um(&us->sound, echo) : 0;
+        reading->trigger_us = us->start_us;
+        reading->end_us = end_us;
+        reading->rise_seen = rise_seen;
+    }
+    return result;
+}
+
+esp_err_t ultrasonic_poll(ultrasonic_handle_t h, ultrasonic_reading_t *reading)
+{
+    if (h == NULL || !h->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (h->state != ULTRASONIC_IN_FLIGHT) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ultrasonic_port_sync(h);
+    int64_t rise = h->rise_us;
+    int64_t fall = h->fall_us;
+    int64_t rise_deadline = h->start_us + h->cfg.rise_timeout_us;
+
+    if (rise != 0 && rise > rise_deadline) {
+        // Subida tardía: no es respuesta a este disparo
+        h->rise_us = 0;
+        return finish(h, ESP_ERR_TIMEOUT, rise, reading);
+    }
+    if (fall != 0) {
+        if ((uint64_t)(fall - rise) > h->cfg.echo_timeout_us) {
+            return finish(h, ESP_ERR_TIMEOUT, rise + h->cfg.echo_timeout_us, reading);
+        }
+        return finish(h, ESP_OK, fall, reading);
+    }
+
+    int64_t now = ultrasonic_port_now_us();
+    if (rise == 0 && now > rise_deadline) {
+        return finish(h, ESP_ERR_TIMEOUT, rise_deadline, reading);
+    }
+    if (rise != 0 && now > rise + h->cfg.echo_timeout_us) {
+        return finish(h, ESP_ERR_TIMEOUT, rise + h->cfg.echo_timeout_us, reading);
+    }
+    return ESP_ERR_NOT_FINISHED;
+}
+
+esp_err_t ultrasonic_wait(ultrasonic_handle_t h, ultrasonic_reading_t *reading)
+{
+    esp_err_t ret;
+    while ((ret = ultrasonic_poll(h, reading)) == ESP_ERR_NOT_FINISHED) {
+        // Plazo vigente: hasta la subida o, si ya subió, hasta el fin del eco
+        int64_t deadline = h->rise_us ? h->rise_us + h->cfg.echo_timeout_us
+                                      : h->start_us + h->cfg.rise_timeout_us;
+        ultrasonic_port_wait_edge(h, deadline + 1);
+    }
+    return ret;
+}
+
+esp_err_t ultrasonic_measure(ultrasonic_handle_t h, ultrasonic_reading_t *reading)
+{
+    if (h == NULL || !h->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (h->state == ULTRASONIC_IN_FLIGHT) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t guard = ultrasonic_guard_remaining_us(h);
+    if (guard > 0) {
+        ultrasonic_port_sleep_us(guard);
+    }
+    esp_err_t ret = ultrasonic_trigger(h);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return ultrasonic_wait(h, reading);
+}
+
+bool ultrasonic_set_temp_dc(ultrasonic_handle_t h, int16_t temp_dc)
+{
+    return sound_speed_set_temp_dc(&h->sound, temp_dc);
+}
+
+int16_t ultrasonic_get_temp_dc(ultrasonic_handle_t h)
+{
+    return h->sound.temp_dc;
+}
+
+uint32_t ultrasonic_echo_to_um(ultrasonic_handle_t h, uint32_t echo_us)
+{
+    return sound_speed_echo_to_um(&h->sound, echo_us);
+}
+
+void ultrasonic_get_stats(ultrasonic_handle_t h, ultrasonic_stats_t *stats)
+{
+    if (h == NULL || stats == NULL) {
+        return;
+    }
+    ultrasonic_port_lock();
+    *stats = h->stats;
+    stats->latency_avg_us = h->stats.echoes ? (uint32_t)(h->latency_sum_us / h->stats.echoes) : 0;
+    ultrasonic_port_unlock();
+}
+
+void ultrasonic_reset_stats(ultrasonic_handle_t h)
+{
+    if (h == NULL) {
+        return;
+    }
+    ultrasonic_port_lock();
+    memset(&h->stats, 0, sizeof(h->stats));
+    h->latency_sum_us = 0;
+    ultrasonic_port_unlock();
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * Driver HC-SR04 compartido por Nodo_Cisterna y Node_Tank.
+ *
+ * Cada instancia es un par TRIG/ECHO tomado de un arreglo estático. La
+ * medición no bloquea: ultrasonic_trigger() dispara y retorna, los flancos
+ * del eco los marca una ISR y ultrasonic_poll() entrega el resultado cuando
+ * está listo. ultrasonic_wait()/ultrasonic_measure() son las variantes
+ * bloqueantes (semáforo, sin busy-wait).
+ *
+ * El backend se elige al compilar: GPIO/ISR (ultrasonic_port_gpio.c) o el
+ * modelo simulado con reloj virtual (ultrasonic_port_sim.c,
+ * CONFIG_ULTRASONIC_SIMULATED) que usan las pruebas de host.
+ */
+
+#ifdef CONFIG_ULTRASONIC_MAX_INSTANCES
+#define ULTRASONIC_MAX_INSTANCES    CONFIG_ULTRASONIC_MAX_INSTANCES
+#define ULTRASONIC_RISE_TIMEOUT_US  CONFIG_ULTRASONIC_RISE_TIMEOUT_US
+#define ULTRASONIC_ECHO_TIMEOUT_US  CONFIG_ULTRASONIC_ECHO_TIMEOUT_US
+#define ULTRASONIC_GUARD_US         CONFIG_ULTRASONIC_GUARD_US
+#else
+// Valores por defecto fuera de ESP-IDF (pruebas de host)
+#define ULTRASONIC_MAX_INSTANCES    4
+#define ULTRASONIC_RISE_TIMEOUT_US  30000
+#define ULTRASONIC_ECHO_TIMEOUT_US  40000
+#define ULTRASONIC_GUARD_US         60000
+#endif
+
+#define ULTRASONIC_TRIG_PULSE_US    10
+
+typedef struct {
+    int trig_gpio;
+    int echo_gpio;
+    uint32_t rise_timeout_us;    // Disparo → ECHO alto
+    uint32_t echo_timeout_us;    // Duración máxima del eco
+    uint32_t guard_us;           // Mínimo entre el fin de un ping y el siguiente disparo
+    int16_t temp_dc;             // Temperatura inicial del aire (décimas de °C)
+} ultrasonic_config_t;
+
+#define ULTRASONIC_CONFIG_DEFAULT(trig, echo) {      \
+        .trig_gpio = (trig),                         \
+        .echo_gpio = (echo),                         \
+        .rise_timeout_us = ULTRASONIC_RISE_TIMEOUT_US, \
+        .echo_timeout_us = ULTRASONIC_ECHO_TIMEOUT_US, \
+        .guard_us = ULTRASONIC_GUARD_US,             \
+        .temp_dc = 200,                              \
+    }
+
+typedef struct ultrasonic_s *ultrasonic_handle_t;
+
+typedef struct {
+    uint32_t echo_us;            // Duración del eco (0 si hubo timeout)
+    uint32_t distance_um;        // Distancia compensada por temperatura
+    int64_t trigger_us;          // Disparo (reloj del backend)
+    int64_t end_us;              // Flanco de bajada o vencimiento del plazo
+    bool rise_seen;              // En timeout: si llegó el flanco de subida
+} ultrasonic_reading_t;
+
+typedef struct {
+    uint32_t pings;
+    uint32_t echoes;
+    uint32_t rise_timeouts;      // ECHO nunca subió (sensor ausente o desconectado)
+    uint32_t echo_timeouts;      // ECHO subió pero no bajó a tiempo (sin objeto)
+    uint32_t busy_rejects;       // Disparos rechazados (en vuelo o en guarda)
+    uint32_t last_echo_us;
+    uint32_t latency_avg_us;     // Disparo → fin del eco, solo ecos válidos
+    uint32_t latency_max_us;
+} ultrasonic_stats_t;
+
+/**
+ * @brief Crea una instancia y configura sus pines
+ * @return ESP_ERR_NO_MEM sin instancias libres, ESP_ERR_INVALID_STATE si un
+ *         pin ya lo usa otra instancia
+ */
+esp_err_t ultrasonic_create(const ultrasonic_config_t *cfg, ultrasonic_handle_t *out);
+
+/**
+ * @brief Libera la instancia y su ISR
+ */
+esp_err_t ultrasonic_delete(ultrasonic_handle_t h);
+
+/**
+ * @brief Dispara un ping y retorna de inmediato
+ * @return ESP_ERR_INVALID_STATE si hay un ping en vuelo o no venció la guarda
+ */
+esp_err_t ultrasonic_trigger(ultrasonic_handle_t h);
+
+/**
+ * @brief Consulta sin bloquear el ping en vuelo
+ * @return ESP_OK con eco, ESP_ERR_TIMEOUT, o ESP_ERR_NOT_FINISHED si sigue en vuelo
+ */
+esp_err_t ultrasonic_poll(ultrasonic_handle_t h, ultrasonic_reading_t *reading);
+
+/**
+ * @brief Bloquea hasta que el ping en vuelo termine (eco o timeout)
+ */
+esp_err_t ultrasonic_wait(ultrasonic_handle_t h, ultrasonic_reading_t *reading);
+
+/**
+ * @brief Espera la guarda, dispara y espera el resultado
+ */
+esp_err_t ultrasonic_measure(ultrasonic_handle_t h, ultrasonic_reading_t *reading);
+
+/**
+ * @brief µs que faltan para poder disparar de nuevo (0 = listo)
+ */
+uint32_t ultrasonic_guard_remaining_us(ultrasonic_handle_t h);
+
+/**
+ * @brief Temperatura del aire para la velocidad del sonido (décimas de °C)
+ * @return true si el factor de conversión cambió
+ */
+bool ultrasonic_set_temp_dc(ultrasonic_handle_t h, int16_t temp_dc);
+int16_t ultrasonic_get_temp_dc(ultrasonic_handle_t h);
+
+/**
+ * @brief Convierte un eco en µm con la temperatura actual de la instancia
+ *
+ * Para resultados filtrados fuera del driver (p. ej. promedio de una ráfaga).
+ */
+uint32_t ultrasonic_echo_to_um(ultrasonic_handle_t h, uint32_t echo_us);
+
+void ultrasonic_get_stats(ultrasonic_handle_t h, ultrasonic_stats_t *stats);
+void ultrasonic_reset_stats(ultrasonic_handle_t h);
@@ -0,0 +1,153 @@
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "ultrasonic_priv.h"
+
+static const char *TAG = "ULTRASONIC";
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief ISR del pin ECHO: marca el flanco de subida y el de bajada
+ *
+ * Libera el semáforo de la instancia en la bajada; la tarea que espera no
+ * consume CPU mientras el eco está en vuelo.
+ */
+static void IRAM_ATTR echo_isr_handler(void *arg)
+{
+    struct ultrasonic_s *us = (struct ultrasonic_s *)arg;
+    if (us->state != ULTRASONIC_IN_FLIGHT) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    if (gpio_get_level(us->cfg.echo_gpio)) {
+        if (us->rise_us == 0) {
+            us->rise_us = now;
+        }
+    } else if (us->rise_us != 0 && us->fall_us == 0) {
+        us->fall_us = now;
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR((SemaphoreHandle_t)us->port_ctx, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+int64_t ultrasonic_port_now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+esp_err_t ultrasonic_port_attach(struct ultrasonic_s *us)
+{
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << us->cfg.trig_gpio),
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error configurando TRIG=%d: %s", us->cfg.trig_gpio, esp_err_to_name(ret));
+        return ret;
+    }
+    gpio_set_level(us->cfg.trig_gpio, 0);
+
+    // ECHO como entrada con interrupción en ambos flancos
+    io_conf.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << us->cfg.echo_gpio);
+    io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error configurando ECHO=%d: %s", us->cfg.echo_gpio, esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (us->port_ctx == NULL) {
+        us->port_ctx = xSemaphoreCreateBinary();
+        if (us->port_ctx == NULL) {
+            ESP_LOGE(TAG, "✗ Error creando semáforo del eco");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // El servicio de ISR puede estar instalado por otro componente
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "✗ Error instalando servicio de ISR GPIO: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    gpio_isr_handler_remove(us->cfg.echo_gpio);
+    ret = gpio_isr_handler_add(us->cfg.echo_gpio, echo_isr_handler, us);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Error registrando ISR de ECHO: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "✓ Sensor %u listo (TRIG=%d, ECHO=%d)", us->index,
+             us->cfg.trig_gpio, us->cfg.echo_gpio);
+    return ESP_OK;
+}
+
+void ultrasonic_port_detach(struct ultrasonic_s *us)
+{
+    gpio_isr_handler_remove(us->cfg.echo_gpio);
+    gpio_set_intr_type(us->cfg.echo_gpio, GPIO_INTR_DISABLE);
+    // El semáforo se conserva para reutilizar la ranura sin volver a asignar
+}
+
+void ultrasonic_port_trigger(struct ultrasonic_s *us)
+{
+    // Descartar un flanco tardío de la medición anterior
+    xSemaphoreTake((SemaphoreHandle_t)us->port_ctx, 0);
+
+    gpio_set_level(us->cfg.trig_gpio, 0);
+    esp_rom_delay_us(2);
+    gpio_set_level(us->cfg.trig_gpio, 1);
+    esp_rom_delay_us(ULTRASONIC_TRIG_PULSE_US);
+    gpio_set_level(us->cfg.trig_gpio, 0);
+    us->start_us = esp_timer_get_time();
+}
+
+void ultrasonic_port_sync(struct ultrasonic_s *us)
+{
+    (void)us;   // La ISR ya publica los flancos
+}
+
+void ultrasonic_port_wait_edge(struct ultrasonic_s *us, int64_t deadline_us)
+{
+    int64_t remaining_us = deadline_us - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return;
+    }
+    TickType_t wait = pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1;
+    xSemaphoreTake((SemaphoreHandle_t)us->port_ctx, wait);
+}
+
+void ultrasonic_port_sleep_us(uint32_t us)
+{
+    if (us >= 1000) {
+        vTaskDelay(pdMS_TO_TICKS((us + 999) / 1000));
+    } else {
+        esp_rom_delay_us(us);
+    }
+}
+
+void ultrasonic_port_lock(void)
+{
+    taskENTER_CRITICAL(&s_lock);
+}
+
+void ultrasonic_port_unlock(void)
+{
+    taskEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,105 @@
+#include "ultrasonic_priv.h"
+#include "ultrasonic_sim.h"
+
+/*
+ * Backend simulado: cada ping programa sus flancos sobre un reloj virtual
+ * y ultrasonic_port_sync() los hace visibles cuando el reloj los alcanza,
+ * igual que la ISR en el chip.
+ */
+
+typedef struct {
+    uint32_t echo_us;
+    int64_t rise_at;
+    int64_t fall_at;
+} sim_channel_t;
+
+static sim_channel_t s_sim[ULTRASONIC_MAX_INSTANCES];
+static int64_t s_now_us = 1;   // 0 significa "flanco no visto"
+
+void ultrasonic_sim_set_echo_us(ultrasonic_handle_t h, uint32_t echo_us)
+{
+    s_sim[h->index].echo_us = echo_us;
+}
+
+void ultrasonic_sim_set_distance_um(ultrasonic_handle_t h, uint32_t distance_um)
+{
+    s_sim[h->index].echo_us = sound_speed_um_to_echo_us(&h->sound, distance_um);
+}
+
+void ultrasonic_sim_advance_us(uint32_t us)
+{
+    s_now_us += us;
+}
+
+int64_t ultrasonic_sim_now_us(void)
+{
+    return s_now_us;
+}
+
+int64_t ultrasonic_port_now_us(void)
+{
+    return s_now_us;
+}
+
+esp_err_t ultrasonic_port_attach(struct ultrasonic_s *us)
+{
+    s_sim[us->index] = (sim_channel_t){ 0 };
+    return ESP_OK;
+}
+
+void ultrasonic_port_detach(struct ultrasonic_s *us)
+{
+    (void)us;
+}
+
+void ultrasonic_port_trigger(struct ultrasonic_s *us)
+{
+    sim_channel_t *ch = &s_sim[us->index];
+    s_now_us += 2 + ULTRASONIC_TRIG_PULSE_US;
+    us->start_us = s_now_us;
+    if (ch->echo_us == 0) {
+        ch->rise_at = ch->fall_at = 0;
+        return;
+    }
+    ch->rise_at = s_now_us + ULTRASONIC_SIM_RISE_DELAY_US;
+    ch->fall_at = ch->rise_at + ch->echo_us;
+}
+
+void ultrasonic_port_sync(struct ultrasonic_s *us)
+{
+    const sim_channel_t *ch = &s_sim[us->index];
+    if (ch->rise_at != 0 && us->rise_us == 0 && s_now_us >= ch->rise_at) {
+        us->rise_us = ch->rise_at;
+    }
+    if (ch->fall_at != 0 && us->fall_us == 0 && s_now_us >= ch->fall_at) {
+        us->fall_us = ch->fall_at;
+    }
+}
+
+void ultrasonic_port_wait_edge(struct ultrasonic_s *us, int64_t deadline_us)
+{
+    // Avanzar el reloj hasta el próximo flanco pendiente o hasta el plazo
+    const sim_channel_t *ch = &s_sim[us->index];
+    int64_t target = deadline_us;
+    if (ch->rise_at != 0 && us->rise_us == 0 && ch->rise_at < target) {
+        target = ch->rise_at;
+    } else if (ch->fall_at != 0 && us->fall_us == 0 && ch->fall_at < target) {
+        target = ch->fall_at;
+    }
+    if (target > s_now_us) {
+        s_now_us = target;
+    }
+}
+
+void ultrasonic_port_sleep_us(uint32_t us)
+{
+    s_now_us += us;
+}
+
+void ultrasonic_port_lock(void)
+{
+}
+
+void ultrasonic_port_unlock(void)
+{
+}
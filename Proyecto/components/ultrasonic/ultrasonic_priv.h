@@ -0,0 +1,54 @@
+#pragma once
+#include "ultrasonic.h"
+#include "sound_speed.h"
+
+/*
+ * Estado interno de una instancia y la interfaz que implementa cada backend
+ * (ultrasonic_port_gpio.c en el chip, ultrasonic_port_sim.c en el host).
+ */
+
+typedef enum {
+    ULTRASONIC_IDLE = 0,
+    ULTRASONIC_IN_FLIGHT,
+} ultrasonic_state_t;
+
+struct ultrasonic_s {
+    bool used;
+    uint8_t index;
+    ultrasonic_config_t cfg;
+    sound_speed_t sound;
+    ultrasonic_state_t state;
+
+    // Escritos por la ISR (o por el modelo simulado); 0 = flanco no visto
+    volatile int64_t rise_us;
+    volatile int64_t fall_us;
+    int64_t start_us;
+    int64_t last_end_us;
+
+    ultrasonic_stats_t stats;
+    uint64_t latency_sum_us;
+    void *port_ctx;
+};
+
+int64_t ultrasonic_port_now_us(void);
+esp_err_t ultrasonic_port_attach(struct ultrasonic_s *us);
+void ultrasonic_port_detach(struct ultrasonic_s *us);
+
+/**
+ * @brief Emite el pulso de disparo y fija start_us
+ */
+void ultrasonic_port_trigger(struct ultrasonic_s *us);
+
+/**
+ * @brief Hace visibles los flancos ya ocurridos (no-op con ISR)
+ */
+void ultrasonic_port_sync(struct ultrasonic_s *us);
+
+/**
+ * @brief Bloquea hasta el flanco de bajada o hasta deadline_us
+ */
+void ultrasonic_port_wait_edge(struct ultrasonic_s *us, int64_t deadline_us);
+
+void ultrasonic_port_sleep_us(uint32_t us);
+void ultrasonic_port_lock(void);
+void ultrasonic_port_unlock(void);
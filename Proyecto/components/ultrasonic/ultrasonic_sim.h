@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+#include "ultrasonic.h"
+
+/**
+ * Control del backend simulado (CONFIG_ULTRASONIC_SIMULATED y pruebas de
+ * host). El reloj es virtual: solo avanza con ultrasonic_sim_advance_us()
+ * o cuando una llamada bloqueante del driver espera un flanco o la guarda.
+ */
+
+#define ULTRASONIC_SIM_RISE_DELAY_US  450   // Disparo → ECHO alto (ráfaga de 8 ciclos a 40 kHz + lógica)
+
+/**
+ * @brief Fija la duración del eco que devolverá cada ping
+ *
+ * 0 = ECHO nunca sube (sensor desconectado). Un valor mayor al timeout del
+ * eco simula "sin objeto".
+ */
+void ultrasonic_sim_set_echo_us(ultrasonic_handle_t h, uint32_t echo_us);
+
+/**
+ * @brief Fija el eco equivalente a una distancia con la temperatura actual
+ */
+void ultrasonic_sim_set_distance_um(ultrasonic_handle_t h, uint32_t distance_um);
+
+void ultrasonic_sim_advance_us(uint32_t us);
+int64_t ultrasonic_sim_now_us(void);